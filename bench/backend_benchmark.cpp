@@ -0,0 +1,274 @@
+// 后端热点路径的微基准：歌词解析与逐帧查找、文件名解析、歌单模型读取、频谱计算与转换、响度测量。
+// 不需要窗口与声卡，可在无界面环境运行：QT_QPA_PLATFORM=offscreen backend_benchmark
+// 用法：backend_benchmark [--json 输出.json] [--baseline 基准.json]
+//   --json      把本次结果（每次操作的纳秒数）写成 JSON，可作为新的基准文件保存
+//   --baseline  读取之前保存的 JSON，逐项打印相对变化
+#include "playerbackend.h"
+#include "playlistmodel.h"
+#include "spectrumanalyzer.h"
+#include "librarycolumns.h"
+#include "librarysnapshot.h"
+#include "smartquery.h"
+#include "loudness.h"
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <cstdio>
+#include <vector>
+
+static const int ROUNDS = 7;
+static const int LYRIC_LINES = 2000;    // 长歌词（含翻译的长曲目也很少超过这个行数）
+static const int PLAYLIST_SIZE = 5000;
+static const int FILE_NAMES = 1000;
+static const int SMART_LIBRARY_SIZE = 100000;
+
+// 防止编译器把被测调用整体优化掉
+static volatile qint64 g_sink = 0;
+
+// 运行 iterations 次 fn，取多轮最小值，返回每次操作的纳秒数
+template <typename Fn>
+static double measure(int iterations, Fn fn)
+{
+    fn(); // 预热
+    double best = 1e300;
+    for (int round = 0; round < ROUNDS; ++round) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i) fn();
+        best = qMin(best, double(timer.nsecsElapsed()) / iterations);
+    }
+    return best;
+}
+
+static QString makeLrc(int lines)
+{
+    QString text = "[ti:Benchmark]\n[ar:Nobody]\n";
+    for (int i = 0; i < lines; ++i) {
+        const int ms = i * 2300;
+        text += QString("[%1:%2.%3]第 %4 行歌词 line %4 of the benchmark lyrics\n")
+                    .arg(ms / 60000 % 100, 2, 10, QChar('0'))
+                    .arg(ms / 1000 % 60, 2, 10, QChar('0'))
+                    .arg(ms % 1000 / 10, 2, 10, QChar('0'))
+                    .arg(i);
+    }
+    return text;
+}
+
+// 可访问 PlayerBackend / PlaylistModel 私有成员的基准入口
+class BackendBenchmark
+{
+public:
+    explicit BackendBenchmark(QObject *parent)
+        : m_playlist(new PlaylistModel(parent))
+        , m_backend(new PlayerBackend(m_playlist, parent))
+    {
+    }
+
+    void run(QJsonObject &results)
+    {
+        auto report = [&results](const char *name, double ns) {
+            results[name] = ns;
+            std::printf("%-32s %14.1f\n", name, ns);
+        };
+
+        // 歌词
+        const QString lrc = makeLrc(LYRIC_LINES);
+        report("parseLyrics/2000", measure(20, [&]() {
+            g_sink += m_backend->parseLyrics(lrc).size();
+        }));
+
+        m_backend->m_parsedLyrics = m_backend->parseLyrics(lrc);
+        const qint64 songMs = qint64(LYRIC_LINES) * 2300;
+        qint64 position = 0;
+        report("updateLyrics/2000 sweep", measure(200, [&]() {
+            position = (position + 16 * 2300 + 7) % songMs;   // 播放中按任意位置查找
+            m_backend->updateLyrics(position);
+        }));
+        report("updateLyrics/2000 start", measure(2000, [&]() {
+            m_backend->updateLyrics(1000);
+        }));
+
+        // 文件名解析
+        QStringList names;
+        for (int i = 0; i < FILE_NAMES; ++i) {
+            switch (i % 4) {
+            case 0: names << QString("Artist %1 - Song Title %1.mp3").arg(i); break;
+            case 1: names << QString("%1. 歌名 %1.flac").arg(i % 100, 2, 10, QChar('0')); break;
+            case 2: names << QString("歌手%1-歌名%1（Live）.m4a").arg(i); break;
+            default: names << QString("track_%1_final_mix.wav").arg(i); break;
+            }
+        }
+        report("parseFileName x1000", measure(20, [&]() {
+            for (const QString &name : names) g_sink += m_playlist->parseFileName(name).first.size();
+        }));
+
+        // 歌单模型：所有行 × 所有角色，以及 QML 常用的 get()
+        QVector<TrackItem> tracks;
+        tracks.reserve(PLAYLIST_SIZE);
+        for (int i = 0; i < PLAYLIST_SIZE; ++i) {
+            TrackItem t;
+            t.name = QString("Artist %1 - Song %1").arg(i);
+            t.title = QString("Song %1").arg(i);
+            t.artist = QString("Artist %1").arg(i % 300);
+            t.album = QString("Album %1").arg(i % 500);
+            t.lyrics = i % 10 == 0 ? makeLrc(40) : QString();
+            t.url = QUrl::fromLocalFile(QString("/music/Artist %1/Song %2.mp3").arg(i % 300).arg(i));
+            t.duration = 180000 + i;
+            t.cover = "qrc:/assets/default_cover.svg";
+            tracks.append(t);
+        }
+        m_playlist->setTracks(tracks);
+        const QList<int> roles = m_playlist->roleNames().keys();
+        report("data/5000 rows x all roles", measure(5, [&]() {
+            for (int row = 0; row < PLAYLIST_SIZE; ++row) {
+                const QModelIndex index = m_playlist->index(row);
+                for (int role : roles) g_sink += m_playlist->data(index, role).isValid();
+            }
+        }));
+        report("get/5000 rows", measure(5, [&]() {
+            for (int row = 0; row < PLAYLIST_SIZE; ++row) g_sink += m_playlist->get(row).size();
+        }));
+
+        // 智能歌单：10 万行的列式曲库上整表求值，以及重新扫描后只有少量行变化时的增量求值
+        QVector<TrackItem> library;
+        library.reserve(SMART_LIBRARY_SIZE);
+        for (int i = 0; i < SMART_LIBRARY_SIZE; ++i) {
+            TrackItem t;
+            t.title = QString("Song %1").arg(i);
+            t.artist = QString("Artist %1").arg(i % 3000);
+            t.album = QString("Album %1").arg(i % 8000);
+            t.url = QUrl::fromLocalFile(QString("/music/%1/%2.mp3").arg(i % 3000).arg(i));
+            t.duration = 120000 + (i * 37) % 300000;
+            library.append(t);
+        }
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        LibraryColumns columns;
+        columns.update(TrackList(library), now);
+        const SmartQuery textQuery = SmartQuery::compile("artist contains \"artist 12\" and duration > 5m");
+        const SmartQuery numberQuery = SmartQuery::compile("duration > 5m and plays = 0");
+        std::vector<quint8> matches;
+        report("smart query text/100k", measure(20, [&]() {
+            textQuery.evaluate(columns, now, &matches);
+            g_sink += matches[0];
+        }));
+        report("smart query numeric/100k", measure(50, [&]() {
+            numberQuery.evaluate(columns, now, &matches);
+            g_sink += matches[0];
+        }));
+        // 曲库快照发布：重新扫描后只有两行变化，未变的块与上一份共享，再计算给读者的变化区间
+        LibrarySnapshot before;
+        before.generation = 1;
+        before.tracks = columns.tracks();
+        for (int r = 0; r < before.tracks.size(); ++r) {
+            before.rowByPath.insert(LibrarySnapshot::pathKey(before.tracks[r].url.toLocalFile()), r);
+        }
+        library[500].title = "Changed";
+        library[90000].duration = 1000;
+        LibrarySnapshot after = before;
+        after.generation = 2;
+        report("library publish/100k", measure(10, [&]() {
+            after.tracks = TrackList::build(library, before.tracks);
+            g_sink += LibraryChangeSet::diff(before, after).changed.size();
+        }));
+        const LibraryColumns::Delta delta = columns.update(after.tracks, now);
+        textQuery.evaluate(columns, now, &matches);
+        report("smart query update/100k", measure(20, [&]() {
+            std::vector<quint8> copy = matches;
+            textQuery.update(columns, delta, now, &copy);
+            g_sink += copy[0];
+        }));
+
+        // 频谱：PCM 管线每帧的 FFT 与分段、未播放时的 updateSpectrum、转换给 QML 的 spectrum()
+        SpectrumAnalyzer analyzer;
+        std::vector<float> window(size_t(analyzer.fftSize()));
+        for (float &s : window) s = float(QRandomGenerator::global()->bounded(1.0) - 0.5);
+        QVector<double> bands;
+        double level = 0.0;
+        report("SpectrumAnalyzer::process", measure(2000, [&]() {
+            analyzer.process(window.data(), bands, level);
+        }));
+        report("updateSpectrum (idle)", measure(20000, [&]() {
+            m_backend->updateSpectrum();
+        }));
+        m_backend->m_spectrum = bands;
+        report("spectrum() 60 bands", measure(20000, [&]() {
+            g_sink += m_backend->spectrum().size();
+        }));
+
+        // 响度：1 秒 48 kHz 立体声的 K 计权、门限块与 4 倍过采样真峰值（批量分析的主要开销之一，另一部分是解码）
+        std::vector<float> pcm(size_t(48000 * 2));
+        for (float &s : pcm) s = float(QRandomGenerator::global()->bounded(1.0) - 0.5);
+        report("LoudnessMeter 1s stereo", measure(50, [&]() {
+            LoudnessMeter meter(48000, 2);
+            meter.process(pcm.data(), 48000);
+            g_sink += meter.result().histogram.size();
+        }));
+    }
+
+private:
+    PlaylistModel *m_playlist;
+    PlayerBackend *m_backend;
+};
+
+static void compareWithBaseline(const QJsonObject &results, const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "无法读取基准文件: %s\n", qPrintable(path));
+        return;
+    }
+    const QJsonObject baseline = QJsonDocument::fromJson(file.readAll()).object().value("results").toObject();
+    if (baseline.isEmpty()) {
+        std::fprintf(stderr, "基准文件中还没有结果，请先用 --json 记录: %s\n", qPrintable(path));
+    }
+    std::printf("\n%-32s %14s %14s %9s\n", "case", "baseline ns", "now ns", "change");
+    for (auto it = results.constBegin(); it != results.constEnd(); ++it) {
+        const double now = it.value().toDouble();
+        if (!baseline.contains(it.key())) {
+            std::printf("%-32s %14s %14.1f %9s\n", qPrintable(it.key()), "-", now, "new");
+            continue;
+        }
+        const double before = baseline.value(it.key()).toDouble();
+        std::printf("%-32s %14.1f %14.1f %+8.1f%%\n", qPrintable(it.key()), before, now,
+                    before > 0 ? (now - before) / before * 100.0 : 0.0);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+    // 使用测试目录，不读写用户的设置、会话快照与歌词索引
+    QStandardPaths::setTestModeEnabled(true);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption({ "json", "把结果写入 JSON 文件", "file" });
+    parser.addOption({ "baseline", "与之前保存的 JSON 结果比较", "file" });
+    parser.process(app);
+
+    std::printf("%-32s %14s\n", "case", "ns / op");
+    QJsonObject results;
+    BackendBenchmark(&app).run(results);
+
+    if (parser.isSet("baseline")) compareWithBaseline(results, parser.value("baseline"));
+
+    if (parser.isSet("json")) {
+        QJsonObject root;
+        root["machine"] = QSysInfo::prettyProductName() + " " + QSysInfo::currentCpuArchitecture();
+        root["qt"] = QString::fromLatin1(qVersion());
+        root["results"] = results;
+        QSaveFile out(parser.value("json"));
+        if (!out.open(QIODevice::WriteOnly)) return 1;
+        out.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+        if (!out.commit()) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+// 均衡器性能基准：分别在 44.1/48/96 kHz 下测量处理 1 秒立体声音频的耗时
+// 用法：eq_benchmark [秒数]（默认 30 秒音频，取多轮最小值）
+#include "equalizer.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const int CHANNELS = 2;
+static const int BLOCK_FRAMES = 1024;   // 与音频输出回调的典型块大小相近
+static const int ROUNDS = 5;
+
+// 返回每秒音频的处理耗时（微秒）
+static double measure(Equalizer &eq, std::vector<float> &audio, int sampleRate, bool moveSliders)
+{
+    const qsizetype frames = qsizetype(audio.size() / CHANNELS);
+    double best = 1e300;
+    for (int round = 0; round < ROUNDS; ++round) {
+        QElapsedTimer timer;
+        timer.start();
+        int block = 0;
+        for (qsizetype pos = 0; pos < frames; pos += BLOCK_FRAMES, ++block) {
+            // 模拟持续拖动滑块：每个块都改变一次目标增益，平滑与系数重算一直在进行
+            if (moveSliders) eq.setBandGain(block % Equalizer::BAND_COUNT, (block % 25) - 12.0);
+            const qsizetype n = qMin<qsizetype>(BLOCK_FRAMES, frames - pos);
+            eq.process(audio.data() + pos * CHANNELS, n);
+        }
+        const double seconds = double(frames) / sampleRate;
+        best = qMin(best, double(timer.nsecsElapsed()) / 1000.0 / seconds);
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int seconds = argc > 1 ? qMax(1, atoi(argv[1])) : 30;
+    const QVector<double> rock = Equalizer::presetGains("Rock");
+
+    std::printf("%-10s %-22s %14s %10s\n", "rate", "case", "us / s audio", "cpu %");
+    for (int rate : { 44100, 48000, 96000 }) {
+        std::vector<float> audio(size_t(rate) * seconds * CHANNELS);
+        for (float &s : audio) s = float(QRandomGenerator::global()->bounded(1.0) - 0.5) * 0.5f;
+
+        Equalizer eq(rate, CHANNELS);
+        eq.setEnabled(true);
+        for (int b = 0; b < Equalizer::BAND_COUNT; ++b) eq.setBandGain(b, rock[b]);
+        eq.process(audio.data(), qMin<qsizetype>(rate, qsizetype(audio.size() / CHANNELS))); // 先平滑到位
+
+        const double steady = measure(eq, audio, rate, false);
+        const double moving = measure(eq, audio, rate, true);
+        std::printf("%-10d %-22s %14.1f %10.3f\n", rate, "10 bands, settled", steady, steady / 1e4);
+        std::printf("%-10d %-22s %14.1f %10.3f\n", rate, "10 bands, smoothing", moving, moving / 1e4);
+    }
+    return 0;
+}
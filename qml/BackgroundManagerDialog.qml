@@ -0,0 +1,905 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Effects
+
+// 背景图片管理对话框：由 main.qml 在第一次打开时通过 TracedLoader 创建
+Dialog {
+    id: backgroundManagerDialog
+    width: 1000
+    height: 700
+    modal: true
+    closePolicy: Popup.CloseOnEscape | Popup.CloseOnPressOutside
+
+    // 收纳到右侧时关闭（由 main.qml 绑定）
+    property bool docked: false
+    // 批量删除功能属性
+    property bool batchDeleteMode: false
+    property var selectedImages: []
+
+    // 请求打开批量添加图片的文件对话框（对话框位于 main.qml）
+    signal addImagesRequested()
+
+    onDockedChanged: {
+        if (docked) close()
+    }
+
+    // 透明背景层，用于点击隐藏右键菜单和退出批量选择模式
+    MouseArea {
+        anchors.fill: parent
+        enabled: contextMenu.visible || batchDeleteMode
+        onClicked: {
+            if (contextMenu.visible) {
+                contextMenu.visible = false
+            } else if (batchDeleteMode) {
+                // 退出批量选择模式
+                batchDeleteMode = false
+                selectedImages = []
+            }
+        }
+    }
+    
+    // 浅色科技风格背景
+    Rectangle {
+        anchors.fill: parent
+        color: "#f8fafc"
+        radius: 20
+        
+        // 柔和渐变边框
+        Rectangle {
+            anchors.fill: parent
+            anchors.margins: 2
+            color: "transparent"
+            radius: 18
+            border.width: 2
+            border.color: "#e2e8f0"
+            
+            // 柔和发光效果
+            Rectangle {
+                anchors.fill: parent
+                anchors.margins: -4
+                color: "transparent"
+                radius: 22
+                border.width: 1
+                border.color: "#cbd5e144"
+                
+                // 外层光晕
+                Rectangle {
+                    anchors.fill: parent
+                    anchors.margins: -6
+                    color: "transparent"
+                    radius: 26
+                    border.width: 1
+                    border.color: "#94a3b822"
+                }
+            }
+        }
+        
+        // 简约网格背景纹理
+        Rectangle {
+            anchors.fill: parent
+            anchors.margins: 4
+            color: "transparent"
+            clip: true
+            
+            // 简洁的网格背景
+            Canvas {
+                id: lightGridPattern
+                anchors.fill: parent
+                
+                property int cellSize: 24
+                property real lineWidth: 0.3
+                property color lineColor: "#e2e8f033"
+                
+                onPaint: {
+                    var ctx = getContext("2d")
+                    ctx.clearRect(0, 0, width, height)
+                    ctx.strokeStyle = lineColor
+                    ctx.lineWidth = lineWidth
+                    
+                    // 绘制垂直线
+                    for (var x = 0; x <= width; x += cellSize) {
+                        ctx.beginPath()
+                        ctx.moveTo(x, 0)
+                        ctx.lineTo(x, height)
+                        ctx.stroke()
+                    }
+                    
+                    // 绘制水平线
+                    for (var y = 0; y <= height; y += cellSize) {
+                        ctx.beginPath()
+                        ctx.moveTo(0, y)
+                        ctx.lineTo(width, y)
+                        ctx.stroke()
+                    }
+                }
+                
+                onWidthChanged: requestPaint()
+                onHeightChanged: requestPaint()
+            }
+        }
+        
+        Column {
+            anchors.fill: parent
+            anchors.margins: 30
+            spacing: 25
+            
+            // 简约科技风格标题栏
+            Rectangle {
+                width: parent.width
+                height: 60
+                color: "transparent"
+                
+                Row {
+                    anchors.fill: parent
+                    spacing: 20
+                    anchors.verticalCenter: parent.verticalCenter
+                    
+                    // 标题区域
+                    Column {
+                        spacing: 5
+                        
+                        Text {
+                            text: "背景图片管理"
+                            font.pixelSize: 24
+                            font.bold: true
+                            color: "#1e293b"
+                            font.family: "Segoe UI"
+                            
+                            // 简洁文字效果
+                            layer.enabled: true
+                            layer.effect: MultiEffect {
+                                colorization: 0.1
+                                colorizationColor: "#64748b"
+                                blur: 0.2
+                                blurMax: 4
+                            }
+                        }
+                        
+                        Rectangle {
+                            width: 200
+                            height: 3
+                            color: "#cff3f3ff"
+                            radius: 2
+                            
+                            // 柔和扫描线
+                            Rectangle {
+                                width: 40
+                                height: 3
+                                color: "#76e0e2ff"
+                                radius: 2
+                                
+                                SequentialAnimation on x {
+                                    loops: Animation.Infinite
+                                    NumberAnimation { to: 160; duration: 2500; easing.type: Easing.InOutQuad }
+                                    NumberAnimation { to: 0; duration: 2500; easing.type: Easing.InOutQuad }
+                                }
+                            }
+                        }
+                    }
+                    
+                    // 状态指示器
+                    Rectangle {
+                        width: 220
+                        height: 45
+                        color: "#f1f5f9"
+                        radius: 22
+                        border.color: "#cbd5e1"
+                        border.width: 2
+                        
+                        Row {
+                            anchors.centerIn: parent
+                            spacing: 15
+                            
+                            Rectangle {
+                                width: 12
+                                height: 12
+                                color: playerBackend.backgroundImageList.length > 0 ? "#10b981" : "#ef4444"
+                                radius: 6
+                                
+                                // 柔和脉冲动画
+                                SequentialAnimation on scale {
+                                    loops: Animation.Infinite
+                                    NumberAnimation { to: 1.2; duration: 1200 }
+                                    NumberAnimation { to: 1.0; duration: 1200 }
+                                }
+                            }
+                            
+                            Text {
+                                text: playerBackend.currentBackgroundIndex >= 0 ? 
+                                      (playerBackend.currentBackgroundIndex + 1) + "/" + playerBackend.backgroundImageList.length : 
+                                      "无背景"
+                                color: "#475569"
+                                font.pixelSize: 14
+                                font.bold: true
+                            }
+                        }
+                    }
+                }
+            }
+            
+            // 简约科技风格缩略图网格区域
+            Rectangle {
+                width: parent.width
+                height: 380
+                color: "#ffffff"
+                radius: 16
+                border.color: "#e2e8f0"
+                border.width: 2
+                clip: true
+                
+                // 内部柔和边框
+                Rectangle {
+                    anchors.fill: parent
+                    anchors.margins: 3
+                    color: "transparent"
+                    radius: 13
+                    border.width: 1
+                    border.color: "#f1f5f9"
+                }
+                
+                ScrollView {
+                    anchors.fill: parent
+                    anchors.margins: 20
+                    
+                    GridView {
+                        id: thumbnailGrid
+                        model: playerBackend.backgroundImageList
+                        cellWidth: 210  
+                        cellHeight: 158 
+                        
+                        delegate: Rectangle {
+                            width: 210
+                            height: 157
+                            color: "transparent"
+                            
+                            // 简约科技风格卡片
+                            Rectangle {
+                                anchors.fill: parent
+                                anchors.margins: 6 
+                                color: index === playerBackend.currentBackgroundIndex ? "#f0f9ff" : "#ffffff"
+                                radius: 12
+                                border.color: index === playerBackend.currentBackgroundIndex ? "#0ea5e9" : "#e2e8f0"
+                                border.width: index === playerBackend.currentBackgroundIndex ? 2 : 1
+                                
+                                // 柔和阴影效果
+                                Rectangle {
+                                    anchors.fill: parent
+                                    anchors.margins: -2
+                                    color: "transparent"
+                                    radius: 14
+                                    border.width: 1
+                                    border.color: index === playerBackend.currentBackgroundIndex ? "#0ea5e922" : "transparent"
+                                    visible: index === playerBackend.currentBackgroundIndex
+                                }
+                                
+                                Column {
+                                    anchors.fill: parent
+                                    anchors.margins: 8   
+                                    spacing: 14  
+                                    
+                                    // 缩略图容器
+                                    Rectangle {
+                                        width: 176  // 进一步缩小 (从185调整到176)
+                                        height: 99  // 进一步缩小 (从104调整到99)
+                                        color: "#f8fafc"
+                                        radius: 6
+                                        border.color: "#e2e8f0"
+                                        border.width: 1
+                                        anchors.horizontalCenter: parent.horizontalCenter
+                                        clip: true
+                                        
+                                        Image {
+                                            anchors.fill: parent
+                                            anchors.margins: 3
+                                            source: playerBackend.backgroundThumbnailUrl(modelData)
+                                            sourceSize: Qt.size(352, 198)
+                                            fillMode: Image.PreserveAspectCrop
+                                            asynchronous: true
+                                            cache: true
+                                            
+                                            // 优雅加载动画
+                                            Rectangle {
+                                                anchors.centerIn: parent
+                                                width: 28
+                                                height: 28
+                                                color: "#e2e8f0"
+                                                radius: 14
+                                                visible: parent.status === Image.Loading
+                                                
+                                                // 旋转动画
+                                                RotationAnimation on rotation {
+                                                    from: 0
+                                                    to: 360
+                                                    duration: 1800
+                                                    loops: Animation.Infinite
+                                                }
+                                                
+                                                Text {
+                                                    anchors.centerIn: parent
+                                                    text: "⚡"
+                                                    color: "#94a3b8"
+                                                    font.pixelSize: 14
+                                                }
+                                            }
+                                            
+                                            // 错误状态
+                                            Rectangle {
+                                                anchors.fill: parent
+                                                color: "#fef2f2"
+                                                visible: parent.status === Image.Error
+                                                
+                                                Text {
+                                                    anchors.centerIn: parent
+                                                    text: "⚠️\n加载失败"
+                                                    color: "#ef4444"
+                                                    font.pixelSize: 12
+                                                    horizontalAlignment: Text.AlignHCenter
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                                
+                                // 鼠标交互区域
+                                MouseArea {
+                                    anchors.fill: parent
+                                    hoverEnabled: true
+                                    
+                                    onEntered: {
+                                        parent.scale = 1.03
+                                        parent.color = index === playerBackend.currentBackgroundIndex ? "#e0f2fe" : "#f8fafc"
+                                    }
+                                    
+                                    onExited: {
+                                        if (!contextMenu.visible) {
+                                            parent.scale = 1.0
+                                            parent.color = index === playerBackend.currentBackgroundIndex ? "#f0f9ff" : "#ffffff"
+                                        }
+                                    }
+                                    
+                                    onClicked: {
+                                        // 点击动画 - 使用parent作为动画目标
+                                        var clickAnim = Qt.createQmlObject('import QtQuick 2.15; SequentialAnimation { PropertyAnimation { target: parent; property: "scale"; to: 0.95; duration: 100 } PropertyAnimation { target: parent; property: "scale"; to: 1.0; duration: 100 } }', parent, "dynamicClickAnimation")
+                                        clickAnim.start()
+                                        clickAnim.destroy(1000)
+                                        
+                                        if (batchDeleteMode) {
+                                            // 批量删除模式：使用图片路径作为唯一标识，避免索引随删除变化
+                                            var key = modelData  // 使用图片路径作为唯一标识，避免索引随删除变化
+                                            var selectedIndex = selectedImages.indexOf(key)
+                                            if (selectedIndex === -1) {
+                                                selectedImages = selectedImages.concat([key])
+                                            } else {
+                                                var newArr = selectedImages.slice()
+                                                newArr.splice(selectedIndex, 1)
+                                                selectedImages = newArr
+                                            }
+                                        } else {
+                                            // 普通模式：设置为背景
+                                            playerBackend.setBackgroundByIndex(index)
+                                        }
+                                    }
+                                    
+                                    // 右键菜单
+                                    acceptedButtons: Qt.LeftButton | Qt.RightButton
+                                    
+                                    onPressed: function(mouse) {
+                                        if (mouse.button === Qt.RightButton) {
+                                            // 设置右键菜单的目标图片信息
+                                            contextMenu.targetImagePath = modelData
+                                            contextMenu.targetImageIndex = index
+                                            
+                                            // 计算右键菜单位置（在鼠标附近，但确保不超出屏幕边界）
+                                            var globalPos = mapToItem(backgroundManagerDialog.contentItem, mouse.x, mouse.y)
+                                            var menuX = globalPos.x - 100 // 菜单宽度的一半，让菜单中心对齐鼠标
+                                            var menuY = globalPos.y - 60 // 菜单显示在鼠标上方
+                                            
+                                            // 确保菜单不超出对话框边界
+                                            if (menuX < 10) menuX = 10
+                                            if (menuX + 200 > backgroundManagerDialog.width - 10) menuX = backgroundManagerDialog.width - 210
+                                            if (menuY < 10) menuY = 10
+                                            if (menuY + 75 > backgroundManagerDialog.height - 10) menuY = globalPos.y + 10 // 如果上方空间不够，显示在下方
+                                            
+                                            // 设置菜单位置并显示
+                                            contextMenu.parent = backgroundManagerDialog.contentItem
+                                            contextMenu.x = menuX
+                                            contextMenu.y = menuY
+                                            contextMenu.visible = true
+                                            
+                                            // 保持缩略图高亮状态
+                                            parent.scale = 1.03
+                                            parent.color = index === playerBackend.currentBackgroundIndex ? "#e0f2fe" : "#f8fafc"
+                                        }
+                                    }
+                                }
+                                
+                                // 当前背景指示器
+                                Rectangle {
+                                    width: 20
+                                    height: 20
+                                    color: "#0ea5e9"
+                                    radius: 10
+                                    anchors.top: parent.top
+                                    anchors.right: parent.right
+                                    anchors.margins: 8
+                                    visible: index === playerBackend.currentBackgroundIndex
+                                    
+                                    // 柔和发光效果
+                                    Rectangle {
+                                        anchors.fill: parent
+                                        anchors.margins: -2
+                                        color: "transparent"
+                                        radius: 12
+                                        border.width: 1
+                                        border.color: "#0ea5e944"
+                                    }
+                                    
+                                    Text {
+                                        anchors.centerIn: parent
+                                        text: "✓"
+                                        color: "#ffffff"
+                                        font.pixelSize: 12
+                                        font.bold: true
+                                    }
+                                    
+                                    // 柔和脉冲动画
+                                    SequentialAnimation on scale {
+                                        loops: Animation.Infinite
+                                        NumberAnimation { to: 1.15; duration: 1200 }
+                                        NumberAnimation { to: 1.0; duration: 1200 }
+                                    }
+                                }
+                                
+                                // 批量选择指示器
+                                Rectangle {
+                                    id: batchSelector
+                                    width: 24
+                                    height: 24
+                                    color: isItemSelected ? "#ef4444" : "#f1f5f9"
+                                    radius: 12
+                                    anchors.top: parent.top
+                                    anchors.left: parent.left
+                                    anchors.margins: 8
+                                    visible: batchDeleteMode
+                                    
+                                    property bool isItemSelected: selectedImages.indexOf(modelData) !== -1
+                                    
+                                    border.color: isItemSelected ? "#dc2626" : "#cbd5e1"
+                                    border.width: 2
+                                    
+                                    Text {
+                                        anchors.centerIn: parent
+                                        text: batchSelector.isItemSelected ? "✓" : ""
+                                        color: "#ffffff"
+                                        font.pixelSize: 12
+                                        font.bold: true
+                                    }
+                                    
+                                    // 选中状态动画
+                                    Behavior on color {
+                                        ColorAnimation { duration: 200 }
+                                    }
+                                    
+                                    Behavior on scale {
+                                        NumberAnimation { duration: 200; easing.type: Easing.OutBack }
+                                    }
+                                    
+                                    // 悬停效果
+                                    MouseArea {
+                                        anchors.fill: parent
+                                        hoverEnabled: true
+                                        onEntered: {
+                                            if (!batchSelector.isItemSelected) {
+                                                parent.scale = 1.1
+                                                parent.color = "#e2e8f0"
+                                            }
+                                        }
+                                        onExited: {
+                                            if (!batchSelector.isItemSelected) {
+                                                parent.scale = 1.0
+                                                parent.color = "#f1f5f9"
+                                            }
+                                        }
+                                    }
+                                }
+                                
+                                Behavior on scale {
+                                    NumberAnimation { duration: 200; easing.type: Easing.OutBack }
+                                }
+                                
+                                Behavior on color {
+                                    ColorAnimation { duration: 300 }
+                                }
+                            }
+                        }
+                    }
+                }
+                Column {
+                    anchors.centerIn: parent
+                    visible: playerBackend.backgroundImageList.length === 0
+                    spacing: 20
+                    
+                    Rectangle {
+                        width: 80
+                        height: 80
+                        color: "#f1f5f9"
+                        radius: 40
+                        border.color: "#e2e8f0"
+                        border.width: 2
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        
+                        Text {
+                            anchors.centerIn: parent
+                            text: "🖼️"
+                            color: "#94a3b8"
+                            font.pixelSize: 40
+                            
+                            // 柔和浮动动画
+                            SequentialAnimation on y {
+                                loops: Animation.Infinite
+                                NumberAnimation { to: -5; duration: 2500; easing.type: Easing.InOutQuad }
+                                NumberAnimation { to: 5; duration: 2500; easing.type: Easing.InOutQuad }
+                            }
+                        }
+                        
+                        // 旋转光环
+                        Rectangle {
+                            anchors.fill: parent
+                            anchors.margins: -10
+                            color: "transparent"
+                            radius: 50
+                            border.width: 1
+                            border.color: "#e2e8f033"
+                            
+                            RotationAnimation on rotation {
+                                from: 0
+                                to: 360
+                                duration: 12000
+                                loops: Animation.Infinite
+                            }
+                        }
+                    }
+                    
+                    Text {
+                        text: "还没有背景图片"
+                        color: "#475569"
+                        font.pixelSize: 18
+                        font.bold: true
+                        anchors.horizontalCenter: parent.horizontalCenter
+                    }
+                    
+                    Text {
+                        text: "点击下方按钮添加您喜欢的背景图片"
+                        color: "#94a3b8"
+                        font.pixelSize: 14
+                        anchors.horizontalCenter: parent.horizontalCenter
+                    }
+                }
+            }
+            
+            // 简约科技风格控制按钮区域
+            Rectangle {
+                width: parent.width
+                height: 80
+                color: "#f8fafc"
+                radius: 16
+                border.color: "#e2e8f0"
+                border.width: 1
+                
+                // 内部柔和边框
+                Rectangle {
+                    anchors.fill: parent
+                    anchors.margins: 2
+                    color: "transparent"
+                    radius: 14
+                    border.width: 1
+                    border.color: "#f1f5f9"
+                }
+                
+                Row {
+                    anchors.horizontalCenter: parent.horizontalCenter
+                    anchors.verticalCenter: parent.verticalCenter
+                    anchors.margins: 20
+                    spacing: 15
+                    
+                    // 添加背景图片按钮
+                    Rectangle {
+                        width: 160
+                        height: 45
+                        color: "#ffffff"
+                        radius: 22
+                        border.color: "#0ea5e9"
+                        border.width: 2
+                        
+                        // 柔和阴影效果
+                        Rectangle {
+                            anchors.fill: parent
+                            anchors.margins: -3
+                            color: "transparent"
+                            radius: 25
+                            border.width: 2
+                            border.color: "#0ea5e922"
+                        }
+                        
+                        MouseArea {
+                            anchors.fill: parent
+                            hoverEnabled: true
+                            
+                            onEntered: {
+                                parent.color = "#f0f9ff"
+                                parent.scale = 1.03
+                            }
+                            
+                            onExited: {
+                                parent.color = "#ffffff"
+                                parent.scale = 1.0
+                            }
+                            
+                            onPressed: {
+                                parent.scale = 0.97
+                            }
+                            
+                            onReleased: {
+                                parent.scale = 1.03
+                            }
+                            
+                            onClicked: {
+                                backgroundManagerDialog.addImagesRequested()
+                            }
+                        }
+                        
+                        Row {
+                            anchors.centerIn: parent
+                            spacing: 15
+                            
+                            Text {
+                                text: "添加背景"
+                                color: "#0ea5e9"
+                                font.pixelSize: 14
+                                font.bold: true
+                            }
+                        }
+                        
+                        Behavior on color {
+                            ColorAnimation { duration: 200 }
+                        }
+                        
+                        Behavior on scale {
+                            NumberAnimation { duration: 200; easing.type: Easing.OutBack }
+                        }
+                    }
+                    
+                    // 批量删除按钮
+                    Rectangle {
+                        width: 160
+                        height: 45
+                        color: batchDeleteMode ? "#fee2e2" : "#ffffff"
+                        radius: 22
+                        border.color: "#ef4444"
+                        border.width: 2
+                        
+                        // 移除外层黑色边框，只保留内层红色边框
+                        
+                        MouseArea {
+                            anchors.fill: parent
+                            hoverEnabled: true
+                            
+                            onEntered: {
+                                parent.color = batchDeleteMode ? "#fecaca" : "#fef2f2"
+                                parent.scale = 1.03
+                            }
+                            
+                            onExited: {
+                                parent.color = batchDeleteMode ? "#fee2e2" : "#ffffff"
+                                parent.scale = 1.0
+                            }
+                            
+                            onPressed: {
+                                parent.scale = 0.97
+                            }
+                            
+                            onReleased: {
+                                parent.scale = 1.03
+                            }
+                            
+                            onClicked: {
+                                    if (batchDeleteMode) {
+                                        // 执行批量删除
+                                        performBatchDelete()
+                                    } else {
+                                        // 进入批量选择模式：重新赋空数组以触发绑定
+                                        batchDeleteMode = true
+                                        selectedImages = []
+                                    }
+                                }
+                        }
+                        
+                        Row {
+                            anchors.centerIn: parent
+                            spacing: 15
+                            
+                            Text {
+                                text: batchDeleteMode ? "确认删除" : "批量删除"
+                                color: "#ef4444"
+                                font.pixelSize: 14
+                                font.bold: true
+                            }
+                        }
+                        
+                        Behavior on color {
+                            ColorAnimation { duration: 200 }
+                        }
+                        
+                        Behavior on scale {
+                            NumberAnimation { duration: 200; easing.type: Easing.OutBack }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    // 右键菜单 - 浅色调未来感设计
+    Rectangle {
+        id: contextMenu
+        width: 200
+        height: 75
+        visible: false
+        color: "#ffffff"
+        radius: 12
+        border.color: "#e2e8f0"
+        border.width: 1
+        z: 1000
+        
+        property string targetImagePath: ""
+        property int targetImageIndex: -1
+        property real menuX: 0
+        property real menuY: 0
+        
+        // 柔和阴影效果
+        Rectangle {
+            anchors.fill: parent
+            anchors.margins: -2
+            color: "transparent"
+            radius: 14
+            border.width: 1
+            border.color: "#f1f5f9"
+        }
+        
+        // 悬浮阴影
+        MultiEffect {
+            anchors.fill: parent
+            source: contextMenu
+            shadowEnabled: true
+            shadowBlur: 0.8
+            shadowColor: "#10000000"
+            shadowVerticalOffset: 6
+            shadowHorizontalOffset: 0
+            visible: contextMenu.visible
+        }
+        
+        // 菜单标题
+        Rectangle {
+            id: menuHeader
+            anchors.top: parent.top
+            anchors.left: parent.left
+            anchors.right: parent.right
+            anchors.topMargin: 1
+            anchors.leftMargin: 1
+            anchors.rightMargin: 1
+            height: 35
+            color: "#f8fafc"
+            radius: 11
+            border.color: "#e2e8f0"
+            border.width: 1
+            
+            Text {
+                text: "🖼️ 图片操作"
+                color: "#475569"
+                font.pixelSize: 13
+                font.bold: true
+                anchors.centerIn: parent
+            }
+        }
+        
+        // 菜单项容器
+        Column {
+            anchors.top: menuHeader.bottom
+            anchors.left: parent.left
+            anchors.right: parent.right
+            anchors.bottom: parent.bottom
+            anchors.margins: 8
+            spacing: 4
+            
+            // 设为背景按钮
+            Rectangle {
+                width: parent.width
+                height: 32
+                color: "#ffffff"
+                radius: 8
+                border.color: "#e2e8f0"
+                border.width: 1
+                
+                MouseArea {
+                    anchors.fill: parent
+                    hoverEnabled: true
+                    
+                    onEntered: {
+                        parent.color = "#f0f9ff"
+                        parent.border.color = "#0ea5e9"
+                    }
+                    
+                    onExited: {
+                        parent.color = "#ffffff"
+                        parent.border.color = "#e2e8f0"
+                    }
+                    
+                    onClicked: {
+                        playerBackend.setBackgroundByIndex(contextMenu.targetImageIndex)
+                        contextMenu.visible = false
+                    }
+                }
+                
+                Row {
+                    anchors.centerIn: parent
+                    spacing: 8
+                    
+                    Text {
+                        text: "🎨"
+                        font.pixelSize: 14
+                        anchors.verticalCenter: parent.verticalCenter
+                    }
+                    
+                    Text {
+                        text: "设为背景"
+                        color: "#0ea5e9"
+                        font.pixelSize: 13
+                        font.bold: true
+                        anchors.verticalCenter: parent.verticalCenter
+                    }
+                }
+                
+                Behavior on color {
+                    ColorAnimation { duration: 150 }
+                }
+                
+                Behavior on border.color {
+                    ColorAnimation { duration: 150 }
+                }
+            }
+        }
+        
+        Behavior on visible {
+            NumberAnimation { duration: 200 }
+        }
+        
+        Behavior on opacity {
+            NumberAnimation { duration: 150 }
+        }
+    }
+
+    // 执行批量删除函数
+    function performBatchDelete() {
+        if (!selectedImages || selectedImages.length === 0) {
+            batchDeleteMode = false
+            return
+        }
+        
+        // 将选中的路径转换为当前 model 的索引（可能有未找到的项，忽略之）
+        var indicesToDelete = []
+        for (var i = 0; i < selectedImages.length; i++) {
+            var idx = playerBackend.backgroundImageList.indexOf(selectedImages[i])
+            if (idx !== -1) indicesToDelete.push(idx)
+        }
+        
+        // 从大到小删除以避免索引错位
+        indicesToDelete.sort(function(a,b){ return b - a })
+        
+        for (var j = 0; j < indicesToDelete.length; j++) {
+            playerBackend.removeBackgroundImageByIndex(indicesToDelete[j])
+        }
+        
+        // 清空并退出批量模式（重新赋空数组以触发绑定）
+        selectedImages = []
+        batchDeleteMode = false
+    }
+}
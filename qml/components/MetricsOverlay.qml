@@ -0,0 +1,112 @@
+import QtQuick
+import QtQuick.Controls
+
+// 调试用的运行时指标浮层（Ctrl+Shift+M）：显示计数器、各直方图的分位数与缓存命中率。
+// 显示期间打开 metrics.live，让快照每 500 ms 刷新一次；隐藏后停止刷新
+Rectangle {
+    id: overlay
+
+    property var snapshot: ({})
+    readonly property var histogramLabels: ({
+        "probeLatency": "元数据读取",
+        "searchLatency": "歌词搜索",
+        "trackSwitchLatency": "切歌",
+        "spectrumFrame": "频谱帧",
+        "qmlFrame": "渲染帧"
+    })
+
+    width: 340
+    height: content.implicitHeight + 24
+    radius: 8
+    color: "#CC101418"
+    border.color: "#40FFFFFF"
+
+    function format(ms) {
+        return ms >= 100 ? ms.toFixed(0) : ms.toFixed(2)
+    }
+
+    function percent(ratio) {
+        return ratio < 0 ? "—" : (ratio * 100).toFixed(1) + "%"
+    }
+
+    onVisibleChanged: metrics.live = visible
+    Component.onCompleted: metrics.live = visible
+    Component.onDestruction: metrics.live = false
+
+    Connections {
+        target: metrics
+        function onUpdated() {
+            overlay.snapshot = metrics.snapshot
+        }
+    }
+
+    Column {
+        id: content
+        x: 12
+        y: 12
+        width: parent.width - 24
+        spacing: 4
+
+        Text {
+            text: "运行时指标"
+            color: "white"
+            font.bold: true
+            font.pixelSize: 13
+        }
+
+        Repeater {
+            model: overlay.snapshot.counters ? Object.keys(overlay.snapshot.counters) : []
+            delegate: Text {
+                text: modelData + ": " + overlay.snapshot.counters[modelData]
+                color: "#D0FFFFFF"
+                font.pixelSize: 11
+                font.family: "monospace"
+            }
+        }
+
+        Text {
+            text: "p50 / p95 / p99 / max (ms)"
+            color: "white"
+            font.pixelSize: 11
+            topPadding: 4
+        }
+
+        Repeater {
+            model: overlay.snapshot.histograms ? Object.keys(overlay.snapshot.histograms) : []
+            delegate: Text {
+                readonly property var row: overlay.snapshot.histograms[modelData]
+                text: (overlay.histogramLabels[modelData] || modelData) + " ×" + row.count + "  "
+                      + overlay.format(row.p50Ms) + " / " + overlay.format(row.p95Ms) + " / "
+                      + overlay.format(row.p99Ms) + " / " + overlay.format(row.maxMs)
+                color: "#D0FFFFFF"
+                font.pixelSize: 11
+                font.family: "monospace"
+            }
+        }
+
+        Text {
+            visible: overlay.snapshot.hitRates !== undefined
+            text: overlay.snapshot.hitRates
+                  ? "命中率  背景 " + overlay.percent(overlay.snapshot.hitRates.background)
+                    + "  缩略图 " + overlay.percent(overlay.snapshot.hitRates.thumbnail)
+                    + "  歌词索引 " + overlay.percent(overlay.snapshot.hitRates.lyricIndex)
+                  : ""
+            color: "#D0FFFFFF"
+            font.pixelSize: 11
+            topPadding: 4
+        }
+
+        Row {
+            spacing: 8
+            topPadding: 4
+            Button {
+                text: "导出 JSON"
+                onClicked: metrics.dumpJson()
+            }
+            Button {
+                text: "清零"
+                onClicked: metrics.reset()
+            }
+        }
+    }
+}
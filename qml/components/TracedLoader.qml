@@ -0,0 +1,38 @@
+import QtQuick
+
+// 按需加载并记录耗时的 Loader：wanted 变为 true（或调用 load()）时才编译、创建组件，
+// 编译与创建时间写入 PlayerBackend 的启动时间线。加载后保持存在，不随 wanted 卸载
+Loader {
+    id: loader
+
+    property string traceName: ""
+    property url componentSource: ""
+    property bool wanted: false
+
+    active: false
+
+    function load() {
+        if (loader.active) return
+
+        var started = Date.now()
+        if (componentSource.toString() !== "") {
+            var component = Qt.createComponent(componentSource)
+            if (component.status === Component.Error) {
+                console.warn("TracedLoader:", traceName, component.errorString())
+                return
+            }
+            loader.sourceComponent = component
+        }
+        var compiled = Date.now()
+        loader.active = true
+        playerBackend.traceComponent(traceName, compiled - started, Date.now() - compiled)
+    }
+
+    onWantedChanged: {
+        if (wanted) load()
+    }
+
+    Component.onCompleted: {
+        if (wanted) load()
+    }
+}
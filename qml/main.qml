@@ -4,6 +4,8 @@ import QtQuick.Controls
 import QtQuick.Layouts
 import QtQuick.Dialogs
 import QtQuick.Effects
+import QtQml
+import App 1.0
 import "components"
 
 ApplicationWindow {
@@ -20,6 +22,14 @@ ApplicationWindow {
     // 窗口透明度
     color: "transparent"
 
+    // 预取下一首的封面：异步解码进图片缓存，切歌时卡片上的封面直接命中缓存
+    Image {
+        visible: false
+        asynchronous: true
+        cache: true
+        source: playerBackend.nextCover
+    }
+
     // 背景图片组件 - 支持静态图片和GIF动图
     Loader {
         id: backgroundLoader
@@ -30,7 +40,7 @@ ApplicationWindow {
         sourceComponent: {
             if (!playerBackend.backgroundImage) return null
             var filePath = playerBackend.backgroundImage.toLowerCase()
-            if (filePath.endsWith('.gif')) {
+            if (filePath.endsWith('.gif') || filePath.endsWith('.webp')) {
                 return animatedBackgroundComponent
             } else {
                 return staticBackgroundComponent
@@ -42,8 +52,12 @@ ApplicationWindow {
             id: staticBackgroundComponent
             Image {
                 anchors.fill: parent
-                source: "file:///" + playerBackend.backgroundImage
+                // 优先使用后台预缩放到屏幕尺寸的缓存图片，处理完成前先异步加载原图
+                source: "file:///" + playerBackend.backgroundDisplayImage
                 fillMode: Image.PreserveAspectCrop
+                asynchronous: true
+                sourceSize.width: Screen.width
+                sourceSize.height: Screen.height
                 opacity: root.isDocked ? 0.45 : 1.0
                 
                 // 添加暗色遮罩以确保UI可见性 - 使用纯中性黑避免色彩偏移
@@ -59,16 +73,15 @@ ApplicationWindow {
             }
         }
         
-        // GIF动图组件
+        // 动图组件（GIF/WebP）：后台按显示尺寸流式解码，停靠时降帧，隐藏时暂停
         Component {
             id: animatedBackgroundComponent
-            AnimatedImage {
+            AnimatedBackground {
                 anchors.fill: parent
-                source: "file:///" + playerBackend.backgroundImage
-                fillMode: AnimatedImage.PreserveAspectCrop
+                source: playerBackend.backgroundImage
                 opacity: root.isDocked ? 0.45 : 1.0
-                playing: true  // 自动播放
-                paused: false  // 不暂停
+                throttled: root.isDocked
+                paused: root.isHidden
                 
                 // 添加暗色遮罩以确保UI可见性 - 使用纯中性黑避免色彩偏移
                 Rectangle {
@@ -110,10 +123,6 @@ ApplicationWindow {
     property int dockedWidth: 120
     property int normalWidth: Screen.width
 
-    // 批量删除功能属性
-    property bool batchDeleteMode: false
-    property var selectedImages: []
-
     // 搜索功能属性
     property bool searchMode: false
     property string searchText: ""
@@ -135,6 +144,7 @@ ApplicationWindow {
         onTriggered: {
             // 使用全局鼠标位置判断是否真正离开窗口
             if (root.isDocked && !root.isHidden) {
+                playerBackend.updateGlobalMousePosition()
                 var globalX = playerBackend.globalMouseX
                 var globalY = playerBackend.globalMouseY
                 var windowX = root.x
@@ -156,6 +166,7 @@ ApplicationWindow {
         repeat: false
         onTriggered: {
             if (root.isDocked && !root.isHidden) {
+                playerBackend.updateGlobalMousePosition()
                 var globalX = playerBackend.globalMouseX
                 var globalY = playerBackend.globalMouseY
                 var windowX = root.x
@@ -171,43 +182,19 @@ ApplicationWindow {
         }
     }
 
-    // 边缘检测延迟定时器 - 鼠标在边缘停留0.3秒后才呼出
-    Timer {
-        id: edgeDelayTimer
-        interval: 300  // 0.3秒延迟
-        repeat: false
-        onTriggered: {
-            // 确保鼠标仍在边缘区域才呼出
-            if (playerBackend.globalMouseX >= Screen.width - 6) {
-                showDockFromEdge()
-            }
-        }
+    // 边缘热区（C++ 中由窗口系统事件驱动，停留 0.3 秒与进出滞回已在内部处理）
+    // 仅在窗口完全隐藏时启用，鼠标在屏幕右侧边缘停留后唤出收纳窗口
+    Binding {
+        target: edgeHotZone
+        property: "armed"
+        value: root.isHidden
     }
 
-    // 边缘检测定时器 - 检测鼠标在屏幕右侧（当窗口处于完全隐藏状态时唤出） 
-    Timer {
-        id: edgeCheckTimer
-        interval: 40  // 更灵敏：每40ms检查一次
-        running: true
-        repeat: true
-        onTriggered: {
-            // 更新全局鼠标位置
-            playerBackend.updateGlobalMousePosition()
-
+    Connections {
+        target: edgeHotZone
+        function onEdgeEntered() {
             if (root.isHidden) {
-                // 使用PlayerBackend的全局鼠标位置
-                if (playerBackend.globalMouseX >= Screen.width - 6) {  // 6像素的边缘区域
-                    // 启动延迟定时器，而不是立即呼出
-                    if (!edgeDelayTimer.running) {
-                        edgeDelayTimer.start()
-                    }
-                } else {
-                    // 鼠标离开边缘区域，取消延迟定时器
-                    edgeDelayTimer.stop()
-                }
-            } else {
-                // 窗口可见时，确保延迟定时器停止
-                edgeDelayTimer.stop()
+                showDockFromEdge()
             }
         }
     }
@@ -221,6 +208,7 @@ ApplicationWindow {
             // 延迟检查：使用全局鼠标位置判断是否真正离开窗口
             if (root.isDocked && !root.isHidden) {
                 // 检查全局鼠标位置是否在窗口区域内
+                playerBackend.updateGlobalMousePosition()
                 var globalX = playerBackend.globalMouseX
                 var globalY = playerBackend.globalMouseY
                 var windowX = root.x
@@ -284,6 +272,21 @@ ApplicationWindow {
             }
         }
         
+        function onActivationRequested() {
+            // 其它实例转来文件或命令：从隐藏状态唤出并置前
+            if (root.isHidden) {
+                showWindow()
+            }
+            root.raise()
+            root.requestActivate()
+        }
+
+        function onToggleMetricsOverlay() {
+            // Ctrl+Shift+M：第一次显示时才创建指标浮层
+            metricsOverlayLoader.load()
+            metricsOverlayLoader.item.visible = !metricsOverlayLoader.item.visible
+        }
+
         function onToggleSearchMode() {
             // 处理Ctrl+F快捷键，切换搜索模式
             root.searchMode = !root.searchMode
@@ -332,17 +335,17 @@ ApplicationWindow {
             if (event.key === Qt.Key_Escape) {
                 console.log("ESC key pressed in QML")
                 console.log("mainContextMenu.visible:", mainContextMenu.visible)
-                console.log("backgroundManagerDialog.visible:", backgroundManagerDialog.visible)
+                console.log("backgroundManagerDialog.visible:", isBackgroundManagerOpen())
                 
-                var hasOpenDialogs = mainContextMenu.visible || backgroundManagerDialog.visible
+                var hasOpenDialogs = mainContextMenu.visible || isBackgroundManagerOpen()
                 
                 // 优先关闭所有打开的对话框和菜单
                 if (mainContextMenu.visible) {
             mainContextMenu.close()
                     console.log("Closed context menu")
                 }
-                if (backgroundManagerDialog.visible) {
-                    backgroundManagerDialog.close()
+                if (isBackgroundManagerOpen()) {
+                    backgroundManagerLoader.item.close()
                     console.log("Closed background manager dialog")
                 }
                 
@@ -669,185 +672,201 @@ ApplicationWindow {
         x: playlistTitleRow.x + playlistTitleRow.width + 60 
         y: playlistTitleRow.y + 87   
         
-        // 玻璃拟态背景层（不引用自身，避免循环崩溃）
-        Rectangle {
-            anchors.fill: parent
-            radius: 18
-            color: "#1AFFFFFF"
-        }
-        
-        // 模糊层（使用父级作为源，不会循环）
-        MultiEffect {
-            anchors.fill: parent
-            source: backgroundLayer   // <<< 🔥 关键：引用整个背景，不引用自己
-            blurEnabled: true
-            blur: 36
-            blurMax: 64
-            brightness: 0.1
-            saturation: 1.2
-        }
-        
-        // 阻止点击事件冒泡到背景层，但优先处理窗口隐藏功能
-        MouseArea {
+        // 搜索框内容在第一次进入搜索模式时才创建
+        TracedLoader {
+            id: searchBoxLoader
             anchors.fill: parent
-            onClicked: function(mouse) {
-                // 计算点击位置相对于窗口的全局坐标
-                var globalClickX = root.x + searchBox.x + mouse.x
-                
-                // 如果点击位置在窗口右侧120px区域内，不拦截事件，让主窗口处理隐藏功能
-                if (globalClickX >= root.x + root.width - 120) {
-                    console.log("Search box clicked in right 120px area - allowing event to propagate")
-                    mouse.accepted = false  // 不接受事件，让其传播到主窗口
-                    return
-                }
-                
-                // 其他情况正常拦截事件
-                mouse.accepted = true
-            }
-        }
-        
-        Behavior on opacity {
-            NumberAnimation { duration: 240; easing.type: Easing.OutCubic }
-        }
-        
-        Behavior on visible {
-            PropertyAnimation { duration: 240 }
-        }
-        
-        // 左侧图标
-        Image {
-            anchors.left: parent.left
-            anchors.leftMargin: 12
-            anchors.verticalCenter: parent.verticalCenter
-            width: 16
-            height: 16
-            source: "qrc:/qml/icons/search_white.svg"
-            fillMode: Image.PreserveAspectFit
-            smooth: true
-            antialiasing: true
-            opacity: 0.9
-        }
-        
-        // 搜索输入框
-        TextInput {
-            id: searchInput
-            anchors.left: parent.left
-            anchors.leftMargin: 34
-            anchors.right: parent.right
-            anchors.rightMargin: 12
-            anchors.verticalCenter: parent.verticalCenter
-            
-            color: "#ffffff"
-            font.pixelSize: 14
-            font.family: "Segoe UI, sans-serif"
-            selectionColor: "#4a9eff60"
-            
-            // 占位符文本
-            Text {
-                text: "搜索..."
-                visible: !searchInput.text && !searchInput.activeFocus
-                anchors.verticalCenter: parent.verticalCenter
-                anchors.left: parent.left
-                anchors.leftMargin: 2
-                color: "#cfeafd88"
-                font.pixelSize: 14
-            }
-            
-            // 处理键盘事件，让快捷键传递给主窗口
-            Keys.onPressed: function(event) {
-                if (event.key === Qt.Key_Space) {
-                    // 空格键播放/暂停
-                    playerBackend.togglePlay()
-                    console.log("Space key pressed in search - toggle play/pause")
-                    event.accepted = true
-                } else if (event.key === Qt.Key_Z && (event.modifiers & Qt.ControlModifier)) {
-                    // Ctrl+Z 上一首
-                    playerBackend.previous()
-                    console.log("Ctrl+Z pressed in search - previous track")
-                    event.accepted = true
-                } else if (event.key === Qt.Key_X && (event.modifiers & Qt.ControlModifier)) {
-                    // Ctrl+X 下一首
-                    playerBackend.next()
-                    console.log("Ctrl+X pressed in search - next track")
-                    event.accepted = true
-                } else if (event.key === Qt.Key_F && (event.modifiers & Qt.ControlModifier)) {
-                    // Ctrl+F 切换搜索模式
-                    root.searchMode = !root.searchMode
-                    if (root.searchMode) {
-                        console.log("Ctrl+F pressed in search - search mode enabled")
-                    } else {
-                        console.log("Ctrl+F pressed in search - search mode disabled")
-                    }
-                    event.accepted = true
-                } else if (event.key === Qt.Key_Escape) {
-                    // ESC键关闭搜索
-                    root.searchMode = false
-                    console.log("ESC pressed in search - close search")
-                    event.accepted = true
-                } else if (event.key === Qt.Key_Down) {
-                    // ↓键移动焦点到播放列表
-                    if (playlistView.count > 0) {
-                        playlistView.forceActiveFocus()
-                        playlistView.currentIndex = 0
-                        console.log("Down key pressed - moving focus to playlist, selected index 0")
+            traceName: "SearchBox"
+            wanted: root.searchMode
+            sourceComponent: Component {
+                Item {
+                    // 供歌单键盘导航把焦点移回输入框
+                    property alias input: searchInput
+
+                    // 玻璃拟态背景层（不引用自身，避免循环崩溃）
+                    Rectangle {
+                        anchors.fill: parent
+                        radius: 18
+                        color: "#1AFFFFFF"
                     }
-                    event.accepted = true
-                } else if (event.key === Qt.Key_Return || event.key === Qt.Key_Enter) {
-                    // Enter键播放第一个搜索结果
-                    if (playlistView.count > 0) {
-                        var playIndex = root.searchMode ? playlistView.model.get(0).originalIndex : 0
-                        playerBackend.playIndex(playIndex)
-                        console.log("Enter key pressed - playing first search result at index", playIndex)
+
+                    // 模糊层：直接贴预先模糊好的壁纸（与背景相同的铺满方式对齐到窗口坐标），不再逐帧运行模糊着色器
+                    Image {
+                        x: -searchBox.x
+                        y: -searchBox.y
+                        width: root.width
+                        height: root.height
+                        visible: playerBackend.backgroundBlurImage !== ""
+                        source: playerBackend.backgroundBlurImage !== "" ? "file:///" + playerBackend.backgroundBlurImage : ""
+                        fillMode: Image.PreserveAspectCrop
+                        asynchronous: true
+                        smooth: true
                     }
-                    event.accepted = true
-                }
-            }
-            
-            // 添加鼠标点击事件处理，优先处理窗口隐藏功能
-            MouseArea {
-                anchors.fill: parent
-                acceptedButtons: Qt.LeftButton
-                onClicked: function(mouse) {
-                    // 计算点击位置相对于窗口的全局坐标
-                    var globalClickX = root.x + searchBox.x + searchInput.x + mouse.x
-                    
-                    // 如果点击位置在窗口右侧120px区域内，触发窗口隐藏功能
-                    if (globalClickX >= root.x + root.width - 120) {
-                        console.log("Search input clicked in right 120px area - triggering window hide")
-                        if (!root.isDocked) {
-                            root.dockToRight()
+
+                    // 阻止点击事件冒泡到背景层，但优先处理窗口隐藏功能
+                    MouseArea {
+                        anchors.fill: parent
+                        onClicked: function(mouse) {
+                            // 计算点击位置相对于窗口的全局坐标
+                            var globalClickX = root.x + searchBox.x + mouse.x
+
+                            // 如果点击位置在窗口右侧120px区域内，不拦截事件，让主窗口处理隐藏功能
+                            if (globalClickX >= root.x + root.width - 120) {
+                                console.log("Search box clicked in right 120px area - allowing event to propagate")
+                                mouse.accepted = false  // 不接受事件，让其传播到主窗口
+                                return
+                            }
+
+                            // 其他情况正常拦截事件
+                            mouse.accepted = true
                         }
-                        return
                     }
-                    
-                    // 其他情况让输入框正常处理点击事件
-                    mouse.accepted = false
-                }
-            }
-            
-            // 实时搜索
-            onTextChanged: {
-                root.searchText = text
-                console.log("Search text changed:", text)
-            }
-            
-            // 获得焦点
-            Component.onCompleted: {
-                if (root.searchMode) {
-                    forceActiveFocus()
-                }
-            }
-            
-            // 监听搜索模式变化
-            Connections {
-                target: root
-                function onSearchModeChanged() {
-                    if (root.searchMode) {
-                        searchInput.forceActiveFocus()
-                        searchInput.selectAll()
-                    } else {
-                        searchInput.text = ""
-                        root.searchText = ""
+
+                    Behavior on opacity {
+                        NumberAnimation { duration: 240; easing.type: Easing.OutCubic }
+                    }
+
+                    Behavior on visible {
+                        PropertyAnimation { duration: 240 }
+                    }
+
+                    // 左侧图标
+                    Image {
+                        anchors.left: parent.left
+                        anchors.leftMargin: 12
+                        anchors.verticalCenter: parent.verticalCenter
+                        width: 16
+                        height: 16
+                        source: "qrc:/qml/icons/search_white.svg"
+                        fillMode: Image.PreserveAspectFit
+                        smooth: true
+                        antialiasing: true
+                        opacity: 0.9
+                    }
+
+                    // 搜索输入框
+                    TextInput {
+                        id: searchInput
+                        anchors.left: parent.left
+                        anchors.leftMargin: 34
+                        anchors.right: parent.right
+                        anchors.rightMargin: 12
+                        anchors.verticalCenter: parent.verticalCenter
+
+                        color: "#ffffff"
+                        font.pixelSize: 14
+                        font.family: "Segoe UI, sans-serif"
+                        selectionColor: "#4a9eff60"
+
+                        // 占位符文本
+                        Text {
+                            text: "搜索..."
+                            visible: !searchInput.text && !searchInput.activeFocus
+                            anchors.verticalCenter: parent.verticalCenter
+                            anchors.left: parent.left
+                            anchors.leftMargin: 2
+                            color: "#cfeafd88"
+                            font.pixelSize: 14
+                        }
+
+                        // 处理键盘事件，让快捷键传递给主窗口
+                        Keys.onPressed: function(event) {
+                            if (event.key === Qt.Key_Space) {
+                                // 空格键播放/暂停
+                                playerBackend.togglePlay()
+                                console.log("Space key pressed in search - toggle play/pause")
+                                event.accepted = true
+                            } else if (event.key === Qt.Key_Z && (event.modifiers & Qt.ControlModifier)) {
+                                // Ctrl+Z 上一首
+                                playerBackend.previous()
+                                console.log("Ctrl+Z pressed in search - previous track")
+                                event.accepted = true
+                            } else if (event.key === Qt.Key_X && (event.modifiers & Qt.ControlModifier)) {
+                                // Ctrl+X 下一首
+                                playerBackend.next()
+                                console.log("Ctrl+X pressed in search - next track")
+                                event.accepted = true
+                            } else if (event.key === Qt.Key_F && (event.modifiers & Qt.ControlModifier)) {
+                                // Ctrl+F 切换搜索模式
+                                root.searchMode = !root.searchMode
+                                if (root.searchMode) {
+                                    console.log("Ctrl+F pressed in search - search mode enabled")
+                                } else {
+                                    console.log("Ctrl+F pressed in search - search mode disabled")
+                                }
+                                event.accepted = true
+                            } else if (event.key === Qt.Key_Escape) {
+                                // ESC键关闭搜索
+                                root.searchMode = false
+                                console.log("ESC pressed in search - close search")
+                                event.accepted = true
+                            } else if (event.key === Qt.Key_Down) {
+                                // ↓键移动焦点到播放列表
+                                if (playlistView.count > 0) {
+                                    playlistView.forceActiveFocus()
+                                    playlistView.currentIndex = 0
+                                    console.log("Down key pressed - moving focus to playlist, selected index 0")
+                                }
+                                event.accepted = true
+                            } else if (event.key === Qt.Key_Return || event.key === Qt.Key_Enter) {
+                                // Enter键播放第一个搜索结果
+                                if (playlistView.count > 0) {
+                                    var playIndex = root.searchMode ? playlistView.model.get(0).originalIndex : 0
+                                    playerBackend.playIndex(playIndex)
+                                    console.log("Enter key pressed - playing first search result at index", playIndex)
+                                }
+                                event.accepted = true
+                            }
+                        }
+
+                        // 添加鼠标点击事件处理，优先处理窗口隐藏功能
+                        MouseArea {
+                            anchors.fill: parent
+                            acceptedButtons: Qt.LeftButton
+                            onClicked: function(mouse) {
+                                // 计算点击位置相对于窗口的全局坐标
+                                var globalClickX = root.x + searchBox.x + searchInput.x + mouse.x
+
+                                // 如果点击位置在窗口右侧120px区域内，触发窗口隐藏功能
+                                if (globalClickX >= root.x + root.width - 120) {
+                                    console.log("Search input clicked in right 120px area - triggering window hide")
+                                    if (!root.isDocked) {
+                                        root.dockToRight()
+                                    }
+                                    return
+                                }
+
+                                // 其他情况让输入框正常处理点击事件
+                                mouse.accepted = false
+                            }
+                        }
+
+                        // 实时搜索
+                        onTextChanged: {
+                            root.searchText = text
+                            console.log("Search text changed:", text)
+                        }
+
+                        // 获得焦点
+                        Component.onCompleted: {
+                            if (root.searchMode) {
+                                forceActiveFocus()
+                            }
+                        }
+
+                        // 监听搜索模式变化
+                        Connections {
+                            target: root
+                            function onSearchModeChanged() {
+                                if (root.searchMode) {
+                                    searchInput.forceActiveFocus()
+                                    searchInput.selectAll()
+                                } else {
+                                    searchInput.text = ""
+                                    root.searchText = ""
+                                }
+                            }
+                        }
                     }
                 }
             }
@@ -999,7 +1018,7 @@ ApplicationWindow {
                                         console.log("Up key pressed - selected index", currentIndex)
                                     } else if (currentIndex === 0 && count > 0) {
                                         // 如果已经在第一个项目，移动焦点回搜索框
-                                        searchInput.forceActiveFocus()
+                                        if (searchBoxLoader.item) searchBoxLoader.item.input.forceActiveFocus()
                                         console.log("Up key pressed at first item - moving focus back to search")
                                     }
                                     event.accepted = true
@@ -1063,7 +1082,9 @@ ApplicationWindow {
                                             "album": albumData || "", 
                                             "duration": durationData || 0, 
                                             "path": pathData || "", 
-                                            "originalIndex": i 
+                                            "originalIndex": i,
+                                            "lyricLine": "",
+                                            "lyricTime": -1
                                         })
                                     }
                                     console.log("filter: full list contains", filteredListModel.count, "items")
@@ -1091,10 +1112,29 @@ ApplicationWindow {
                                             "album": albumData || "", 
                                             "duration": durationData || 0, 
                                             "path": pathData || "", 
-                                            "originalIndex": i 
+                                            "originalIndex": i,
+                                            "lyricLine": "",
+                                            "lyricTime": -1
                                         })
                                     }
                                 }
+
+                                // 歌词全文检索：追加命中的歌词行，点击可直接跳转到该行
+                                var lyricHits = playerBackend.searchLyrics(search, 50)
+                                for (var h = 0; h < lyricHits.length; h++) {
+                                    var hit = lyricHits[h]
+                                    filteredListModel.append({
+                                        "title": hit.title || "",
+                                        "artist": hit.artist || "",
+                                        "name": hit.title || "",
+                                        "album": "",
+                                        "duration": 0,
+                                        "path": "",
+                                        "originalIndex": hit.index,
+                                        "lyricLine": hit.line || "",
+                                        "lyricTime": hit.time
+                                    })
+                                }
                                 console.log("filter: found", filteredListModel.count, "items")
                             }
                             
@@ -1118,7 +1158,9 @@ ApplicationWindow {
                                 property string itemArtist: model.artist || "Unknown Artist"
                                 property string itemAlbum: model.album || ""
                                 property int itemDuration: model.duration || 0
-                                property int itemOriginalIndex: root.searchMode ? (model.originalIndex || -1) : index
+                                property int itemOriginalIndex: root.searchMode ? (model.originalIndex || 0) : index
+                                property string itemLyricLine: root.searchMode ? (model.lyricLine || "") : ""
+                                property real itemLyricTime: root.searchMode && model.lyricTime !== undefined ? model.lyricTime : -1
                                 property bool isCurrentItem: ListView.isCurrentItem
                                 
                                 // 函数：生成高亮文本
@@ -1144,9 +1186,20 @@ ApplicationWindow {
                                 
                                 MouseArea {
                                     anchors.fill: parent
-                                    onClicked: {
+                                    acceptedButtons: Qt.LeftButton | Qt.RightButton
+                                    onClicked: function(mouse) {
                                         var playIndex = root.searchMode ? itemOriginalIndex : index
-                                        playerBackend.playIndex(playIndex)
+                                        if (mouse.button === Qt.RightButton) {
+                                            // 右键：下一首播放 / 加入播放队列
+                                            trackContextMenu.trackIndex = playIndex
+                                            trackContextMenu.popup()
+                                            return
+                                        }
+                                        if (itemLyricLine !== "") {
+                                            playerBackend.playLyricHit(playIndex, itemLyricTime)
+                                        } else {
+                                            playerBackend.playIndex(playIndex)
+                                        }
                                         // 同步键盘导航位置到当前点击的项目
                                         playlistView.currentIndex = index
                                         playlistView.forceActiveFocus()
@@ -1259,7 +1312,8 @@ ApplicationWindow {
                                             textFormat: Text.RichText
                                         }
                                         Text {
-                                            text: highlightText(itemArtist, root.searchText);
+                                            text: itemLyricLine !== "" ? "♪ " + highlightText(itemLyricLine, root.searchText)
+                                                                       : highlightText(itemArtist, root.searchText);
                                             color: "#cfeffd";
                                             font.pixelSize: 12;
                                             opacity: 0.75;
@@ -1305,11 +1359,13 @@ ApplicationWindow {
                         }
 
                         // PlayerCard 加载（全屏模式）
-                        Loader {
+                        TracedLoader {
                             id: playerCardLoader
                             anchors.fill: parent
                             anchors.margins: 24
-                            source: "qrc:/qml/PlayerCard.qml"
+                            traceName: "PlayerCard"
+                            componentSource: "qrc:/qml/PlayerCard.qml"
+                            wanted: true
                             
                             // 平滑淡入动画
                             Behavior on opacity {
@@ -1354,12 +1410,14 @@ ApplicationWindow {
                             width: parent.width
                             height: parent.height
                             
-                            Loader {
+                            TracedLoader {
                                 id: visualizerLoader
                                 anchors.centerIn: parent
                                 width: parent.width * 0.8
                                 height: parent.height * 0.8
-                                source: "qrc:/qml/components/Visualizer.qml"
+                                traceName: "Visualizer"
+                                componentSource: "qrc:/qml/components/Visualizer.qml"
+                                wanted: true
                                 
                                 // 绑定频谱数据到 Visualizer
                                 onLoaded: {
@@ -1422,11 +1480,13 @@ ApplicationWindow {
                 color: "transparent"
                 visible: root.isDocked
                 
-                // PlayerCardMini 加载（dock模式）
-                Loader {
+                // PlayerCardMini 加载（dock模式，第一次收纳时才创建）
+                TracedLoader {
                     id: playerCardMiniLoader
                     anchors.fill: parent
-                    source: "qrc:/qml/PlayerCardMini.qml"
+                    traceName: "PlayerCardMini"
+                    componentSource: "qrc:/qml/PlayerCardMini.qml"
+                    wanted: root.isDocked
                     
                     // 平滑淡入动画
                     Behavior on opacity {
@@ -1448,65 +1508,72 @@ ApplicationWindow {
         }
 
         // 音乐文件夹选择提示对话框
-        Dialog {
-            id: musicFolderPrompt
-            title: "欢迎使用音乐播放器"
-            width: 400
-            height: 200
-            modal: true
+        TracedLoader {
+            id: musicFolderPromptLoader
+            anchors.fill: parent
+            traceName: "MusicFolderPrompt"
+            sourceComponent: Component {
+                Dialog {
+                    id: musicFolderPrompt
+                    title: "欢迎使用音乐播放器"
+                    width: 400
+                    height: 200
+                    modal: true
             
-            Rectangle {
-                anchors.fill: parent
-                color: "#1a1a2e"
-                radius: 12
-                border.color: "#4a9eff33"
-                border.width: 1
+                    Rectangle {
+                        anchors.fill: parent
+                        color: "#1a1a2e"
+                        radius: 12
+                        border.color: "#4a9eff33"
+                        border.width: 1
                 
-                Column {
-                    anchors.centerIn: parent
-                    spacing: 20
+                        Column {
+                            anchors.centerIn: parent
+                            spacing: 20
                     
-                    Text {
-                        text: "🎵 欢迎使用音乐播放器！"
-                        font.pixelSize: 18
-                        font.bold: true
-                        color: "#ffffff"
-                        anchors.horizontalCenter: parent.horizontalCenter
-                    }
+                            Text {
+                                text: "🎵 欢迎使用音乐播放器！"
+                                font.pixelSize: 18
+                                font.bold: true
+                                color: "#ffffff"
+                                anchors.horizontalCenter: parent.horizontalCenter
+                            }
                     
-                    Text {
-                        text: "请选择您的音乐文件夹以开始播放"
-                        font.pixelSize: 14
-                        color: "#cccccc"
-                        anchors.horizontalCenter: parent.horizontalCenter
-                    }
+                            Text {
+                                text: "请选择您的音乐文件夹以开始播放"
+                                font.pixelSize: 14
+                                color: "#cccccc"
+                                anchors.horizontalCenter: parent.horizontalCenter
+                            }
                     
-                    Row {
-                        spacing: 15
-                        anchors.horizontalCenter: parent.horizontalCenter
+                            Row {
+                                spacing: 15
+                                anchors.horizontalCenter: parent.horizontalCenter
                         
-                        Button {
-                            text: "选择音乐文件夹"
-                            font.pixelSize: 14
-                            background: Rectangle {
-                                color: "#4a9eff"
-                                radius: 6
-                            }
-                            onClicked: {
-                                musicFolderPrompt.close()
-                                folderDialog.open()
-                            }
-                        }
+                                Button {
+                                    text: "选择音乐文件夹"
+                                    font.pixelSize: 14
+                                    background: Rectangle {
+                                        color: "#4a9eff"
+                                        radius: 6
+                                    }
+                                    onClicked: {
+                                        musicFolderPrompt.close()
+                                        openFolderDialog()
+                                    }
+                                }
                         
-                        Button {
-                            text: "稍后设置"
-                            font.pixelSize: 14
-                            background: Rectangle {
-                                color: "#666666"
-                                radius: 6
-                            }
-                            onClicked: {
-                                musicFolderPrompt.close()
+                                Button {
+                                    text: "稍后设置"
+                                    font.pixelSize: 14
+                                    background: Rectangle {
+                                        color: "#666666"
+                                        radius: 6
+                                    }
+                                    onClicked: {
+                                        musicFolderPrompt.close()
+                                    }
+                                }
                             }
                         }
                     }
@@ -1514,939 +1581,257 @@ ApplicationWindow {
             }
         }
 
-        FolderDialog {
-            id: folderDialog
-            title: "Select Music Folder"
-            onAccepted: {
-                playerBackend.importFolder(folderDialog.selectedFolder.toString().replace("file:///", ""))
+        TracedLoader {
+            id: folderDialogLoader
+            traceName: "FolderDialog"
+            sourceComponent: Component {
+                FolderDialog {
+                    id: folderDialog
+                    title: "Select Music Folder"
+                    onAccepted: {
+                        playerBackend.importFolder(folderDialog.selectedFolder.toString().replace("file:///", ""))
+                    }
+                }
             }
         }
 
         // 背景图片文件选择对话框
-        FileDialog {
-            id: backgroundImageDialog
-            title: "选择背景图片"
-            nameFilters: ["图片文件 (*.png *.jpg *.jpeg *.bmp *.gif)", "所有文件 (*.*)"]
-            onAccepted: {
-                var imagePath = selectedFile.toString().replace("file:///", "")
-                playerBackend.setBackgroundImage(imagePath)
+        TracedLoader {
+            id: backgroundImageDialogLoader
+            traceName: "BackgroundImageDialog"
+            sourceComponent: Component {
+                FileDialog {
+                    id: backgroundImageDialog
+                    title: "选择背景图片"
+                    nameFilters: ["图片文件 (*.png *.jpg *.jpeg *.bmp *.gif)", "所有文件 (*.*)"]
+                    onAccepted: {
+                        var imagePath = selectedFile.toString().replace("file:///", "")
+                        playerBackend.setBackgroundImage(imagePath)
+                    }
+                }
             }
         }
 
         // 批量添加背景图片对话框
-        FileDialog {
-            id: batchBackgroundImageDialog
-            title: "批量添加背景图片"
-            nameFilters: ["图片文件 (*.png *.jpg *.jpeg *.bmp *.gif)", "所有文件 (*.*)"]
-            fileMode: FileDialog.OpenFiles
-            onAccepted: {
-                var imagePaths = []
-                for (var i = 0; i < selectedFiles.length; i++) {
-                    var imagePath = selectedFiles[i].toString().replace("file:///", "")
-                    imagePaths.push(imagePath)
+        TracedLoader {
+            id: batchBackgroundImageDialogLoader
+            traceName: "BatchBackgroundImageDialog"
+            sourceComponent: Component {
+                FileDialog {
+                    id: batchBackgroundImageDialog
+                    title: "批量添加背景图片"
+                    nameFilters: ["图片文件 (*.png *.jpg *.jpeg *.bmp *.gif)", "所有文件 (*.*)"]
+                    fileMode: FileDialog.OpenFiles
+                    onAccepted: {
+                        var imagePaths = []
+                        for (var i = 0; i < selectedFiles.length; i++) {
+                            var imagePath = selectedFiles[i].toString().replace("file:///", "")
+                            imagePaths.push(imagePath)
+                        }
+                        playerBackend.addBackgroundImages(imagePaths)
+                    }
                 }
-                playerBackend.addBackgroundImages(imagePaths)
             }
         }
 
-        // 背景图片管理对话框
-        Dialog {
-            id: backgroundManagerDialog
-            width: 1000
-            height: 700
-            modal: true
-            closePolicy: Popup.CloseOnEscape | Popup.CloseOnPressOutside
-            visible: !root.isDocked && visible
-            
-            // 透明背景层，用于点击隐藏右键菜单和退出批量选择模式
-            MouseArea {
-                anchors.fill: parent
-                enabled: contextMenu.visible || batchDeleteMode
-                onClicked: {
-                    if (contextMenu.visible) {
-                        contextMenu.visible = false
-                    } else if (batchDeleteMode) {
-                        // 退出批量选择模式
-                        batchDeleteMode = false
-                        selectedImages = []
+        // 背景图片管理对话框（第一次打开时才创建）
+        TracedLoader {
+            id: backgroundManagerLoader
+            anchors.fill: parent
+            traceName: "BackgroundManagerDialog"
+            componentSource: "qrc:/qml/BackgroundManagerDialog.qml"
+            onLoaded: {
+                item.docked = Qt.binding(function() { return root.isDocked })
+                item.addImagesRequested.connect(openBatchBackgroundImageDialog)
+            }
+        }
+
+        // 歌单导入 / 导出对话框
+        TracedLoader {
+            id: playlistImportDialogLoader
+            traceName: "PlaylistImportDialog"
+            sourceComponent: Component {
+                FileDialog {
+                    title: "导入歌单"
+                    nameFilters: ["歌单文件 (*.m3u *.m3u8 *.pls)", "所有文件 (*.*)"]
+                    onAccepted: {
+                        playerBackend.importPlaylist(selectedFile.toString().replace("file:///", ""))
                     }
                 }
             }
-            
-            // 浅色科技风格背景
-            Rectangle {
-                anchors.fill: parent
-                color: "#f8fafc"
-                radius: 20
-                
-                // 柔和渐变边框
-                Rectangle {
-                    anchors.fill: parent
-                    anchors.margins: 2
-                    color: "transparent"
-                    radius: 18
-                    border.width: 2
-                    border.color: "#e2e8f0"
-                    
-                    // 柔和发光效果
-                    Rectangle {
-                        anchors.fill: parent
-                        anchors.margins: -4
-                        color: "transparent"
-                        radius: 22
-                        border.width: 1
-                        border.color: "#cbd5e144"
-                        
-                        // 外层光晕
-                        Rectangle {
-                            anchors.fill: parent
-                            anchors.margins: -6
-                            color: "transparent"
-                            radius: 26
-                            border.width: 1
-                            border.color: "#94a3b822"
-                        }
+        }
+
+        TracedLoader {
+            id: playlistExportDialogLoader
+            traceName: "PlaylistExportDialog"
+            sourceComponent: Component {
+                FileDialog {
+                    title: "导出当前列表"
+                    fileMode: FileDialog.SaveFile
+                    defaultSuffix: "m3u8"
+                    nameFilters: ["M3U8 歌单 (*.m3u8)", "PLS 歌单 (*.pls)"]
+                    onAccepted: {
+                        playerBackend.exportPlaylist(selectedFile.toString().replace("file:///", ""))
                     }
                 }
-                
-                // 简约网格背景纹理
-                Rectangle {
-                    anchors.fill: parent
-                    anchors.margins: 4
-                    color: "transparent"
-                    clip: true
-                    
-                    // 简洁的网格背景
-                    Canvas {
-                        id: lightGridPattern
+            }
+        }
+
+        // 新建 / 编辑智能歌单
+        TracedLoader {
+            id: smartPlaylistDialogLoader
+            anchors.fill: parent
+            traceName: "SmartPlaylistDialog"
+            sourceComponent: Component {
+                Dialog {
+                    id: smartPlaylistDialog
+                    title: "智能歌单"
+                    width: 460
+                    height: 260
+                    anchors.centerIn: parent
+                    modal: true
+
+                    property alias playlistName: smartNameField.text
+                    property alias query: smartQueryField.text
+
+                    Column {
                         anchors.fill: parent
-                        
-                        property int cellSize: 24
-                        property real lineWidth: 0.3
-                        property color lineColor: "#e2e8f033"
-                        
-                        onPaint: {
-                            var ctx = getContext("2d")
-                            ctx.clearRect(0, 0, width, height)
-                            ctx.strokeStyle = lineColor
-                            ctx.lineWidth = lineWidth
-                            
-                            // 绘制垂直线
-                            for (var x = 0; x <= width; x += cellSize) {
-                                ctx.beginPath()
-                                ctx.moveTo(x, 0)
-                                ctx.lineTo(x, height)
-                                ctx.stroke()
-                            }
-                            
-                            // 绘制水平线
-                            for (var y = 0; y <= height; y += cellSize) {
-                                ctx.beginPath()
-                                ctx.moveTo(0, y)
-                                ctx.lineTo(width, y)
-                                ctx.stroke()
-                            }
-                        }
-                        
-                        onWidthChanged: requestPaint()
-                        onHeightChanged: requestPaint()
-                    }
-                }
-                
-                Column {
-                    anchors.fill: parent
-                    anchors.margins: 30
-                    spacing: 25
-                    
-                    // 简约科技风格标题栏
-                    Rectangle {
-                        width: parent.width
-                        height: 60
-                        color: "transparent"
-                        
-                        Row {
-                            anchors.fill: parent
-                            spacing: 20
-                            anchors.verticalCenter: parent.verticalCenter
-                            
-                            // 标题区域
-                            Column {
-                                spacing: 5
-                                
-                                Text {
-                                    text: "背景图片管理"
-                                    font.pixelSize: 24
-                                    font.bold: true
-                                    color: "#1e293b"
-                                    font.family: "Segoe UI"
-                                    
-                                    // 简洁文字效果
-                                    layer.enabled: true
-                                    layer.effect: MultiEffect {
-                                        colorization: 0.1
-                                        colorizationColor: "#64748b"
-                                        blur: 0.2
-                                        blurMax: 4
-                                    }
-                                }
-                                
-                                Rectangle {
-                                    width: 200
-                                    height: 3
-                                    color: "#cff3f3ff"
-                                    radius: 2
-                                    
-                                    // 柔和扫描线
-                                    Rectangle {
-                                        width: 40
-                                        height: 3
-                                        color: "#76e0e2ff"
-                                        radius: 2
-                                        
-                                        SequentialAnimation on x {
-                                            loops: Animation.Infinite
-                                            NumberAnimation { to: 160; duration: 2500; easing.type: Easing.InOutQuad }
-                                            NumberAnimation { to: 0; duration: 2500; easing.type: Easing.InOutQuad }
-                                        }
-                                    }
-                                }
-                            }
-                            
-                            // 状态指示器
-                            Rectangle {
-                                width: 220
-                                height: 45
-                                color: "#f1f5f9"
-                                radius: 22
-                                border.color: "#cbd5e1"
-                                border.width: 2
-                                
-                                Row {
-                                    anchors.centerIn: parent
-                                    spacing: 15
-                                    
-                                    Rectangle {
-                                        width: 12
-                                        height: 12
-                                        color: playerBackend.backgroundImageList.length > 0 ? "#10b981" : "#ef4444"
-                                        radius: 6
-                                        
-                                        // 柔和脉冲动画
-                                        SequentialAnimation on scale {
-                                            loops: Animation.Infinite
-                                            NumberAnimation { to: 1.2; duration: 1200 }
-                                            NumberAnimation { to: 1.0; duration: 1200 }
-                                        }
-                                    }
-                                    
-                                    Text {
-                                        text: playerBackend.currentBackgroundIndex >= 0 ? 
-                                              (playerBackend.currentBackgroundIndex + 1) + "/" + playerBackend.backgroundImageList.length : 
-                                              "无背景"
-                                        color: "#475569"
-                                        font.pixelSize: 14
-                                        font.bold: true
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    
-                    // 简约科技风格缩略图网格区域
-                    Rectangle {
-                        width: parent.width
-                        height: 380
-                        color: "#ffffff"
-                        radius: 16
-                        border.color: "#e2e8f0"
-                        border.width: 2
-                        clip: true
-                        
-                        // 内部柔和边框
-                        Rectangle {
-                            anchors.fill: parent
-                            anchors.margins: 3
-                            color: "transparent"
-                            radius: 13
-                            border.width: 1
-                            border.color: "#f1f5f9"
-                        }
-                        
-                        ScrollView {
-                            anchors.fill: parent
-                            anchors.margins: 20
-                            
-                            GridView {
-                                id: thumbnailGrid
-                                model: playerBackend.backgroundImageList
-                                cellWidth: 210  
-                                cellHeight: 158 
-                                
-                                delegate: Rectangle {
-                                    width: 210
-                                    height: 157
-                                    color: "transparent"
-                                    
-                                    // 简约科技风格卡片
-                                    Rectangle {
-                                        anchors.fill: parent
-                                        anchors.margins: 6 
-                                        color: index === playerBackend.currentBackgroundIndex ? "#f0f9ff" : "#ffffff"
-                                        radius: 12
-                                        border.color: index === playerBackend.currentBackgroundIndex ? "#0ea5e9" : "#e2e8f0"
-                                        border.width: index === playerBackend.currentBackgroundIndex ? 2 : 1
-                                        
-                                        // 柔和阴影效果
-                                        Rectangle {
-                                            anchors.fill: parent
-                                            anchors.margins: -2
-                                            color: "transparent"
-                                            radius: 14
-                                            border.width: 1
-                                            border.color: index === playerBackend.currentBackgroundIndex ? "#0ea5e922" : "transparent"
-                                            visible: index === playerBackend.currentBackgroundIndex
-                                        }
-                                        
-                                        Column {
-                                            anchors.fill: parent
-                                            anchors.margins: 8   
-                                            spacing: 14  
-                                            
-                                            // 缩略图容器
-                                            Rectangle {
-                                                width: 176  // 进一步缩小 (从185调整到176)
-                                                height: 99  // 进一步缩小 (从104调整到99)
-                                                color: "#f8fafc"
-                                                radius: 6
-                                                border.color: "#e2e8f0"
-                                                border.width: 1
-                                                anchors.horizontalCenter: parent.horizontalCenter
-                                                clip: true
-                                                
-                                                Image {
-                                                    anchors.fill: parent
-                                                    anchors.margins: 3
-                                                    source: "file:///" + modelData
-                                                    fillMode: Image.PreserveAspectCrop
-                                                    asynchronous: true
-                                                    cache: true
-                                                    
-                                                    // 优雅加载动画
-                                                    Rectangle {
-                                                        anchors.centerIn: parent
-                                                        width: 28
-                                                        height: 28
-                                                        color: "#e2e8f0"
-                                                        radius: 14
-                                                        visible: parent.status === Image.Loading
-                                                        
-                                                        // 旋转动画
-                                                        RotationAnimation on rotation {
-                                                            from: 0
-                                                            to: 360
-                                                            duration: 1800
-                                                            loops: Animation.Infinite
-                                                        }
-                                                        
-                                                        Text {
-                                                            anchors.centerIn: parent
-                                                            text: "⚡"
-                                                            color: "#94a3b8"
-                                                            font.pixelSize: 14
-                                                        }
-                                                    }
-                                                    
-                                                    // 错误状态
-                                                    Rectangle {
-                                                        anchors.fill: parent
-                                                        color: "#fef2f2"
-                                                        visible: parent.status === Image.Error
-                                                        
-                                                        Text {
-                                                            anchors.centerIn: parent
-                                                            text: "⚠️\n加载失败"
-                                                            color: "#ef4444"
-                                                            font.pixelSize: 12
-                                                            horizontalAlignment: Text.AlignHCenter
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                        
-                                        // 鼠标交互区域
-                                        MouseArea {
-                                            anchors.fill: parent
-                                            hoverEnabled: true
-                                            
-                                            onEntered: {
-                                                parent.scale = 1.03
-                                                parent.color = index === playerBackend.currentBackgroundIndex ? "#e0f2fe" : "#f8fafc"
-                                            }
-                                            
-                                            onExited: {
-                                                if (!contextMenu.visible) {
-                                                    parent.scale = 1.0
-                                                    parent.color = index === playerBackend.currentBackgroundIndex ? "#f0f9ff" : "#ffffff"
-                                                }
-                                            }
-                                            
-                                            onClicked: {
-                                                // 点击动画 - 使用parent作为动画目标
-                                                var clickAnim = Qt.createQmlObject('import QtQuick 2.15; SequentialAnimation { PropertyAnimation { target: parent; property: "scale"; to: 0.95; duration: 100 } PropertyAnimation { target: parent; property: "scale"; to: 1.0; duration: 100 } }', parent, "dynamicClickAnimation")
-                                                clickAnim.start()
-                                                clickAnim.destroy(1000)
-                                                
-                                                if (batchDeleteMode) {
-                                                    // 批量删除模式：使用图片路径作为唯一标识，避免索引随删除变化
-                                                    var key = modelData  // 使用图片路径作为唯一标识，避免索引随删除变化
-                                                    var selectedIndex = selectedImages.indexOf(key)
-                                                    if (selectedIndex === -1) {
-                                                        selectedImages = selectedImages.concat([key])
-                                                    } else {
-                                                        var newArr = selectedImages.slice()
-                                                        newArr.splice(selectedIndex, 1)
-                                                        selectedImages = newArr
-                                                    }
-                                                } else {
-                                                    // 普通模式：设置为背景
-                                                    playerBackend.setBackgroundByIndex(index)
-                                                }
-                                            }
-                                            
-                                            // 右键菜单
-                                            acceptedButtons: Qt.LeftButton | Qt.RightButton
-                                            
-                                            onPressed: function(mouse) {
-                                                if (mouse.button === Qt.RightButton) {
-                                                    // 设置右键菜单的目标图片信息
-                                                    contextMenu.targetImagePath = modelData
-                                                    contextMenu.targetImageIndex = index
-                                                    
-                                                    // 计算右键菜单位置（在鼠标附近，但确保不超出屏幕边界）
-                                                    var globalPos = mapToItem(backgroundImageManagerDialog.contentItem, mouse.x, mouse.y)
-                                                    var menuX = globalPos.x - 100 // 菜单宽度的一半，让菜单中心对齐鼠标
-                                                    var menuY = globalPos.y - 60 // 菜单显示在鼠标上方
-                                                    
-                                                    // 确保菜单不超出对话框边界
-                                                    if (menuX < 10) menuX = 10
-                                                    if (menuX + 200 > backgroundImageManagerDialog.width - 10) menuX = backgroundImageManagerDialog.width - 210
-                                                    if (menuY < 10) menuY = 10
-                                                    if (menuY + 75 > backgroundImageManagerDialog.height - 10) menuY = globalPos.y + 10 // 如果上方空间不够，显示在下方
-                                                    
-                                                    // 设置菜单位置并显示
-                                                    contextMenu.parent = backgroundImageManagerDialog.contentItem
-                                                    contextMenu.x = menuX
-                                                    contextMenu.y = menuY
-                                                    contextMenu.visible = true
-                                                    
-                                                    // 保持缩略图高亮状态
-                                                    parent.scale = 1.03
-                                                    parent.color = index === playerBackend.currentBackgroundIndex ? "#e0f2fe" : "#f8fafc"
-                                                }
-                                            }
-                                        }
-                                        
-                                        // 当前背景指示器
-                                        Rectangle {
-                                            width: 20
-                                            height: 20
-                                            color: "#0ea5e9"
-                                            radius: 10
-                                            anchors.top: parent.top
-                                            anchors.right: parent.right
-                                            anchors.margins: 8
-                                            visible: index === playerBackend.currentBackgroundIndex
-                                            
-                                            // 柔和发光效果
-                                            Rectangle {
-                                                anchors.fill: parent
-                                                anchors.margins: -2
-                                                color: "transparent"
-                                                radius: 12
-                                                border.width: 1
-                                                border.color: "#0ea5e944"
-                                            }
-                                            
-                                            Text {
-                                                anchors.centerIn: parent
-                                                text: "✓"
-                                                color: "#ffffff"
-                                                font.pixelSize: 12
-                                                font.bold: true
-                                            }
-                                            
-                                            // 柔和脉冲动画
-                                            SequentialAnimation on scale {
-                                                loops: Animation.Infinite
-                                                NumberAnimation { to: 1.15; duration: 1200 }
-                                                NumberAnimation { to: 1.0; duration: 1200 }
-                                            }
-                                        }
-                                        
-                                        // 批量选择指示器
-                                        Rectangle {
-                                            id: batchSelector
-                                            width: 24
-                                            height: 24
-                                            color: isItemSelected ? "#ef4444" : "#f1f5f9"
-                                            radius: 12
-                                            anchors.top: parent.top
-                                            anchors.left: parent.left
-                                            anchors.margins: 8
-                                            visible: batchDeleteMode
-                                            
-                                            property bool isItemSelected: selectedImages.indexOf(modelData) !== -1
-                                            
-                                            border.color: isItemSelected ? "#dc2626" : "#cbd5e1"
-                                            border.width: 2
-                                            
-                                            Text {
-                                                anchors.centerIn: parent
-                                                text: batchSelector.isItemSelected ? "✓" : ""
-                                                color: "#ffffff"
-                                                font.pixelSize: 12
-                                                font.bold: true
-                                            }
-                                            
-                                            // 选中状态动画
-                                            Behavior on color {
-                                                ColorAnimation { duration: 200 }
-                                            }
-                                            
-                                            Behavior on scale {
-                                                NumberAnimation { duration: 200; easing.type: Easing.OutBack }
-                                            }
-                                            
-                                            // 悬停效果
-                                            MouseArea {
-                                                anchors.fill: parent
-                                                hoverEnabled: true
-                                                onEntered: {
-                                                    if (!batchSelector.isItemSelected) {
-                                                        parent.scale = 1.1
-                                                        parent.color = "#e2e8f0"
-                                                    }
-                                                }
-                                                onExited: {
-                                                    if (!batchSelector.isItemSelected) {
-                                                        parent.scale = 1.0
-                                                        parent.color = "#f1f5f9"
-                                                    }
-                                                }
-                                            }
-                                        }
-                                        
-                                        Behavior on scale {
-                                            NumberAnimation { duration: 200; easing.type: Easing.OutBack }
-                                        }
-                                        
-                                        Behavior on color {
-                                            ColorAnimation { duration: 300 }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        Column {
-                            anchors.centerIn: parent
-                            visible: playerBackend.backgroundImageList.length === 0
-                            spacing: 20
-                            
-                            Rectangle {
-                                width: 80
-                                height: 80
-                                color: "#f1f5f9"
-                                radius: 40
-                                border.color: "#e2e8f0"
-                                border.width: 2
-                                anchors.horizontalCenter: parent.horizontalCenter
-                                
-                                Text {
-                                    anchors.centerIn: parent
-                                    text: "🖼️"
-                                    color: "#94a3b8"
-                                    font.pixelSize: 40
-                                    
-                                    // 柔和浮动动画
-                                    SequentialAnimation on y {
-                                        loops: Animation.Infinite
-                                        NumberAnimation { to: -5; duration: 2500; easing.type: Easing.InOutQuad }
-                                        NumberAnimation { to: 5; duration: 2500; easing.type: Easing.InOutQuad }
-                                    }
-                                }
-                                
-                                // 旋转光环
-                                Rectangle {
-                                    anchors.fill: parent
-                                    anchors.margins: -10
-                                    color: "transparent"
-                                    radius: 50
-                                    border.width: 1
-                                    border.color: "#e2e8f033"
-                                    
-                                    RotationAnimation on rotation {
-                                        from: 0
-                                        to: 360
-                                        duration: 12000
-                                        loops: Animation.Infinite
-                                    }
-                                }
-                            }
-                            
-                            Text {
-                                text: "还没有背景图片"
-                                color: "#475569"
-                                font.pixelSize: 18
-                                font.bold: true
-                                anchors.horizontalCenter: parent.horizontalCenter
-                            }
-                            
-                            Text {
-                                text: "点击下方按钮添加您喜欢的背景图片"
-                                color: "#94a3b8"
-                                font.pixelSize: 14
-                                anchors.horizontalCenter: parent.horizontalCenter
-                            }
-                        }
-                    }
-                    
-                    // 简约科技风格控制按钮区域
-                    Rectangle {
-                        width: parent.width
-                        height: 80
-                        color: "#f8fafc"
-                        radius: 16
-                        border.color: "#e2e8f0"
-                        border.width: 1
-                        
-                        // 内部柔和边框
-                        Rectangle {
-                            anchors.fill: parent
-                            anchors.margins: 2
-                            color: "transparent"
-                            radius: 14
-                            border.width: 1
-                            border.color: "#f1f5f9"
-                        }
-                        
-                        Row {
-                            anchors.horizontalCenter: parent.horizontalCenter
-                            anchors.verticalCenter: parent.verticalCenter
-                            anchors.margins: 20
-                            spacing: 15
-                            
-                            // 添加背景图片按钮
-                            Rectangle {
-                                width: 160
-                                height: 45
-                                color: "#ffffff"
-                                radius: 22
-                                border.color: "#0ea5e9"
-                                border.width: 2
-                                
-                                // 柔和阴影效果
-                                Rectangle {
-                                    anchors.fill: parent
-                                    anchors.margins: -3
-                                    color: "transparent"
-                                    radius: 25
-                                    border.width: 2
-                                    border.color: "#0ea5e922"
-                                }
-                                
-                                MouseArea {
-                                    anchors.fill: parent
-                                    hoverEnabled: true
-                                    
-                                    onEntered: {
-                                        parent.color = "#f0f9ff"
-                                        parent.scale = 1.03
-                                    }
-                                    
-                                    onExited: {
-                                        parent.color = "#ffffff"
-                                        parent.scale = 1.0
-                                    }
-                                    
-                                    onPressed: {
-                                        parent.scale = 0.97
-                                    }
-                                    
-                                    onReleased: {
-                                        parent.scale = 1.03
-                                    }
-                                    
-                                    onClicked: {
-                                        batchBackgroundImageDialog.open()
-                                    }
-                                }
-                                
-                                Row {
-                                    anchors.centerIn: parent
-                                    spacing: 15
-                                    
-                                    Text {
-                                        text: "添加背景"
-                                        color: "#0ea5e9"
-                                        font.pixelSize: 14
-                                        font.bold: true
-                                    }
-                                }
-                                
-                                Behavior on color {
-                                    ColorAnimation { duration: 200 }
-                                }
-                                
-                                Behavior on scale {
-                                    NumberAnimation { duration: 200; easing.type: Easing.OutBack }
-                                }
-                            }
-                            
-                            // 批量删除按钮
-                            Rectangle {
-                                width: 160
-                                height: 45
-                                color: batchDeleteMode ? "#fee2e2" : "#ffffff"
-                                radius: 22
-                                border.color: "#ef4444"
-                                border.width: 2
-                                
-                                // 移除外层黑色边框，只保留内层红色边框
-                                
-                                MouseArea {
-                                    anchors.fill: parent
-                                    hoverEnabled: true
-                                    
-                                    onEntered: {
-                                        parent.color = batchDeleteMode ? "#fecaca" : "#fef2f2"
-                                        parent.scale = 1.03
-                                    }
-                                    
-                                    onExited: {
-                                        parent.color = batchDeleteMode ? "#fee2e2" : "#ffffff"
-                                        parent.scale = 1.0
-                                    }
-                                    
-                                    onPressed: {
-                                        parent.scale = 0.97
-                                    }
-                                    
-                                    onReleased: {
-                                        parent.scale = 1.03
-                                    }
-                                    
-                                    onClicked: {
-                                            if (batchDeleteMode) {
-                                                // 执行批量删除
-                                                performBatchDelete()
-                                            } else {
-                                                // 进入批量选择模式：重新赋空数组以触发绑定
-                                                batchDeleteMode = true
-                                                selectedImages = []
-                                            }
-                                        }
-                                }
-                                
-                                Row {
-                                    anchors.centerIn: parent
-                                    spacing: 15
-                                    
-                                    Text {
-                                        text: batchDeleteMode ? "确认删除" : "批量删除"
-                                        color: "#ef4444"
-                                        font.pixelSize: 14
-                                        font.bold: true
-                                    }
-                                }
-                                
-                                Behavior on color {
-                                    ColorAnimation { duration: 200 }
-                                }
-                                
-                                Behavior on scale {
-                                    NumberAnimation { duration: 200; easing.type: Easing.OutBack }
-                                }
+                        spacing: 10
+
+                        TextField {
+                            id: smartNameField
+                            width: parent.width
+                            placeholderText: "名称"
+                        }
+
+                        TextField {
+                            id: smartQueryField
+                            width: parent.width
+                            placeholderText: "例如：artist contains \"周杰伦\" and duration > 5m"
+                            onTextChanged: smartErrorText.text = ""
+                        }
+
+                        Text {
+                            text: "字段：title artist album duration added played plays；added < 30d 表示 30 天内加入，plays = 0 表示从未播放"
+                            width: parent.width
+                            wrapMode: Text.WordWrap
+                            font.pixelSize: 12
+                            color: "#999999"
+                        }
+
+                        Text {
+                            id: smartErrorText
+                            width: parent.width
+                            wrapMode: Text.WordWrap
+                            font.pixelSize: 12
+                            color: "#ff6b6b"
+                        }
+
+                        Button {
+                            text: "保存并打开"
+                            anchors.right: parent.right
+                            onClicked: {
+                                var error = playerBackend.saveSmartPlaylist(smartNameField.text, smartQueryField.text)
+                                if (error !== "") {
+                                    smartErrorText.text = error
+                                    return
+                                }
+                                playerBackend.openSmartPlaylist(smartNameField.text.trim())
+                                smartPlaylistDialog.close()
                             }
                         }
                     }
                 }
             }
         }
-        
-        // 右键菜单 - 浅色调未来感设计
-        Rectangle {
-            id: contextMenu
-            width: 200
-            height: 75
-            visible: false
-            color: "#ffffff"
-            radius: 12
-            border.color: "#e2e8f0"
-            border.width: 1
+
+        // 运行时指标浮层（调试用，Ctrl+Shift+M 切换）
+        TracedLoader {
+            id: metricsOverlayLoader
+            anchors.left: parent.left
+            anchors.top: parent.top
+            anchors.margins: 16
             z: 1000
-            
-            property string targetImagePath: ""
-            property int targetImageIndex: -1
-            property real menuX: 0
-            property real menuY: 0
-            
-            // 柔和阴影效果
-            Rectangle {
-                anchors.fill: parent
-                anchors.margins: -2
-                color: "transparent"
-                radius: 14
-                border.width: 1
-                border.color: "#f1f5f9"
-            }
-            
-            // 悬浮阴影
-            MultiEffect {
-                anchors.fill: parent
-                source: contextMenu
-                shadowEnabled: true
-                shadowBlur: 0.8
-                shadowColor: "#10000000"
-                shadowVerticalOffset: 6
-                shadowHorizontalOffset: 0
-                visible: contextMenu.visible
-            }
-            
-            // 菜单标题
-            Rectangle {
-                id: menuHeader
-                anchors.top: parent.top
-                anchors.left: parent.left
-                anchors.right: parent.right
-                anchors.topMargin: 1
-                anchors.leftMargin: 1
-                anchors.rightMargin: 1
-                height: 35
-                color: "#f8fafc"
-                radius: 11
-                border.color: "#e2e8f0"
-                border.width: 1
-                
-                Text {
-                    text: "🖼️ 图片操作"
-                    color: "#475569"
-                    font.pixelSize: 13
-                    font.bold: true
-                    anchors.centerIn: parent
-                }
-            }
-            
-            // 菜单项容器
-            Column {
-                anchors.top: menuHeader.bottom
-                anchors.left: parent.left
-                anchors.right: parent.right
-                anchors.bottom: parent.bottom
-                anchors.margins: 8
-                spacing: 4
-                
-                // 设为背景按钮
-                Rectangle {
-                    width: parent.width
-                    height: 32
-                    color: "#ffffff"
-                    radius: 8
-                    border.color: "#e2e8f0"
-                    border.width: 1
-                    
-                    MouseArea {
-                        anchors.fill: parent
-                        hoverEnabled: true
-                        
-                        onEntered: {
-                            parent.color = "#f0f9ff"
-                            parent.border.color = "#0ea5e9"
-                        }
-                        
-                        onExited: {
-                            parent.color = "#ffffff"
-                            parent.border.color = "#e2e8f0"
-                        }
-                        
-                        onClicked: {
-                            playerBackend.setBackgroundByIndex(contextMenu.targetImageIndex)
-                            contextMenu.visible = false
-                        }
-                    }
-                    
-                    Row {
-                        anchors.centerIn: parent
-                        spacing: 8
-                        
-                        Text {
-                            text: "🎨"
-                            font.pixelSize: 14
-                            anchors.verticalCenter: parent.verticalCenter
-                        }
-                        
-                        Text {
-                            text: "设为背景"
-                            color: "#0ea5e9"
-                            font.pixelSize: 13
-                            font.bold: true
-                            anchors.verticalCenter: parent.verticalCenter
-                        }
-                    }
-                    
-                    Behavior on color {
-                        ColorAnimation { duration: 150 }
-                    }
-                    
-                    Behavior on border.color {
-                        ColorAnimation { duration: 150 }
-                    }
+            traceName: "MetricsOverlay"
+            sourceComponent: Component {
+                MetricsOverlay {
+                    visible: false
                 }
             }
-            
-            Behavior on visible {
-                NumberAnimation { duration: 200 }
-            }
-            
-            Behavior on opacity {
-                NumberAnimation { duration: 150 }
-            }
         }
         
 
     }
+    // 按需创建的对话框：第一次使用时才由对应的 TracedLoader 加载
+    function openMusicFolderPrompt() {
+        musicFolderPromptLoader.load()
+        musicFolderPromptLoader.item.open()
+    }
 
-    // 执行批量删除函数
-    function performBatchDelete() {
-        if (!selectedImages || selectedImages.length === 0) {
-            batchDeleteMode = false
-            return
-        }
-        
-        // 将选中的路径转换为当前 model 的索引（可能有未找到的项，忽略之）
-        var indicesToDelete = []
-        for (var i = 0; i < selectedImages.length; i++) {
-            var idx = playerBackend.backgroundImageList.indexOf(selectedImages[i])
-            if (idx !== -1) indicesToDelete.push(idx)
-        }
-        
-        // 从大到小删除以避免索引错位
-        indicesToDelete.sort(function(a,b){ return b - a })
-        
-        for (var j = 0; j < indicesToDelete.length; j++) {
-            playerBackend.removeBackgroundImageByIndex(indicesToDelete[j])
+    function openFolderDialog() {
+        folderDialogLoader.load()
+        folderDialogLoader.item.open()
+    }
+
+    function openPlaylistImportDialog() {
+        playlistImportDialogLoader.load()
+        playlistImportDialogLoader.item.open()
+    }
+
+    function openPlaylistExportDialog() {
+        playlistExportDialogLoader.load()
+        playlistExportDialogLoader.item.open()
+    }
+
+    function openSmartPlaylistDialog(name) {
+        smartPlaylistDialogLoader.load()
+        smartPlaylistDialogLoader.item.playlistName = name
+        smartPlaylistDialogLoader.item.query = name === "" ? "" : playerBackend.smartPlaylistQuery(name)
+        smartPlaylistDialogLoader.item.open()
+    }
+
+    function openBackgroundImageDialog() {
+        backgroundImageDialogLoader.load()
+        backgroundImageDialogLoader.item.open()
+    }
+
+    function openBatchBackgroundImageDialog() {
+        batchBackgroundImageDialogLoader.load()
+        batchBackgroundImageDialogLoader.item.open()
+    }
+
+    function openBackgroundManager() {
+        backgroundManagerLoader.load()
+        if (backgroundManagerLoader.item) {
+            backgroundManagerLoader.item.open()
         }
-        
-        // 清空并退出批量模式（重新赋空数组以触发绑定）
-        selectedImages = []
-        batchDeleteMode = false
+    }
+
+    function isBackgroundManagerOpen() {
+        return backgroundManagerLoader.item !== null && backgroundManagerLoader.item.visible
     }
 
     // 连接PlayerBackend的音乐文件夹需求信号
     Connections {
         target: playerBackend
         function onMusicFolderNeeded() {
-            musicFolderPrompt.open()
+            openMusicFolderPrompt()
+        }
+    }
+
+    // 歌单项的右键菜单
+    Menu {
+        id: trackContextMenu
+        property int trackIndex: -1
+
+        MenuItem {
+            text: "   下一首播放"
+            onTriggered: playerBackend.playNext(trackContextMenu.trackIndex)
+        }
+
+        MenuItem {
+            text: "   加入播放队列"
+            onTriggered: playerBackend.addToQueue(trackContextMenu.trackIndex)
         }
     }
 
@@ -2459,7 +1844,106 @@ ApplicationWindow {
             text: "📁 添加音乐文件夹..."
             visible: !root.isDocked || playerBackend.musicFolder === ""
             onTriggered: {
-                folderDialog.open()
+                openFolderDialog()
+            }
+        }
+
+        // 命名歌单：切换、导入与导出
+        Menu {
+            id: playlistMenu
+            title: "   歌单"
+            enabled: !root.isDocked
+
+            MenuItem {
+                text: (playerBackend.currentPlaylist === "" && playerBackend.currentSmartPlaylist === "" ? "✓ " : "   ") + "全部歌曲"
+                onTriggered: playerBackend.showLibrary()
+            }
+
+            Instantiator {
+                model: playerBackend.playlists
+                delegate: MenuItem {
+                    text: (playerBackend.currentPlaylist === modelData ? "✓ " : "   ") + modelData
+                    onTriggered: playerBackend.openPlaylist(modelData)
+                }
+                onObjectAdded: function(index, object) { playlistMenu.insertItem(index + 1, object) }
+                onObjectRemoved: function(index, object) { playlistMenu.removeItem(object) }
+            }
+
+            MenuSeparator {}
+
+            MenuItem {
+                text: "   导入歌单..."
+                onTriggered: openPlaylistImportDialog()
+            }
+
+            MenuItem {
+                text: "   导出当前列表..."
+                enabled: !playerBackend.playlistLoading
+                onTriggered: openPlaylistExportDialog()
+            }
+        }
+
+        // 智能歌单：按条件从曲库筛选
+        Menu {
+            id: smartPlaylistMenu
+            title: "   智能歌单"
+            enabled: !root.isDocked
+
+            Instantiator {
+                model: playerBackend.smartPlaylists
+                delegate: MenuItem {
+                    text: (playerBackend.currentSmartPlaylist === modelData ? "✓ " : "   ") + modelData
+                    onTriggered: playerBackend.openSmartPlaylist(modelData)
+                }
+                onObjectAdded: function(index, object) { smartPlaylistMenu.insertItem(index, object) }
+                onObjectRemoved: function(index, object) { smartPlaylistMenu.removeItem(object) }
+            }
+
+            MenuSeparator {}
+
+            MenuItem {
+                text: "   新建智能歌单..."
+                onTriggered: openSmartPlaylistDialog("")
+            }
+
+            MenuItem {
+                text: "   编辑当前智能歌单..."
+                enabled: playerBackend.currentSmartPlaylist !== ""
+                onTriggered: openSmartPlaylistDialog(playerBackend.currentSmartPlaylist)
+            }
+
+            MenuItem {
+                text: "   删除当前智能歌单"
+                enabled: playerBackend.currentSmartPlaylist !== ""
+                onTriggered: playerBackend.deleteSmartPlaylist(playerBackend.currentSmartPlaylist)
+            }
+        }
+
+        // 响度均衡：从下一首开始生效
+        Menu {
+            title: "   音量均衡"
+
+            MenuItem {
+                text: (playerBackend.loudnessMode === 0 ? "✓ " : "   ") + "关闭"
+                onTriggered: playerBackend.loudnessMode = 0
+            }
+
+            MenuItem {
+                text: (playerBackend.loudnessMode === 1 ? "✓ " : "   ") + "按曲目"
+                onTriggered: playerBackend.loudnessMode = 1
+            }
+
+            MenuItem {
+                text: (playerBackend.loudnessMode === 2 ? "✓ " : "   ") + "按专辑"
+                onTriggered: playerBackend.loudnessMode = 2
+            }
+
+            MenuSeparator {}
+
+            MenuItem {
+                text: (playerBackend.loudnessPreventClipping ? "✓ " : "   ") + "防止削波"
+                enabled: playerBackend.loudnessMode !== 0
+                onTriggered: playerBackend.loudnessPreventClipping = !playerBackend.loudnessPreventClipping
             }
         }
 
@@ -2471,7 +1955,7 @@ ApplicationWindow {
             text: "   设置背景图片..."
             visible: !root.isDocked
             onTriggered: {
-                backgroundImageDialog.open()
+                openBackgroundImageDialog()
             }
         }
 
@@ -2479,7 +1963,7 @@ ApplicationWindow {
             text: "   管理背景图片..."
             visible: !root.isDocked
             onTriggered: {
-                backgroundManagerDialog.open()
+                openBackgroundManager()
             }
         }
 
@@ -0,0 +1,344 @@
+#include "animatedbackground.h"
+#include "trace.h"
+#include <QElapsedTimer>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QQuickWindow>
+#include <QSGImageNode>
+#include <QDebug>
+#include <memory>
+
+static const int FRAME_RING = 3;            // 最多预先解码的帧数
+static const int MIN_FRAME_DELAY_MS = 20;   // 小于此值的帧延迟按浏览器惯例视为 100 ms
+static const int RESIZE_DEBOUNCE_MS = 150;
+
+// 解码线程上的工作对象：顺序读取动画帧，解码到显示尺寸后放入 AnimatedBackground 的就绪帧环
+class AnimatedFrameDecoder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AnimatedFrameDecoder(AnimatedBackground *owner) : m_owner(owner) {}
+
+public slots:
+    void start(const QString &path, const QSize &size, quint64 generation);
+    void setActive(bool active);
+    void fill();
+
+signals:
+    void frameDecoded(quint64 generation, double decodeMs);
+
+private:
+    bool openReader();
+    bool decodeOne();
+
+    AnimatedBackground *m_owner;
+    std::unique_ptr<QImageReader> m_reader;
+    QString m_path;
+    QSize m_size;
+    quint64 m_generation = 0;
+    bool m_active = false;
+    bool m_failed = false;
+    bool m_stillDone = false;   // 单帧图片解码一次即可
+};
+
+void AnimatedFrameDecoder::start(const QString &path, const QSize &size, quint64 generation)
+{
+    m_path = path;
+    m_size = size;
+    m_generation = generation;
+    m_failed = false;
+    m_stillDone = false;
+    m_reader.reset();
+    fill();
+}
+
+void AnimatedFrameDecoder::setActive(bool active)
+{
+    m_active = active;
+    if (active) fill();
+}
+
+bool AnimatedFrameDecoder::openReader()
+{
+    m_reader = std::make_unique<QImageReader>(m_path);
+    m_reader->setAutoTransform(true);
+
+    // 按“铺满并裁切”换算解码尺寸，内存中的帧只有显示尺寸大小
+    const QSize sourceSize = m_reader->size();
+    if (sourceSize.isValid() && !m_size.isEmpty()) {
+        const double scale = qMax(double(m_size.width()) / sourceSize.width(),
+                                  double(m_size.height()) / sourceSize.height());
+        if (scale < 1.0) m_reader->setScaledSize((QSizeF(sourceSize) * scale).toSize());
+    }
+    return m_reader->canRead();
+}
+
+bool AnimatedFrameDecoder::decodeOne()
+{
+    TRACE_SCOPE("AnimatedFrameDecoder::decodeOne");
+    QElapsedTimer timer;
+    timer.start();
+
+    // 读到结尾后重新打开，从第一帧循环播放
+    if (!m_reader || !m_reader->canRead()) {
+        if (!openReader()) {
+            qWarning() << "AnimatedBackground - 无法读取:" << m_path << m_reader->errorString();
+            m_failed = true;
+            return false;
+        }
+    }
+
+    QImage image = m_reader->read();
+    if (image.isNull()) {
+        m_reader.reset();
+        return false;
+    }
+    int delay = m_reader->nextImageDelay();
+    if (delay < MIN_FRAME_DELAY_MS) delay = 100;
+    if (!m_reader->supportsAnimation() || m_reader->imageCount() == 1) m_stillDone = true;
+
+    // 在解码线程上转换为纹理上传所需的格式
+    image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const double decodeMs = timer.nsecsElapsed() / 1e6;
+
+    {
+        QMutexLocker locker(&m_owner->m_mutex);
+        if (m_owner->m_generation != m_generation) return false;
+        m_owner->m_ready.push_back({ std::move(image), delay });
+    }
+    emit frameDecoded(m_generation, decodeMs);
+    return true;
+}
+
+void AnimatedFrameDecoder::fill()
+{
+    if (!m_active || m_failed || m_stillDone || m_path.isEmpty()) return;
+    for (int attempts = 0; attempts < FRAME_RING * 2; ++attempts) {
+        {
+            QMutexLocker locker(&m_owner->m_mutex);
+            if (m_owner->m_generation != m_generation || int(m_owner->m_ready.size()) >= FRAME_RING) return;
+        }
+        if ((!decodeOne() && m_failed) || m_stillDone) return;
+    }
+}
+
+AnimatedBackground::AnimatedBackground(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+
+    m_decoder = new AnimatedFrameDecoder(this);
+    m_decoder->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_decoder, &QObject::deleteLater);
+    connect(m_decoder, &AnimatedFrameDecoder::frameDecoded, this, &AnimatedBackground::onFrameDecoded);
+    m_thread.setObjectName("AnimatedBackground");
+    m_thread.start(QThread::LowPriority);
+
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &AnimatedBackground::showNextFrame);
+
+    m_restartTimer.setSingleShot(true);
+    m_restartTimer.setInterval(RESIZE_DEBOUNCE_MS);
+    connect(&m_restartTimer, &QTimer::timeout, this, &AnimatedBackground::restartDecoder);
+    connect(this, &QQuickItem::visibleChanged, this, &AnimatedBackground::updateActivity);
+}
+
+AnimatedBackground::~AnimatedBackground()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void AnimatedBackground::setSource(const QString &path)
+{
+    if (m_source == path) return;
+    m_source = path;
+    emit sourceChanged();
+    restartDecoder();
+}
+
+void AnimatedBackground::setPaused(bool paused)
+{
+    if (m_paused == paused) return;
+    m_paused = paused;
+    emit pausedChanged();
+    updateActivity();
+}
+
+void AnimatedBackground::setThrottled(bool throttled)
+{
+    if (m_throttled == throttled) return;
+    m_throttled = throttled;
+    emit throttledChanged();
+}
+
+void AnimatedBackground::setThrottledFps(int fps)
+{
+    fps = qBound(1, fps, 60);
+    if (m_throttledFps == fps) return;
+    m_throttledFps = fps;
+    emit throttledChanged();
+}
+
+qint64 AnimatedBackground::frameMemoryBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 bytes = m_current.sizeInBytes();
+    for (const Frame &frame : m_ready) bytes += frame.image.sizeInBytes();
+    return bytes;
+}
+
+bool AnimatedBackground::isActive() const
+{
+    return !m_paused && m_windowVisible && isVisible() && !m_source.isEmpty();
+}
+
+void AnimatedBackground::updateActivity()
+{
+    const bool active = isActive();
+    QMetaObject::invokeMethod(m_decoder, [d = m_decoder, active]() { d->setActive(active); }, Qt::QueuedConnection);
+    if (!active) {
+        m_frameTimer.stop();
+        m_waitingForFrame = false;
+    } else if (!m_frameTimer.isActive()) {
+        showNextFrame();
+    }
+}
+
+void AnimatedBackground::restartDecoder()
+{
+    const qreal dpr = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    const QSize size = (QSizeF(width(), height()) * dpr).toSize();
+
+    quint64 generation;
+    {
+        QMutexLocker locker(&m_mutex);
+        generation = ++m_generation;
+        m_ready.clear();
+    }
+    m_frameTimer.stop();
+    m_waitingForFrame = true;
+    if (m_source.isEmpty() || size.isEmpty()) {
+        m_current = QImage();
+        update();
+        return;
+    }
+
+    const QString path = m_source;
+    const bool active = isActive();
+    QMetaObject::invokeMethod(m_decoder, [d = m_decoder, path, size, generation, active]() {
+        d->setActive(active);
+        d->start(path, size, generation);
+    }, Qt::QueuedConnection);
+}
+
+void AnimatedBackground::onFrameDecoded(quint64 generation, double decodeMs)
+{
+    if (generation != m_generation) return;
+    m_lastDecodeMs = decodeMs;
+    m_averageDecodeMs = m_averageDecodeMs > 0.0 ? m_averageDecodeMs * 0.9 + decodeMs * 0.1 : decodeMs;
+    emit statsChanged();
+
+    if (m_waitingForFrame && isActive()) showNextFrame();
+}
+
+void AnimatedBackground::showNextFrame()
+{
+    if (!isActive()) return;
+
+    Frame frame;
+    int delay = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_ready.empty()) {
+            m_waitingForFrame = true;
+            return;
+        }
+        frame = std::move(m_ready.front());
+        m_ready.pop_front();
+        delay = frame.delayMs;
+
+        // 降帧：把间隔不足的帧合并跳过，保持动画的实际播放速度
+        const int minInterval = m_throttled ? 1000 / m_throttledFps : 0;
+        while (delay < minInterval && !m_ready.empty()) {
+            frame = std::move(m_ready.front());
+            m_ready.pop_front();
+            delay += frame.delayMs;
+        }
+        delay = qMax(delay, minInterval);
+    }
+
+    m_waitingForFrame = false;
+    m_current = std::move(frame.image);
+    m_textureDirty = true;
+    ++m_displayedFrames;
+    update();
+
+    m_frameTimer.start(delay);
+    QMetaObject::invokeMethod(m_decoder, &AnimatedFrameDecoder::fill, Qt::QueuedConnection);
+}
+
+QSGNode *AnimatedBackground::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    auto *node = static_cast<QSGImageNode *>(oldNode);
+    if (m_current.isNull() || width() <= 0 || height() <= 0) {
+        delete node;
+        return nullptr;
+    }
+
+    if (!node) {
+        node = window()->createImageNode();
+        node->setOwnsTexture(true);
+        node->setFiltering(QSGTexture::Linear);
+        m_textureDirty = true;
+    }
+    if (m_textureDirty) {
+        node->setTexture(window()->createTextureFromImage(m_current));
+        m_textureDirty = false;
+    }
+
+    // PreserveAspectCrop：取图片中心与控件宽高比一致的区域
+    const QSizeF imageSize = m_current.size();
+    const double itemAspect = width() / height();
+    QRectF source(QPointF(0, 0), imageSize);
+    if (imageSize.width() / imageSize.height() > itemAspect) {
+        source.setWidth(imageSize.height() * itemAspect);
+        source.moveLeft((imageSize.width() - source.width()) / 2);
+    } else {
+        source.setHeight(imageSize.width() / itemAspect);
+        source.moveTop((imageSize.height() - source.height()) / 2);
+    }
+    node->setSourceRect(source);
+    node->setRect(boundingRect());
+    return node;
+}
+
+void AnimatedBackground::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        if (m_current.isNull()) restartDecoder();
+        else m_restartTimer.start();
+    }
+}
+
+void AnimatedBackground::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+    if (change != ItemSceneChange) return;
+    // 离开或换到另一个窗口：不再跟随原窗口的可见性
+    disconnect(m_visibilityConnection);
+    if (value.window) {
+        // 窗口隐藏或最小化时暂停解码
+        QQuickWindow *win = value.window;
+        m_visibilityConnection = connect(win, &QWindow::visibilityChanged, this, [this](QWindow::Visibility visibility) {
+            m_windowVisible = visibility != QWindow::Hidden && visibility != QWindow::Minimized;
+            updateActivity();
+        });
+        m_windowVisible = win->isVisible();
+        restartDecoder();
+    }
+}
+
+#include "animatedbackground.moc"
@@ -0,0 +1,100 @@
+#ifndef ANIMATEDBACKGROUND_H
+#define ANIMATEDBACKGROUND_H
+
+#include <QQuickItem>
+#include <QImage>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+#include <deque>
+
+class AnimatedFrameDecoder;
+
+// 动态壁纸（GIF / WebP 等）：后台线程按显示尺寸逐帧解码，只保留少量已就绪帧，
+// 取代在 GUI 线程按原始分辨率解码并缓存全部帧的 AnimatedImage。
+// 显示方式等同 PreserveAspectCrop；窗口停靠时降低帧率，隐藏时暂停解码
+class AnimatedBackground : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QString source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(bool paused READ paused WRITE setPaused NOTIFY pausedChanged)
+    Q_PROPERTY(bool throttled READ throttled WRITE setThrottled NOTIFY throttledChanged)
+    Q_PROPERTY(int throttledFps READ throttledFps WRITE setThrottledFps NOTIFY throttledChanged)
+    // 统计：已就绪帧占用的内存、单帧解码耗时
+    Q_PROPERTY(qint64 frameMemoryBytes READ frameMemoryBytes NOTIFY statsChanged)
+    Q_PROPERTY(double lastDecodeMs READ lastDecodeMs NOTIFY statsChanged)
+    Q_PROPERTY(double averageDecodeMs READ averageDecodeMs NOTIFY statsChanged)
+    Q_PROPERTY(int displayedFrames READ displayedFrames NOTIFY statsChanged)
+
+public:
+    explicit AnimatedBackground(QQuickItem *parent = nullptr);
+    ~AnimatedBackground() override;
+
+    QString source() const { return m_source; }
+    void setSource(const QString &path);
+    bool paused() const { return m_paused; }
+    void setPaused(bool paused);
+    bool throttled() const { return m_throttled; }
+    void setThrottled(bool throttled);
+    int throttledFps() const { return m_throttledFps; }
+    void setThrottledFps(int fps);
+
+    qint64 frameMemoryBytes() const;
+    double lastDecodeMs() const { return m_lastDecodeMs; }
+    double averageDecodeMs() const { return m_averageDecodeMs; }
+    int displayedFrames() const { return m_displayedFrames; }
+
+signals:
+    void sourceChanged();
+    void pausedChanged();
+    void throttledChanged();
+    void statsChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+
+private slots:
+    void onFrameDecoded(quint64 generation, double decodeMs);
+    void showNextFrame();
+    void restartDecoder();
+
+private:
+    friend class AnimatedFrameDecoder;
+
+    struct Frame {
+        QImage image;
+        int delayMs = 100;
+    };
+
+    bool isActive() const;
+    void updateActivity();
+
+    QString m_source;
+    bool m_paused = false;
+    bool m_throttled = false;
+    int m_throttledFps = 10;
+    bool m_windowVisible = true;
+    QMetaObject::Connection m_visibilityConnection;   // 所在窗口的可见性变化，换窗口时断开
+
+    // 解码线程写入、GUI 线程取出的就绪帧环（容量 FRAME_RING）
+    mutable QMutex m_mutex;
+    std::deque<Frame> m_ready;
+    quint64 m_generation = 0;   // 换源或改尺寸时递增，丢弃旧解码器送来的帧
+
+    QThread m_thread;
+    AnimatedFrameDecoder *m_decoder = nullptr;
+    QTimer m_frameTimer;
+    QTimer m_restartTimer;      // 尺寸变化去抖
+
+    QImage m_current;
+    bool m_textureDirty = false;
+    bool m_waitingForFrame = false;
+
+    double m_lastDecodeMs = 0.0;
+    double m_averageDecodeMs = 0.0;
+    int m_displayedFrames = 0;
+};
+
+#endif // ANIMATEDBACKGROUND_H
@@ -0,0 +1,866 @@
+#include "audioengine.h"
+#include "gaplessinfo.h"
+#include "pcmmix.h"
+#include <QAudioDecoder>
+#include <QAudioSink>
+#include <QAudioBuffer>
+#include <QAudioFormat>
+#include <QAudioDevice>
+#include <QMediaDevices>
+#include <QIODevice>
+#include <QDebug>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+static const int ENGINE_CHANNELS = 2;
+static const qsizetype TAP_GUARD_FRAMES = 8192;   // 分析抽头可安全读取的历史帧数 * 2
+static const qint64 PREBUFFER_MS = 150;           // 启动输出前至少缓冲的时长
+static const int PUMP_INTERVAL_MS = 5;            // 环形缓冲区已满时重试写入的间隔
+static const qint64 DECODE_AHEAD_MS = 2000;       // 环形缓冲区之外最多预先取出的解码数据（不含暂扣的尾部）
+
+// 输出端：QAudioSink 以拉模式从环形缓冲区取数据
+class PcmSourceDevice : public QIODevice
+{
+public:
+    PcmSourceDevice(AudioEngineShared *shared, const QAudioFormat &format, QObject *parent)
+        : QIODevice(parent), m_shared(shared), m_format(format) {}
+
+    bool isSequential() const override { return true; }
+
+    qint64 bytesAvailable() const override
+    {
+        return QIODevice::bytesAvailable() + m_shared->ring.availableToRead() * m_format.bytesPerFrame();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override
+    {
+        const int channels = m_shared->channels;
+        const int bytesPerFrame = m_format.bytesPerFrame();
+        qsizetype frames = qsizetype(maxlen / bytesPerFrame);
+        if (frames <= 0) return 0;
+
+        // 设备支持 float 时直接读入输出缓冲区，否则借助预分配的暂存区转换
+        const bool direct = m_format.sampleFormat() == QAudioFormat::Float;
+        float *out;
+        if (direct) {
+            out = reinterpret_cast<float *>(data);
+        } else {
+            if (m_scratch.size() < size_t(frames * channels)) m_scratch.resize(size_t(frames * channels));
+            out = m_scratch.data();
+        }
+
+        const qsizetype got = m_shared->ring.read(out, frames);
+        if (got > 0) {
+            const quint64 played = m_shared->framesPlayed.fetch_add(quint64(got), std::memory_order_relaxed) + quint64(got);
+            const qint64 boundary = m_shared->pendingBoundary.load(std::memory_order_acquire);
+            if (boundary >= 0 && played >= quint64(boundary)) {
+                // 已进入下一首：位置从边界处重新计时
+                m_shared->trackStartFrame.store(quint64(boundary), std::memory_order_relaxed);
+                m_shared->basePositionMs.store(0, std::memory_order_relaxed);
+                m_shared->lastGapFrames.store(m_silenceRun, std::memory_order_relaxed);
+                m_shared->pendingBoundary.store(-1, std::memory_order_relaxed);
+                m_shared->trackSwitches.fetch_add(1, std::memory_order_release);
+            }
+            m_silenceRun = 0;
+        }
+        if (got < frames) {
+            const bool ended = m_shared->decoderFinished.load(std::memory_order_acquire)
+                && m_shared->pendingFrames.load(std::memory_order_acquire) == 0;
+            if (ended) {
+                // 播放到结尾：返回剩余数据，下一次返回 0 使输出进入 Idle 状态
+                if (got == 0) return 0;
+                frames = got;
+            } else {
+                // 欠载：补静音保持输出运行，并计数
+                m_shared->underruns.fetch_add(1, std::memory_order_relaxed);
+                m_silenceRun += quint64(frames - got);
+                std::fill(out + got * channels, out + frames * channels, 0.0f);
+            }
+        }
+
+        m_shared->equalizer.process(out, frames);
+
+        if (!direct) {
+            qint16 *dst = reinterpret_cast<qint16 *>(data);
+            for (qsizetype i = 0; i < frames * channels; ++i) {
+                dst[i] = qint16(std::clamp(out[i], -1.0f, 1.0f) * 32767.0f);
+            }
+        }
+        return frames * bytesPerFrame;
+    }
+
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    AudioEngineShared *m_shared;
+    QAudioFormat m_format;
+    std::vector<float> m_scratch;
+    quint64 m_silenceRun = 0;   // 连续补入的静音帧数
+};
+
+// 解码/输出线程上的工作对象，持有 QAudioDecoder 与 QAudioSink
+// 播放/暂停状态由 AudioEngine 立即更新，工作对象只上报自身产生的变化（播放结束、解码失败）
+class AudioWorker : public QObject
+{
+    Q_OBJECT
+public:
+    AudioWorker(AudioEngineShared *shared, const QAudioFormat &format)
+        : m_shared(shared), m_format(format) {}
+
+public slots:
+    void init();
+    void open(const QUrl &url, float gain);
+    void setNextSource(const QUrl &url, float gain);
+    void setCrossfade(int ms);
+    void play();
+    void pause();
+    void stop();
+    void seek(qint64 ms);
+    void setVolume(float volume);
+    void shutdown();
+
+signals:
+    void durationChanged(qint64 duration);
+    void stateChanged(int state);
+    void statusChanged(int status);
+
+private slots:
+    void onBufferReady();
+    void onDecoderFinished();
+    void onDecoderError(QAudioDecoder::Error error);
+    void onDecoderDuration(qint64 duration);
+    void onSinkStateChanged(QAudio::State state);
+    void pushPending();
+    void startNextDecode();
+
+private:
+    // 已解码但尚未写入环形缓冲区的数据块
+    struct PendingBlock {
+        QAudioBuffer buffer;           // 格式匹配时直接引用解码器的缓冲区
+        std::vector<float> converted;  // 格式不匹配时转换后的 float 交错数据
+        const float *data = nullptr;
+        qsizetype frames = 0;
+        qsizetype offset = 0;
+    };
+
+    // 解码器是否已自行裁剪编码器延迟/填充：首次遇到带无缝信息的曲目时根据实际解码帧数判定
+    enum class BackendTrim { Unknown, Yes, No };
+
+    void restartDecoder(qint64 startMs);
+    void readDecoded();
+    void beginDecode(const QUrl &url, float gain);
+    void syncCurrentTrack();
+    void dropPendingTail(qsizetype frames);
+    std::vector<float> takePendingTail(qsizetype frames);
+    void finishFade();
+    qsizetype holdBackFrames() const;
+    bool convertBlock(PendingBlock &block);
+    void startSinkIfReady();
+
+    AudioEngineShared *m_shared;
+    QAudioFormat m_format;
+    QAudioDecoder *m_decoder = nullptr;
+    QAudioSink *m_sink = nullptr;
+    PcmSourceDevice *m_device = nullptr;
+    QTimer *m_pumpTimer = nullptr;
+
+    std::deque<PendingBlock> m_pending;
+    QUrl m_source;            // 输出端正在播放的曲目
+    QUrl m_decodingSource;    // 解码器正在处理的曲目（预读时为下一首）
+    QUrl m_nextSource;        // 等待预读的下一首
+    float m_sourceGain = 1.0f;     // 以上三者各自的响度均衡增益
+    float m_decodingGain = 1.0f;
+    float m_nextGain = 1.0f;
+    bool m_prerolling = false;
+    bool m_finishDeferred = false;   // 解码器已结束，但还有未取出的缓冲区
+    qsizetype m_skipFrames = 0;
+
+    GaplessInfo m_gapless;
+    BackendTrim m_backendTrim = BackendTrim::Unknown;
+    qsizetype m_holdBackFrames = 0;   // 解码期间保留在队列尾部的帧：可能需要裁掉的填充 + 交叉淡化区间
+    qint64 m_decodedFrames = 0;
+
+    // 交叉淡化：淡出曲目的尾部复制为独立数据块，淡入曲目解码出的数据直接混入其中
+    qsizetype m_crossfadeFrames = 0;
+    PendingBlock *m_fadeBlock = nullptr;   // 指向 m_pending 的最后一个块（deque 尾部追加不会使其失效）
+    qsizetype m_fadeFrames = 0;
+    qsizetype m_fadePos = 0;
+    bool m_wantPlaying = false;
+    bool m_loaded = false;
+    bool m_atEnd = false;
+    bool m_rateWarned = false;
+    float m_volume = 1.0f;
+};
+
+void AudioWorker::init()
+{
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+
+    // 设备不支持 float 时退回 16 位整数输出，由 PcmSourceDevice 转换
+    QAudioFormat sinkFormat = m_format;
+    if (!device.isFormatSupported(sinkFormat)) {
+        sinkFormat.setSampleFormat(QAudioFormat::Int16);
+    }
+
+    m_decoder = new QAudioDecoder(this);
+    m_decoder->setAudioFormat(m_format);
+    connect(m_decoder, &QAudioDecoder::bufferReady, this, &AudioWorker::onBufferReady);
+    connect(m_decoder, &QAudioDecoder::finished, this, &AudioWorker::onDecoderFinished);
+    connect(m_decoder, qOverload<QAudioDecoder::Error>(&QAudioDecoder::error), this, &AudioWorker::onDecoderError);
+    connect(m_decoder, &QAudioDecoder::durationChanged, this, &AudioWorker::onDecoderDuration);
+
+    m_sink = new QAudioSink(device, sinkFormat, this);
+    m_sink->setVolume(m_volume);
+    connect(m_sink, &QAudioSink::stateChanged, this, &AudioWorker::onSinkStateChanged);
+
+    m_device = new PcmSourceDevice(m_shared, sinkFormat, this);
+    m_device->open(QIODevice::ReadOnly);
+
+    m_pumpTimer = new QTimer(this);
+    m_pumpTimer->setInterval(PUMP_INTERVAL_MS);
+    connect(m_pumpTimer, &QTimer::timeout, this, &AudioWorker::pushPending);
+}
+
+void AudioWorker::open(const QUrl &url, float gain)
+{
+    m_source = url;
+    m_sourceGain = gain;
+    m_nextSource.clear();
+    m_prerolling = false;
+    m_wantPlaying = false;
+    restartDecoder(0);
+}
+
+void AudioWorker::setNextSource(const QUrl &url, float gain)
+{
+    syncCurrentTrack();
+    if (m_prerolling) {
+        // 下一首已写入环形缓冲区，无法撤回；播放模式变化将在下一次切换时生效
+        return;
+    }
+    m_nextSource = url;
+    m_nextGain = gain;
+    if (url.isEmpty() && m_holdBackFrames > 0 && m_shared->decoderFinished.load()) {
+        // 不再有下一首：放出为交叉淡化扣住的尾部
+        m_holdBackFrames = 0;
+        pushPending();
+        return;
+    }
+
+    // 当前曲目已解码完但尚未播完：立即开始预读
+    if (!url.isEmpty() && !m_atEnd && m_shared->decoderFinished.load()) {
+        m_shared->decoderFinished.store(false, std::memory_order_release);
+        startNextDecode();
+    }
+}
+
+void AudioWorker::setCrossfade(int ms)
+{
+    // 从下一次开始解码的曲目起生效
+    m_crossfadeFrames = qsizetype(qint64(qMax(0, ms)) * m_shared->sampleRate / 1000);
+}
+
+void AudioWorker::syncCurrentTrack()
+{
+    // 输出端已越过边界：预读的曲目成为当前曲目
+    if (m_prerolling && m_shared->pendingBoundary.load(std::memory_order_acquire) < 0) {
+        m_source = m_decodingSource;
+        m_sourceGain = m_decodingGain;
+        m_prerolling = false;
+    }
+}
+
+void AudioWorker::restartDecoder(qint64 startMs)
+{
+    // 先停止输出，保证环形缓冲区的生产者与消费者都静止后再重置
+    if (m_sink->state() != QAudio::StoppedState) m_sink->stop();
+    m_decoder->stop();
+    m_pumpTimer->stop();
+
+    // 预读中途跳转：丢弃已预读的下一首，稍后重新预读
+    syncCurrentTrack();
+    if (m_prerolling) {
+        m_nextSource = m_decodingSource;
+        m_nextGain = m_decodingGain;
+        m_prerolling = false;
+    }
+
+    m_pending.clear();
+    m_fadeBlock = nullptr;
+    m_shared->pendingFrames.store(0);
+    m_shared->ring.reset();
+    m_shared->framesPlayed.store(0);
+    m_shared->trackStartFrame.store(0);
+    m_shared->pendingBoundary.store(-1);
+    m_shared->decoderFinished.store(false);
+    m_loaded = false;
+    m_atEnd = false;
+    m_finishDeferred = false;
+
+    if (m_source.isEmpty()) return;
+    beginDecode(m_source, m_sourceGain);
+    // QAudioDecoder 不支持随机访问：从头解码并丢弃目标位置之前的帧，跳转的开销与目标位置成正比（解码远快于实时）
+    m_skipFrames += qsizetype(startMs * m_shared->sampleRate / 1000);
+}
+
+void AudioWorker::beginDecode(const QUrl &url, float gain)
+{
+    m_decodingSource = url;
+    m_decodingGain = gain;
+    m_decodedFrames = 0;
+    m_skipFrames = 0;
+    m_holdBackFrames = 0;
+    m_finishDeferred = false;
+
+    m_gapless = url.isLocalFile() ? GaplessInfo::fromFile(url.toLocalFile()).scaledTo(m_shared->sampleRate)
+                                  : GaplessInfo();
+    if (m_gapless.valid) {
+        // 尚不确定解码器是否裁剪时先扣住尾部填充，解码结束后再决定是否丢弃
+        if (m_backendTrim != BackendTrim::Yes) m_holdBackFrames = qsizetype(m_gapless.endTrim);
+        if (m_backendTrim == BackendTrim::No) m_skipFrames = qsizetype(m_gapless.startTrim);
+    }
+    // 结尾处要与下一首交叉淡化的部分同样先扣住
+    m_holdBackFrames += m_crossfadeFrames;
+
+    m_decoder->setSource(url);
+    m_decoder->start();
+}
+
+void AudioWorker::startNextDecode()
+{
+    // 排队期间可能已经跳转或换源，解码器重新开始工作时放弃本次预读
+    if (m_nextSource.isEmpty() || m_prerolling || m_decoder->isDecoding()) return;
+    m_decoder->stop();
+
+    // 交叉淡化时下一首从淡化区间起点开始，否则紧接在当前曲目已解码数据之后
+    const qsizetype fade = std::min<qsizetype>(m_crossfadeFrames, m_shared->pendingFrames.load());
+    std::vector<float> tail = takePendingTail(fade);
+    const qint64 boundary = qint64(m_shared->ring.totalWritten()) + m_shared->pendingFrames.load();
+    if (fade > 0) {
+        PendingBlock block;
+        block.converted = std::move(tail);
+        block.data = block.converted.data();
+        block.frames = fade;
+        m_pending.push_back(std::move(block));
+        m_shared->pendingFrames.fetch_add(fade);
+        m_fadeBlock = &m_pending.back();
+        m_fadeFrames = fade;
+        m_fadePos = 0;
+    }
+
+    const QUrl url = m_nextSource;
+    const float gain = m_nextGain;
+    m_nextSource.clear();
+    m_prerolling = true;
+    m_shared->nextDurationMs.store(0);
+    m_shared->pendingBoundary.store(boundary, std::memory_order_release);
+    beginDecode(url, gain);
+}
+
+std::vector<float> AudioWorker::takePendingTail(qsizetype frames)
+{
+    const int channels = m_shared->channels;
+    std::vector<float> tail(size_t(frames * channels));
+    qsizetype remaining = frames;
+    for (auto it = m_pending.rbegin(); it != m_pending.rend() && remaining > 0; ++it) {
+        const qsizetype n = std::min(remaining, it->frames - it->offset);
+        remaining -= n;
+        std::copy(it->data + (it->frames - n) * channels, it->data + it->frames * channels,
+                  tail.begin() + remaining * channels);
+    }
+    dropPendingTail(frames);
+    return tail;
+}
+
+void AudioWorker::finishFade()
+{
+    // 淡入曲目比淡化区间还短：剩余部分只做淡出
+    if (!m_fadeBlock) return;
+    fadeOutEqualPower(m_fadeBlock->converted.data() + m_fadePos * m_shared->channels, m_shared->channels,
+                      m_fadeFrames - m_fadePos, m_fadePos, m_fadeFrames);
+    m_fadeBlock = nullptr;
+}
+
+qsizetype AudioWorker::holdBackFrames() const
+{
+    return m_holdBackFrames + (m_fadeBlock ? m_fadeFrames - m_fadePos : 0);
+}
+
+void AudioWorker::dropPendingTail(qsizetype frames)
+{
+    while (frames > 0 && !m_pending.empty()) {
+        PendingBlock &block = m_pending.back();
+        const qsizetype n = std::min(frames, block.frames - block.offset);
+        block.frames -= n;
+        frames -= n;
+        m_shared->pendingFrames.fetch_sub(n);
+        if (block.offset >= block.frames) m_pending.pop_back();
+    }
+}
+
+bool AudioWorker::convertBlock(PendingBlock &block)
+{
+    const QAudioFormat fmt = block.buffer.format();
+    const int channels = m_shared->channels;
+    block.frames = block.buffer.frameCount();
+    if (block.frames <= 0) return false;
+
+    if (fmt.sampleRate() != m_shared->sampleRate && !m_rateWarned) {
+        qWarning() << "AudioEngine - 解码器未按要求重采样:" << fmt.sampleRate() << "->" << m_shared->sampleRate;
+        m_rateWarned = true;
+    }
+
+    const float gain = m_decodingGain;
+    if (fmt.sampleFormat() == QAudioFormat::Float && fmt.channelCount() == channels) {
+        if (gain == 1.0f) {
+            block.data = block.buffer.constData<float>();
+            return true;
+        }
+        // 响度均衡：复制一份再乘以增益（解码器的缓冲区是只读的）
+        const float *src = block.buffer.constData<float>();
+        block.converted.resize(size_t(block.frames * channels));
+        for (qsizetype i = 0; i < block.frames * channels; ++i) block.converted[size_t(i)] = src[i] * gain;
+        block.data = block.converted.data();
+        return true;
+    }
+
+    // 其它格式/声道数：逐采样归一化后映射到引擎声道
+    const int inChannels = fmt.channelCount();
+    const int bytesPerSample = fmt.bytesPerSample();
+    const char *src = block.buffer.constData<char>();
+    block.converted.resize(size_t(block.frames * channels));
+    for (qsizetype f = 0; f < block.frames; ++f) {
+        for (int c = 0; c < channels; ++c) {
+            const int inC = std::min(c, inChannels - 1);
+            block.converted[size_t(f * channels + c)] =
+                fmt.normalizedSampleValue(src + (f * inChannels + inC) * bytesPerSample) * gain;
+        }
+    }
+    block.data = block.converted.data();
+    return true;
+}
+
+void AudioWorker::onBufferReady()
+{
+    readDecoded();
+    pushPending();
+}
+
+void AudioWorker::readDecoded()
+{
+    // 待写数据达到上限后不再取出，缓冲区留在解码器中，由 pushPending 腾出空间后继续读取
+    const qint64 limit = holdBackFrames() + DECODE_AHEAD_MS * m_shared->sampleRate / 1000;
+    while (m_decoder->bufferAvailable() && m_shared->pendingFrames.load() < limit) {
+        PendingBlock block;
+        block.buffer = m_decoder->read();
+        if (!block.buffer.isValid() || !convertBlock(block)) continue;
+        m_decodedFrames += block.frames;
+
+        if (m_skipFrames > 0) {
+            const qsizetype skip = std::min(m_skipFrames, block.frames);
+            block.offset = skip;
+            m_skipFrames -= skip;
+            if (block.offset >= block.frames) continue;
+        }
+
+        if (m_fadeBlock) {
+            const int channels = m_shared->channels;
+            const qsizetype n = std::min(block.frames - block.offset, m_fadeFrames - m_fadePos);
+            crossfadeEqualPower(m_fadeBlock->converted.data() + m_fadePos * channels,
+                                block.data + block.offset * channels, channels, n, m_fadePos, m_fadeFrames);
+            m_fadePos += n;
+            block.offset += n;
+            if (m_fadePos >= m_fadeFrames) m_fadeBlock = nullptr;
+            if (block.offset >= block.frames) continue;
+        }
+
+        m_shared->pendingFrames.fetch_add(block.frames - block.offset);
+        m_pending.push_back(std::move(block));
+    }
+
+    if (!m_loaded && !m_pending.empty()) {
+        m_loaded = true;
+        emit statusChanged(QMediaPlayer::LoadedMedia);
+    }
+}
+
+void AudioWorker::pushPending()
+{
+    const int channels = m_shared->channels;
+    bool full = false;
+    for (;;) {
+        qint64 budget = m_shared->pendingFrames.load() - holdBackFrames();
+        while (!m_pending.empty() && budget > 0) {
+            PendingBlock &block = m_pending.front();
+            const qsizetype want = qsizetype(std::min<qint64>(block.frames - block.offset, budget));
+            const qsizetype written = m_shared->ring.write(block.data + block.offset * channels, want);
+            block.offset += written;
+            budget -= written;
+            m_shared->pendingFrames.fetch_sub(written);
+            if (written < want) { full = true; break; }
+            if (block.offset < block.frames) break; // 余下部分是暂扣的尾部填充
+            m_pending.pop_front();
+        }
+        // 腾出了空间：继续从解码器取出留在那里的缓冲区
+        const qint64 before = m_shared->pendingFrames.load();
+        if (full || !m_decoder->bufferAvailable()) break;
+        readDecoded();
+        if (m_shared->pendingFrames.load() == before) break;
+    }
+
+    if (m_finishDeferred && !m_decoder->bufferAvailable()) {
+        // 推迟的结束处理：此时解码数据已全部取出（onDecoderFinished 会再次调用本函数）
+        m_finishDeferred = false;
+        onDecoderFinished();
+        return;
+    }
+
+    // QAudioDecoder 没有反压接口：写不下的数据留在队列或解码器中，定时重试
+    if (!full) m_pumpTimer->stop();
+    else if (!m_pumpTimer->isActive()) m_pumpTimer->start();
+
+    startSinkIfReady();
+}
+
+void AudioWorker::startSinkIfReady()
+{
+    if (!m_wantPlaying || m_sink->state() != QAudio::StoppedState) return;
+
+    const qint64 aheadMs = m_shared->ring.availableToRead() * 1000 / m_shared->sampleRate;
+    if (aheadMs >= PREBUFFER_MS || m_shared->decoderFinished.load()) {
+        m_sink->start(m_device);
+        if (m_loaded) emit statusChanged(QMediaPlayer::BufferedMedia);
+    }
+}
+
+void AudioWorker::onDecoderFinished()
+{
+    if (m_decoder->bufferAvailable()) {
+        // 解码器中还留有未取出的数据：等 pushPending 取完后再做结束处理
+        m_finishDeferred = true;
+        return;
+    }
+
+    // 淡入曲目在淡化区间内就结束了：其尾部填充已混入淡化块，不再单独裁剪
+    const bool fadeCutShort = m_fadeBlock != nullptr;
+    finishFade();
+
+    if (m_gapless.valid) {
+        if (m_backendTrim == BackendTrim::Unknown) {
+            // 实际解码帧数更接近有效长度说明解码器已自行裁剪
+            const qint64 untrimmed = m_gapless.validFrames + m_gapless.startTrim + m_gapless.endTrim;
+            const bool trims = qAbs(m_decodedFrames - m_gapless.validFrames) <= qAbs(m_decodedFrames - untrimmed);
+            m_backendTrim = trims ? BackendTrim::Yes : BackendTrim::No;
+            qDebug() << "AudioEngine - 解码器" << (trims ? "已" : "未") << "裁剪编码器延迟/填充";
+        }
+        if (m_backendTrim == BackendTrim::No && !fadeCutShort) dropPendingTail(qsizetype(m_gapless.endTrim));
+        m_gapless = GaplessInfo();
+    }
+
+    syncCurrentTrack();
+    // 有（或切换后即将收到）下一首时继续扣住交叉淡化区间，留给 startNextDecode 取出
+    m_holdBackFrames = !m_nextSource.isEmpty() || m_prerolling ? m_crossfadeFrames : 0;
+    if (!m_nextSource.isEmpty() && !m_prerolling) {
+        // 在当前解码回调之外切换解码器的源
+        QMetaObject::invokeMethod(this, &AudioWorker::startNextDecode, Qt::QueuedConnection);
+    } else {
+        m_shared->decoderFinished.store(true, std::memory_order_release);
+    }
+    pushPending();
+}
+
+void AudioWorker::onDecoderDuration(qint64 duration)
+{
+    syncCurrentTrack();
+    if (m_prerolling) {
+        // 预读曲目的时长在切换时由 AudioEngine 上报
+        m_shared->nextDurationMs.store(duration);
+        return;
+    }
+    emit durationChanged(duration);
+}
+
+void AudioWorker::onDecoderError(QAudioDecoder::Error error)
+{
+    qWarning() << "AudioEngine - 解码失败:" << error << m_decoder->errorString();
+    m_wantPlaying = false;
+    if (m_sink->state() != QAudio::StoppedState) m_sink->stop();
+    emit statusChanged(QMediaPlayer::InvalidMedia);
+    emit stateChanged(QMediaPlayer::StoppedState);
+}
+
+void AudioWorker::onSinkStateChanged(QAudio::State state)
+{
+    if (state != QAudio::IdleState) return;
+
+    const bool drained = m_shared->decoderFinished.load()
+        && m_pending.empty()
+        && m_shared->ring.availableToRead() == 0;
+    if (drained && !m_atEnd) {
+        m_atEnd = true;
+        m_wantPlaying = false;
+        m_sink->stop();
+        emit statusChanged(QMediaPlayer::EndOfMedia);
+        emit stateChanged(QMediaPlayer::StoppedState);
+    }
+}
+
+void AudioWorker::play()
+{
+    if (m_atEnd) {
+        restartDecoder(0);
+    }
+    m_wantPlaying = true;
+    if (m_sink->state() == QAudio::SuspendedState) {
+        m_sink->resume();
+    } else {
+        startSinkIfReady();
+    }
+}
+
+void AudioWorker::pause()
+{
+    m_wantPlaying = false;
+    if (m_sink->state() == QAudio::ActiveState || m_sink->state() == QAudio::IdleState) {
+        m_sink->suspend();
+    }
+}
+
+void AudioWorker::stop()
+{
+    m_wantPlaying = false;
+    restartDecoder(0);
+}
+
+void AudioWorker::seek(qint64 ms)
+{
+    const bool resume = m_wantPlaying;
+    restartDecoder(ms);
+    m_wantPlaying = resume;
+}
+
+void AudioWorker::setVolume(float volume)
+{
+    m_volume = volume;
+    if (m_sink) m_sink->setVolume(volume);
+}
+
+void AudioWorker::shutdown()
+{
+    m_wantPlaying = false;
+    if (m_sink) m_sink->stop();
+    if (m_decoder) m_decoder->stop();
+    m_pending.clear();
+    delete m_sink;
+    m_sink = nullptr;
+    delete m_decoder;
+    m_decoder = nullptr;
+}
+
+AudioEngine::AudioEngine(QObject *parent)
+    : QObject(parent)
+{
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    int rate = device.preferredFormat().sampleRate();
+    if (rate <= 0) rate = 48000;
+
+    // 环形缓冲区约 2 秒
+    m_shared = std::make_unique<AudioEngineShared>(rate, ENGINE_CHANNELS, qsizetype(rate) * 2, TAP_GUARD_FRAMES);
+
+    QAudioFormat format;
+    format.setSampleRate(rate);
+    format.setChannelCount(ENGINE_CHANNELS);
+    format.setSampleFormat(QAudioFormat::Float);
+
+    m_worker = new AudioWorker(m_shared.get(), format);
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::started, m_worker, &AudioWorker::init);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &AudioWorker::durationChanged, this, &AudioEngine::onWorkerDuration);
+    connect(m_worker, &AudioWorker::stateChanged, this, &AudioEngine::onWorkerState);
+    connect(m_worker, &AudioWorker::statusChanged, this, &AudioEngine::onWorkerStatus);
+
+    m_thread.setObjectName("AudioEngine");
+    m_thread.start(QThread::TimeCriticalPriority);
+
+    // 与 QMediaPlayer 类似地周期性上报播放位置
+    m_positionTimer = new QTimer(this);
+    m_positionTimer->setInterval(50);
+    connect(m_positionTimer, &QTimer::timeout, this, [this]() {
+        checkTrackSwitch();
+        emit positionChanged(position());
+    });
+}
+
+AudioEngine::~AudioEngine()
+{
+    QMetaObject::invokeMethod(m_worker, &AudioWorker::shutdown, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void AudioEngine::setSource(const QUrl &url, float gain)
+{
+    m_source = url;
+    m_nextSource.clear();
+    m_shared->basePositionMs.store(0);
+    m_shared->framesPlayed.store(0);
+    m_shared->trackStartFrame.store(0);
+    if (m_duration != 0) {
+        m_duration = 0;
+        emit durationChanged(0);
+    }
+    setState(QMediaPlayer::StoppedState);
+    setStatus(url.isEmpty() ? QMediaPlayer::NoMedia : QMediaPlayer::LoadingMedia);
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, url, gain]() { w->open(url, gain); }, Qt::QueuedConnection);
+}
+
+void AudioEngine::setNextSource(const QUrl &url, float gain)
+{
+    if (m_nextSource == url && m_nextGain == gain) return;
+    m_nextSource = url;
+    m_nextGain = gain;
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, url, gain]() { w->setNextSource(url, gain); },
+                              Qt::QueuedConnection);
+}
+
+void AudioEngine::checkTrackSwitch()
+{
+    const quint64 switches = m_shared->trackSwitches.load(std::memory_order_acquire);
+    if (switches == m_seenSwitches) return;
+    m_seenSwitches = switches;
+    if (m_nextSource.isEmpty()) return; // 换源前残留的切换
+
+    m_source = m_nextSource;
+    m_nextSource.clear();
+    const qint64 duration = m_shared->nextDurationMs.load();
+    if (duration > 0 && duration != m_duration) {
+        m_duration = duration;
+        emit durationChanged(duration);
+    }
+    emit trackAdvanced();
+}
+
+double AudioEngine::lastTrackSwitchGapMs() const
+{
+    return double(m_shared->lastGapFrames.load(std::memory_order_relaxed)) * 1000.0 / m_shared->sampleRate;
+}
+
+void AudioEngine::play()
+{
+    if (m_source.isEmpty()) return;
+    if (m_status == QMediaPlayer::EndOfMedia) {
+        m_shared->basePositionMs.store(0);
+        m_shared->framesPlayed.store(0);
+        m_shared->trackStartFrame.store(0);
+    }
+    setState(QMediaPlayer::PlayingState);
+    QMetaObject::invokeMethod(m_worker, &AudioWorker::play, Qt::QueuedConnection);
+}
+
+void AudioEngine::pause()
+{
+    setState(QMediaPlayer::PausedState);
+    QMetaObject::invokeMethod(m_worker, &AudioWorker::pause, Qt::QueuedConnection);
+}
+
+void AudioEngine::stop()
+{
+    setState(QMediaPlayer::StoppedState);
+    m_shared->basePositionMs.store(0);
+    m_shared->framesPlayed.store(0);
+    m_shared->trackStartFrame.store(0);
+    QMetaObject::invokeMethod(m_worker, &AudioWorker::stop, Qt::QueuedConnection);
+}
+
+void AudioEngine::setPosition(qint64 ms)
+{
+    ms = qMax<qint64>(0, ms);
+    checkTrackSwitch();
+    m_shared->basePositionMs.store(ms);
+    m_shared->framesPlayed.store(0);
+    m_shared->trackStartFrame.store(0);
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, ms]() { w->seek(ms); }, Qt::QueuedConnection);
+    emit positionChanged(ms);
+}
+
+void AudioEngine::setCrossfadeMs(int ms)
+{
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, ms]() { w->setCrossfade(ms); }, Qt::QueuedConnection);
+}
+
+void AudioEngine::setVolume(float volume)
+{
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, volume]() { w->setVolume(volume); }, Qt::QueuedConnection);
+}
+
+qint64 AudioEngine::position() const
+{
+    const quint64 played = m_shared->framesPlayed.load(std::memory_order_relaxed);
+    const quint64 start = m_shared->trackStartFrame.load(std::memory_order_relaxed);
+    const quint64 frames = played > start ? played - start : 0;
+    return m_shared->basePositionMs.load(std::memory_order_relaxed) + qint64(frames * 1000 / quint64(m_shared->sampleRate));
+}
+
+double AudioEngine::bufferFill() const
+{
+    return double(m_shared->ring.availableToRead()) / double(m_shared->ring.capacityFrames());
+}
+
+qint64 AudioEngine::decodeAheadMs() const
+{
+    const qint64 frames = m_shared->ring.availableToRead() + m_shared->pendingFrames.load(std::memory_order_relaxed);
+    return frames * 1000 / m_shared->sampleRate;
+}
+
+int AudioEngine::readAnalysisWindow(float *mono, int frames) const
+{
+    const int channels = m_shared->channels;
+    int written = 0;
+    m_shared->ring.peekRecent(frames, [&](const float *samples, qsizetype count) {
+        for (qsizetype i = 0; i < count; ++i) {
+            float sum = 0.0f;
+            for (int c = 0; c < channels; ++c) sum += samples[i * channels + c];
+            mono[written++] = sum / channels;
+        }
+    });
+    return written;
+}
+
+void AudioEngine::onWorkerDuration(qint64 duration)
+{
+    if (m_duration != duration) {
+        m_duration = duration;
+        emit durationChanged(duration);
+    }
+}
+
+void AudioEngine::onWorkerState(int state)
+{
+    setState(static_cast<QMediaPlayer::PlaybackState>(state));
+}
+
+void AudioEngine::onWorkerStatus(int status)
+{
+    setStatus(static_cast<QMediaPlayer::MediaStatus>(status));
+}
+
+void AudioEngine::setState(QMediaPlayer::PlaybackState state)
+{
+    if (m_state == state) return;
+    m_state = state;
+    if (state == QMediaPlayer::PlayingState) m_positionTimer->start();
+    else m_positionTimer->stop();
+    emit playbackStateChanged(state);
+}
+
+void AudioEngine::setStatus(QMediaPlayer::MediaStatus status)
+{
+    if (m_status == status) return;
+    m_status = status;
+    emit mediaStatusChanged(status);
+}
+
+#include "audioengine.moc"
@@ -0,0 +1,115 @@
+#ifndef AUDIOENGINE_H
+#define AUDIOENGINE_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+#include <QMediaPlayer>
+#include <atomic>
+#include <memory>
+#include "pcmringbuffer.h"
+#include "equalizer.h"
+
+class AudioWorker;
+
+// 解码线程与音频输出回调共享的状态
+struct AudioEngineShared {
+    AudioEngineShared(int rate, int ch, qsizetype capacityFrames, qsizetype tapGuardFrames)
+        : sampleRate(rate), channels(ch), ring(ch, capacityFrames, tapGuardFrames), equalizer(rate, ch) {}
+
+    const int sampleRate;
+    const int channels;
+    PcmRingBuffer ring;
+    Equalizer equalizer;   // 在输出回调中处理，参数改动立即可闻（不受预解码深度影响）
+    std::atomic<quint64> framesPlayed { 0 };   // 已送入设备的有效帧数（用于计算播放位置）
+    std::atomic<quint64> underruns { 0 };      // 输出回调取不到数据、补静音的次数
+    std::atomic<qint64> pendingFrames { 0 };   // 已解码但尚未进入环形缓冲区的帧数
+    std::atomic<bool> decoderFinished { false };
+
+    // 播放位置 = basePositionMs + (framesPlayed - trackStartFrame) 换算的毫秒数
+    std::atomic<qint64> basePositionMs { 0 };
+    std::atomic<quint64> trackStartFrame { 0 };
+
+    // 无缝切换：下一首的首帧在 framesPlayed 计数中的序号，-1 表示没有已预读的下一首。
+    // 输出回调越过该位置时即完成切换（精确到采样），并记录切换前补入的静音帧数
+    std::atomic<qint64> pendingBoundary { -1 };
+    std::atomic<quint64> trackSwitches { 0 };
+    std::atomic<quint64> lastGapFrames { 0 };
+    std::atomic<qint64> nextDurationMs { 0 };
+};
+
+// 自有播放管线：QAudioDecoder → 无锁 SPSC 环形缓冲区 → QAudioSink
+// 解码与输出运行在独立的高优先级线程上；对外接口与信号沿用 QMediaPlayer 的枚举，
+// PlayerBackend 可以在两种播放引擎之间切换而不改变 QML 可见的属性
+class AudioEngine : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AudioEngine(QObject *parent = nullptr);
+    ~AudioEngine() override;
+
+    // gain 为曲目的线性增益（响度均衡），在解码时施加，与预读的下一首各自独立
+    void setSource(const QUrl &url, float gain = 1.0f);
+    QUrl source() const { return m_source; }
+    // 预读下一首：当前曲目解码完毕后立即接着解码 url，输出端无缝衔接（发出 trackAdvanced）
+    void setNextSource(const QUrl &url, float gain = 1.0f);
+    QUrl nextSource() const { return m_nextSource; }
+    void play();
+    void pause();
+    void stop();
+    void setPosition(qint64 ms);
+    void setVolume(float volume);
+    // 交叉淡化时长（毫秒，0 为关闭）：与下一首的衔接处按等功率曲线重叠混音
+    void setCrossfadeMs(int ms);
+
+    qint64 position() const;
+    qint64 duration() const { return m_duration; }
+    QMediaPlayer::PlaybackState playbackState() const { return m_state; }
+    QMediaPlayer::MediaStatus mediaStatus() const { return m_status; }
+
+    int sampleRate() const { return m_shared->sampleRate; }
+    Equalizer &equalizer() { return m_shared->equalizer; }
+    int channelCount() const { return m_shared->channels; }
+
+    // 计数器
+    quint64 underruns() const { return m_shared->underruns.load(std::memory_order_relaxed); }
+    double lastTrackSwitchGapMs() const;   // 最近一次无缝切换时实际插入的静音时长
+    double bufferFill() const;      // 环形缓冲区填充率 0..1
+    qint64 decodeAheadMs() const;   // 已解码未播放的时长（环形缓冲区 + 待写入队列）
+
+    // 分析抽头：直接读取刚输出的 frames 帧并下混为单声道，返回实际帧数
+    int readAnalysisWindow(float *mono, int frames) const;
+
+signals:
+    void positionChanged(qint64 position);
+    void durationChanged(qint64 duration);
+    void playbackStateChanged(QMediaPlayer::PlaybackState state);
+    void mediaStatusChanged(QMediaPlayer::MediaStatus status);
+    void trackAdvanced();   // 已无缝切换到 setNextSource() 指定的曲目，source() 随之更新
+
+private slots:
+    void onWorkerDuration(qint64 duration);
+    void onWorkerState(int state);
+    void onWorkerStatus(int status);
+
+private:
+    void setState(QMediaPlayer::PlaybackState state);
+    void setStatus(QMediaPlayer::MediaStatus status);
+    void checkTrackSwitch();
+
+    std::unique_ptr<AudioEngineShared> m_shared;
+    QThread m_thread;
+    AudioWorker *m_worker = nullptr;
+    QTimer *m_positionTimer = nullptr;
+
+    QUrl m_source;
+    QUrl m_nextSource;
+    float m_nextGain = 1.0f;
+    quint64 m_seenSwitches = 0;
+    qint64 m_duration = 0;
+    QMediaPlayer::PlaybackState m_state = QMediaPlayer::StoppedState;
+    QMediaPlayer::MediaStatus m_status = QMediaPlayer::NoMedia;
+};
+
+#endif // AUDIOENGINE_H
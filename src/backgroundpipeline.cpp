@@ -0,0 +1,333 @@
+#include "backgroundpipeline.h"
+#include "trace.h"
+#include "metrics.h"
+#include "imageblur.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QDebug>
+#include <deque>
+
+static const int BLUR_DOWNSCALE = 4;        // 模糊版本的缩小倍数
+static const int BLUR_RADIUS = 64;          // 与原先 MultiEffect 的 blurMax 对应（按屏幕像素计）
+static const double BLUR_BRIGHTNESS = 0.1;
+static const double BLUR_SATURATION = 1.2;
+static const int JPEG_QUALITY = 92;
+static const quint32 HASH_CACHE_MAGIC = 0x42474853; // "BGHS"
+static const quint32 HASH_CACHE_VERSION = 1;
+
+// 后台线程上的工作对象：按队列顺序逐个处理，每处理一张回到事件循环，
+// 让随后到达的高优先级请求可以插队
+class BackgroundWorker : public QObject
+{
+    Q_OBJECT
+public:
+    void enqueue(const QString &path, const QSize &size, bool urgent);
+
+signals:
+    void ready(const QString &path, const QSize &size, const QString &display, const QString &blurred);
+
+private:
+    struct Job {
+        QString path;
+        QSize size;
+    };
+    struct HashEntry {
+        qint64 fileSize = 0;
+        qint64 mtime = 0;
+        QByteArray hash;
+    };
+
+    void processNext();
+    void process(const Job &job);
+    QByteArray contentHash(const QFileInfo &info);
+    void loadHashes();
+    void saveHashes();
+    static QString hashCachePath();
+    static bool saveImage(const QImage &image, const QString &filePath);
+
+    std::deque<Job> m_queue;
+    bool m_scheduled = false;
+    QHash<QString, HashEntry> m_hashes;   // 路径 → 内容哈希（文件未变时不重复计算，跨启动保存）
+    bool m_hashesLoaded = false;
+    bool m_hashesDirty = false;
+};
+
+void BackgroundWorker::enqueue(const QString &path, const QSize &size, bool urgent)
+{
+    for (auto it = m_queue.begin(); it != m_queue.end(); ++it) {
+        if (it->path == path && it->size == size) {
+            if (!urgent) return;
+            m_queue.erase(it);
+            break;
+        }
+    }
+    if (urgent) m_queue.push_front({ path, size });
+    else m_queue.push_back({ path, size });
+
+    if (!m_scheduled) {
+        m_scheduled = true;
+        QTimer::singleShot(0, this, &BackgroundWorker::processNext);
+    }
+}
+
+void BackgroundWorker::processNext()
+{
+    m_scheduled = false;
+    if (m_queue.empty()) return;
+    const Job job = m_queue.front();
+    m_queue.pop_front();
+    process(job);
+
+    if (!m_queue.empty()) {
+        m_scheduled = true;
+        QTimer::singleShot(0, this, &BackgroundWorker::processNext);
+    } else if (m_hashesDirty) {
+        // 队列处理完再写回，避免逐张写盘
+        saveHashes();
+    }
+}
+
+QString BackgroundWorker::hashCachePath()
+{
+    return BackgroundPipeline::cacheDir() + "/hashes.idx";
+}
+
+void BackgroundWorker::loadHashes()
+{
+    m_hashesLoaded = true;
+    QFile file(hashCachePath());
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_2);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != HASH_CACHE_MAGIC || version != HASH_CACHE_VERSION) {
+        qWarning() << "BackgroundPipeline - 哈希缓存格式不匹配，忽略:" << file.fileName();
+        return;
+    }
+
+    QHash<QString, HashEntry> entries;
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        HashEntry entry;
+        in >> path >> entry.fileSize >> entry.mtime >> entry.hash;
+        entries.insert(path, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "BackgroundPipeline - 哈希缓存已损坏，忽略:" << file.fileName();
+        return;
+    }
+    m_hashes = entries;
+}
+
+void BackgroundWorker::saveHashes()
+{
+    QDir().mkpath(BackgroundPipeline::cacheDir());
+    QSaveFile file(hashCachePath());
+    if (!file.open(QIODevice::WriteOnly)) return;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << HASH_CACHE_MAGIC << HASH_CACHE_VERSION << qint32(m_hashes.size());
+    for (auto it = m_hashes.constBegin(); it != m_hashes.constEnd(); ++it) {
+        out << it.key() << it->fileSize << it->mtime << it->hash;
+    }
+    if (file.commit()) m_hashesDirty = false;
+}
+
+QByteArray BackgroundWorker::contentHash(const QFileInfo &info)
+{
+    if (!m_hashesLoaded) loadHashes();
+
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+    HashEntry &entry = m_hashes[info.absoluteFilePath()];
+    if (!entry.hash.isEmpty() && entry.fileSize == info.size() && entry.mtime == mtime) {
+        return entry.hash;
+    }
+
+    QFile file(info.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_hashes.remove(info.absoluteFilePath());
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    entry.fileSize = info.size();
+    entry.mtime = mtime;
+    entry.hash = hash.result().toHex();
+    m_hashesDirty = true;
+    return entry.hash;
+}
+
+bool BackgroundWorker::saveImage(const QImage &image, const QString &filePath)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QImageWriter writer(&file, filePath.endsWith(".png") ? "png" : "jpg");
+    writer.setQuality(JPEG_QUALITY);
+    if (!writer.write(image)) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void BackgroundWorker::process(const Job &job)
+{
+    TRACE_SCOPE("BackgroundWorker::process");
+    const QFileInfo info(job.path);
+    const QByteArray hash = info.exists() ? contentHash(info) : QByteArray();
+    if (hash.isEmpty() || job.size.isEmpty()) return;
+
+    const QString base = BackgroundPipeline::cacheDir() + "/" + QString::fromLatin1(hash)
+                       + QString("_%1x%2").arg(job.size.width()).arg(job.size.height());
+
+    // 已有缓存（无透明通道的图片存为 jpg，否则 png）
+    for (const QString &ext : { QStringLiteral(".jpg"), QStringLiteral(".png") }) {
+        const QString display = base + ext;
+        const QString blurred = base + "_blur" + ext;
+        if (QFileInfo::exists(blurred) && (QFileInfo::exists(display) || QFileInfo::exists(base + ".anim"))) {
+            Metrics::count(Metrics::BackgroundCacheHits);
+            emit ready(job.path, job.size, QFileInfo::exists(display) ? display : job.path, blurred);
+            return;
+        }
+    }
+    Metrics::count(Metrics::BackgroundCacheMisses);
+
+    QImageReader reader(job.path);
+    reader.setAutoTransform(true);
+    const bool animated = reader.supportsAnimation() && reader.imageCount() > 1;
+    QSize sourceSize = reader.size();
+    if (sourceSize.isValid() && (reader.transformation() & QImageIOHandler::TransformationRotate90)) {
+        sourceSize.transpose();
+    }
+
+    // 按“铺满并裁切”计算缩放比例，让解码器直接输出缩小后的图像（JPEG 可跳过大部分解码工作）
+    if (sourceSize.isValid()) {
+        const double scale = qMax(double(job.size.width()) / sourceSize.width(),
+                                  double(job.size.height()) / sourceSize.height());
+        if (scale < 1.0) reader.setScaledSize((QSizeF(sourceSize) * scale).toSize());
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "BackgroundPipeline - 无法解码:" << job.path << reader.errorString();
+        return;
+    }
+
+    // 居中裁切到目标宽高比（不放大小图）
+    const double targetAspect = double(job.size.width()) / job.size.height();
+    QRect crop(QPoint(0, 0), image.size());
+    if (double(image.width()) / image.height() > targetAspect) {
+        crop.setWidth(qRound(image.height() * targetAspect));
+        crop.moveLeft((image.width() - crop.width()) / 2);
+    } else {
+        crop.setHeight(qRound(image.width() / targetAspect));
+        crop.moveTop((image.height() - crop.height()) / 2);
+    }
+    QImage display = image.copy(crop);
+    if (display.width() > job.size.width()) {
+        display = display.scaled(job.size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    const QString ext = display.hasAlphaChannel() ? ".png" : ".jpg";
+    QDir().mkpath(BackgroundPipeline::cacheDir());
+
+    // 动图保持原文件播放，只记录一个标记文件；模糊版本取第一帧
+    QString displayPath = job.path;
+    if (animated) {
+        QFile marker(base + ".anim");
+        if (marker.open(QIODevice::WriteOnly)) marker.close();
+    } else if (saveImage(display, base + ext)) {
+        displayPath = base + ext;
+    }
+
+    QImage blurred = display.scaled(qMax(1, job.size.width() / BLUR_DOWNSCALE),
+                                    qMax(1, job.size.height() / BLUR_DOWNSCALE),
+                                    Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    boxBlur(blurred, BLUR_RADIUS / BLUR_DOWNSCALE / 2);
+    adjustBrightnessSaturation(blurred, BLUR_BRIGHTNESS, BLUR_SATURATION);
+    const QString blurredPath = base + "_blur" + ext;
+    if (!saveImage(blurred, blurredPath)) return;
+
+    emit ready(job.path, job.size, displayPath, blurredPath);
+}
+
+BackgroundPipeline::BackgroundPipeline(QObject *parent)
+    : QObject(parent)
+{
+    m_worker = new BackgroundWorker;
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &BackgroundWorker::ready, this, &BackgroundPipeline::onWorkerReady);
+    m_thread.setObjectName("BackgroundPipeline");
+    m_thread.start(QThread::LowPriority);
+}
+
+BackgroundPipeline::~BackgroundPipeline()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+QString BackgroundPipeline::cacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/backgrounds";
+}
+
+QString BackgroundPipeline::key(const QString &path, const QSize &size)
+{
+    return QString("%1|%2x%3").arg(path).arg(size.width()).arg(size.height());
+}
+
+void BackgroundPipeline::setTargetSize(const QSize &size)
+{
+    m_targetSize = size;
+}
+
+bool BackgroundPipeline::lookup(const QString &path, Variants *out) const
+{
+    auto it = m_done.constFind(key(path, m_targetSize));
+    if (it == m_done.constEnd()) return false;
+    if (out) *out = it.value();
+    return true;
+}
+
+void BackgroundPipeline::request(const QString &path)
+{
+    if (path.isEmpty() || m_targetSize.isEmpty()) return;
+    const QSize size = m_targetSize;
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, path, size]() { w->enqueue(path, size, true); },
+                              Qt::QueuedConnection);
+}
+
+void BackgroundPipeline::prefetch(const QStringList &paths)
+{
+    if (m_targetSize.isEmpty()) return;
+    const QSize size = m_targetSize;
+    for (const QString &path : paths) {
+        if (path.isEmpty() || m_done.contains(key(path, size))) continue;
+        QMetaObject::invokeMethod(m_worker, [w = m_worker, path, size]() { w->enqueue(path, size, false); },
+                                  Qt::QueuedConnection);
+    }
+}
+
+void BackgroundPipeline::onWorkerReady(const QString &path, const QSize &size, const QString &display, const QString &blurred)
+{
+    m_done.insert(key(path, size), { display, blurred });
+    if (size == m_targetSize) emit ready(path, display, blurred);
+}
+
+#include "backgroundpipeline.moc"
@@ -0,0 +1,54 @@
+#ifndef BACKGROUNDPIPELINE_H
+#define BACKGROUNDPIPELINE_H
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <QSize>
+#include <QStringList>
+
+class BackgroundWorker;
+
+// 背景图片预处理：在后台线程解码一次，按屏幕尺寸裁切缩放，并预先生成搜索框等毛玻璃区域用的模糊版本。
+// 结果以“文件内容哈希 + 目标尺寸”为键缓存在磁盘上，切换壁纸时界面只需加载现成的小图，
+// 模糊效果也变成普通的纹理采样而不是每帧运行的着色器
+class BackgroundPipeline : public QObject
+{
+    Q_OBJECT
+public:
+    struct Variants {
+        QString display;   // 缩放到屏幕尺寸的图片
+        QString blurred;   // 1/4 分辨率的模糊图片（已叠加亮度与饱和度调整）
+    };
+
+    explicit BackgroundPipeline(QObject *parent = nullptr);
+    ~BackgroundPipeline() override;
+
+    void setTargetSize(const QSize &size);
+    QSize targetSize() const { return m_targetSize; }
+
+    // 本次运行中已处理过的图片立即返回结果
+    bool lookup(const QString &path, Variants *out) const;
+    // 当前壁纸：插到队首优先处理
+    void request(const QString &path);
+    // 壁纸列表中的其它图片：排在队尾，空闲时处理
+    void prefetch(const QStringList &paths);
+
+    static QString cacheDir();
+
+signals:
+    void ready(const QString &path, const QString &display, const QString &blurred);
+
+private slots:
+    void onWorkerReady(const QString &path, const QSize &size, const QString &display, const QString &blurred);
+
+private:
+    static QString key(const QString &path, const QSize &size);
+
+    QThread m_thread;
+    BackgroundWorker *m_worker = nullptr;
+    QSize m_targetSize;
+    QHash<QString, Variants> m_done;
+};
+
+#endif // BACKGROUNDPIPELINE_H
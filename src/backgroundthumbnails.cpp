@@ -0,0 +1,141 @@
+#include "backgroundthumbnails.h"
+#include "trace.h"
+#include "metrics.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+static const int THUMB_WIDTH = 352;
+static const int THUMB_HEIGHT = 198;
+static const int THUMB_JPEG_QUALITY = 85;
+
+namespace BackgroundThumbnails {
+
+QSize thumbnailSize()
+{
+    return QSize(THUMB_WIDTH, THUMB_HEIGHT);
+}
+
+QString cacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+}
+
+QString url(const QString &imagePath)
+{
+    // base64url 只含 URL 安全字符：QQuickPixmap 会先对 id 做百分号解码，中文路径经百分号编码会被还原成原字符
+    return QStringLiteral("image://bgthumb/")
+         + QString::fromLatin1(imagePath.toUtf8().toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+}
+
+// 缩略图只需在文件变化时重新生成，不必像预模糊那样读取整个文件计算内容哈希
+static QString cacheBase(const QString &imagePath)
+{
+    const QFileInfo info(imagePath);
+    if (!info.exists()) return QString();
+    const QByteArray key = info.absoluteFilePath().toUtf8() + '|'
+                         + QByteArray::number(info.lastModified().toMSecsSinceEpoch()) + '|'
+                         + QByteArray::number(info.size()) + '|'
+                         + QByteArray::number(THUMB_WIDTH) + 'x' + QByteArray::number(THUMB_HEIGHT);
+    return cacheDir() + "/" + QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex());
+}
+
+QString cachedFile(const QString &imagePath)
+{
+    const QString base = cacheBase(imagePath);
+    if (base.isEmpty()) return QString();
+    for (const QString &ext : { QStringLiteral(".jpg"), QStringLiteral(".png") }) {
+        if (QFileInfo::exists(base + ext)) return base + ext;
+    }
+    return QString();
+}
+
+QString ensure(const QString &imagePath)
+{
+    TRACE_SCOPE("BackgroundThumbnails::ensure");
+    const QString existing = cachedFile(imagePath);
+    if (!existing.isEmpty()) {
+        Metrics::count(Metrics::ThumbnailCacheHits);
+        return existing;
+    }
+    Metrics::count(Metrics::ThumbnailCacheMisses);
+    const QString base = cacheBase(imagePath);
+    if (base.isEmpty()) return QString();
+
+    QImageReader reader(imagePath);
+    reader.setAutoTransform(true);
+    QSize sourceSize = reader.size();
+    if (sourceSize.isValid() && (reader.transformation() & QImageIOHandler::TransformationRotate90)) {
+        sourceSize.transpose();
+    }
+
+    // 让解码器直接输出接近缩略图大小的图像，避免解码整张原图
+    const QSize target = thumbnailSize();
+    if (sourceSize.isValid()) {
+        const double scale = qMax(double(target.width()) / sourceSize.width(),
+                                  double(target.height()) / sourceSize.height());
+        if (scale < 1.0) reader.setScaledSize((QSizeF(sourceSize) * scale).toSize());
+    }
+
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "BackgroundThumbnails - 无法解码:" << imagePath << reader.errorString();
+        return QString();
+    }
+
+    // 与界面的 PreserveAspectCrop 一致：缩放后居中裁切
+    QImage thumb = image.scaled(target, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    thumb = thumb.copy((thumb.width() - target.width()) / 2, (thumb.height() - target.height()) / 2,
+                       target.width(), target.height());
+
+    const QString filePath = base + (thumb.hasAlphaChannel() ? ".png" : ".jpg");
+    QDir().mkpath(cacheDir());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return QString();
+    QImageWriter writer(&file, filePath.endsWith(".png") ? "png" : "jpg");
+    writer.setQuality(THUMB_JPEG_QUALITY);
+    if (!writer.write(thumb)) {
+        file.cancelWriting();
+        return QString();
+    }
+    return file.commit() ? filePath : QString();
+}
+
+void remove(const QString &imagePath)
+{
+    const QString file = cachedFile(imagePath);
+    if (!file.isEmpty()) QFile::remove(file);
+}
+
+} // namespace BackgroundThumbnails
+
+BackgroundThumbnailProvider::BackgroundThumbnailProvider()
+    : QQuickImageProvider(QQuickImageProvider::Image, QQuickImageProvider::ForceAsynchronousImageLoading)
+{
+}
+
+QImage BackgroundThumbnailProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    // 正常情况下添加壁纸时已生成；旧版本保存的列表在第一次显示时补生成
+    const auto decoded = QByteArray::fromBase64Encoding(id.toLatin1(), QByteArray::Base64UrlEncoding
+                                                        | QByteArray::AbortOnBase64DecodingErrors);
+    if (!decoded) {
+        if (size) *size = QSize();
+        return QImage();
+    }
+    const QString imagePath = QString::fromUtf8(*decoded);
+    const QString file = BackgroundThumbnails::ensure(imagePath);
+    QImage image = file.isEmpty() ? QImage() : QImage(file);
+    if (!image.isNull() && !requestedSize.isEmpty() && image.width() > requestedSize.width()) {
+        image = image.scaled(requestedSize, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    }
+    if (size) *size = image.size();
+    return image;
+}
@@ -0,0 +1,40 @@
+#ifndef BACKGROUNDTHUMBNAILS_H
+#define BACKGROUNDTHUMBNAILS_H
+
+#include <QQuickImageProvider>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+// 背景管理窗口用的缩略图：按“路径 + 修改时间 + 文件大小”为键保存在磁盘缓存中，
+// 添加壁纸时由 BackgroundPipeline 在后台生成，界面通过 image://bgthumb/ 读取现成的小图
+namespace BackgroundThumbnails {
+
+// 缩略图像素尺寸（管理窗口中显示为 176×99，按 2 倍生成以适配高分屏）
+QSize thumbnailSize();
+
+// image://bgthumb/ 地址，路径以 UTF-8 编码后再做 base64url 编码
+QString url(const QString &imagePath);
+
+// 磁盘缓存中的缩略图文件；不存在时返回空字符串
+QString cachedFile(const QString &imagePath);
+
+// 解码并保存缩略图，已存在时直接返回缓存文件。可在任意线程调用
+QString ensure(const QString &imagePath);
+
+// 删除某张壁纸对应的缩略图缓存
+void remove(const QString &imagePath);
+
+QString cacheDir();
+
+} // namespace BackgroundThumbnails
+
+class BackgroundThumbnailProvider : public QQuickImageProvider
+{
+public:
+    BackgroundThumbnailProvider();
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+};
+
+#endif // BACKGROUNDTHUMBNAILS_H
@@ -0,0 +1,144 @@
+#include "edgehotzone.h"
+#include <QGuiApplication>
+#include <QPainter>
+#include <QRasterWindow>
+#include <QScreen>
+#include <QDebug>
+
+static const int EDGE_WIDTH = 6;          // 进入热区的宽度（与原先 QML 的 6 像素一致）
+static const int HYSTERESIS_WIDTH = 24;   // 进入后热区扩宽到此宽度，鼠标在边缘抖动不会反复进出
+static const int DEFAULT_DWELL_MS = 300;  // 在边缘停留多久才唤出
+
+// 热区窗口：无边框、置顶、不接受焦点，画满 alpha=1 的像素。
+// 完全透明的像素在部分平台（Windows 分层窗口）上会被鼠标穿透，所以保留极低的不透明度
+class EdgeWindow : public QRasterWindow
+{
+public:
+    explicit EdgeWindow(EdgeHotZone *zone) : m_zone(zone)
+    {
+        setFlags(Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint
+                 | Qt::WindowDoesNotAcceptFocus | Qt::BypassWindowManagerHint);
+        QSurfaceFormat format = this->format();
+        format.setAlphaBufferSize(8);
+        setFormat(format);
+        setTitle("EdgeHotZone");
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter painter(this);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.fillRect(QRect(QPoint(0, 0), size()), QColor(0, 0, 0, 1));
+    }
+
+    bool event(QEvent *event) override
+    {
+        if (event->type() == QEvent::Enter) m_zone->onPointerEntered();
+        else if (event->type() == QEvent::Leave) m_zone->onPointerLeft();
+        return QRasterWindow::event(event);
+    }
+
+private:
+    EdgeHotZone *m_zone;
+};
+
+EdgeHotZone::EdgeHotZone(QObject *parent)
+    : QObject(parent)
+{
+    m_dwellTimer.setSingleShot(true);
+    m_dwellTimer.setInterval(DEFAULT_DWELL_MS);
+    connect(&m_dwellTimer, &QTimer::timeout, this, &EdgeHotZone::onDwellTimeout);
+
+    m_screen = QGuiApplication::primaryScreen();
+    if (m_screen) {
+        connect(m_screen, &QScreen::geometryChanged, this, &EdgeHotZone::updateGeometry);
+    }
+    // Wayland 下普通窗口无法自行定位到屏幕边缘（需要 layer-shell），此时热区不可用
+    if (QGuiApplication::platformName().startsWith("wayland")) {
+        qWarning() << "EdgeHotZone - Wayland 下无法放置边缘窗口，边缘唤出不可用";
+    }
+}
+
+EdgeHotZone::~EdgeHotZone()
+{
+    delete m_window;
+}
+
+void EdgeHotZone::setArmed(bool armed)
+{
+    if (m_armed == armed) return;
+    m_armed = armed;
+
+    if (armed) {
+        if (!m_window) m_window = new EdgeWindow(this);
+        m_pointerInside = false;
+        updateGeometry();
+        m_window->show();
+    } else {
+        m_dwellTimer.stop();
+        m_pointerInside = false;
+        if (m_window) m_window->hide();
+        setTriggered(false);
+    }
+    emit armedChanged();
+}
+
+void EdgeHotZone::setDwellMs(int ms)
+{
+    ms = qMax(0, ms);
+    if (m_dwellTimer.interval() == ms) return;
+    m_dwellTimer.setInterval(ms);
+    emit dwellMsChanged();
+}
+
+void EdgeHotZone::updateGeometry()
+{
+    if (!m_window || !m_screen) return;
+    const QRect screen = m_screen->geometry();
+    const int width = m_pointerInside ? HYSTERESIS_WIDTH : EDGE_WIDTH;
+    m_window->setScreen(m_screen);
+    m_window->setGeometry(screen.right() - width + 1, screen.top(), width, screen.height());
+}
+
+void EdgeHotZone::countWakeup()
+{
+    ++m_wakeups;
+    emit wakeupsChanged();
+}
+
+void EdgeHotZone::onPointerEntered()
+{
+    countWakeup();
+    if (!m_armed || m_pointerInside) return;
+    m_pointerInside = true;
+    updateGeometry();
+    m_dwellTimer.start();
+}
+
+void EdgeHotZone::onPointerLeft()
+{
+    countWakeup();
+    if (!m_pointerInside) return;
+    m_pointerInside = false;
+    m_dwellTimer.stop();
+    updateGeometry();
+    setTriggered(false);
+}
+
+void EdgeHotZone::onDwellTimeout()
+{
+    countWakeup();
+    if (!m_armed || !m_pointerInside) return;
+    ++m_triggerCount;
+    setTriggered(true);
+}
+
+void EdgeHotZone::setTriggered(bool triggered)
+{
+    if (m_triggered == triggered) return;
+    m_triggered = triggered;
+    emit edgeStateChanged();
+    if (triggered) emit edgeEntered();
+    else emit edgeLeft();
+}
@@ -0,0 +1,66 @@
+#ifndef EDGEHOTZONE_H
+#define EDGEHOTZONE_H
+
+#include <QObject>
+#include <QTimer>
+
+class EdgeWindow;
+class QScreen;
+
+// 屏幕右侧边缘热区：取代 QML 中每 40 ms 轮询一次全局鼠标位置的做法。
+// 在屏幕边缘放置一个几乎透明、不抢焦点的窄窗口，由窗口系统投递的进入/离开事件驱动，
+// 鼠标不动时没有任何唤醒。停留延迟与进出滞回都在这里处理，QML 只接收 edgeEntered/edgeLeft。
+// 只有 armed 为 true（主窗口完全隐藏）时热区窗口才存在
+class EdgeHotZone : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool armed READ armed WRITE setArmed NOTIFY armedChanged)
+    Q_PROPERTY(int dwellMs READ dwellMs WRITE setDwellMs NOTIFY dwellMsChanged)
+    Q_PROPERTY(bool inside READ inside NOTIFY edgeStateChanged)
+    // 验证用：热区处理过的事件与定时器回调次数、成功唤出次数
+    Q_PROPERTY(int wakeups READ wakeups NOTIFY wakeupsChanged)
+    Q_PROPERTY(int triggerCount READ triggerCount NOTIFY wakeupsChanged)
+
+public:
+    explicit EdgeHotZone(QObject *parent = nullptr);
+    ~EdgeHotZone() override;
+
+    bool armed() const { return m_armed; }
+    void setArmed(bool armed);
+    int dwellMs() const { return m_dwellTimer.interval(); }
+    void setDwellMs(int ms);
+    bool inside() const { return m_triggered; }
+    int wakeups() const { return m_wakeups; }
+    int triggerCount() const { return m_triggerCount; }
+
+signals:
+    void edgeEntered();
+    void edgeLeft();
+    void armedChanged();
+    void dwellMsChanged();
+    void edgeStateChanged();
+    void wakeupsChanged();
+
+private slots:
+    void updateGeometry();
+    void onDwellTimeout();
+
+private:
+    friend class EdgeWindow;
+
+    void onPointerEntered();
+    void onPointerLeft();
+    void countWakeup();
+    void setTriggered(bool triggered);
+
+    EdgeWindow *m_window = nullptr;
+    QScreen *m_screen = nullptr;
+    QTimer m_dwellTimer;
+    bool m_armed = false;
+    bool m_pointerInside = false;   // 鼠标在热区窗口内（含滞回带）
+    bool m_triggered = false;       // 已停留足够时间并发出 edgeEntered
+    int m_wakeups = 0;
+    int m_triggerCount = 0;
+};
+
+#endif // EDGEHOTZONE_H
@@ -0,0 +1,327 @@
+#include "equalizer.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EQUALIZER_SSE2 1
+#endif
+
+static const double PI = 3.14159265358979323846;
+static const qsizetype SUBBLOCK_FRAMES = 32;     // 参数平滑与系数更新的粒度
+static const double SMOOTHING_TIME = 0.02;       // 约 20 ms 逼近目标值
+static const float CLIP_THRESHOLD = 0.891f;      // -1 dBFS 以上开始软削波
+static const float MIN_GAIN_DB = -24.0f;
+static const float MAX_GAIN_DB = 24.0f;
+
+static const double DEFAULT_FREQUENCIES[Equalizer::BAND_COUNT] = {
+    31.0, 62.0, 125.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0, 16000.0
+};
+
+struct EqPreset {
+    const char *name;
+    float gains[Equalizer::BAND_COUNT];
+};
+
+static const EqPreset PRESETS[] = {
+    { "Flat",         {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 } },
+    { "Bass Boost",   {  6,  5,  4,  2,  0,  0,  0,  0,  0,  0 } },
+    { "Treble Boost", {  0,  0,  0,  0,  0,  1,  2,  4,  5,  6 } },
+    { "Rock",         {  5,  4,  2, -1, -2, -1,  2,  3,  4,  4 } },
+    { "Pop",          { -1,  1,  3,  4,  3,  0, -1, -1,  1,  2 } },
+    { "Jazz",         {  3,  2,  1,  2, -1, -1,  0,  1,  2,  3 } },
+    { "Classical",    {  4,  3,  2,  1, -1, -1,  0,  2,  3,  4 } },
+    { "Vocal",        { -2, -2, -1,  1,  3,  4,  3,  1,  0, -1 } },
+};
+
+static float dbToLinear(float db)
+{
+    return std::pow(10.0f, db / 20.0f);
+}
+
+Equalizer::Equalizer(int sampleRate, int channels)
+    : m_sampleRate(sampleRate)
+    , m_channels(channels)
+    , m_smoothing(float(1.0 - std::exp(-double(SUBBLOCK_FRAMES) / (SMOOTHING_TIME * sampleRate))))
+{
+    for (int b = 0; b < BAND_COUNT; ++b) {
+        m_targetFrequency[b].store(float(DEFAULT_FREQUENCIES[b]));
+        m_targetGainDb[b].store(0.0f);
+        m_targetQ[b].store(1.0f);
+        m_current[b].frequency = float(DEFAULT_FREQUENCIES[b]);
+        designBand(b);
+    }
+}
+
+void Equalizer::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Equalizer::setPreamp(double gainDb)
+{
+    m_targetPreampDb.store(std::clamp(gainDb, double(MIN_GAIN_DB), double(MAX_GAIN_DB)), std::memory_order_relaxed);
+}
+
+void Equalizer::setBandGain(int band, double gainDb)
+{
+    if (band < 0 || band >= BAND_COUNT) return;
+    m_targetGainDb[band].store(std::clamp(float(gainDb), MIN_GAIN_DB, MAX_GAIN_DB), std::memory_order_relaxed);
+}
+
+void Equalizer::setBand(int band, double frequencyHz, double gainDb, double q)
+{
+    if (band < 0 || band >= BAND_COUNT) return;
+    const double nyquistSafe = m_sampleRate * 0.45;
+    m_targetFrequency[band].store(float(std::clamp(frequencyHz, 20.0, nyquistSafe)), std::memory_order_relaxed);
+    m_targetQ[band].store(float(std::clamp(q, 0.1, 10.0)), std::memory_order_relaxed);
+    setBandGain(band, gainDb);
+}
+
+double Equalizer::bandGain(int band) const
+{
+    return band >= 0 && band < BAND_COUNT ? m_targetGainDb[band].load(std::memory_order_relaxed) : 0.0;
+}
+
+double Equalizer::bandFrequency(int band) const
+{
+    return band >= 0 && band < BAND_COUNT ? m_targetFrequency[band].load(std::memory_order_relaxed) : 0.0;
+}
+
+double Equalizer::bandQ(int band) const
+{
+    return band >= 0 && band < BAND_COUNT ? m_targetQ[band].load(std::memory_order_relaxed) : 0.0;
+}
+
+double Equalizer::defaultFrequency(int band)
+{
+    return band >= 0 && band < BAND_COUNT ? DEFAULT_FREQUENCIES[band] : 0.0;
+}
+
+QStringList Equalizer::presetNames()
+{
+    QStringList names;
+    for (const EqPreset &preset : PRESETS) names << QString::fromLatin1(preset.name);
+    return names;
+}
+
+QVector<double> Equalizer::presetGains(const QString &name)
+{
+    for (const EqPreset &preset : PRESETS) {
+        if (name == QLatin1String(preset.name)) {
+            return QVector<double>(preset.gains, preset.gains + BAND_COUNT);
+        }
+    }
+    return QVector<double>();
+}
+
+// RBJ Audio EQ Cookbook：首段低架、末段高架，其余为峰值滤波器
+void Equalizer::designBand(int band)
+{
+    const Params &p = m_current[band];
+    Coeffs &c = m_coeffs[band];
+    m_active[band] = std::fabs(p.gainDb) >= 0.01f;
+    if (!m_active[band]) {
+        c = Coeffs();
+        std::fill(m_z1[band], m_z1[band] + MAX_CHANNELS, 0.0f);
+        std::fill(m_z2[band], m_z2[band] + MAX_CHANNELS, 0.0f);
+        return;
+    }
+
+    const double A = std::pow(10.0, p.gainDb / 40.0);
+    const double w0 = 2.0 * PI * std::min<double>(p.frequency, m_sampleRate * 0.45) / m_sampleRate;
+    const double cosw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * p.q);
+    const double sqrtA2alpha = 2.0 * std::sqrt(A) * alpha;
+
+    double b0, b1, b2, a0, a1, a2;
+    if (band == 0) {
+        b0 = A * ((A + 1) - (A - 1) * cosw + sqrtA2alpha);
+        b1 = 2 * A * ((A - 1) - (A + 1) * cosw);
+        b2 = A * ((A + 1) - (A - 1) * cosw - sqrtA2alpha);
+        a0 = (A + 1) + (A - 1) * cosw + sqrtA2alpha;
+        a1 = -2 * ((A - 1) + (A + 1) * cosw);
+        a2 = (A + 1) + (A - 1) * cosw - sqrtA2alpha;
+    } else if (band == BAND_COUNT - 1) {
+        b0 = A * ((A + 1) + (A - 1) * cosw + sqrtA2alpha);
+        b1 = -2 * A * ((A - 1) + (A + 1) * cosw);
+        b2 = A * ((A + 1) + (A - 1) * cosw - sqrtA2alpha);
+        a0 = (A + 1) - (A - 1) * cosw + sqrtA2alpha;
+        a1 = 2 * ((A - 1) - (A + 1) * cosw);
+        a2 = (A + 1) - (A - 1) * cosw - sqrtA2alpha;
+    } else {
+        b0 = 1 + alpha * A;
+        b1 = -2 * cosw;
+        b2 = 1 - alpha * A;
+        a0 = 1 + alpha / A;
+        a1 = -2 * cosw;
+        a2 = 1 - alpha / A;
+    }
+
+    c.b0 = float(b0 / a0);
+    c.b1 = float(b1 / a0);
+    c.b2 = float(b2 / a0);
+    c.a1 = float(a1 / a0);
+    c.a2 = float(a2 / a0);
+}
+
+// 当前参数向目标值逼近一步，返回是否仍未到位
+bool Equalizer::updateSmoothing()
+{
+    const bool enabled = m_enabled.load(std::memory_order_relaxed);
+    bool moving = false;
+
+    auto approach = [this](float &value, float target, float epsilon) {
+        if (value == target) return false;
+        value += (target - value) * m_smoothing;
+        if (std::fabs(target - value) < epsilon) value = target;
+        return true;
+    };
+
+    for (int b = 0; b < BAND_COUNT; ++b) {
+        Params &p = m_current[b];
+        const float gain = enabled ? m_targetGainDb[b].load(std::memory_order_relaxed) : 0.0f;
+        bool changed = approach(p.gainDb, gain, 0.01f);
+        changed |= approach(p.frequency, m_targetFrequency[b].load(std::memory_order_relaxed), 0.1f);
+        changed |= approach(p.q, m_targetQ[b].load(std::memory_order_relaxed), 0.001f);
+        if (changed) {
+            designBand(b);
+            moving = true;
+        }
+    }
+
+    const float preamp = enabled ? float(m_targetPreampDb.load(std::memory_order_relaxed)) : 0.0f;
+    moving |= approach(m_currentPreampDb, preamp, 0.01f);
+    return moving;
+}
+
+void Equalizer::process(float *samples, qsizetype frames)
+{
+    if (m_channels > MAX_CHANNELS || frames <= 0) return;
+
+    // 关闭且已平滑回平直响应时完全旁路
+    if (m_settled && !m_enabled.load(std::memory_order_relaxed) && m_currentPreampDb == 0.0f) {
+        bool flat = true;
+        for (int b = 0; b < BAND_COUNT && flat; ++b) flat = !m_active[b];
+        if (flat) return;
+    }
+
+#ifdef EQUALIZER_SSE2
+    // 极小的滤波器状态按零处理，避免非规格化数拖慢运算
+    const unsigned int csr = _mm_getcsr();
+    _mm_setcsr(csr | 0x8040);
+#endif
+
+    for (qsizetype done = 0; done < frames; done += SUBBLOCK_FRAMES) {
+        const qsizetype n = std::min(SUBBLOCK_FRAMES, frames - done);
+        const float preampFrom = dbToLinear(m_currentPreampDb);
+        m_settled = !updateSmoothing();
+        const float preampTo = dbToLinear(m_currentPreampDb);
+        processBlock(samples + done * m_channels, n, preampFrom, preampTo);
+    }
+
+#ifdef EQUALIZER_SSE2
+    _mm_setcsr(csr);
+#endif
+
+    softClip(samples, frames * m_channels);
+}
+
+void Equalizer::processBlock(float *samples, qsizetype frames, float preampFrom, float preampTo)
+{
+    int bands[BAND_COUNT];
+    int activeCount = 0;
+    for (int b = 0; b < BAND_COUNT; ++b) {
+        if (m_active[b]) bands[activeCount++] = b;
+    }
+    const int channels = m_channels;
+    const float preampStep = (preampTo - preampFrom) / float(frames);
+
+#ifdef EQUALIZER_SSE2
+    // 每个声道占一条 SSE 通道，整条级联对所有声道同时计算
+    __m128 b0[BAND_COUNT], b1[BAND_COUNT], b2[BAND_COUNT], a1[BAND_COUNT], a2[BAND_COUNT];
+    __m128 z1[BAND_COUNT], z2[BAND_COUNT];
+    for (int i = 0; i < activeCount; ++i) {
+        const int b = bands[i];
+        b0[i] = _mm_set1_ps(m_coeffs[b].b0);
+        b1[i] = _mm_set1_ps(m_coeffs[b].b1);
+        b2[i] = _mm_set1_ps(m_coeffs[b].b2);
+        a1[i] = _mm_set1_ps(m_coeffs[b].a1);
+        a2[i] = _mm_set1_ps(m_coeffs[b].a2);
+        z1[i] = _mm_load_ps(m_z1[b]);
+        z2[i] = _mm_load_ps(m_z2[b]);
+    }
+
+    float preamp = preampFrom;
+    alignas(16) float lane[MAX_CHANNELS] = {};
+    for (qsizetype f = 0; f < frames; ++f) {
+        float *frame = samples + f * channels;
+        __m128 x;
+        if (channels == 2) {
+            x = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(frame)));
+        } else {
+            std::memcpy(lane, frame, size_t(channels) * sizeof(float));
+            x = _mm_load_ps(lane);
+        }
+        preamp += preampStep;
+        x = _mm_mul_ps(x, _mm_set1_ps(preamp));
+
+        // 转置直接 II 型：y = b0·x + z1；z1 = b1·x − a1·y + z2；z2 = b2·x − a2·y
+        for (int i = 0; i < activeCount; ++i) {
+            const __m128 y = _mm_add_ps(_mm_mul_ps(b0[i], x), z1[i]);
+            z1[i] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1[i], x), _mm_mul_ps(a1[i], y)), z2[i]);
+            z2[i] = _mm_sub_ps(_mm_mul_ps(b2[i], x), _mm_mul_ps(a2[i], y));
+            x = y;
+        }
+
+        if (channels == 2) {
+            _mm_store_sd(reinterpret_cast<double *>(frame), _mm_castps_pd(x));
+        } else {
+            _mm_store_ps(lane, x);
+            std::memcpy(frame, lane, size_t(channels) * sizeof(float));
+        }
+    }
+
+    for (int i = 0; i < activeCount; ++i) {
+        _mm_store_ps(m_z1[bands[i]], z1[i]);
+        _mm_store_ps(m_z2[bands[i]], z2[i]);
+    }
+#else
+    float preamp = preampFrom;
+    for (qsizetype f = 0; f < frames; ++f) {
+        preamp += preampStep;
+        for (int c = 0; c < channels; ++c) {
+            float x = samples[f * channels + c] * preamp;
+            for (int i = 0; i < activeCount; ++i) {
+                const int b = bands[i];
+                const Coeffs &k = m_coeffs[b];
+                const float y = k.b0 * x + m_z1[b][c];
+                m_z1[b][c] = k.b1 * x - k.a1 * y + m_z2[b][c];
+                m_z2[b][c] = k.b2 * x - k.a2 * y;
+                x = y;
+            }
+            samples[f * channels + c] = x;
+        }
+    }
+#endif
+}
+
+// 超过阈值的部分经 tanh 压缩到 ±1 以内，阈值以下保持线性
+void Equalizer::softClip(float *samples, qsizetype count)
+{
+    const float knee = 1.0f - CLIP_THRESHOLD;
+    for (qsizetype i = 0; i < count; ++i) {
+        const float v = samples[i];
+        const float a = std::fabs(v);
+        if (a <= CLIP_THRESHOLD) continue;
+        const float shaped = CLIP_THRESHOLD + knee * std::tanh((a - CLIP_THRESHOLD) / knee);
+        samples[i] = v < 0.0f ? -shaped : shaped;
+    }
+}
+
+void Equalizer::reset()
+{
+    std::memset(m_z1, 0, sizeof(m_z1));
+    std::memset(m_z2, 0, sizeof(m_z2));
+}
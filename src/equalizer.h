@@ -0,0 +1,80 @@
+#ifndef EQUALIZER_H
+#define EQUALIZER_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+
+// 10 段参数均衡器（双二阶滤波器级联：低架 + 8 个峰值 + 高架），作用于交错 float PCM
+// - 控制端：任意线程调用 setXxx()，参数以原子量发布，不加锁
+// - 音频线程：process() 每 32 帧一个子块，把当前参数平滑地逼近目标值后重算系数，拖动滑块时无拉链噪声
+// - 各声道占 SSE 寄存器的一条通道同时滤波；超出 -1 dBFS 的峰值经软削波收敛，避免硬削波失真
+class Equalizer
+{
+public:
+    static const int BAND_COUNT = 10;
+    static const int MAX_CHANNELS = 4;
+
+    Equalizer(int sampleRate, int channels);
+
+    // 控制端
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void setPreamp(double gainDb);
+    double preamp() const { return m_targetPreampDb.load(std::memory_order_relaxed); }
+    void setBandGain(int band, double gainDb);
+    void setBand(int band, double frequencyHz, double gainDb, double q);
+    double bandGain(int band) const;
+    double bandFrequency(int band) const;
+    double bandQ(int band) const;
+
+    static double defaultFrequency(int band);
+    static QStringList presetNames();
+    static QVector<double> presetGains(const QString &name); // 未知预设返回空
+
+    // 音频线程：原地处理 frames 帧
+    void process(float *samples, qsizetype frames);
+    void reset();
+
+    int sampleRate() const { return m_sampleRate; }
+    int channels() const { return m_channels; }
+
+private:
+    struct Params {
+        float frequency = 1000.0f;
+        float gainDb = 0.0f;
+        float q = 1.0f;
+    };
+    struct Coeffs {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    bool updateSmoothing();
+    void designBand(int band);
+    void processBlock(float *samples, qsizetype frames, float preampFrom, float preampTo);
+    void softClip(float *samples, qsizetype count);
+
+    const int m_sampleRate;
+    const int m_channels;
+    const float m_smoothing;   // 每个子块向目标值逼近的比例
+
+    // 控制端写入的目标参数
+    std::atomic<float> m_targetFrequency[BAND_COUNT];
+    std::atomic<float> m_targetGainDb[BAND_COUNT];
+    std::atomic<float> m_targetQ[BAND_COUNT];
+    std::atomic<double> m_targetPreampDb { 0.0 };
+    std::atomic<bool> m_enabled { false };
+
+    // 以下仅音频线程访问
+    Params m_current[BAND_COUNT];
+    Coeffs m_coeffs[BAND_COUNT];
+    bool m_active[BAND_COUNT] = {};   // 增益为 0 的频段直接跳过
+    float m_currentPreampDb = 0.0f;
+    alignas(16) float m_z1[BAND_COUNT][MAX_CHANNELS] = {};
+    alignas(16) float m_z2[BAND_COUNT][MAX_CHANNELS] = {};
+    bool m_settled = true;
+};
+
+#endif // EQUALIZER_H
@@ -0,0 +1,137 @@
+#include "gaplessinfo.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QByteArray>
+#include <QRegularExpression>
+
+static const qint64 MP3_DECODER_DELAY = 529;    // MP3 解码器固有延迟（LAME 约定）
+static const qint64 SCAN_BYTES = 512 * 1024;    // iTunSMPB 可能位于文件头或尾部的 moov 中
+
+static quint32 readBE32(const QByteArray &b, int pos)
+{
+    return (quint32(quint8(b[pos])) << 24) | (quint32(quint8(b[pos + 1])) << 16)
+         | (quint32(quint8(b[pos + 2])) << 8) | quint32(quint8(b[pos + 3]));
+}
+
+static GaplessInfo parseMp3(QFile &file)
+{
+    GaplessInfo info;
+    QByteArray head = file.read(SCAN_BYTES);
+    int pos = 0;
+
+    // 跳过 ID3v2 标签
+    if (head.size() >= 10 && head.startsWith("ID3")) {
+        const int size = (quint8(head[6]) & 0x7F) << 21 | (quint8(head[7]) & 0x7F) << 14
+                       | (quint8(head[8]) & 0x7F) << 7 | (quint8(head[9]) & 0x7F);
+        pos = 10 + size + ((quint8(head[5]) & 0x10) ? 10 : 0);
+        if (pos + 4096 > head.size()) {
+            file.seek(pos);
+            head = file.read(8192);
+            pos = 0;
+        }
+    }
+
+    // 查找第一个 Layer III 帧头
+    const int limit = qMin(int(head.size()) - 4, pos + 4096);
+    for (; pos < limit; ++pos) {
+        if (quint8(head[pos]) == 0xFF && (quint8(head[pos + 1]) & 0xE0) == 0xE0
+            && ((quint8(head[pos + 1]) >> 1) & 3) == 1) {
+            break;
+        }
+    }
+    if (pos >= limit) return info;
+
+    const int versionBits = (quint8(head[pos + 1]) >> 3) & 3; // 3: MPEG1, 2: MPEG2, 0: MPEG2.5
+    const int rateIndex = (quint8(head[pos + 2]) >> 2) & 3;
+    const bool mono = ((quint8(head[pos + 3]) >> 6) & 3) == 3;
+    if (versionBits == 1 || rateIndex == 3) return info;
+
+    static const int rates[3][3] = { { 44100, 48000, 32000 }, { 22050, 24000, 16000 }, { 11025, 12000, 8000 } };
+    const int row = versionBits == 3 ? 0 : (versionBits == 2 ? 1 : 2);
+    const bool mpeg1 = versionBits == 3;
+    const int samplesPerFrame = mpeg1 ? 1152 : 576;
+    const int sideInfo = mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17);
+
+    int p = pos + 4 + sideInfo;
+    if (p + 8 > head.size()) return info;
+    const QByteArray tag = head.mid(p, 4);
+    if (tag != "Xing" && tag != "Info") return info;
+
+    const quint32 flags = readBE32(head, p + 4);
+    p += 8;
+    qint64 frames = 0;
+    if (flags & 0x1) { frames = readBE32(head, p); p += 4; }
+    if (flags & 0x2) p += 4;    // 字节数
+    if (flags & 0x4) p += 100;  // TOC
+    if (flags & 0x8) p += 4;    // 质量
+    if (frames <= 0 || p + 24 > head.size()) return info;
+
+    // LAME 扩展：编码器版本 9 字节后第 21 字节起为 12 位 delay + 12 位 padding
+    const qint64 delay = (qint64(quint8(head[p + 21])) << 4) | (quint8(head[p + 22]) >> 4);
+    const qint64 padding = (qint64(quint8(head[p + 22]) & 0x0F) << 8) | quint8(head[p + 23]);
+    const qint64 total = frames * samplesPerFrame;
+    if (delay + padding >= total) return info;
+
+    info.valid = true;
+    info.sampleRate = rates[row][rateIndex];
+    info.startTrim = delay + MP3_DECODER_DELAY;
+    info.endTrim = qMax<qint64>(0, padding - MP3_DECODER_DELAY);
+    info.validFrames = total - delay - padding;
+    return info;
+}
+
+static GaplessInfo parseITunSmpb(QFile &file)
+{
+    GaplessInfo info;
+    QByteArray data = file.read(SCAN_BYTES);
+    if (file.size() > SCAN_BYTES) {
+        file.seek(qMax<qint64>(SCAN_BYTES, file.size() - SCAN_BYTES));
+        data += file.read(SCAN_BYTES);
+    }
+
+    const int tagPos = data.indexOf("iTunSMPB");
+    if (tagPos < 0) return info;
+
+    // 形如 " 00000000 00000840 000001CA 00000000003F1234 ..."
+    static const QRegularExpression re(
+        R"(([0-9A-Fa-f]{8})\s+([0-9A-Fa-f]{8})\s+([0-9A-Fa-f]{8})\s+([0-9A-Fa-f]{16}))");
+    const QString text = QString::fromLatin1(data.mid(tagPos, 200));
+    const QRegularExpressionMatch m = re.match(text);
+    if (!m.hasMatch()) return info;
+
+    info.startTrim = m.captured(2).toLongLong(nullptr, 16);
+    info.endTrim = m.captured(3).toLongLong(nullptr, 16);
+    info.validFrames = m.captured(4).toLongLong(nullptr, 16);
+
+    // AudioSampleEntry：'mp4a' 类型字段之后第 24 字节为 16.16 定点采样率
+    const int entry = data.indexOf("mp4a");
+    info.sampleRate = 44100;
+    if (entry >= 0 && entry + 30 <= data.size()) {
+        const int rate = (quint8(data[entry + 28]) << 8) | quint8(data[entry + 29]);
+        if (rate > 0) info.sampleRate = rate;
+    }
+    info.valid = info.validFrames > 0;
+    return info;
+}
+
+GaplessInfo GaplessInfo::fromFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return GaplessInfo();
+
+    const QString ext = QFileInfo(filePath).suffix().toLower();
+    if (ext == "mp3") return parseMp3(file);
+    if (ext == "m4a" || ext == "mp4" || ext == "aac") return parseITunSmpb(file);
+    return GaplessInfo();
+}
+
+GaplessInfo GaplessInfo::scaledTo(int outputRate) const
+{
+    if (!valid || sampleRate <= 0 || outputRate == sampleRate) return *this;
+    GaplessInfo scaled = *this;
+    scaled.sampleRate = outputRate;
+    scaled.startTrim = startTrim * outputRate / sampleRate;
+    scaled.endTrim = endTrim * outputRate / sampleRate;
+    scaled.validFrames = validFrames * outputRate / sampleRate;
+    return scaled;
+}
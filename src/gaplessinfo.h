@@ -0,0 +1,21 @@
+#ifndef GAPLESSINFO_H
+#define GAPLESSINFO_H
+
+#include <QString>
+
+// 编码器延迟/填充信息（用于无缝播放时裁剪首尾静音）
+// - MP3：Xing/Info 头中的 LAME 扩展（enc_delay / enc_padding，另加解码器固有的 529 帧延迟）
+// - AAC/M4A：iTunSMPB 元数据（priming / padding / 原始采样数）
+struct GaplessInfo {
+    bool valid = false;
+    int sampleRate = 0;      // 以下帧数所基于的源采样率
+    qint64 startTrim = 0;    // 解码输出开头应丢弃的帧数
+    qint64 endTrim = 0;      // 解码输出结尾应丢弃的帧数
+    qint64 validFrames = 0;  // 有效帧数（裁剪后的长度）
+
+    static GaplessInfo fromFile(const QString &filePath);
+    // 换算到输出采样率
+    GaplessInfo scaledTo(int outputRate) const;
+};
+
+#endif // GAPLESSINFO_H
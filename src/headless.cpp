@@ -0,0 +1,274 @@
+#include "headless.h"
+#include "libraryservice.h"
+#include "settingsstore.h"
+#include "sessionsnapshot.h"
+#include "backgroundthumbnails.h"
+#include "gaplessinfo.h"
+#include "jobscheduler.h"
+#include "loudnesscache.h"
+#include "metrics.h"
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cstdio>
+#include <cstring>
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+namespace {
+
+// 每秒处理数，耗时过短时按 1 ms 计
+double perSecond(int count, qint64 ms)
+{
+    return count * 1000.0 / double(qMax<qint64>(1, ms));
+}
+
+QJsonObject histogram(const QVariantMap &snapshot, const char *name)
+{
+    return QJsonObject::fromVariantMap(snapshot.value("histograms").toMap().value(name).toMap());
+}
+
+QJsonObject scan(LibraryService &library, const QString &folder)
+{
+    Metrics::instance()->reset();
+    QElapsedTimer timer;
+    timer.start();
+    const LibrarySnapshotPtr snapshot = library.scanAndWait(folder);
+    const qint64 ms = timer.elapsed();
+
+    const QVariantMap metrics = Metrics::instance()->snapshot();
+    const QVariantMap counters = metrics.value("counters").toMap();
+    const int files = counters.value("filesScanned").toInt();
+
+    QJsonObject result;
+    result["folder"] = folder;
+    result["files"] = files;
+    result["tracks"] = snapshot->tracks.size();
+    result["elapsedMs"] = ms;
+    result["filesPerSecond"] = perSecond(files, ms);
+    result["metadataTimeouts"] = counters.value("metadataTimeouts").toInt();
+    result["probeFailuresSkipped"] = counters.value("probeFailuresSkipped").toInt();
+    result["probeHelperCrashes"] = counters.value("probeHelperCrashes").toInt();
+    result["lyricIndexHits"] = counters.value("lyricIndexHits").toInt();
+    result["lyricIndexMisses"] = counters.value("lyricIndexMisses").toInt();
+    result["probeLatency"] = histogram(metrics, "probeLatency");
+    return result;
+}
+
+// 响度分析：与界面共用任务调度器，但使用全部核且不限预算；已有结果且文件未变的曲目跳过
+void analyzeLoudness(const TrackList &tracks, QJsonObject *result)
+{
+    LoudnessCache cache;
+    cache.load(LoudnessCache::defaultCachePath());
+    QElapsedTimer timer;
+    timer.start();
+
+    JobScheduler scheduler(nullptr, QThread::idealThreadCount());
+    scheduler.setBudget(100, 100, 100);
+    scheduler.registerKind("loudness", [&cache](const QString &path, JobScheduler::Context &context) {
+        return cache.analyze(path, [&context]() { return context.isCancelled(); });
+    });
+    QEventLoop loop;
+    QObject::connect(&scheduler, &JobScheduler::jobFinished, &loop, [&]() {
+        if (scheduler.pendingCount() == 0) loop.quit();
+    });
+
+    int cached = 0, queued = 0;
+    for (const TrackItem &track : tracks) {
+        const QString path = track.url.toLocalFile();
+        if (cache.lookup(path, nullptr)) {
+            ++cached;
+        } else {
+            scheduler.submit("loudness", path, JobScheduler::Idle);
+            ++queued;
+        }
+    }
+    if (scheduler.pendingCount() > 0) loop.exec();
+    scheduler.shutdown(QString());
+    const qint64 ms = timer.elapsed();
+    if (cache.isDirty() && !cache.save(LoudnessCache::defaultCachePath())) {
+        std::fprintf(stderr, "保存响度分析结果失败\n");
+    }
+
+    (*result)["loudnessCached"] = cached;
+    (*result)["loudnessAnalyzed"] = queued;
+    (*result)["loudnessWorkers"] = scheduler.workerCount();
+    (*result)["loudnessMs"] = ms;
+    (*result)["loudnessTracksPerSecond"] = perSecond(queued, ms);
+}
+
+// 分析任务：逐首读取无缝播放信息（PCM 管线切歌时需要）与响度，并生成背景管理窗口的缩略图
+QJsonObject analyze(const TrackList &tracks, const QStringList &backgrounds)
+{
+    QElapsedTimer timer;
+    timer.start();
+    int gapless = 0;
+    for (const TrackItem &track : tracks) {
+        if (GaplessInfo::fromFile(track.url.toLocalFile()).valid) ++gapless;
+    }
+    const qint64 gaplessMs = timer.restart();
+
+    int thumbnails = 0;
+    for (const QString &path : backgrounds) {
+        if (!BackgroundThumbnails::ensure(path).isEmpty()) ++thumbnails;
+    }
+    const qint64 thumbnailMs = timer.elapsed();
+
+    QJsonObject result;
+    result["tracks"] = tracks.size();
+    result["gaplessInfo"] = gapless;
+    result["gaplessMs"] = gaplessMs;
+    result["tracksPerSecond"] = perSecond(tracks.size(), gaplessMs);
+    result["backgrounds"] = backgrounds.size();
+    result["thumbnails"] = thumbnails;
+    result["thumbnailMs"] = thumbnailMs;
+    analyzeLoudness(tracks, &result);
+    return result;
+}
+
+QJsonObject verify(const LibraryService &library, const QStringList &backgrounds, bool *ok)
+{
+    const LibraryService::IndexCheck index = library.verifyLyricIndex();
+
+    SessionSnapshot snapshot;
+    const bool hasSnapshot = QFileInfo::exists(SessionSnapshot::defaultPath());
+    const bool snapshotValid = hasSnapshot && snapshot.load(SessionSnapshot::defaultPath());
+
+    int thumbnailsMissing = 0;
+    for (const QString &path : backgrounds) {
+        if (QFileInfo::exists(path) && BackgroundThumbnails::cachedFile(path).isEmpty()) ++thumbnailsMissing;
+    }
+
+    *ok = index.stale == 0 && index.missing == 0 && (!hasSnapshot || snapshotValid) && thumbnailsMissing == 0;
+
+    QJsonObject result;
+    result["lyricIndexDocuments"] = index.documents;
+    result["lyricIndexCurrent"] = index.current;
+    result["lyricIndexStale"] = index.stale;
+    result["lyricIndexMissing"] = index.missing;
+    result["sessionSnapshot"] = !hasSnapshot ? "none" : snapshotValid ? "ok" : "corrupt";
+    result["thumbnailsMissing"] = thumbnailsMissing;
+    result["probeFailures"] = library.snapshot()->probeFailures;
+    result["ok"] = *ok;
+    return result;
+}
+
+void printText(const QJsonObject &report)
+{
+    if (report.contains("scan")) {
+        const QJsonObject s = report["scan"].toObject();
+        const QJsonObject probe = s["probeLatency"].toObject();
+        std::printf("scan      %s\n", qPrintable(s["folder"].toString()));
+        std::printf("  %d files, %d tracks in %.2f s (%.1f files/s)\n",
+                    s["files"].toInt(), s["tracks"].toInt(), s["elapsedMs"].toDouble() / 1000.0,
+                    s["filesPerSecond"].toDouble());
+        std::printf("  metadata probe  p50 %.1f ms  p95 %.1f ms  max %.1f ms  timeouts %d\n",
+                    probe["p50Ms"].toDouble(), probe["p95Ms"].toDouble(), probe["maxMs"].toDouble(),
+                    s["metadataTimeouts"].toInt());
+        std::printf("  known failures  %d skipped, %d helper crashes\n",
+                    s["probeFailuresSkipped"].toInt(), s["probeHelperCrashes"].toInt());
+        std::printf("  lyric index     %d reused, %d rebuilt\n",
+                    s["lyricIndexHits"].toInt(), s["lyricIndexMisses"].toInt());
+    }
+    if (report.contains("analyze")) {
+        const QJsonObject a = report["analyze"].toObject();
+        std::printf("analyze\n");
+        std::printf("  gapless info    %d / %d tracks in %.2f s (%.1f tracks/s)\n",
+                    a["gaplessInfo"].toInt(), a["tracks"].toInt(), a["gaplessMs"].toDouble() / 1000.0,
+                    a["tracksPerSecond"].toDouble());
+        std::printf("  thumbnails      %d / %d backgrounds in %.2f s\n",
+                    a["thumbnails"].toInt(), a["backgrounds"].toInt(), a["thumbnailMs"].toDouble() / 1000.0);
+        std::printf("  loudness        %d analysed, %d cached in %.2f s on %d threads (%.1f tracks/s)\n",
+                    a["loudnessAnalyzed"].toInt(), a["loudnessCached"].toInt(), a["loudnessMs"].toDouble() / 1000.0,
+                    a["loudnessWorkers"].toInt(), a["loudnessTracksPerSecond"].toDouble());
+    }
+    if (report.contains("verify")) {
+        const QJsonObject v = report["verify"].toObject();
+        std::printf("verify-cache      %s\n", v["ok"].toBool() ? "ok" : "PROBLEMS FOUND");
+        std::printf("  lyric index     %d documents: %d current, %d stale, %d missing\n",
+                    v["lyricIndexDocuments"].toInt(), v["lyricIndexCurrent"].toInt(),
+                    v["lyricIndexStale"].toInt(), v["lyricIndexMissing"].toInt());
+        std::printf("  session         %s\n", qPrintable(v["sessionSnapshot"].toString()));
+        std::printf("  thumbnails      %d missing\n", v["thumbnailsMissing"].toInt());
+        std::printf("  probe failures  %d files skipped until they change\n", v["probeFailures"].toInt());
+    }
+}
+
+} // namespace
+
+namespace Headless {
+
+bool requested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) return true;
+    }
+    return false;
+}
+
+int run(int argc, char *argv[])
+{
+#ifdef WIN32
+    // 程序按 GUI 子系统链接，从命令行启动时把输出接到父进程的控制台
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        std::freopen("CONOUT$", "w", stdout);
+        std::freopen("CONOUT$", "w", stderr);
+    }
+#endif
+    // 不连接显示服务器；QImage 与 QMediaPlayer 的元数据读取在 offscreen 平台下照常工作
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("MusicPlayer headless mode");
+    parser.addHelpOption();
+    parser.addOption({ "headless", "不创建窗口，运行以下任务后退出" });
+    parser.addOption({ "scan", "扫描曲库目录并更新歌词索引缓存（默认使用设置中的音乐文件夹）", "dir" });
+    parser.addOption({ "analyze", "运行分析任务：无缝播放信息、响度、背景缩略图" });
+    parser.addOption({ "verify-cache", "校验歌词索引、会话快照与缩略图缓存" });
+    parser.addOption({ "json", "以 JSON 输出统计" });
+    parser.process(app);
+
+    const bool doScan = parser.isSet("scan");
+    const bool doAnalyze = parser.isSet("analyze");
+    const bool doVerify = parser.isSet("verify-cache");
+    if (!doScan && !doAnalyze && !doVerify) {
+        std::fprintf(stderr, "--headless 需要 --scan、--analyze 或 --verify-cache 中的至少一个\n");
+        return 1;
+    }
+
+    // 只读取设置，不写回
+    SettingsStore settings("MusicPlayer", "Settings");
+    const QString folder = doScan ? QFileInfo(parser.value("scan")).absoluteFilePath()
+                                  : settings.value("musicFolder").toString();
+    const QStringList backgrounds = settings.value("backgroundImageList").toStringList();
+    if (folder.isEmpty() || !QFileInfo(folder).isDir()) {
+        std::fprintf(stderr, "音乐文件夹不存在: %s\n", qPrintable(folder));
+        return 1;
+    }
+
+    LibraryService library;
+    QJsonObject report;
+    // 先校验：扫描会重建歌词索引、分析会补生成缩略图，之后再校验总是通过
+    bool ok = true;
+    if (doVerify) report["verify"] = verify(library, backgrounds, &ok);
+
+    // 分析任务需要曲目列表，未指定 --scan 时也先扫描一次设置中的文件夹
+    if (doScan || doAnalyze) report["scan"] = scan(library, folder);
+    if (doAnalyze) report["analyze"] = analyze(library.snapshot()->tracks, backgrounds);
+
+    if (parser.isSet("json")) {
+        std::printf("%s", QJsonDocument(report).toJson(QJsonDocument::Indented).constData());
+    } else {
+        printText(report);
+    }
+    return ok ? 0 : 2;
+}
+
+} // namespace Headless
@@ -0,0 +1,17 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+// 无界面命令行模式：app --headless [--scan <目录>] [--analyze] [--verify-cache] [--json]
+// 不创建 QML 引擎和窗口、不打开声卡，直接运行曲库扫描、索引构建与分析任务，
+// 输出吞吐统计后退出。用于在服务器上预热曲库缓存、脚本化回归测量以及在无显示器的环境中扫描
+namespace Headless {
+
+// 命令行中是否带有 --headless（在创建 QApplication 之前调用）
+bool requested(int argc, char *argv[]);
+
+// 运行并返回进程退出码：0 成功，1 参数错误，2 缓存校验发现问题
+int run(int argc, char *argv[]);
+
+} // namespace Headless
+
+#endif // HEADLESS_H
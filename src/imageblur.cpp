@@ -0,0 +1,114 @@
+#include "imageblur.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGEBLUR_SSE2 1
+#endif
+
+// 对一行连续像素做一次半径为 radius 的滑动平均，边缘像素向外延伸
+static void blurLine(const quint32 *src, quint32 *dst, int count, int radius)
+{
+    const int last = count - 1;
+    const float inv = 1.0f / float(2 * radius + 1);
+
+#ifdef IMAGEBLUR_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    auto load = [&](int i) {
+        const __m128i px = _mm_cvtsi32_si128(int(src[std::clamp(i, 0, last)]));
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(px, zero), zero);
+    };
+
+    __m128i sum = zero;
+    for (int i = -radius; i <= radius; ++i) sum = _mm_add_epi32(sum, load(i));
+
+    const __m128 scale = _mm_set1_ps(inv);
+    for (int x = 0; x < count; ++x) {
+        const __m128i avg = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), scale));
+        const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(avg, zero), zero);
+        dst[x] = quint32(_mm_cvtsi128_si32(packed));
+        sum = _mm_add_epi32(sum, _mm_sub_epi32(load(x + radius + 1), load(x - radius)));
+    }
+#else
+    int sum[4] = {};
+    auto channel = [&](int i, int c) { return int((src[std::clamp(i, 0, last)] >> (c * 8)) & 0xFF); };
+    for (int c = 0; c < 4; ++c) {
+        sum[c] = channel(0, c) * (radius + 1);
+        for (int i = 1; i <= radius; ++i) sum[c] += channel(i, c);
+    }
+    for (int x = 0; x < count; ++x) {
+        quint32 px = 0;
+        for (int c = 0; c < 4; ++c) {
+            px |= quint32(std::min(255, int(std::lround(sum[c] * inv)))) << (c * 8);
+            sum[c] += channel(x + radius + 1, c) - channel(x - radius, c);
+        }
+        dst[x] = px;
+    }
+#endif
+}
+
+void boxBlur(QImage &image, int radius, int passes)
+{
+    if (image.isNull() || radius <= 0) return;
+    if (image.format() != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    const int width = image.width();
+    const int height = image.height();
+    std::vector<quint32> a(size_t(std::max(width, height)));
+    std::vector<quint32> b(a.size());
+
+    // 水平：直接在行内存上来回滤波
+    for (int y = 0; y < height; ++y) {
+        quint32 *row = reinterpret_cast<quint32 *>(image.scanLine(y));
+        std::copy(row, row + width, a.begin());
+        for (int p = 0; p < passes; ++p) {
+            blurLine(a.data(), b.data(), width, radius);
+            a.swap(b);
+        }
+        std::copy(a.begin(), a.begin() + width, row);
+    }
+
+    // 垂直：把一列收集到连续缓冲区后复用同一个行内核
+    const qsizetype stride = image.bytesPerLine() / 4;
+    quint32 *bits = reinterpret_cast<quint32 *>(image.bits());
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) a[size_t(y)] = bits[y * stride + x];
+        for (int p = 0; p < passes; ++p) {
+            blurLine(a.data(), b.data(), height, radius);
+            a.swap(b);
+        }
+        for (int y = 0; y < height; ++y) bits[y * stride + x] = a[size_t(y)];
+    }
+}
+
+void adjustBrightnessSaturation(QImage &image, double brightness, double saturation)
+{
+    if (image.isNull()) return;
+    if (image.format() != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    const float sat = float(saturation);
+    const float add = float(brightness) * 255.0f;
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *row = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            const QRgb px = row[x];
+            const int alpha = qAlpha(px);
+            const float alphaF = alpha / 255.0f;
+            const float r = float(qRed(px));
+            const float g = float(qGreen(px));
+            const float bl = float(qBlue(px));
+            const float luma = 0.2126f * r + 0.7152f * g + 0.0722f * bl;
+            auto channel = [&](float v) {
+                const float out = luma + (v - luma) * sat + add * alphaF;
+                return std::clamp(int(out + 0.5f), 0, alpha); // 预乘格式下各通道不超过 alpha
+            };
+            row[x] = qRgba(channel(r), channel(g), channel(bl), alpha);
+        }
+    }
+}
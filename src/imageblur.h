@@ -0,0 +1,13 @@
+#ifndef IMAGEBLUR_H
+#define IMAGEBLUR_H
+
+#include <QImage>
+
+// 可分离盒式模糊：水平/垂直各做 passes 次滑动窗口平均（3 次即接近高斯模糊），
+// 每个像素的 4 个通道放在一个 SSE 寄存器中一起累加。image 会被转换为 ARGB32_Premultiplied
+void boxBlur(QImage &image, int radius, int passes = 3);
+
+// 烘焙亮度（-1..1，按 alpha 叠加）与饱和度（1 为原样），与 MultiEffect 的同名参数大致对应
+void adjustBrightnessSaturation(QImage &image, double brightness, double saturation);
+
+#endif // IMAGEBLUR_H
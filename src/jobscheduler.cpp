@@ -0,0 +1,384 @@
+#include "jobscheduler.h"
+#include "trace.h"
+#include "metrics.h"
+#include <QDataStream>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+static const quint32 JOB_STATE_MAGIC = 0x4A4F4253; // "JOBS"
+static const quint32 JOB_STATE_VERSION = 1;
+static const int MAX_WORKERS = 4;
+static const qint64 MAX_PAUSE_MS = 2000;        // 单次预算暂停的上限
+static const int POWER_POLL_MS = 60 * 1000;
+
+struct JobState {
+    QString kind;
+    QString key;
+    std::atomic<int> priority { JobScheduler::Idle };
+    std::atomic<bool> started { false };
+    std::atomic<bool> cancelled { false };
+    QMutex checkpointMutex;
+    QByteArray checkpoint;
+};
+
+bool JobScheduler::Context::isCancelled() const
+{
+    return m_state->cancelled.load() || m_scheduler->m_stopping.load();
+}
+
+QByteArray JobScheduler::Context::checkpoint() const
+{
+    QMutexLocker locker(&m_state->checkpointMutex);
+    return m_state->checkpoint;
+}
+
+void JobScheduler::Context::setCheckpoint(const QByteArray &data)
+{
+    QMutexLocker locker(&m_state->checkpointMutex);
+    m_state->checkpoint = data;
+}
+
+// 是否使用电池供电（无法判断时视为接通电源）
+static bool runningOnBattery()
+{
+#ifdef Q_OS_WIN
+    SYSTEM_POWER_STATUS status;
+    return GetSystemPowerStatus(&status) && status.ACLineStatus == 0;
+#elif defined(Q_OS_LINUX)
+    bool hasMains = false;
+    const QFileInfoList supplies = QDir("/sys/class/power_supply").entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QFileInfo &supply : supplies) {
+        QFile type(supply.absoluteFilePath() + "/type");
+        if (!type.open(QIODevice::ReadOnly) || type.readAll().trimmed() != "Mains") continue;
+        hasMains = true;
+        QFile online(supply.absoluteFilePath() + "/online");
+        if (online.open(QIODevice::ReadOnly) && online.readAll().trimmed() == "1") return false;
+    }
+    return hasMains;
+#else
+    return false;
+#endif
+}
+
+JobScheduler::JobScheduler(QObject *parent, int workerCount)
+    : QObject(parent)
+{
+    const int count = workerCount > 0 ? workerCount : qBound(1, QThread::idealThreadCount() - 1, MAX_WORKERS);
+    for (int i = 0; i < count; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->thread = QThread::create([this, i]() { workerLoop(i); });
+        worker->thread->setObjectName(QString("JobWorker-%1").arg(i));
+        m_workers.push_back(std::move(worker));
+    }
+    // 全部创建后再启动，工作线程窃取时 m_workers 不再变化
+    for (const auto &worker : m_workers) worker->thread->start(QThread::LowPriority);
+
+    m_powerTimer.setInterval(POWER_POLL_MS);
+    connect(&m_powerTimer, &QTimer::timeout, this, &JobScheduler::pollPowerSource);
+    m_powerTimer.start();
+    pollPowerSource();
+}
+
+JobScheduler::~JobScheduler()
+{
+    shutdown(QString());
+}
+
+QString JobScheduler::defaultStatePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/jobs.dat";
+}
+
+void JobScheduler::registerKind(const QString &kind, Handler handler)
+{
+    QMutexLocker locker(&m_jobsMutex);
+    m_handlers.insert(kind, std::move(handler));
+}
+
+void JobScheduler::submit(const QString &kind, const QString &key, Priority priority)
+{
+    if (m_stopping.load()) return;
+    std::shared_ptr<JobState> state;
+    {
+        QMutexLocker locker(&m_jobsMutex);
+        if (!m_handlers.contains(kind)) return;
+        std::shared_ptr<JobState> &slot = m_jobs[jobId(kind, key)];
+        if (slot) {
+            // 已在执行或已有同等以上优先级的排队条目；提高优先级时旧条目在出队时被跳过
+            if (slot->started.load() || priority >= slot->priority.load()) return;
+            slot->priority = priority;
+        } else {
+            slot = std::make_shared<JobState>();
+            slot->kind = kind;
+            slot->key = key;
+            slot->priority = priority;
+        }
+        state = slot;
+    }
+    enqueue(state, priority);
+}
+
+void JobScheduler::enqueue(const std::shared_ptr<JobState> &state, Priority priority)
+{
+    {
+        QMutexLocker locker(&m_sleepMutex);
+        ++m_queued;
+    }
+    Worker &worker = *m_workers[size_t(m_nextWorker.fetch_add(1) % int(m_workers.size()))];
+    {
+        // 空闲补全按提交顺序执行，其余按最近提交优先（最新的可见项、刚切换的曲目）
+        QMutexLocker locker(&worker.mutex);
+        if (priority == Idle) worker.queues[priority].push_back(state);
+        else worker.queues[priority].push_front(state);
+    }
+    m_wake.wakeOne();
+    if (priority <= NextTrack) m_urgent.wakeAll();
+}
+
+void JobScheduler::cancel(const QString &kind, const QString &key)
+{
+    QMutexLocker locker(&m_jobsMutex);
+    auto it = m_jobs.find(jobId(kind, key));
+    if (it == m_jobs.end()) return;
+    it.value()->cancelled = true;
+    m_jobs.erase(it);
+}
+
+void JobScheduler::demote(Priority from, Priority to)
+{
+    QVector<std::shared_ptr<JobState>> moved;
+    {
+        QMutexLocker locker(&m_jobsMutex);
+        for (const std::shared_ptr<JobState> &state : std::as_const(m_jobs)) {
+            if (state->priority.load() != from || state->started.load()) continue;
+            state->priority = to;
+            moved.append(state);
+        }
+    }
+    for (const std::shared_ptr<JobState> &state : moved) enqueue(state, to);
+}
+
+void JobScheduler::cancelPriority(Priority priority)
+{
+    QMutexLocker locker(&m_jobsMutex);
+    for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+        if (it.value()->priority.load() == priority && !it.value()->started.load()) {
+            it.value()->cancelled = true;
+            it = m_jobs.erase(it);
+            Metrics::count(Metrics::JobsCancelled);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int JobScheduler::pendingCount() const
+{
+    QMutexLocker locker(&m_jobsMutex);
+    return m_jobs.size();
+}
+
+std::shared_ptr<JobState> JobScheduler::take(int self)
+{
+    // 按优先级从高到低：先取自己队首，没有时从其它线程的同级队尾窃取，再看下一级
+    const int count = int(m_workers.size());
+    for (int priority = 0; priority < PriorityCount; ++priority) {
+        for (int offset = 0; offset < count; ++offset) {
+            Worker &worker = *m_workers[size_t((self + offset) % count)];
+            QMutexLocker locker(&worker.mutex);
+            std::deque<std::shared_ptr<JobState>> &queue = worker.queues[priority];
+            while (!queue.empty()) {
+                std::shared_ptr<JobState> state;
+                if (offset == 0) {
+                    state = std::move(queue.front());
+                    queue.pop_front();
+                } else {
+                    state = std::move(queue.back());
+                    queue.pop_back();
+                }
+                {
+                    QMutexLocker sleepLocker(&m_sleepMutex);
+                    --m_queued;
+                }
+                // 已取消、已调整到其它优先级或已被其它线程取走的旧条目直接丢弃
+                if (state->cancelled.load() || state->priority.load() != priority || state->started.exchange(true)) continue;
+                if (offset != 0) Metrics::count(Metrics::JobsStolen);
+                return state;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void JobScheduler::workerLoop(int self)
+{
+    qint64 debtNs = 0;   // 预算折算出的、尚未暂停的时间
+    while (!m_stopping.load()) {
+        const std::shared_ptr<JobState> job = take(self);
+        if (!job) {
+            QMutexLocker locker(&m_sleepMutex);
+            if (m_queued <= 0 && !m_stopping.load()) m_wake.wait(&m_sleepMutex);
+            continue;
+        }
+
+        Handler handler;
+        {
+            QMutexLocker locker(&m_jobsMutex);
+            handler = m_handlers.value(job->kind);
+        }
+        const int priority = job->priority.load();
+        QElapsedTimer timer;
+        timer.start();
+        bool ok = false;
+        {
+            TRACE_SCOPE("JobScheduler::run");
+            Context context(this, job);
+            ok = handler && handler(job->key, context);
+        }
+        const qint64 elapsedNs = timer.nsecsElapsed();
+
+        // 退出时中断的任务留在表中，连同断点一起保存；退出前刚好完成的任务照常移除，免得下次启动重做
+        const bool stopping = m_stopping.load();
+        if (!stopping || ok) {
+            QMutexLocker locker(&m_jobsMutex);
+            auto it = m_jobs.find(jobId(job->kind, job->key));
+            if (it != m_jobs.end() && it.value() == job) m_jobs.erase(it);
+        }
+        if (stopping) break;
+        if (job->cancelled.load()) {
+            Metrics::count(Metrics::JobsCancelled);
+        } else {
+            Metrics::count(Metrics::JobsCompleted);
+            emit jobFinished(job->kind, job->key, ok);
+        }
+
+        // 预算：当前曲目的任务不受限制。预算是所有工作线程合计的份额，每个线程只分得 1/workerCount
+        const int budget = m_budget.load();
+        if (priority == CurrentTrack || budget >= 100) continue;
+        const qint64 share = qint64(100) * workerCount();
+        debtNs += elapsedNs * (share - budget) / budget;
+        if (debtNs >= 1000000) {
+            const qint64 pauseMs = qMin(MAX_PAUSE_MS, debtNs / 1000000);
+            QElapsedTimer paused;
+            paused.start();
+            {
+                QMutexLocker locker(&m_sleepMutex);
+                if (!m_stopping.load()) m_urgent.wait(&m_sleepMutex, QDeadlineTimer(pauseMs));
+            }
+            // 被高优先级任务提前唤醒时，剩余的暂停留到之后
+            debtNs = qMax<qint64>(0, debtNs - paused.nsecsElapsed());
+        }
+    }
+}
+
+void JobScheduler::setBudget(int idlePercent, int playingPercent, int batteryPercent)
+{
+    m_idleBudget = qBound(1, idlePercent, 100);
+    m_playingBudget = qBound(1, playingPercent, 100);
+    m_batteryBudget = qBound(1, batteryPercent, 100);
+    updateBudget();
+}
+
+void JobScheduler::setPlaybackActive(bool active)
+{
+    if (m_playing == active) return;
+    m_playing = active;
+    updateBudget();
+}
+
+void JobScheduler::pollPowerSource()
+{
+    const bool battery = runningOnBattery();
+    if (battery == m_onBattery) return;
+    m_onBattery = battery;
+    updateBudget();
+}
+
+void JobScheduler::updateBudget()
+{
+    int budget = m_idleBudget;
+    if (m_playing) budget = qMin(budget, m_playingBudget);
+    if (m_onBattery) budget = qMin(budget, m_batteryBudget);
+    m_budget = budget;
+}
+
+void JobScheduler::shutdown(const QString &statePath)
+{
+    if (m_stopping.exchange(true)) return;
+    m_powerTimer.stop();
+    {
+        QMutexLocker locker(&m_sleepMutex);
+        m_wake.wakeAll();
+        m_urgent.wakeAll();
+    }
+    for (const auto &worker : m_workers) {
+        worker->thread->wait();
+        delete worker->thread;
+        worker->thread = nullptr;
+    }
+    if (statePath.isEmpty()) return;
+
+    // 未完成的任务一律按空闲补全恢复：重启后当前曲目等上下文已经不同，由界面重新提交
+    QMutexLocker locker(&m_jobsMutex);
+    if (m_jobs.isEmpty()) {
+        QFile::remove(statePath);
+        return;
+    }
+    QDir().mkpath(QFileInfo(statePath).absolutePath());
+    QSaveFile file(statePath);
+    if (!file.open(QIODevice::WriteOnly)) return;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << JOB_STATE_MAGIC << JOB_STATE_VERSION << qint32(m_jobs.size());
+    for (const std::shared_ptr<JobState> &state : std::as_const(m_jobs)) {
+        QMutexLocker checkpointLocker(&state->checkpointMutex);
+        out << state->kind << state->key << state->checkpoint;
+    }
+    if (!file.commit()) qWarning() << "JobScheduler - 保存未完成的任务失败:" << statePath;
+}
+
+void JobScheduler::restore(const QString &statePath)
+{
+    QFile file(statePath);
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_2);
+    quint32 magic = 0, version = 0;
+    qint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != JOB_STATE_MAGIC || version != JOB_STATE_VERSION) {
+        qWarning() << "JobScheduler - 任务文件格式不匹配，忽略:" << statePath;
+        return;
+    }
+
+    int restored = 0;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString kind, key;
+        QByteArray checkpoint;
+        in >> kind >> key >> checkpoint;
+        if (in.status() != QDataStream::Ok) break;
+        std::shared_ptr<JobState> state;
+        {
+            QMutexLocker locker(&m_jobsMutex);
+            if (!m_handlers.contains(kind) || m_jobs.contains(jobId(kind, key))) continue;
+            state = std::make_shared<JobState>();
+            state->kind = kind;
+            state->key = key;
+            state->checkpoint = checkpoint;
+            m_jobs.insert(jobId(kind, key), state);
+        }
+        enqueue(state, Idle);
+        ++restored;
+    }
+    if (restored > 0) qDebug() << "JobScheduler - 恢复未完成的任务:" << restored;
+}
@@ -0,0 +1,111 @@
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+
+struct JobState;
+
+// 后台分析任务调度：按优先级（当前曲目 > 下一首 > 可见项 > 空闲补全）在几个工作线程上执行，
+// 每个线程有自己的队列，空闲时从其它线程的队尾窃取同一优先级的任务。
+// 除“当前曲目”外的任务受 CPU/IO 预算限制：任务耗时 t 之后暂停 t × (100 − 预算) / 预算，
+// 播放中与使用电池时采用更低的预算。退出时未完成的任务（含断点）保存到磁盘，下次启动继续
+class JobScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum Priority { CurrentTrack, NextTrack, Visible, Idle, PriorityCount };
+
+    // 任务执行时的上下文：长任务应定期检查 isCancelled()，可保存断点以便中断后继续
+    class Context
+    {
+    public:
+        bool isCancelled() const;
+        QByteArray checkpoint() const;
+        void setCheckpoint(const QByteArray &data);
+
+    private:
+        friend class JobScheduler;
+        explicit Context(JobScheduler *scheduler, const std::shared_ptr<JobState> &state)
+            : m_scheduler(scheduler), m_state(state) {}
+        JobScheduler *m_scheduler;
+        std::shared_ptr<JobState> m_state;
+    };
+
+    // 在工作线程上调用；返回 false 表示失败（取消或退出时的返回值被忽略）
+    using Handler = std::function<bool(const QString &key, Context &context)>;
+
+    // workerCount 为 0 时按核数取（最多 4 个，留出一个核给播放与界面）；批量分析可指定使用全部核
+    explicit JobScheduler(QObject *parent = nullptr, int workerCount = 0);
+    ~JobScheduler() override;
+
+    // 注册任务类型后才能提交，也只会恢复已注册类型的任务
+    void registerKind(const QString &kind, Handler handler);
+    // 提交任务；同一任务已在排队时只会提高（不会降低）其优先级
+    void submit(const QString &kind, const QString &key, Priority priority);
+    void cancel(const QString &kind, const QString &key);
+    // 优先级变化：把某一级的全部排队任务降级（例如切歌后原“当前曲目”的任务），或取消
+    void demote(Priority from, Priority to);
+    void cancelPriority(Priority priority);
+
+    // 预算（单核 CPU 的百分比，1–100，由所有工作线程分摊；100 为不限）：空闲、播放中、使用电池时
+    void setBudget(int idlePercent, int playingPercent, int batteryPercent);
+    void setPlaybackActive(bool active);
+    bool onBattery() const { return m_onBattery; }
+    int pendingCount() const;
+    int workerCount() const { return int(m_workers.size()); }
+
+    // 停止工作线程并保存未完成的任务；之后不再执行任务
+    void shutdown(const QString &statePath);
+    // 重新提交上次退出时未完成的任务
+    void restore(const QString &statePath);
+    static QString defaultStatePath();
+
+signals:
+    void jobFinished(const QString &kind, const QString &key, bool ok);
+
+private:
+    struct Worker {
+        QMutex mutex;
+        std::deque<std::shared_ptr<JobState>> queues[PriorityCount];
+        QThread *thread = nullptr;
+    };
+
+    static QString jobId(const QString &kind, const QString &key) { return kind + QChar('\n') + key; }
+    void enqueue(const std::shared_ptr<JobState> &state, Priority priority);
+    std::shared_ptr<JobState> take(int self);
+    void workerLoop(int self);
+    void updateBudget();
+    void pollPowerSource();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    QHash<QString, Handler> m_handlers;
+    mutable QMutex m_jobsMutex;
+    QHash<QString, std::shared_ptr<JobState>> m_jobs;   // 排队与执行中的任务
+    std::atomic<int> m_nextWorker { 0 };
+
+    QMutex m_sleepMutex;
+    QWaitCondition m_wake;         // 有新任务或退出
+    QWaitCondition m_urgent;       // 高优先级任务到达：打断预算暂停
+    int m_queued = 0;              // 队列中的条目数（含已失效的旧条目），受 m_sleepMutex 保护
+    std::atomic<bool> m_stopping { false };
+
+    int m_idleBudget = 50;
+    int m_playingBudget = 20;
+    int m_batteryBudget = 10;
+    bool m_playing = false;
+    bool m_onBattery = false;
+    std::atomic<int> m_budget { 50 };
+    QTimer m_powerTimer;
+};
+
+#endif // JOBSCHEDULER_H
@@ -0,0 +1,165 @@
+#include "librarycolumns.h"
+#include "trace.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+static const quint32 LIBRARY_STATS_MAGIC = 0x4C535453; // "LSTS"
+static const quint32 LIBRARY_STATS_VERSION = 1;
+
+static bool sameMetadata(const TrackItem &a, const TrackItem &b)
+{
+    return a.title == b.title && a.artist == b.artist && a.album == b.album && a.duration == b.duration;
+}
+
+static qint64 fileAddedAt(const QString &path, qint64 fallbackMs)
+{
+    // 创建时间并非所有文件系统都提供，退回到修改时间
+    const QFileInfo info(path);
+    QDateTime time = info.birthTime();
+    if (!time.isValid()) time = info.lastModified();
+    return time.isValid() ? qMin(time.toMSecsSinceEpoch(), fallbackMs) : fallbackMs;
+}
+
+LibraryColumns::Delta LibraryColumns::update(const TrackList &tracks, qint64 nowMs)
+{
+    TRACE_SCOPE("LibraryColumns::update");
+    const int count = tracks.size();
+    Delta delta;
+    delta.oldRow.resize(count);
+
+    QVector<QString> titles(count), artists(count), albums(count);
+    QVector<qint64> durations(count), addedAt(count), lastPlayedAt(count), playCounts(count);
+    QHash<QString, int> rowByPath;
+    rowByPath.reserve(count);
+    // 还没有任何统计（首次扫描或刚升级）：曲库里已有的文件按文件时间计入，
+    // 否则“最近加入”会在之后一段时间内匹配整个曲库
+    const bool seeding = m_stats.isEmpty();
+
+    for (int r = 0; r < count; ++r) {
+        const TrackItem &track = tracks[r];
+        const QString path = track.url.toLocalFile();
+        rowByPath.insert(path, r);
+
+        const int old = m_rowByPath.value(path, -1);
+        if (old >= 0 && sameMetadata(m_tracks[old], track)) {
+            delta.oldRow[r] = old;
+            titles[r] = m_titles[old];
+            artists[r] = m_artists[old];
+            albums[r] = m_albums[old];
+        } else {
+            delta.oldRow[r] = -1;
+            delta.changedRows.append(r);
+            titles[r] = track.title.toLower();
+            artists[r] = track.artist.toLower();
+            albums[r] = track.album.toLower();
+        }
+        durations[r] = track.duration;
+
+        Stats &stats = m_stats[path];
+        if (stats.addedAt == 0) {
+            stats.addedAt = seeding ? fileAddedAt(path, nowMs) : nowMs;
+            m_dirty = true;
+        }
+        addedAt[r] = stats.addedAt;
+        lastPlayedAt[r] = stats.lastPlayedAt;
+        playCounts[r] = stats.playCount;
+    }
+
+    // 已移出曲库、从未播放过的文件不必保留统计（重新加入时按新加入计）
+    for (auto it = m_stats.begin(); it != m_stats.end();) {
+        if (it->playCount == 0 && !rowByPath.contains(it.key())) {
+            it = m_stats.erase(it);
+            m_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+
+    m_tracks = tracks;
+    m_titles = titles;
+    m_artists = artists;
+    m_albums = albums;
+    m_durations = durations;
+    m_addedAt = addedAt;
+    m_lastPlayedAt = lastPlayedAt;
+    m_playCounts = playCounts;
+    m_rowByPath = rowByPath;
+    return delta;
+}
+
+int LibraryColumns::recordPlay(const QString &path, qint64 nowMs)
+{
+    Stats &stats = m_stats[path];
+    if (stats.addedAt == 0) stats.addedAt = nowMs;
+    ++stats.playCount;
+    stats.lastPlayedAt = nowMs;
+    m_dirty = true;
+
+    const int row = m_rowByPath.value(path, -1);
+    if (row >= 0) {
+        m_playCounts[row] = stats.playCount;
+        m_lastPlayedAt[row] = stats.lastPlayedAt;
+    }
+    return row;
+}
+
+QString LibraryColumns::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/library-stats.dat";
+}
+
+bool LibraryColumns::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_2);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != LIBRARY_STATS_MAGIC || version != LIBRARY_STATS_VERSION) {
+        qWarning() << "LibraryColumns - 统计文件格式不匹配，忽略:" << filePath;
+        return false;
+    }
+
+    QHash<QString, Stats> entries;
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Stats stats;
+        in >> path >> stats.addedAt >> stats.playCount >> stats.lastPlayedAt;
+        entries.insert(path, stats);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "LibraryColumns - 统计文件已损坏，忽略:" << filePath;
+        return false;
+    }
+    m_stats = entries;
+    m_dirty = false;
+    return true;
+}
+
+bool LibraryColumns::save(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << LIBRARY_STATS_MAGIC << LIBRARY_STATS_VERSION << qint32(m_stats.size());
+    for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it) {
+        out << it.key() << it->addedAt << it->playCount << it->lastPlayedAt;
+    }
+
+    if (!file.commit()) return false;
+    m_dirty = false;
+    return true;
+}
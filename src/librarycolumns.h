@@ -0,0 +1,63 @@
+#ifndef LIBRARYCOLUMNS_H
+#define LIBRARYCOLUMNS_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include "playlistmodel.h"
+
+// 曲库的列式存储：每个字段一列连续数组（文本列预先转成小写），智能歌单的条件按列顺序扫描，
+// 不再逐行组装 QVariantMap。加入时间、播放次数与最近播放按路径保存在 library-stats.dat，
+// 重新扫描曲库后仍然保留
+class LibraryColumns
+{
+public:
+    // 一次 update 的变化：oldRow[r] 为第 r 行在更新前的行号（新行或元数据有变化时为 -1）
+    struct Delta {
+        QVector<int> oldRow;
+        QVector<int> changedRows;
+    };
+
+    // 用新的扫描结果重建各列；未变化的行沿用原有的小写文本，不重复转换
+    Delta update(const TrackList &tracks, qint64 nowMs);
+    // 记录一次播放，返回所在行（不在曲库中时为 -1）
+    int recordPlay(const QString &path, qint64 nowMs);
+
+    int rowCount() const { return m_tracks.size(); }
+    const TrackList &tracks() const { return m_tracks; }
+
+    const QVector<QString> &titles() const { return m_titles; }
+    const QVector<QString> &artists() const { return m_artists; }
+    const QVector<QString> &albums() const { return m_albums; }
+    const QVector<qint64> &durations() const { return m_durations; }       // 毫秒
+    const QVector<qint64> &addedAt() const { return m_addedAt; }           // 毫秒时间戳
+    const QVector<qint64> &lastPlayedAt() const { return m_lastPlayedAt; } // 从未播放为 0
+    const QVector<qint64> &playCounts() const { return m_playCounts; }
+
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+    bool isDirty() const { return m_dirty; }
+
+    static QString defaultPath();
+
+private:
+    struct Stats {
+        qint64 addedAt = 0;
+        qint64 playCount = 0;
+        qint64 lastPlayedAt = 0;
+    };
+
+    TrackList m_tracks;   // 与曲库快照共享
+    QVector<QString> m_titles;
+    QVector<QString> m_artists;
+    QVector<QString> m_albums;
+    QVector<qint64> m_durations;
+    QVector<qint64> m_addedAt;
+    QVector<qint64> m_lastPlayedAt;
+    QVector<qint64> m_playCounts;
+    QHash<QString, int> m_rowByPath;
+    QHash<QString, Stats> m_stats;
+    mutable bool m_dirty = false;
+};
+
+#endif // LIBRARYCOLUMNS_H
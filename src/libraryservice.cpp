@@ -0,0 +1,346 @@
+#include "libraryservice.h"
+#include "playlistmodel.h"
+#include "lyricindex.h"
+#include "probefailurecache.h"
+#include "metadataprobe.h"
+#include "trace.h"
+#include "metrics.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSet>
+#include <QStringDecoder>
+#include <QDebug>
+
+static const QStringList AUDIO_EXTS = { ".mp3", ".m4a", ".wav", ".flac", ".ogg" };
+
+// 歌词索引文档的版本戳：音频文件与外挂歌词的大小之和、较新的修改时间
+static void lyricDocumentStamp(const QFileInfo &audioInfo, const QFileInfo &sidecarInfo, qint64 *size, qint64 *mtime)
+{
+    *size = audioInfo.size() + (sidecarInfo.exists() ? sidecarInfo.size() : 0);
+    *mtime = qMax(audioInfo.lastModified().toMSecsSinceEpoch(),
+                  sidecarInfo.exists() ? sidecarInfo.lastModified().toMSecsSinceEpoch() : 0);
+}
+
+static QFileInfo sidecarLyricsFile(const QFileInfo &audioInfo)
+{
+    // 同目录同名的 .lrc 外挂歌词
+    return QFileInfo(audioInfo.absolutePath() + "/" + audioInfo.completeBaseName() + ".lrc");
+}
+
+static QString readSidecarLyrics(const QFileInfo &audioInfo, QFileInfo *sidecarInfo)
+{
+    const QFileInfo lrc = sidecarLyricsFile(audioInfo);
+    if (sidecarInfo) *sidecarInfo = lrc;
+    if (!lrc.exists()) return QString();
+
+    QFile file(lrc.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+    const QByteArray raw = file.readAll();
+
+    // 优先按 UTF-8 解码，失败时回退到本地编码（常见于 GBK 编码的歌词）
+    QStringDecoder decoder(QStringDecoder::Utf8);
+    QString text = decoder(raw);
+    if (decoder.hasError()) {
+        text = QString::fromLocal8Bit(raw);
+    }
+    return text;
+}
+
+// 由元数据读取结果组装曲目。indexText 为参与全文索引的歌词（内嵌与外挂歌词都算），docSize/docMtime 为其版本戳
+static void fillTrack(const QFileInfo &fi, const ProbeResult &probe, TrackItem *out,
+                      QString *indexText, qint64 *docSize, qint64 *docMtime)
+{
+    TrackItem &it = *out;
+    it.url = QUrl::fromLocalFile(fi.absoluteFilePath());
+    it.duration = 0;
+    it.cover = "qrc:/assets/default_cover.svg";
+
+    // 使用文件名作为后备
+    QString baseName = fi.completeBaseName();
+    it.name = baseName;
+
+    // 初始化为文件名解析结果
+    QPair<QString, QString> parsed = PlaylistModel::parseFileName(fi.fileName());
+    it.title = parsed.first.isEmpty() ? baseName : parsed.first;
+    it.artist = parsed.second.isEmpty() ? "Unknown Artist" : parsed.second;
+
+    // 元数据读取成功时覆盖文件名解析的结果（读取失败、超时或被跳过时保留文件名信息）
+    if (probe.status == ProbeResult::Ok) {
+        if (!probe.title.isEmpty()) it.title = probe.title;
+        if (!probe.artist.isEmpty()) it.artist = probe.artist;
+        it.album = probe.album;
+        it.duration = probe.duration;
+        it.lyrics = probe.lyrics;
+        if (!probe.cover.isEmpty()) it.cover = probe.cover;
+    }
+
+    // 防止title和artist相同
+    if (it.artist == it.title) {
+        it.artist = "Unknown Artist";
+    }
+
+    // 外挂歌词：内嵌歌词为空时作为播放歌词，两者都参与全文索引
+    QFileInfo sidecarInfo;
+    const QString sidecarLyrics = readSidecarLyrics(fi, &sidecarInfo);
+    *indexText = it.lyrics;
+    if (it.lyrics.isEmpty()) {
+        it.lyrics = sidecarLyrics;
+    }
+    if (!sidecarLyrics.isEmpty() && sidecarLyrics != *indexText) {
+        *indexText += "\n" + sidecarLyrics;
+    }
+    lyricDocumentStamp(fi, sidecarInfo, docSize, docMtime);
+}
+
+class LibraryWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LibraryWorker(LibraryService *owner);
+
+    void scan(const QString &folderPath);
+    // 读取不属于曲库的文件，歌词写入索引后发布（曲目列表不变）
+    QVector<TrackItem> probeLoose(const QStringList &filePaths);
+
+private:
+    // 读取一批文件的元数据（辅助进程池），并更新失败记录
+    QVector<ProbeResult> probeFiles(const QStringList &paths);
+    bool makeTrack(const QString &filePath, const ProbeResult &probe, TrackItem *out);
+
+    LibraryService *m_owner;
+    LyricIndex m_lyricIndex;
+    ProbeFailureCache m_probeFailures;
+    std::shared_ptr<const LibrarySnapshot> m_current;   // 最近一次发布的快照
+};
+
+LibraryWorker::LibraryWorker(LibraryService *owner)
+    : m_owner(owner)
+{
+    // 加载上次扫描留下的缓存，扫描时增量更新；在构造线程上完成，第一份快照即带有歌词索引
+    m_lyricIndex.load(LyricIndex::defaultCachePath());
+    m_probeFailures.load(ProbeFailureCache::defaultCachePath());
+
+    auto initial = std::make_shared<LibrarySnapshot>();
+    initial->generation = 1;
+    initial->lyrics = std::make_shared<const LyricIndex>(m_lyricIndex);
+    initial->probeFailures = m_probeFailures.count();
+    m_current = initial;
+    m_owner->publish(m_current);
+}
+
+QVector<ProbeResult> LibraryWorker::probeFiles(const QStringList &paths)
+{
+    // 之前读取失败且文件未变化的直接跳过，其余交给辅助进程池读取
+    QVector<ProbeResult> results(paths.size());
+    QStringList toProbe;
+    QVector<int> positions;
+    for (int i = 0; i < paths.size(); ++i) {
+        const QFileInfo fi(paths.at(i));
+        if (m_probeFailures.contains(paths.at(i), fi.size(), fi.lastModified().toMSecsSinceEpoch())) {
+            results[i].status = ProbeResult::Skipped;
+            Metrics::count(Metrics::ProbeFailuresSkipped);
+        } else {
+            toProbe.append(paths.at(i));
+            positions.append(i);
+        }
+    }
+
+    ProbePool pool;
+    const QVector<ProbeResult> probed = pool.probe(toProbe);
+    for (int j = 0; j < probed.size(); ++j) {
+        const QString &path = toProbe.at(j);
+        const QFileInfo fi(path);
+        if (probed[j].failed()) {
+            m_probeFailures.record(path, fi.size(), fi.lastModified().toMSecsSinceEpoch(), probed[j].status);
+        } else {
+            m_probeFailures.remove(path);
+        }
+        results[positions[j]] = probed[j];
+    }
+    return results;
+}
+
+bool LibraryWorker::makeTrack(const QString &filePath, const ProbeResult &probe, TrackItem *out)
+{
+    TRACE_SCOPE("LibraryWorker::makeTrack");
+    if (!LibraryService::isAudioFile(filePath)) return false;
+    Metrics::count(Metrics::FilesScanned);
+
+    const QFileInfo fi(filePath);
+    QString indexText;
+    qint64 docSize = 0;
+    qint64 docMtime = 0;
+    fillTrack(fi, probe, out, &indexText, &docSize, &docMtime);
+
+    const QString indexPath = fi.absoluteFilePath();
+    if (!m_lyricIndex.isUpToDate(indexPath, docSize, docMtime)) {
+        m_lyricIndex.updateDocument(indexPath, docSize, docMtime, indexText);
+        Metrics::count(Metrics::LyricIndexMisses);
+    } else {
+        Metrics::count(Metrics::LyricIndexHits);
+    }
+    return true;
+}
+
+void LibraryWorker::scan(const QString &folderPath)
+{
+    TRACE_SCOPE("LibraryWorker::scan");
+    QVector<TrackItem> tracks;
+    QStringList paths;
+    const QFileInfoList entries = QDir(folderPath).entryInfoList(QDir::Files | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QFileInfo &fi : entries) {
+        if (LibraryService::isAudioFile(fi.fileName())) paths.append(fi.absoluteFilePath());
+    }
+    const QVector<ProbeResult> probes = probeFiles(paths);
+    tracks.reserve(paths.size());
+    for (int i = 0; i < paths.size(); ++i) {
+        TrackItem it;
+        if (makeTrack(paths.at(i), probes.at(i), &it)) tracks.append(it);
+    }
+
+    // 清理已不在曲库中的歌词文档与失败记录，并在有变化时写回缓存
+    QSet<QString> scanned;
+    for (const TrackItem &t : tracks) scanned.insert(t.url.toLocalFile());
+    m_lyricIndex.retainDocuments(scanned);
+    if (m_lyricIndex.isDirty()) {
+        m_lyricIndex.save(LyricIndex::defaultCachePath());
+    }
+    m_probeFailures.retain(scanned);
+    if (m_probeFailures.isDirty()) {
+        m_probeFailures.save(ProbeFailureCache::defaultCachePath());
+    }
+
+    // 新快照与上一份共享内容未变的块；歌词索引为隐式共享的副本，之后工作线程再修改时才真正复制
+    auto next = std::make_shared<LibrarySnapshot>();
+    next->generation = m_current->generation + 1;
+    next->folder = folderPath;
+    next->tracks = TrackList::build(tracks, m_current->folder == folderPath ? m_current->tracks : TrackList());
+    next->rowByPath.reserve(tracks.size());
+    for (int r = tracks.size() - 1; r >= 0; --r) {
+        next->rowByPath.insert(LibrarySnapshot::pathKey(tracks[r].url.toLocalFile()), r);
+    }
+    next->lyrics = std::make_shared<const LyricIndex>(m_lyricIndex);
+    next->probeFailures = m_probeFailures.count();
+
+    LibraryChangeSet changes = LibraryChangeSet::diff(*m_current, *next);
+    if (changes.isEmpty()) {
+        // 曲目没有变化：版本号不变，持有上一份快照的读者不必做任何事
+        next->generation = m_current->generation;
+        changes.toGeneration = next->generation;
+    }
+    m_current = next;
+    m_owner->publish(next);
+    QMetaObject::invokeMethod(m_owner, [o = m_owner, snapshot = m_current, changes]() {
+        o->onScanned(snapshot, changes);
+    }, Qt::QueuedConnection);
+}
+
+QVector<TrackItem> LibraryWorker::probeLoose(const QStringList &filePaths)
+{
+    TRACE_SCOPE("LibraryWorker::probeLoose");
+    QStringList paths;
+    for (const QString &filePath : filePaths) {
+        const QFileInfo fi(filePath);
+        if (fi.isFile() && LibraryService::isAudioFile(filePath)) paths.append(fi.absoluteFilePath());
+    }
+    if (paths.isEmpty()) return {};
+
+    const QVector<ProbeResult> probes = probeFiles(paths);
+    QVector<TrackItem> tracks;
+    tracks.reserve(paths.size());
+    for (int i = 0; i < paths.size(); ++i) {
+        TrackItem it;
+        if (makeTrack(paths.at(i), probes.at(i), &it)) tracks.append(it);
+    }
+    if (!m_lyricIndex.isDirty()) return tracks;
+
+    // 只有歌词索引变化：曲目列表与路径索引沿用上一份（隐式共享，不复制）
+    auto next = std::make_shared<LibrarySnapshot>(*m_current);
+    next->lyrics = std::make_shared<const LyricIndex>(m_lyricIndex);
+    m_current = next;
+    m_owner->publish(next);
+}
+
+LibraryService::LibraryService(QObject *parent)
+    : QObject(parent)
+{
+    m_worker = new LibraryWorker(this);
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread.setObjectName("LibraryService");
+    m_thread.start(QThread::LowPriority);
+}
+
+LibraryService::~LibraryService()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool LibraryService::isAudioFile(const QString &filePath)
+{
+    return AUDIO_EXTS.contains("." + QFileInfo(filePath).suffix().toLower());
+}
+
+LibrarySnapshotPtr LibraryService::snapshot() const
+{
+    return std::atomic_load(&m_current);
+}
+
+void LibraryService::publish(const LibrarySnapshotPtr &snapshot)
+{
+    std::atomic_store(&m_current, snapshot);
+}
+
+void LibraryService::scan(const QString &folderPath)
+{
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, folderPath]() { w->scan(folderPath); },
+                              Qt::QueuedConnection);
+}
+
+LibrarySnapshotPtr LibraryService::scanAndWait(const QString &folderPath)
+{
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, folderPath]() { w->scan(folderPath); },
+                              Qt::BlockingQueuedConnection);
+    return snapshot();
+}
+
+void LibraryService::probeFiles(const QStringList &filePaths, QObject *context,
+                                const std::function<void(const QVector<TrackItem> &)> &done)
+{
+    // 辅助进程读取可能要等到超时，不能在调用线程（通常是 GUI 线程）上进行。context 不能早于本服务销毁
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, filePaths, context, done]() {
+        const QVector<TrackItem> tracks = w->probeLoose(filePaths);
+        QMetaObject::invokeMethod(context, [done, tracks]() { done(tracks); }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+LibraryService::IndexCheck LibraryService::verifyLyricIndex() const
+{
+    const LibrarySnapshotPtr current = snapshot();
+    IndexCheck check;
+    const QStringList paths = current->lyrics->documentPaths();
+    check.documents = paths.size();
+    for (const QString &path : paths) {
+        const QFileInfo fi(path);
+        if (!fi.exists()) {
+            ++check.missing;
+            continue;
+        }
+        qint64 size = 0;
+        qint64 mtime = 0;
+        lyricDocumentStamp(fi, sidecarLyricsFile(fi), &size, &mtime);
+        if (current->lyrics->isUpToDate(path, size, mtime)) ++check.current;
+        else ++check.stale;
+    }
+    return check;
+}
+
+void LibraryService::onScanned(const LibrarySnapshotPtr &snapshot, const LibraryChangeSet &changes)
+{
+    emit scanned(snapshot, changes);
+}
+
+#include "libraryservice.moc"
@@ -0,0 +1,62 @@
+#ifndef LIBRARYSERVICE_H
+#define LIBRARYSERVICE_H
+
+#include <QObject>
+#include <QThread>
+#include <functional>
+#include "librarysnapshot.h"
+
+class LibraryWorker;
+
+// 曲库服务：扫描目录、读取元数据、维护歌词索引与读取失败记录都在自己的线程上进行，
+// 这些数据只归工作线程所有。每次扫描完成后发布一份不可变快照（曲目列表、路径索引、歌词索引），
+// 以原子方式替换上一份：读者取得快照后不再需要任何同步，正在读旧快照的线程也不受影响，
+// 最后一个持有者释放时旧快照才被回收。GUI 线程另外收到相对上一份快照的变化区间
+class LibraryService : public QObject
+{
+    Q_OBJECT
+public:
+    // 歌词索引缓存与磁盘文件的一致性（命令行 --verify-cache）
+    struct IndexCheck {
+        int documents = 0;
+        int current = 0;
+        int stale = 0;     // 文件已修改，下次扫描会重建
+        int missing = 0;   // 文件已不存在
+    };
+
+    explicit LibraryService(QObject *parent = nullptr);
+    ~LibraryService() override;
+
+    // 任何线程都可调用：返回最新发布的快照（从不为空）。发布方只在交换指针的瞬间与读者竞争
+    LibrarySnapshotPtr snapshot() const;
+
+    // 在工作线程上扫描目录，完成后发布快照并发出 scanned；请求按顺序执行
+    void scan(const QString &folderPath);
+    // 扫描并等待完成（命令行模式）
+    LibrarySnapshotPtr scanAndWait(const QString &folderPath);
+
+    // 在工作线程上读取若干文件（不加入曲库，用于从命令行打开的文件），完成后在 context 所在线程上回调 done。
+    // 不支持或不存在的文件被略过，读取失败时按文件名补全；歌词写入索引并发布，曲目列表不变
+    void probeFiles(const QStringList &filePaths, QObject *context,
+                    const std::function<void(const QVector<TrackItem> &)> &done);
+
+    IndexCheck verifyLyricIndex() const;
+
+    static bool isAudioFile(const QString &filePath);
+
+signals:
+    // 一次扫描完成：changes 为相对上一次扫描结果的变化
+    void scanned(const LibrarySnapshotPtr &snapshot, const LibraryChangeSet &changes);
+
+private:
+    friend class LibraryWorker;
+
+    void publish(const LibrarySnapshotPtr &snapshot);
+    void onScanned(const LibrarySnapshotPtr &snapshot, const LibraryChangeSet &changes);
+
+    QThread m_thread;
+    LibraryWorker *m_worker = nullptr;
+    LibrarySnapshotPtr m_current;   // 只通过 std::atomic_load / std::atomic_store 访问
+};
+
+#endif // LIBRARYSERVICE_H
@@ -0,0 +1,192 @@
+#include "librarysnapshot.h"
+#include "trace.h"
+#include <algorithm>
+
+// 变化区间过多时读者逐段更新反而比整表重置慢
+static const int MAX_CHANGE_RANGES = 32;
+
+static bool sameTrack(const TrackItem &a, const TrackItem &b)
+{
+    return a.url == b.url && a.title == b.title && a.artist == b.artist && a.album == b.album
+        && a.duration == b.duration && a.name == b.name && a.cover == b.cover && a.lyrics == b.lyrics;
+}
+
+TrackList TrackList::build(const QVector<TrackItem> &tracks, const TrackList &previous)
+{
+    TRACE_SCOPE("TrackList::build");
+    TrackList list;
+    for (int first = 0; first < tracks.size(); first += CHUNK_SIZE) {
+        const int count = qMin(CHUNK_SIZE, int(tracks.size()) - first);
+        const int c = first / CHUNK_SIZE;
+        if (c < previous.m_chunks.size() && previous.m_offsets[c] == first && previous.m_chunks[c]->size() == count) {
+            const Chunk &old = *previous.m_chunks[c];
+            bool same = true;
+            for (int i = 0; i < count && same; ++i) same = sameTrack(old[i], tracks[first + i]);
+            if (same) {
+                list.appendChunk(previous.m_chunks[c]);
+                continue;
+            }
+        }
+        list.appendItems(tracks.constData() + first, count);
+    }
+    return list;
+}
+
+void TrackList::appendItems(const TrackItem *items, int count)
+{
+    int i = 0;
+    if (count > 0 && !m_chunks.isEmpty() && m_chunks.last()->size() < CHUNK_SIZE) {
+        // 最后一块未满：复制后补齐，原来的块可能正被其它列表共享
+        auto chunk = std::make_shared<Chunk>(*m_chunks.last());
+        const int n = qMin(count, CHUNK_SIZE - int(chunk->size()));
+        chunk->reserve(chunk->size() + n);
+        for (; i < n; ++i) chunk->append(items[i]);
+        m_chunks.last() = chunk;
+        m_size += n;
+    }
+    while (i < count) {
+        const int n = qMin(count - i, CHUNK_SIZE);
+        auto chunk = std::make_shared<Chunk>();
+        chunk->reserve(n);
+        for (int k = 0; k < n; ++k) chunk->append(items[i + k]);
+        appendChunk(chunk);
+        i += n;
+    }
+}
+
+void TrackList::appendChunk(const std::shared_ptr<const Chunk> &chunk)
+{
+    m_offsets.append(m_size);
+    m_chunks.append(chunk);
+    m_size += int(chunk->size());
+}
+
+TrackList TrackList::appended(const QVector<TrackItem> &tracks) const
+{
+    TrackList list = *this;
+    list.appendItems(tracks.constData(), int(tracks.size()));
+    return list;
+}
+
+TrackList TrackList::spliced(int row, int removeCount, const TrackList &source, int first, int count) const
+{
+    TrackList list;
+    int c = 0;
+    // row 之前的整块直接共享，row 所在块只复制它前面的部分
+    for (; c < m_chunks.size() && m_offsets[c] + m_chunks[c]->size() <= row; ++c) list.appendChunk(m_chunks[c]);
+    if (c < m_chunks.size() && m_offsets[c] < row) {
+        list.appendItems(m_chunks[c]->constData(), row - m_offsets[c]);
+    }
+
+    if (count > 0) {
+        QVector<TrackItem> inserted;
+        inserted.reserve(count);
+        for (int r = first; r < first + count; ++r) inserted.append(source.at(r));
+        list.appendItems(inserted.constData(), count);
+    }
+
+    // 删除区间末尾所在块只复制剩下的部分，之后的整块直接共享（行号整体平移，块本身不变）
+    const int end = row + removeCount;
+    if (end < m_size) {
+        c = chunkOf(end);
+        if (m_offsets[c] < end) {
+            const int skip = end - m_offsets[c];
+            list.appendItems(m_chunks[c]->constData() + skip, int(m_chunks[c]->size()) - skip);
+            ++c;
+        }
+        for (; c < m_chunks.size(); ++c) list.appendChunk(m_chunks[c]);
+    }
+    return list;
+}
+
+QVector<TrackItem> TrackList::toVector() const
+{
+    QVector<TrackItem> tracks;
+    tracks.reserve(m_size);
+    for (const auto &chunk : m_chunks) tracks.append(*chunk);
+    return tracks;
+}
+
+QString LibrarySnapshot::pathKey(const QString &path)
+{
+#ifdef Q_OS_WIN
+    return path.toLower();
+#else
+    return path;
+#endif
+}
+
+int LibraryChangeSet::mapRow(int oldRow) const
+{
+    if (reset || oldRow < 0) return -1;
+    int row = oldRow;
+    for (const Range &range : removed) {
+        if (oldRow >= range.first && oldRow < range.first + range.count) return -1;
+        if (range.first + range.count <= oldRow) row -= range.count;
+    }
+    // row 为保留下来的行中的序号，再加上插在它前面的新行
+    for (const Range &range : inserted) {
+        if (range.first > row) break;
+        row += range.count;
+    }
+    return row;
+}
+
+LibraryChangeSet LibraryChangeSet::diff(const LibrarySnapshot &from, const LibrarySnapshot &to)
+{
+    TRACE_SCOPE("LibraryChangeSet::diff");
+    LibraryChangeSet changes;
+    changes.fromGeneration = from.generation;
+    changes.toGeneration = to.generation;
+    if (from.generation == to.generation) return changes;
+    if (from.folder != to.folder || from.tracks.isEmpty() || to.tracks.isEmpty()) {
+        changes.reset = true;
+        return changes;
+    }
+
+    // 保留下来的行在新快照中必须仍按原来的先后排列，否则只能整表重置
+    int lastRow = -1;
+    int removedFirst = -1;
+    for (int r = 0; r < from.tracks.size(); ++r) {
+        const TrackItem &track = from.tracks.at(r);
+        const int row = to.indexOfPath(track.url.toLocalFile());
+        if (row < 0) {
+            if (removedFirst < 0) removedFirst = r;
+            continue;
+        }
+        if (removedFirst >= 0) {
+            changes.removed.append({ removedFirst, r - removedFirst });
+            removedFirst = -1;
+        }
+        if (row <= lastRow) {
+            changes = LibraryChangeSet();
+            changes.fromGeneration = from.generation;
+            changes.toGeneration = to.generation;
+            changes.reset = true;
+            return changes;
+        }
+        lastRow = row;
+        if (!sameTrack(track, to.tracks.at(row))) changes.changed.append(row);
+    }
+    if (removedFirst >= 0) changes.removed.append({ removedFirst, int(from.tracks.size()) - removedFirst });
+    std::reverse(changes.removed.begin(), changes.removed.end());
+
+    int insertedFirst = -1;
+    for (int r = 0; r < to.tracks.size(); ++r) {
+        const bool added = from.indexOfPath(to.tracks.at(r).url.toLocalFile()) < 0;
+        if (added && insertedFirst < 0) insertedFirst = r;
+        if (!added && insertedFirst >= 0) {
+            changes.inserted.append({ insertedFirst, r - insertedFirst });
+            insertedFirst = -1;
+        }
+    }
+    if (insertedFirst >= 0) changes.inserted.append({ insertedFirst, int(to.tracks.size()) - insertedFirst });
+
+    if (changes.removed.size() + changes.inserted.size() > MAX_CHANGE_RANGES) {
+        changes.removed.clear();
+        changes.inserted.clear();
+        changes.changed.clear();
+        changes.reset = true;
+    }
+    return changes;
+}
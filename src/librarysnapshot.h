@@ -0,0 +1,127 @@
+#ifndef LIBRARYSNAPSHOT_H
+#define LIBRARYSNAPSHOT_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include "trackitem.h"
+
+class LyricIndex;
+
+// 不可变的曲目列表：按 CHUNK_SIZE 行分块，块以引用计数在各个列表之间共享。
+// 追加或替换只复制受影响的块，旧列表及持有它的读者不受影响；复制整个列表只复制块指针
+class TrackList
+{
+public:
+    static const int CHUNK_SIZE = 1024;
+
+    TrackList() = default;
+    explicit TrackList(const QVector<TrackItem> &tracks) { appendItems(tracks.constData(), int(tracks.size())); }
+
+    // 用新的扫描结果建立列表；与 previous 对应块内容完全相同的块直接共享
+    static TrackList build(const QVector<TrackItem> &tracks, const TrackList &previous);
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    const TrackItem &at(int row) const
+    {
+        const int c = chunkOf(row);
+        return (*m_chunks[c])[row - m_offsets[c]];
+    }
+    const TrackItem &operator[](int row) const { return at(row); }
+
+    // 以下都返回新列表，原列表不变
+    TrackList appended(const QVector<TrackItem> &tracks) const;
+    // 从 row 起删去 removeCount 行，再插入 source 的 [first, first + count)。
+    // 前后未受影响的整块直接共享，只复制 row 与删除区间末尾所在的两个块和插入的行
+    TrackList spliced(int row, int removeCount, const TrackList &source, int first, int count) const;
+
+    QVector<TrackItem> toVector() const;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = TrackItem;
+        using difference_type = int;
+        using pointer = const TrackItem *;
+        using reference = const TrackItem &;
+
+        const_iterator(const TrackList *list, int row) : m_list(list), m_row(row) {}
+        reference operator*() const { return m_list->at(m_row); }
+        pointer operator->() const { return &m_list->at(m_row); }
+        const_iterator &operator++() { ++m_row; return *this; }
+        bool operator==(const const_iterator &other) const { return m_row == other.m_row; }
+        bool operator!=(const const_iterator &other) const { return m_row != other.m_row; }
+
+    private:
+        const TrackList *m_list;
+        int m_row;
+    };
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+
+private:
+    using Chunk = QVector<TrackItem>;
+
+    void appendItems(const TrackItem *items, int count);
+    void appendChunk(const std::shared_ptr<const Chunk> &chunk);
+
+    int chunkOf(int row) const
+    {
+        // 各块都满时可以直接算出；拼接出的列表中有不满的块，改为按起始行查找
+        const int c = row / CHUNK_SIZE;
+        if (c < m_offsets.size() && m_offsets[c] == c * CHUNK_SIZE && row - m_offsets[c] < m_chunks[c]->size()) return c;
+        return int(std::upper_bound(m_offsets.begin(), m_offsets.end(), row) - m_offsets.begin()) - 1;
+    }
+
+    // build 与追加得到的列表除最后一块外都是满的；spliced 得到的列表中间可能有不满的块
+    QVector<std::shared_ptr<const Chunk>> m_chunks;
+    QVector<int> m_offsets;   // 每块第一行的行号
+    int m_size = 0;
+};
+
+// 曲库的一次发布：生成后不再修改，任何线程都可以持有并直接读取
+struct LibrarySnapshot
+{
+    quint64 generation = 0;    // 曲目列表的版本，只有曲目变化时才递增
+    QString folder;
+    TrackList tracks;
+    QHash<QString, int> rowByPath;              // pathKey() → 行
+    std::shared_ptr<const LyricIndex> lyrics;   // 与曲目同时发布的歌词索引
+    int probeFailures = 0;                      // 记录为读取失败、扫描时跳过的文件数
+
+    int indexOfPath(const QString &path) const { return rowByPath.value(pathKey(path), -1); }
+
+    // 路径索引的键：Windows 上路径不区分大小写
+    static QString pathKey(const QString &path);
+};
+
+using LibrarySnapshotPtr = std::shared_ptr<const LibrarySnapshot>;
+
+// 两个快照之间的变化，以行区间描述；读者据此增量更新，而不是整表重置
+struct LibraryChangeSet
+{
+    struct Range {
+        int first;
+        int count;
+    };
+
+    quint64 fromGeneration = 0;
+    quint64 toGeneration = 0;
+    bool reset = false;           // 换了目录或曲目顺序改变，无法用区间描述
+    QVector<Range> removed;       // 旧快照的行号，从后往前排列，依次删除
+    QVector<Range> inserted;      // 新快照的行号，从前往后排列，依次插入
+    QVector<int> changed;         // 新快照中元数据有变化的行
+
+    bool isEmpty() const { return !reset && removed.isEmpty() && inserted.isEmpty() && changed.isEmpty(); }
+    // 旧行号 → 新行号，已删除或整表重置时为 -1（保存了行号的读者，如播放队列，用它换算）
+    int mapRow(int oldRow) const;
+
+    static LibraryChangeSet diff(const LibrarySnapshot &from, const LibrarySnapshot &to);
+};
+
+#endif // LIBRARYSNAPSHOT_H
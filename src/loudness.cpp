@@ -0,0 +1,346 @@
+#include "loudness.h"
+#include "trace.h"
+#include <QAudioBuffer>
+#include <QAudioDecoder>
+#include <QAudioFormat>
+#include <QEventLoop>
+#include <QUrl>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+static const double PI = 3.14159265358979323846;
+static const double ABSOLUTE_GATE_LUFS = -70.0;
+static const double RELATIVE_GATE_LU = -10.0;       // 积分响度的相对门限
+static const double RANGE_GATE_LU = -20.0;          // 响度范围的相对门限（EBU Tech 3342）
+static const double TRUE_PEAK_CEILING_DB = -1.0;
+static const double MAX_BOOST_DB = 12.0;            // 很安静的录音也不无限放大，以免抬高底噪
+static const int ANALYSIS_SAMPLE_RATE = 48000;
+static const int OVERSAMPLE = 4;
+static const int PHASE_TAPS = 12;
+
+namespace {
+
+using Histogram = std::array<quint32, LoudnessInfo::HISTOGRAM_BINS>;
+
+double binLoudness(int bin)
+{
+    return ABSOLUTE_GATE_LUFS + (bin + 0.5) * LoudnessInfo::HISTOGRAM_STEP;
+}
+
+double loudnessToPower(double lufs)
+{
+    return std::pow(10.0, (lufs + 0.691) / 10.0);
+}
+
+double powerToLoudness(double power)
+{
+    return -0.691 + 10.0 * std::log10(power);
+}
+
+void addBlock(Histogram &histogram, double power)
+{
+    if (power <= 0.0) return;
+    const double lufs = powerToLoudness(power);
+    if (lufs < ABSOLUTE_GATE_LUFS) return;
+    const int bin = int((lufs - ABSOLUTE_GATE_LUFS) / LoudnessInfo::HISTOGRAM_STEP);
+    ++histogram[size_t(std::min(bin, LoudnessInfo::HISTOGRAM_BINS - 1))];
+}
+
+// 绝对门限后的平均响度 + 相对偏移，作为第二级门限
+double relativeGate(const Histogram &histogram, double offset, quint64 *blocks)
+{
+    double sum = 0.0;
+    quint64 count = 0;
+    for (int i = 0; i < LoudnessInfo::HISTOGRAM_BINS; ++i) {
+        sum += histogram[size_t(i)] * loudnessToPower(binLoudness(i));
+        count += histogram[size_t(i)];
+    }
+    if (blocks) *blocks = count;
+    return count == 0 ? ABSOLUTE_GATE_LUFS : powerToLoudness(sum / double(count)) + offset;
+}
+
+double gatedLoudness(const Histogram &histogram)
+{
+    quint64 blocks = 0;
+    const double gate = relativeGate(histogram, RELATIVE_GATE_LU, &blocks);
+    if (blocks == 0) return ABSOLUTE_GATE_LUFS;
+    double sum = 0.0;
+    quint64 count = 0;
+    for (int i = 0; i < LoudnessInfo::HISTOGRAM_BINS; ++i) {
+        if (binLoudness(i) < gate) continue;
+        sum += histogram[size_t(i)] * loudnessToPower(binLoudness(i));
+        count += histogram[size_t(i)];
+    }
+    return count == 0 ? ABSOLUTE_GATE_LUFS : powerToLoudness(sum / double(count));
+}
+
+double loudnessRange(const Histogram &shortTerm)
+{
+    quint64 blocks = 0;
+    const double gate = relativeGate(shortTerm, RANGE_GATE_LU, &blocks);
+    if (blocks == 0) return 0.0;
+    quint64 total = 0;
+    for (int i = 0; i < LoudnessInfo::HISTOGRAM_BINS; ++i) {
+        if (binLoudness(i) >= gate) total += shortTerm[size_t(i)];
+    }
+    if (total == 0) return 0.0;
+
+    // 门限之上短期响度分布的第 10 与第 95 百分位之差
+    const quint64 lowTarget = quint64(double(total - 1) * 0.10) + 1;
+    const quint64 highTarget = quint64(double(total - 1) * 0.95) + 1;
+    double low = 0.0, high = 0.0;
+    quint64 seen = 0;
+    bool lowFound = false;
+    for (int i = 0; i < LoudnessInfo::HISTOGRAM_BINS; ++i) {
+        if (binLoudness(i) < gate) continue;
+        seen += shortTerm[size_t(i)];
+        if (!lowFound && seen >= lowTarget) {
+            low = binLoudness(i);
+            lowFound = true;
+        }
+        if (seen >= highTarget) {
+            high = binLoudness(i);
+            break;
+        }
+    }
+    return std::max(0.0, high - low);
+}
+
+// 4 倍过采样的多相插值滤波器（Kaiser 窗 sinc），每相的直流增益归一化为 1
+struct TruePeakFilter {
+    float taps[OVERSAMPLE][PHASE_TAPS];
+
+    TruePeakFilter()
+    {
+        const int length = OVERSAMPLE * PHASE_TAPS;
+        const double center = (length - 1) / 2.0;
+        const double beta = 6.0;
+        auto bessel = [](double x) {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 20; ++k) {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        };
+        for (int p = 0; p < OVERSAMPLE; ++p) {
+            double sum = 0.0;
+            for (int k = 0; k < PHASE_TAPS; ++k) {
+                const double t = (p + k * OVERSAMPLE - center) / OVERSAMPLE;
+                const double sinc = t == 0.0 ? 1.0 : std::sin(PI * t) / (PI * t);
+                const double r = (p + k * OVERSAMPLE - center) / center;
+                const double window = bessel(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / bessel(beta);
+                taps[p][k] = float(sinc * window);
+                sum += taps[p][k];
+            }
+            for (int k = 0; k < PHASE_TAPS; ++k) taps[p][k] = float(taps[p][k] / sum);
+        }
+    }
+};
+
+const TruePeakFilter &truePeakFilter()
+{
+    static const TruePeakFilter filter;
+    return filter;
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter(int sampleRate, int channels)
+    : m_channels(std::max(1, channels))
+    , m_subBlockFrames(std::max<qsizetype>(1, sampleRate / 10))
+    , m_shelf(size_t(m_channels))
+    , m_highPass(size_t(m_channels))
+    , m_history(size_t(m_channels))
+{
+    // K 计权：高频搁架 + 高通，按采样率由模拟原型推导（与 BS.1770 在 48 kHz 下给出的系数一致）
+    const double rate = std::max(8000, sampleRate);
+    Biquad shelf;
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(PI * f0 / rate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    Biquad highPass;
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(PI * f0 / rate);
+        const double a0 = 1.0 + k / q + k * k;
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    std::fill(m_shelf.begin(), m_shelf.end(), shelf);
+    std::fill(m_highPass.begin(), m_highPass.end(), highPass);
+    for (auto &history : m_history) history.fill(0.0f);
+}
+
+double LoudnessMeter::truePeakSample(int channel, float sample)
+{
+    std::array<float, PHASE_TAPS> &history = m_history[size_t(channel)];
+    history[size_t(m_historyPos)] = sample;
+    double peak = std::fabs(sample);
+    const TruePeakFilter &filter = truePeakFilter();
+    for (int p = 0; p < OVERSAMPLE; ++p) {
+        float sum = 0.0f;
+        int index = m_historyPos;
+        for (int k = 0; k < PHASE_TAPS; ++k) {
+            sum += filter.taps[p][k] * history[size_t(index)];
+            index = index == 0 ? PHASE_TAPS - 1 : index - 1;
+        }
+        peak = std::max(peak, double(std::fabs(sum)));
+    }
+    return peak;
+}
+
+void LoudnessMeter::process(const float *interleaved, qsizetype frames)
+{
+    for (qsizetype f = 0; f < frames; ++f) {
+        const float *frame = interleaved + f * m_channels;
+        double energy = 0.0;
+        for (int c = 0; c < m_channels; ++c) {
+            m_peak = std::max(m_peak, truePeakSample(c, frame[c]));
+            const double y = m_highPass[size_t(c)].run(m_shelf[size_t(c)].run(frame[c]));
+            energy += y * y;
+        }
+        m_historyPos = m_historyPos + 1 == PHASE_TAPS ? 0 : m_historyPos + 1;
+        m_subBlockEnergy += energy;
+        if (++m_subBlockPos == m_subBlockFrames) finishSubBlock();
+    }
+}
+
+void LoudnessMeter::finishSubBlock()
+{
+    m_recent[size_t(m_recentPos)] = m_subBlockEnergy / double(m_subBlockFrames);
+    m_recentPos = (m_recentPos + 1) % int(m_recent.size());
+    m_recentCount = std::min(m_recentCount + 1, int(m_recent.size()));
+    m_subBlockEnergy = 0.0;
+    m_subBlockPos = 0;
+
+    // 瞬时响度：400 ms 块，75% 重叠；短期响度：3 s 块
+    auto meanOfLast = [this](int count) {
+        double sum = 0.0;
+        for (int i = 1; i <= count; ++i) {
+            sum += m_recent[size_t((m_recentPos - i + int(m_recent.size())) % int(m_recent.size()))];
+        }
+        return sum / count;
+    };
+    if (m_recentCount >= 4) addBlock(m_momentary, meanOfLast(4));
+    if (m_recentCount >= int(m_recent.size())) addBlock(m_shortTerm, meanOfLast(int(m_recent.size())));
+}
+
+LoudnessInfo LoudnessMeter::result() const
+{
+    LoudnessInfo info;
+    info.integratedLufs = gatedLoudness(m_momentary);
+    info.rangeLu = loudnessRange(m_shortTerm);
+    info.truePeak = m_peak;
+
+    int first = 0, last = LoudnessInfo::HISTOGRAM_BINS - 1;
+    while (first <= last && m_momentary[size_t(first)] == 0) ++first;
+    while (last >= first && m_momentary[size_t(last)] == 0) --last;
+    info.histogramStart = first;
+    for (int i = first; i <= last; ++i) info.histogram.append(m_momentary[size_t(i)]);
+    return info;
+}
+
+float LoudnessInfo::gain(double targetLufs, bool preventClipping) const
+{
+    if (!isValid()) return 1.0f;
+    double gainDb = std::min(targetLufs - integratedLufs, MAX_BOOST_DB);
+    if (preventClipping && truePeak > 0.0) {
+        gainDb = std::min(gainDb, TRUE_PEAK_CEILING_DB - 20.0 * std::log10(truePeak));
+    }
+    return float(std::pow(10.0, gainDb / 20.0));
+}
+
+LoudnessInfo LoudnessInfo::combine(const QVector<LoudnessInfo> &tracks)
+{
+    Histogram histogram {};
+    LoudnessInfo album;
+    for (const LoudnessInfo &track : tracks) {
+        album.truePeak = std::max(album.truePeak, track.truePeak);
+        for (int i = 0; i < track.histogram.size(); ++i) {
+            const int bin = track.histogramStart + i;
+            if (bin >= 0 && bin < HISTOGRAM_BINS) histogram[size_t(bin)] += track.histogram[i];
+        }
+    }
+    album.integratedLufs = gatedLoudness(histogram);
+
+    int first = 0, last = HISTOGRAM_BINS - 1;
+    while (first <= last && histogram[size_t(first)] == 0) ++first;
+    while (last >= first && histogram[size_t(last)] == 0) --last;
+    album.histogramStart = first;
+    for (int i = first; i <= last; ++i) album.histogram.append(histogram[size_t(i)]);
+    return album;
+}
+
+bool LoudnessMeter::analyzeFile(const QString &path, const std::function<bool()> &cancelled, LoudnessInfo *out)
+{
+    TRACE_SCOPE("LoudnessMeter::analyzeFile");
+    QAudioDecoder decoder;
+    QAudioFormat format;
+    format.setSampleRate(ANALYSIS_SAMPLE_RATE);
+    format.setChannelCount(2);
+    format.setSampleFormat(QAudioFormat::Float);
+    decoder.setAudioFormat(format);
+
+    std::unique_ptr<LoudnessMeter> meter;
+    std::vector<float> converted;
+    bool failed = false;
+    bool aborted = false;
+    QEventLoop loop;
+
+    QObject::connect(&decoder, &QAudioDecoder::bufferReady, &loop, [&]() {
+        while (decoder.bufferAvailable()) {
+            const QAudioBuffer buffer = decoder.read();
+            if (!buffer.isValid() || buffer.frameCount() <= 0) continue;
+            const QAudioFormat fmt = buffer.format();
+            if (!meter) meter = std::make_unique<LoudnessMeter>(fmt.sampleRate(), fmt.channelCount());
+            if (fmt.sampleFormat() == QAudioFormat::Float) {
+                meter->process(buffer.constData<float>(), buffer.frameCount());
+                continue;
+            }
+            // 解码器未按要求输出 float 时逐采样归一化
+            const qsizetype samples = qsizetype(buffer.frameCount()) * fmt.channelCount();
+            const char *src = buffer.constData<char>();
+            converted.resize(size_t(samples));
+            for (qsizetype i = 0; i < samples; ++i) {
+                converted[size_t(i)] = fmt.normalizedSampleValue(src + i * fmt.bytesPerSample());
+            }
+            meter->process(converted.data(), buffer.frameCount());
+        }
+        if (cancelled && cancelled()) {
+            aborted = true;
+            decoder.stop();
+            loop.quit();
+        }
+    });
+    QObject::connect(&decoder, &QAudioDecoder::finished, &loop, &QEventLoop::quit);
+    QObject::connect(&decoder, qOverload<QAudioDecoder::Error>(&QAudioDecoder::error), &loop,
+                     [&](QAudioDecoder::Error error) {
+        qWarning() << "LoudnessMeter - 解码失败:" << path << error << decoder.errorString();
+        failed = true;
+        loop.quit();
+    });
+
+    decoder.setSource(QUrl::fromLocalFile(path));
+    decoder.start();
+    if (!failed) loop.exec();
+    decoder.stop();
+
+    if (failed || aborted || !meter) return false;
+    *out = meter->result();
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef LOUDNESS_H
+#define LOUDNESS_H
+
+#include <QString>
+#include <QVector>
+#include <array>
+#include <functional>
+#include <vector>
+
+// 一首曲目（或一张专辑）的响度测量结果（EBU R128 / ITU-R BS.1770）
+struct LoudnessInfo {
+    double integratedLufs = -70.0;  // 门限积分响度
+    double rangeLu = 0.0;           // 响度范围 LRA（专辑合并时不计算）
+    double truePeak = 0.0;          // 真峰值（线性，4 倍过采样）
+    // 400 ms 测量块的响度直方图（每格 HISTOGRAM_STEP LU，从 -70 LUFS 起），只保存非零区间；
+    // 合并专辑时按直方图重新做门限积分，不必重新解码
+    int histogramStart = 0;
+    QVector<quint32> histogram;
+
+    bool isValid() const { return !histogram.isEmpty(); }   // 全程静音时无效
+    // 播放时的增益（线性）：把积分响度调整到 targetLufs；preventClipping 时真峰值不超过 -1 dBTP
+    float gain(double targetLufs, bool preventClipping) const;
+
+    // 合并多首曲目的直方图与峰值，得到专辑的积分响度
+    static LoudnessInfo combine(const QVector<LoudnessInfo> &tracks);
+
+    static constexpr double HISTOGRAM_STEP = 0.25;
+    static constexpr int HISTOGRAM_BINS = 300;   // -70 .. +5 LUFS
+};
+
+// 流式响度计：按输入的交错 PCM 逐块累积，result() 时完成门限计算
+class LoudnessMeter
+{
+public:
+    LoudnessMeter(int sampleRate, int channels);
+
+    void process(const float *interleaved, qsizetype frames);
+    LoudnessInfo result() const;
+
+    // 在当前线程上解码整个文件并测量（期间运行局部事件循环）；cancelled 返回 true 时中止
+    static bool analyzeFile(const QString &path, const std::function<bool()> &cancelled, LoudnessInfo *out);
+
+private:
+    struct Biquad {
+        double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+        double z1 = 0, z2 = 0;
+        double run(double x)
+        {
+            const double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    void finishSubBlock();
+    double truePeakSample(int channel, float sample);
+
+    int m_channels;
+    qsizetype m_subBlockFrames;                 // 100 ms：测量块每次前进的步长
+    std::vector<Biquad> m_shelf, m_highPass;    // 每声道的 K 计权两级滤波
+    double m_subBlockEnergy = 0.0;
+    qsizetype m_subBlockPos = 0;
+    std::array<double, 30> m_recent {};         // 最近 30 个 100 ms 子块的能量（短期响度 3 s）
+    int m_recentCount = 0;
+    int m_recentPos = 0;
+
+    std::array<quint32, LoudnessInfo::HISTOGRAM_BINS> m_momentary {};
+    std::array<quint32, LoudnessInfo::HISTOGRAM_BINS> m_shortTerm {};
+
+    // 真峰值：每声道保留最近的输入样本做多相插值
+    std::vector<std::array<float, 12>> m_history;
+    int m_historyPos = 0;
+    double m_peak = 0.0;
+};
+
+#endif // LOUDNESS_H
@@ -0,0 +1,157 @@
+#include "loudnesscache.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+static const quint32 LOUDNESS_CACHE_MAGIC = 0x4C444E53; // "LDNS"
+static const quint32 LOUDNESS_CACHE_VERSION = 1;
+
+bool LoudnessCache::lookup(const QString &path, LoudnessInfo *out) const
+{
+    const QFileInfo info(path);
+    if (!info.exists()) return false;
+    return lookup(path, info.size(), info.lastModified().toMSecsSinceEpoch(), out);
+}
+
+bool LoudnessCache::lookup(const QString &path, qint64 size, qint64 mtime, LoudnessInfo *out) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(path);
+    if (it == m_entries.constEnd() || it->size != size || it->mtime != mtime) return false;
+    if (out) *out = it->info;
+    return true;
+}
+
+bool LoudnessCache::contains(const QString &path, LoudnessInfo *out) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(path);
+    if (it == m_entries.constEnd()) return false;
+    if (out) *out = it->info;
+    return true;
+}
+
+void LoudnessCache::insert(const QString &path, qint64 size, qint64 mtime, const LoudnessInfo &info)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(path, { size, mtime, info });
+    m_dirty = true;
+}
+
+void LoudnessCache::retain(const QSet<QString> &keep)
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (keep.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        }
+    }
+}
+
+int LoudnessCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+bool LoudnessCache::analyze(const QString &path, const std::function<bool()> &cancelled)
+{
+    const QFileInfo file(path);
+    if (!file.exists()) return false;
+    const qint64 size = file.size();
+    const qint64 mtime = file.lastModified().toMSecsSinceEpoch();
+    if (lookup(path, size, mtime, nullptr)) return true;
+
+    LoudnessInfo info;
+    if (!LoudnessMeter::analyzeFile(path, cancelled, &info)) {
+        if (cancelled && cancelled()) return false;
+        info = LoudnessInfo();
+    }
+    insert(path, size, mtime, info);
+    return true;
+}
+
+bool LoudnessCache::isDirty() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dirty;
+}
+
+QString LoudnessCache::defaultCachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/library/loudness.idx";
+}
+
+bool LoudnessCache::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_2);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != LOUDNESS_CACHE_MAGIC || version != LOUDNESS_CACHE_VERSION) {
+        qWarning() << "LoudnessCache - 缓存格式不匹配，忽略:" << filePath;
+        return false;
+    }
+
+    QHash<QString, Entry> entries;
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Entry entry;
+        qint32 histogramStart = 0;
+        in >> path >> entry.size >> entry.mtime >> entry.info.integratedLufs >> entry.info.rangeLu
+           >> entry.info.truePeak >> histogramStart >> entry.info.histogram;
+        entry.info.histogramStart = histogramStart;
+        entries.insert(path, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "LoudnessCache - 缓存已损坏，忽略:" << filePath;
+        return false;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_entries = entries;
+    m_dirty = false;
+    return true;
+}
+
+bool LoudnessCache::save(const QString &filePath) const
+{
+    // 先复制一份，写盘期间不阻塞后台分析
+    QHash<QString, Entry> entries;
+    {
+        QMutexLocker locker(&m_mutex);
+        entries = m_entries;
+        m_dirty = false;
+    }
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    bool ok = file.open(QIODevice::WriteOnly);
+    if (ok) {
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_6_2);
+        out << LOUDNESS_CACHE_MAGIC << LOUDNESS_CACHE_VERSION << qint32(entries.size());
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            out << it.key() << it->size << it->mtime << it->info.integratedLufs << it->info.rangeLu
+                << it->info.truePeak << qint32(it->info.histogramStart) << it->info.histogram;
+        }
+        ok = file.commit();
+    }
+    if (!ok) {
+        QMutexLocker locker(&m_mutex);
+        m_dirty = true;
+    }
+    return ok;
+}
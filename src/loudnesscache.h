@@ -0,0 +1,47 @@
+#ifndef LOUDNESSCACHE_H
+#define LOUDNESSCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <functional>
+#include "loudness.h"
+
+// 每首曲目的响度测量结果：以“路径 + 大小 + 修改时间”校验，文件未变化时不再重新分析。
+// 无法解码的文件记为无效结果，同样在文件变化前不再重试。与歌词索引一起保存在库缓存目录。
+// 分析在后台任务线程上写入、在主线程上读取，所有方法都可跨线程调用
+class LoudnessCache
+{
+public:
+    // 结果仍然有效（文件未变化）时返回 true；lookup(path) 会读取文件信息
+    bool lookup(const QString &path, LoudnessInfo *out) const;
+    bool lookup(const QString &path, qint64 size, qint64 mtime, LoudnessInfo *out) const;
+    // 是否有记录（不检查文件是否变化，不访问文件），用于挑出从未分析过的曲目；out 非空时取出记录
+    bool contains(const QString &path, LoudnessInfo *out = nullptr) const;
+    void insert(const QString &path, qint64 size, qint64 mtime, const LoudnessInfo &info);
+    void retain(const QSet<QString> &keep);
+    int count() const;
+
+    // 分析一首曲目并写入缓存（已有有效结果时直接返回）；返回 false 表示被取消或文件不存在
+    bool analyze(const QString &path, const std::function<bool()> &cancelled);
+
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+    bool isDirty() const;
+
+    static QString defaultCachePath();
+
+private:
+    struct Entry {
+        qint64 size = 0;
+        qint64 mtime = 0;
+        LoudnessInfo info;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    mutable bool m_dirty = false;
+};
+
+#endif // LOUDNESSCACHE_H
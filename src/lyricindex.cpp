@@ -0,0 +1,367 @@
+#include "lyricindex.h"
+#include "trace.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QRegularExpression>
+#include <QDebug>
+#include <algorithm>
+
+static const quint32 LYRIC_INDEX_MAGIC = 0x4C595249; // "LYRI"
+static const quint32 LYRIC_INDEX_VERSION = 1;
+// 序列化后的最小字节数：文档为路径长度 + 大小 + 修改时间 + 行数，歌词行为时间 + 文本长度
+static const qint64 MIN_DOCUMENT_BYTES = 4 + 8 + 8 + 4;
+static const qint64 MIN_LINE_BYTES = 8 + 4;
+
+bool LyricIndex::isCjk(uint ucs4)
+{
+    return (ucs4 >= 0x4E00 && ucs4 <= 0x9FFF)     // CJK 统一汉字
+        || (ucs4 >= 0x3400 && ucs4 <= 0x4DBF)     // 扩展 A
+        || (ucs4 >= 0x20000 && ucs4 <= 0x2A6DF)   // 扩展 B
+        || (ucs4 >= 0xF900 && ucs4 <= 0xFAFF)     // 兼容汉字
+        || (ucs4 >= 0x3040 && ucs4 <= 0x30FF)     // 平假名 / 片假名
+        || (ucs4 >= 0x31F0 && ucs4 <= 0x31FF)     // 片假名扩展
+        || (ucs4 >= 0xAC00 && ucs4 <= 0xD7AF)     // 韩文音节
+        || (ucs4 >= 0x1100 && ucs4 <= 0x11FF);    // 韩文字母
+}
+
+QString LyricIndex::normalize(const QString &text)
+{
+    // NFKC 统一全角/半角，再做大小写折叠
+    return text.normalized(QString::NormalizationForm_KC).toCaseFolded();
+}
+
+// 分词核心：forQuery 为 true 时，连续的中日韩文字只输出 bigram（单字才输出 unigram），
+// 以提高查询的选择性；建索引时同时输出 unigram 与 bigram，保证单字查询也能命中
+QStringList LyricIndex::tokenizeFolded(const QString &folded, bool forQuery)
+{
+    QStringList tokens;
+    QString word;
+    QVector<uint> cjkRun;
+
+    auto flushWord = [&]() {
+        if (!word.isEmpty()) {
+            tokens.append(word);
+            word.clear();
+        }
+    };
+    auto flushCjk = [&]() {
+        if (cjkRun.isEmpty()) return;
+        if (cjkRun.size() == 1 || !forQuery) {
+            for (uint c : cjkRun) {
+                const char32_t ch = c;
+                tokens.append(QString::fromUcs4(&ch, 1));
+            }
+        }
+        for (int i = 1; i < cjkRun.size(); ++i) {
+            const char32_t pair[2] = { cjkRun[i - 1], cjkRun[i] };
+            tokens.append(QString::fromUcs4(pair, 2));
+        }
+        cjkRun.clear();
+    };
+
+    const QList<uint> chars = folded.toUcs4();
+    for (uint c : chars) {
+        if (isCjk(c)) {
+            flushWord();
+            cjkRun.append(c);
+        } else if (QChar::isLetterOrNumber(c)) {
+            flushCjk();
+            const char32_t ch = c;
+            word += QString::fromUcs4(&ch, 1);
+        } else {
+            flushWord();
+            flushCjk();
+        }
+    }
+    flushWord();
+    flushCjk();
+    return tokens;
+}
+
+QStringList LyricIndex::tokenize(const QString &text)
+{
+    return tokenizeFolded(normalize(text), false);
+}
+
+QVector<LyricLine> LyricIndex::parseLines(const QString &lyricsText, bool keepBlank)
+{
+    QVector<LyricLine> result;
+    if (lyricsText.isEmpty()) return result;
+
+    static const QRegularExpression timeRe(R"(^\[(\d{1,3}):(\d{2})(?:[.:](\d{1,3}))?\])");
+    static const QRegularExpression tagRe(R"(^\[[a-zA-Z]+:[^\]]*\]$)");
+
+    const QStringList rawLines = lyricsText.split(QRegularExpression(R"(\r\n|\r|\n)"), Qt::SkipEmptyParts);
+    for (const QString &raw : rawLines) {
+        QString line = raw.trimmed();
+        if (line.isEmpty() || tagRe.match(line).hasMatch()) continue; // [ar:..] [ti:..] 等标签行
+
+        // 一行可能带有多个时间戳：[00:12.00][01:30.00]歌词
+        QVector<qint64> times;
+        QRegularExpressionMatch m = timeRe.match(line);
+        while (m.hasMatch()) {
+            qint64 ms = (m.captured(1).toLongLong() * 60 + m.captured(2).toLongLong()) * 1000;
+            const QString frac = m.captured(3);
+            if (frac.size() == 1) ms += frac.toInt() * 100;
+            else if (frac.size() == 2) ms += frac.toInt() * 10;
+            else if (frac.size() == 3) ms += frac.toInt();
+            times.append(ms);
+            line = line.mid(m.capturedLength());
+            m = timeRe.match(line);
+        }
+
+        const QString text = line.trimmed();
+        if (text.isEmpty() && (times.isEmpty() || !keepBlank)) continue;
+
+        if (times.isEmpty()) {
+            result.append({ -1, text });
+        } else {
+            for (qint64 t : times) result.append({ t, text });
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const LyricLine &a, const LyricLine &b) {
+        return a.timeMs < b.timeMs;
+    });
+    return result;
+}
+
+QString LyricIndex::defaultCachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/library/lyrics.idx";
+}
+
+bool LyricIndex::isUpToDate(const QString &path, qint64 size, qint64 mtime) const
+{
+    auto it = m_docByPath.constFind(path);
+    if (it == m_docByPath.constEnd()) return false;
+    const Document &d = m_docs[it.value()];
+    return d.size == size && d.mtime == mtime;
+}
+
+void LyricIndex::updateDocument(const QString &path, qint64 size, qint64 mtime, const QString &lyricsText)
+{
+    removeDocument(path);
+
+    QVector<LyricLine> lines = parseLines(lyricsText);
+
+    int docId;
+    if (!m_freeSlots.isEmpty()) {
+        docId = m_freeSlots.takeLast();
+    } else {
+        docId = m_docs.size();
+        m_docs.append(Document());
+    }
+
+    Document &d = m_docs[docId];
+    d.path = path;
+    d.size = size;
+    d.mtime = mtime;
+    d.lines = std::move(lines);
+    d.alive = true;
+    m_docByPath.insert(path, docId);
+    indexDocument(docId);
+    m_dirty = true;
+}
+
+void LyricIndex::removeDocument(const QString &path)
+{
+    auto it = m_docByPath.find(path);
+    if (it == m_docByPath.end()) return;
+    const int docId = it.value();
+    m_docByPath.erase(it);
+
+    unindexDocument(docId);
+    m_docs[docId] = Document();
+    m_docs[docId].alive = false;
+    m_freeSlots.append(docId);
+    m_dirty = true;
+}
+
+void LyricIndex::retainDocuments(const QSet<QString> &keep)
+{
+    QStringList stale;
+    for (auto it = m_docByPath.constBegin(); it != m_docByPath.constEnd(); ++it) {
+        if (!keep.contains(it.key())) stale.append(it.key());
+    }
+    for (const QString &path : stale) removeDocument(path);
+}
+
+void LyricIndex::indexDocument(int docId)
+{
+    Document &d = m_docs[docId];
+    d.foldedLines.resize(d.lines.size());
+    for (int i = 0; i < d.lines.size(); ++i) {
+        d.foldedLines[i] = normalize(d.lines[i].text);
+        QStringList tokens = tokenizeFolded(d.foldedLines[i], false);
+        tokens.removeDuplicates();
+        for (const QString &tok : tokens) {
+            m_postings[tok].append({ docId, i });
+        }
+    }
+}
+
+void LyricIndex::unindexDocument(int docId)
+{
+    const Document &d = m_docs[docId];
+    QSet<QString> tokens;
+    for (const QString &folded : d.foldedLines) {
+        for (const QString &tok : tokenizeFolded(folded, false)) tokens.insert(tok);
+    }
+    for (const QString &tok : tokens) {
+        auto it = m_postings.find(tok);
+        if (it == m_postings.end()) continue;
+        QVector<Posting> &list = it.value();
+        list.erase(std::remove_if(list.begin(), list.end(), [docId](const Posting &p) {
+            return p.doc == docId;
+        }), list.end());
+        if (list.isEmpty()) m_postings.erase(it);
+    }
+}
+
+QVector<LyricHit> LyricIndex::search(const QString &query, int limit) const
+{
+    QVector<LyricHit> hits;
+    const QString foldedQuery = normalize(query).simplified();
+    if (foldedQuery.isEmpty() || limit <= 0) return hits;
+
+    const QStringList tokens = tokenizeFolded(foldedQuery, true);
+    if (tokens.isEmpty()) return hits;
+
+    // 正在输入的最后一个拉丁单词按前缀匹配
+    const QString lastToken = tokens.last();
+    const bool prefixLast = !query.endsWith(' ') && !isCjk(lastToken.toUcs4().value(0));
+
+    auto key = [](const Posting &p) { return (quint64(quint32(p.doc)) << 32) | quint32(p.line); };
+
+    QSet<quint64> candidates;
+    bool first = true;
+    for (int t = 0; t < tokens.size(); ++t) {
+        QSet<quint64> current;
+        if (t == tokens.size() - 1 && prefixLast) {
+            for (auto it = m_postings.lowerBound(lastToken);
+                 it != m_postings.constEnd() && it.key().startsWith(lastToken); ++it) {
+                for (const Posting &p : it.value()) current.insert(key(p));
+            }
+        } else {
+            auto it = m_postings.constFind(tokens[t]);
+            if (it == m_postings.constEnd()) return hits;
+            for (const Posting &p : it.value()) current.insert(key(p));
+        }
+
+        if (first) {
+            candidates = std::move(current);
+            first = false;
+        } else {
+            candidates.intersect(current);
+        }
+        if (candidates.isEmpty()) return hits;
+    }
+
+    // 整句短语命中排在前面，其余按文档/行号排序保证结果稳定
+    QVector<quint64> ordered(candidates.cbegin(), candidates.cend());
+    std::sort(ordered.begin(), ordered.end());
+    QVector<LyricHit> phraseHits;
+    QVector<LyricHit> tokenHits;
+    for (quint64 k : ordered) {
+        const int docId = int(k >> 32);
+        const int line = int(k & 0xffffffffu);
+        const Document &d = m_docs[docId];
+        if (!d.alive || line >= d.lines.size()) continue;
+
+        LyricHit hit { d.path, d.lines[line].text, d.lines[line].timeMs };
+        if (d.foldedLines[line].contains(foldedQuery)) phraseHits.append(hit);
+        else tokenHits.append(hit);
+        if (phraseHits.size() >= limit) break;
+    }
+
+    hits = phraseHits;
+    for (const LyricHit &h : tokenHits) {
+        if (hits.size() >= limit) break;
+        hits.append(h);
+    }
+    return hits;
+}
+
+bool LyricIndex::load(const QString &filePath)
+{
+    TRACE_SCOPE("LyricIndex::load");
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_2);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != LYRIC_INDEX_MAGIC || version != LYRIC_INDEX_VERSION) {
+        qWarning() << "LyricIndex::load - 缓存格式不匹配，忽略:" << filePath;
+        return false;
+    }
+
+    m_docs.clear();
+    m_docByPath.clear();
+    m_postings.clear();
+    m_freeSlots.clear();
+
+    // 计数来自文件本身：与剩余字节数对不上时按损坏处理，不按它预留内存
+    qint32 docCount = 0;
+    in >> docCount;
+    if (docCount < 0 || docCount > file.bytesAvailable() / MIN_DOCUMENT_BYTES) {
+        in.setStatus(QDataStream::ReadCorruptData);
+    }
+    for (qint32 i = 0; i < docCount && in.status() == QDataStream::Ok; ++i) {
+        Document d;
+        qint32 lineCount = 0;
+        in >> d.path >> d.size >> d.mtime >> lineCount;
+        if (lineCount < 0 || lineCount > file.bytesAvailable() / MIN_LINE_BYTES) {
+            in.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+        d.lines.reserve(lineCount);
+        for (qint32 j = 0; j < lineCount && in.status() == QDataStream::Ok; ++j) {
+            LyricLine l;
+            in >> l.timeMs >> l.text;
+            d.lines.append(l);
+        }
+        const int docId = m_docs.size();
+        m_docs.append(std::move(d));
+        m_docByPath.insert(m_docs[docId].path, docId);
+        indexDocument(docId);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "LyricIndex::load - 缓存文件损坏:" << filePath;
+        m_docs.clear();
+        m_docByPath.clear();
+        m_postings.clear();
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+bool LyricIndex::save(const QString &filePath) const
+{
+    TRACE_SCOPE("LyricIndex::save");
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << LYRIC_INDEX_MAGIC << LYRIC_INDEX_VERSION << qint32(m_docByPath.size());
+    for (const Document &d : m_docs) {
+        if (!d.alive || d.path.isEmpty()) continue;
+        out << d.path << d.size << d.mtime << qint32(d.lines.size());
+        for (const LyricLine &l : d.lines) out << l.timeMs << l.text;
+    }
+
+    if (!file.commit()) return false;
+    m_dirty = false;
+    return true;
+}
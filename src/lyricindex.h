@@ -0,0 +1,83 @@
+#ifndef LYRICINDEX_H
+#define LYRICINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+
+// 单行歌词：时间戳（毫秒，无时间戳的纯文本歌词为 -1）+ 文本
+struct LyricLine {
+    qint64 timeMs = -1;
+    QString text;
+};
+
+// 搜索命中结果
+struct LyricHit {
+    QString path;     // 音频文件绝对路径
+    QString line;     // 命中的歌词原文
+    qint64 timeMs;    // 该行时间戳（毫秒），-1 表示无时间戳
+};
+
+// 全库歌词倒排索引
+// - 文档以音频文件路径为键，按文件大小/修改时间判断是否需要重建，扫描时增量更新
+// - 拉丁文字按单词切分，中日韩文字按单字 + 双字（bigram）切分
+// - 持久化到库缓存目录，倒排表在加载时由歌词行重建
+class LyricIndex
+{
+public:
+    LyricIndex() = default;
+
+    // 扫描时调用：文档未变化时直接返回 false，不重新分词
+    bool isUpToDate(const QString &path, qint64 size, qint64 mtime) const;
+    void updateDocument(const QString &path, qint64 size, qint64 mtime, const QString &lyricsText);
+    void removeDocument(const QString &path);
+    // 移除不在 keep 集合中的文档（用于重新扫描文件夹后清理）
+    void retainDocuments(const QSet<QString> &keep);
+
+    QVector<LyricHit> search(const QString &query, int limit = 50) const;
+
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+    bool isDirty() const { return m_dirty; }
+
+    int documentCount() const { return m_docs.size(); }
+    QStringList documentPaths() const { return m_docByPath.keys(); }
+
+    // 解析 LRC / 纯文本歌词为行列表（支持一行多个时间戳）；keepBlank 时保留只有时间戳的空行（播放时用于清空当前歌词）
+    static QVector<LyricLine> parseLines(const QString &lyricsText, bool keepBlank = false);
+    // 分词：结果为规范化（case folded）后的 token
+    static QStringList tokenize(const QString &text);
+    static QString defaultCachePath();
+
+private:
+    struct Document {
+        QString path;
+        qint64 size = 0;
+        qint64 mtime = 0;
+        QVector<LyricLine> lines;
+        QVector<QString> foldedLines; // 规范化后的行文本，用于短语校验
+        bool alive = true;
+    };
+
+    struct Posting {
+        int doc;
+        int line;
+    };
+
+    void indexDocument(int docId);
+    void unindexDocument(int docId);
+    static QString normalize(const QString &text);
+    static QStringList tokenizeFolded(const QString &folded, bool forQuery);
+    static bool isCjk(uint ucs4);
+
+    QVector<Document> m_docs;                 // 文档槽位（删除后留空以保持 docId 稳定）
+    QHash<QString, int> m_docByPath;
+    QMap<QString, QVector<Posting>> m_postings; // 有序，便于末尾 token 前缀匹配
+    QVector<int> m_freeSlots;
+    mutable bool m_dirty = false;
+};
+
+#endif // LYRICINDEX_H
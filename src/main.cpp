@@ -6,6 +6,19 @@
 #include <QQuickStyle>
 #include "playlistmodel.h"
 #include "playerbackend.h"
+#include "animatedbackground.h"
+#include "backgroundthumbnails.h"
+#include "edgehotzone.h"
+#include "startuptimeline.h"
+#include "singleinstance.h"
+#include "trace.h"
+#include "metrics.h"
+#include "headless.h"
+#include "metadataprobe.h"
+#include <QQuickWindow>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
 
 #ifdef WIN32
 #include <windows.h>
@@ -13,29 +26,74 @@
 
 int main(int argc, char *argv[])
 {
-#ifdef WIN32
-    // 确保设置为GUI应用程序
-    ShowWindow(GetConsoleWindow(), SW_HIDE);
-#endif
+    StartupTimeline::start();
 
     // 设置 FFmpeg 日志级别为 quiet 以禁用调试输出
     qputenv("AV_LOG_LEVEL", "quiet");
     qputenv("FFREPORT", "file=nul:");
     qputenv("QT_LOGGING_RULES", "*.debug=false;*.info=false");
+
+    // 元数据读取辅助进程（见 ProbePool）
+    if (MetadataProbe::isHelper(argc, argv)) {
+        return MetadataProbe::runHelper(argc, argv);
+    }
+
+    // --headless：不创建窗口与 QML 引擎，运行扫描/分析任务后退出
+    if (Headless::requested(argc, argv)) {
+        return Headless::run(argc, argv);
+    }
+
+#ifdef WIN32
+    // 确保设置为GUI应用程序
+    ShowWindow(GetConsoleWindow(), SW_HIDE);
+#endif
     
     QApplication app(argc, argv);
+
+    // --trace[=文件]：从启动开始记录追踪事件，退出时导出 trace-event JSON
+    QStringList rawArguments = app.arguments();
+    QString traceFile;
+    for (int i = rawArguments.size() - 1; i >= 1; --i) {
+        const QString &arg = rawArguments.at(i);
+        if (arg == "--trace" || arg.startsWith("--trace=")) {
+            traceFile = arg.contains('=') ? arg.section('=', 1) : Trace::defaultDumpPath();
+            rawArguments.removeAt(i);
+        }
+    }
+    if (!traceFile.isEmpty()) {
+        Trace::setEnabled(true);
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [traceFile]() { Trace::dumpJson(traceFile); });
+    }
+
+    // 已有实例在运行：转交参数后立即退出
+    const QStringList arguments = SingleInstance::normalizeArguments(rawArguments);
+    if (SingleInstance::forwardToRunning(arguments)) {
+        return 0;
+    }
+    SingleInstance instance;
+    if (!instance.listen() && SingleInstance::forwardWhenReady(arguments, 3000)) {
+        // 与另一个进程同时启动，对方成为主实例
+        return 0;
+    }
     
     // 设置Basic样式以支持控件自定义
     QQuickStyle::setStyle("Basic");
 
     qmlRegisterType<PlaylistModel>("App", 1, 0, "PlaylistModel");
+    qmlRegisterType<AnimatedBackground>("App", 1, 0, "AnimatedBackground");
 
     PlaylistModel playlist;
     PlayerBackend backend(&playlist);
+    EdgeHotZone edgeHotZone;
+    QObject::connect(&instance, &SingleInstance::argumentsReceived, &backend, &PlayerBackend::handleArguments);
+    if (!arguments.isEmpty()) backend.handleArguments(arguments);
 
     QQmlApplicationEngine engine;
+    engine.addImageProvider("bgthumb", new BackgroundThumbnailProvider);
     engine.rootContext()->setContextProperty("playlistModel", &playlist);
     engine.rootContext()->setContextProperty("playerBackend", &backend);
+    engine.rootContext()->setContextProperty("edgeHotZone", &edgeHotZone);
+    engine.rootContext()->setContextProperty("metrics", Metrics::instance());
 
     // load main QML from resource
     const QUrl url(QStringLiteral("qrc:/qml/main.qml"));
@@ -46,5 +104,28 @@ int main(int argc, char *argv[])
 
     engine.load(url);
 
+    // 记录首帧时间（只取第一次 frameSwapped）
+    if (!engine.rootObjects().isEmpty()) {
+        if (auto *window = qobject_cast<QQuickWindow *>(engine.rootObjects().first())) {
+            auto connection = std::make_shared<QMetaObject::Connection>();
+            *connection = QObject::connect(window, &QQuickWindow::frameSwapped, &backend, [connection, &backend]() {
+                QObject::disconnect(*connection);
+                backend.markStartup("firstFrame");
+            });
+
+            // 每帧在渲染线程上从同步到交换缓冲的耗时（两个信号都在渲染线程直接处理）
+            auto frameClock = std::make_shared<QElapsedTimer>();
+            auto frameStart = std::make_shared<std::atomic<qint64>>(-1);
+            frameClock->start();
+            QObject::connect(window, &QQuickWindow::beforeSynchronizing, window, [frameClock, frameStart]() {
+                frameStart->store(frameClock->nsecsElapsed(), std::memory_order_relaxed);
+            }, Qt::DirectConnection);
+            QObject::connect(window, &QQuickWindow::frameSwapped, window, [frameClock, frameStart]() {
+                const qint64 start = frameStart->exchange(-1, std::memory_order_relaxed);
+                if (start >= 0) Metrics::record(Metrics::QmlFrame, frameClock->nsecsElapsed() - start);
+            }, Qt::DirectConnection);
+        }
+    }
+
     return app.exec();
 }
\ No newline at end of file
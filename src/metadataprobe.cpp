@@ -0,0 +1,356 @@
+#include "metadataprobe.h"
+#include "metrics.h"
+#include "trace.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QGuiApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QEventLoop>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMediaMetaData>
+#include <QMediaPlayer>
+#include <QProcess>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QUrl>
+#include <QDebug>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static const char *const HELPER_ARGUMENT = "--probe-helper";
+static const int HARD_TIMEOUT_MS = MetadataProbe::PROBE_TIMEOUT_MS + 3000; // 另含辅助进程启动时间
+static const int HELPER_START_TIMEOUT_MS = 3000;
+static const int MAX_HELPERS = 4;
+
+// 封面缓存文件：以“路径 + 大小 + 修改时间”命名，文件未变化时每次扫描得到同一个地址，
+// 不会被当作元数据变化，也不必重复写盘
+static QString coverCachePath(const QString &filePath)
+{
+    const QFileInfo info(filePath);
+    const QString key = QString("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.size())
+                            .arg(info.lastModified().toMSecsSinceEpoch());
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/covers/"
+         + QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex()) + ".jpg";
+}
+
+static bool saveCover(const QImage &image, const QString &coverPath)
+{
+    if (QFileInfo::exists(coverPath)) return true;
+    // 多个辅助进程可能同时写同一首曲目的封面：写入临时文件后再原子替换
+    QDir().mkpath(QFileInfo(coverPath).absolutePath());
+    QSaveFile file(coverPath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    if (!image.save(&file, "JPG", 90)) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+static const char *statusName(ProbeResult::Status status)
+{
+    switch (status) {
+    case ProbeResult::Ok: return "ok";
+    case ProbeResult::Invalid: return "invalid";
+    case ProbeResult::Timeout: return "timeout";
+    case ProbeResult::Crashed: return "crashed";
+    case ProbeResult::Skipped: return "skipped";
+    }
+    return "invalid";
+}
+
+static QByteArray toJsonLine(const ProbeResult &result)
+{
+    QJsonObject obj;
+    obj["status"] = statusName(result.status);
+    obj["title"] = result.title;
+    obj["artist"] = result.artist;
+    obj["album"] = result.album;
+    obj["lyrics"] = result.lyrics;
+    obj["cover"] = result.cover;
+    obj["duration"] = result.duration;
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact) + '\n';
+}
+
+static bool fromJsonLine(const QByteArray &line, ProbeResult *result)
+{
+    const QJsonObject obj = QJsonDocument::fromJson(line.trimmed()).object();
+    if (obj.isEmpty()) return false;
+    const QString status = obj.value("status").toString();
+    result->status = status == "ok" ? ProbeResult::Ok
+                   : status == "timeout" ? ProbeResult::Timeout
+                   : ProbeResult::Invalid;
+    result->title = obj.value("title").toString();
+    result->artist = obj.value("artist").toString();
+    result->album = obj.value("album").toString();
+    result->lyrics = obj.value("lyrics").toString();
+    result->cover = obj.value("cover").toString();
+    result->duration = obj.value("duration").toInt();
+    return true;
+}
+
+namespace MetadataProbe {
+
+ProbeResult probeInProcess(const QString &filePath, int timeoutMs)
+{
+    TRACE_SCOPE("MetadataProbe::probeInProcess");
+    ProbeResult result;
+    result.status = ProbeResult::Timeout;
+
+    // 只读取元数据，不需要音频输出
+    QMediaPlayer player;
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    timer.setInterval(timeoutMs);
+
+    QObject::connect(&player, &QMediaPlayer::mediaStatusChanged, [&](QMediaPlayer::MediaStatus status) {
+        if (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::BufferedMedia) {
+            result.status = ProbeResult::Ok;
+            const QMediaMetaData metaData = player.metaData();
+
+            result.title = metaData.value(QMediaMetaData::Title).toString();
+
+            // 艺术家：依次尝试 Author、AlbumArtist、ContributingArtist
+            if (metaData.value(QMediaMetaData::Author).isValid()) {
+                result.artist = metaData.value(QMediaMetaData::Author).toString();
+            } else if (metaData.value(QMediaMetaData::AlbumArtist).isValid()) {
+                result.artist = metaData.value(QMediaMetaData::AlbumArtist).toString();
+            } else if (metaData.value(QMediaMetaData::ContributingArtist).isValid()) {
+                result.artist = metaData.value(QMediaMetaData::ContributingArtist).toString();
+            }
+
+            result.album = metaData.value(QMediaMetaData::AlbumTitle).toString();
+            if (metaData.value(QMediaMetaData::Duration).isValid()) {
+                result.duration = metaData.value(QMediaMetaData::Duration).toInt();
+            }
+
+            // 歌词：遍历所有元数据，取较长且像歌词的文本（通常包含换行符）
+            for (auto metaKey : metaData.keys()) {
+                const QVariant value = metaData.value(metaKey);
+                if (value.isValid() && value.canConvert<QString>()) {
+                    const QString valueStr = value.toString();
+                    if (valueStr.length() > 50 &&
+                        (valueStr.contains('\n') || valueStr.contains('\r') ||
+                         valueStr.contains("lyric", Qt::CaseInsensitive) ||
+                         valueStr.contains("text", Qt::CaseInsensitive))) {
+                        result.lyrics = valueStr;
+                        break;
+                    }
+                }
+            }
+
+            // 封面：CoverArtImage，其次 ThumbnailImage
+            QImage coverImage;
+            if (metaData.value(QMediaMetaData::CoverArtImage).isValid()) {
+                coverImage = metaData.value(QMediaMetaData::CoverArtImage).value<QImage>();
+            } else if (metaData.value(QMediaMetaData::ThumbnailImage).isValid()) {
+                coverImage = metaData.value(QMediaMetaData::ThumbnailImage).value<QImage>();
+            }
+            if (!coverImage.isNull()) {
+                const QString coverPath = coverCachePath(filePath);
+                if (saveCover(coverImage, coverPath)) {
+                    result.cover = QUrl::fromLocalFile(coverPath).toString();
+                } else {
+                    qDebug() << "MetadataProbe - 封面保存失败:" << filePath;
+                }
+            }
+            loop.quit();
+        } else if (status == QMediaPlayer::InvalidMedia) {
+            result.status = ProbeResult::Invalid;
+            loop.quit();
+        }
+    });
+    QObject::connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+    timer.start();
+    // 不调用 play()，只设置源就足够触发元数据加载
+    player.setSource(QUrl::fromLocalFile(filePath));
+    if (result.status == ProbeResult::Timeout) loop.exec();
+    return result;
+}
+
+bool isHelper(int argc, char *argv[])
+{
+    return argc > 1 && std::strcmp(argv[1], HELPER_ARGUMENT) == 0;
+}
+
+int runHelper(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    // 父进程关闭标准输入（或退出）时结束
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        const QString path = QUrl::fromPercentEncoding(QByteArray::fromStdString(line).trimmed());
+        if (path.isEmpty()) continue;
+        const QByteArray out = toJsonLine(probeInProcess(path));
+        std::fwrite(out.constData(), 1, size_t(out.size()), stdout);
+        std::fflush(stdout);
+    }
+    return 0;
+}
+
+} // namespace MetadataProbe
+
+ProbePool::ProbePool(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ProbePool::~ProbePool()
+{
+    for (auto &slot : m_slots) stopHelper(*slot);
+}
+
+bool ProbePool::startHelper(Slot &slot)
+{
+    auto *process = new QProcess(this);
+    process->setProgram(QCoreApplication::applicationFilePath());
+    process->setArguments({ QString::fromLatin1(HELPER_ARGUMENT) });
+    process->setStandardErrorFile(QProcess::nullDevice());
+    process->start();
+    if (!process->waitForStarted(HELPER_START_TIMEOUT_MS)) {
+        qWarning() << "ProbePool - 无法启动元数据辅助进程:" << process->errorString();
+        delete process;
+        return false;
+    }
+
+    Slot *s = &slot;
+    connect(process, &QProcess::readyReadStandardOutput, this, [this, s]() { onOutput(*s); });
+    connect(process, &QProcess::finished, this, [this, s]() { onHelperLost(*s, ProbeResult::Crashed); });
+    slot.process = process;
+    return true;
+}
+
+void ProbePool::stopHelper(Slot &slot)
+{
+    slot.deadline.stop();
+    if (!slot.process) return;
+    slot.process->disconnect(this);
+    slot.process->closeWriteChannel();
+    if (!slot.process->waitForFinished(1000)) {
+        slot.process->kill();
+        slot.process->waitForFinished(1000);
+    }
+    slot.process->deleteLater();
+    slot.process = nullptr;
+}
+
+void ProbePool::dispatch(Slot &slot)
+{
+    if (m_next >= m_paths.size()) return;
+    slot.index = m_next++;
+    slot.clock.start();
+    slot.deadline.start(HARD_TIMEOUT_MS);
+    slot.process->write(QUrl::toPercentEncoding(m_paths.at(slot.index)) + '\n');
+}
+
+void ProbePool::complete(Slot &slot, const ProbeResult &result)
+{
+    slot.deadline.stop();
+    if (slot.index < 0) return;
+    Metrics::record(Metrics::ProbeLatency, slot.clock.nsecsElapsed());
+    if (result.status == ProbeResult::Timeout) Metrics::count(Metrics::MetadataTimeouts);
+    m_results[slot.index] = result;
+    slot.index = -1;
+    if (--m_remaining == 0 && m_loop) m_loop->quit();
+}
+
+void ProbePool::onOutput(Slot &slot)
+{
+    while (slot.process && slot.process->canReadLine()) {
+        ProbeResult result;
+        if (!fromJsonLine(slot.process->readLine(), &result)) continue;
+        complete(slot, result);
+        dispatch(slot);
+    }
+}
+
+void ProbePool::onHelperLost(Slot &slot, ProbeResult::Status status)
+{
+    // 辅助进程卡死（被终止）或崩溃：当前文件记为失败，重启辅助进程继续
+    ProbeResult result;
+    result.status = status;
+    if (slot.index >= 0) {
+        if (status == ProbeResult::Crashed) Metrics::count(Metrics::ProbeHelperCrashes);
+        qWarning() << "ProbePool - 读取元数据失败:" << m_paths.at(slot.index) << statusName(status);
+    }
+    if (slot.process) {
+        slot.process->disconnect(this);
+        slot.process->kill();
+        slot.process->waitForFinished(1000);
+        slot.process->deleteLater();
+        slot.process = nullptr;
+    }
+    complete(slot, result);
+
+    if (m_next >= m_paths.size()) return;
+    if (startHelper(slot)) {
+        dispatch(slot);
+        return;
+    }
+    slot.dead = true;
+    if (std::all_of(m_slots.begin(), m_slots.end(), [](const auto &s) { return s->dead; })) {
+        probeRemainingInProcess();
+    }
+}
+
+void ProbePool::probeRemainingInProcess()
+{
+    while (m_next < m_paths.size()) {
+        const int index = m_next++;
+        QElapsedTimer clock;
+        clock.start();
+        m_results[index] = MetadataProbe::probeInProcess(m_paths.at(index));
+        Metrics::record(Metrics::ProbeLatency, clock.nsecsElapsed());
+        if (m_results[index].status == ProbeResult::Timeout) Metrics::count(Metrics::MetadataTimeouts);
+        --m_remaining;
+    }
+    if (m_remaining == 0 && m_loop) m_loop->quit();
+}
+
+QVector<ProbeResult> ProbePool::probe(const QStringList &paths)
+{
+    TRACE_SCOPE("ProbePool::probe");
+    m_paths = paths;
+    m_results = QVector<ProbeResult>(paths.size());
+    m_next = 0;
+    m_remaining = paths.size();
+    if (paths.isEmpty()) return m_results;
+
+    // 第一次使用时按需启动辅助进程（文件很少时不必启动全部）
+    const int wanted = qMin<int>(paths.size(), qBound(1, QThread::idealThreadCount() / 2, MAX_HELPERS));
+    while (int(m_slots.size()) < wanted) {
+        auto slot = std::make_unique<Slot>();
+        slot->deadline.setSingleShot(true);
+        Slot *s = slot.get();
+        connect(&slot->deadline, &QTimer::timeout, this, [this, s]() { onHelperLost(*s, ProbeResult::Timeout); });
+        slot->dead = !startHelper(*slot);
+        m_slots.push_back(std::move(slot));
+    }
+
+    for (auto &slot : m_slots) {
+        if (!slot->dead && !slot->process) slot->dead = !startHelper(*slot);
+        if (!slot->dead) dispatch(*slot);
+    }
+    if (std::all_of(m_slots.begin(), m_slots.end(), [](const auto &s) { return s->dead; })) {
+        probeRemainingInProcess();
+        return m_results;
+    }
+
+    QEventLoop loop;
+    m_loop = &loop;
+    if (m_remaining > 0) loop.exec();
+    m_loop = nullptr;
+    return m_results;
+}
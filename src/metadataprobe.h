@@ -0,0 +1,89 @@
+#ifndef METADATAPROBE_H
+#define METADATAPROBE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+class QEventLoop;
+class QProcess;
+
+// 一个音频文件的元数据读取结果；读取失败时各字段为空，由调用方按文件名补全
+struct ProbeResult {
+    enum Status {
+        Ok,
+        Invalid,   // 无法识别的文件
+        Timeout,   // 超时未加载完成（含辅助进程卡死被终止）
+        Crashed,   // 辅助进程在读取该文件时崩溃
+        Skipped    // 之前读取失败且文件未变化，本次未读取
+    };
+
+    Status status = Ok;
+    QString title;
+    QString artist;
+    QString album;
+    QString lyrics;
+    QString cover;      // 已保存的封面图片地址
+    int duration = 0;   // ms
+
+    bool failed() const { return status != Ok && status != Skipped; }
+};
+
+namespace MetadataProbe {
+
+// 单个文件的软超时；超过后放弃并记为 Timeout
+static const int PROBE_TIMEOUT_MS = 5000;
+
+// 在当前进程内用 QMediaPlayer 读取元数据（阻塞，内部运行局部事件循环）
+ProbeResult probeInProcess(const QString &filePath, int timeoutMs = PROBE_TIMEOUT_MS);
+
+// 辅助进程：app --probe-helper，从标准输入逐行读取（百分号编码的）路径，
+// 每个文件输出一行 JSON 结果。在创建 QApplication 之前检查
+bool isHelper(int argc, char *argv[]);
+int runHelper(int argc, char *argv[]);
+
+} // namespace MetadataProbe
+
+// 元数据读取的辅助进程池：解码器卡死或崩溃只会终止对应的辅助进程并让当前文件记为失败，
+// 播放器本身不受影响；进程池随即重启该辅助进程继续处理其余文件。
+// 无法启动辅助进程时退回到进程内读取
+class ProbePool : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ProbePool(QObject *parent = nullptr);
+    ~ProbePool() override;
+
+    // 返回与 paths 一一对应的结果；多个辅助进程并行读取
+    QVector<ProbeResult> probe(const QStringList &paths);
+
+private:
+    struct Slot {
+        QProcess *process = nullptr;
+        QTimer deadline;         // 硬超时：辅助进程无响应时强制终止
+        QElapsedTimer clock;
+        int index = -1;          // 正在读取的文件，-1 表示空闲
+        bool dead = false;       // 无法启动，不再使用
+    };
+
+    bool startHelper(Slot &slot);
+    void stopHelper(Slot &slot);
+    void dispatch(Slot &slot);
+    void complete(Slot &slot, const ProbeResult &result);
+    void onOutput(Slot &slot);
+    void onHelperLost(Slot &slot, ProbeResult::Status status);
+    void probeRemainingInProcess();
+
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    QStringList m_paths;
+    QVector<ProbeResult> m_results;
+    int m_next = 0;
+    int m_remaining = 0;
+    QEventLoop *m_loop = nullptr;
+};
+
+#endif // METADATAPROBE_H
@@ -0,0 +1,187 @@
+#include "metrics.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVariantList>
+#include <QtAlgorithms>
+#include <QDebug>
+
+static const int REFRESH_INTERVAL_MS = 500;
+
+namespace {
+
+struct Histogram {
+    std::atomic<quint64> buckets[Metrics::BUCKET_COUNT] = {};
+    std::atomic<quint64> count{ 0 };
+    std::atomic<quint64> sumNs{ 0 };
+    std::atomic<quint64> maxNs{ 0 };
+};
+
+std::atomic<quint64> s_counters[Metrics::CounterCount] = {};
+Histogram s_histograms[Metrics::HistogramCount];
+
+const char *const COUNTER_NAMES[Metrics::CounterCount] = {
+    "filesScanned", "metadataTimeouts", "probeFailuresSkipped", "probeHelperCrashes", "settingsWrites",
+    "backgroundCacheHits", "backgroundCacheMisses",
+    "thumbnailCacheHits", "thumbnailCacheMisses",
+    "lyricIndexHits", "lyricIndexMisses",
+    "jobsCompleted", "jobsCancelled", "jobsStolen",
+    "prefetchHits", "prefetchMisses",
+};
+
+const char *const HISTOGRAM_NAMES[Metrics::HistogramCount] = {
+    "probeLatency", "searchLatency", "trackSwitchLatency", "spectrumFrame", "qmlFrame",
+};
+
+int bucketFor(qint64 ns)
+{
+    const quint64 us = quint64(qMax<qint64>(0, ns)) / 1000;
+    const int bits = us == 0 ? 0 : 64 - qCountLeadingZeroBits(us);
+    return qMin(bits, Metrics::BUCKET_COUNT - 1);
+}
+
+// 桶的上界（毫秒），用于估算分位数
+double bucketUpperMs(int bucket)
+{
+    return double(quint64(1) << bucket) / 1000.0;
+}
+
+double percentileMs(const quint64 *buckets, quint64 total, double fraction)
+{
+    if (total == 0) return 0.0;
+    const quint64 target = quint64(fraction * double(total - 1)) + 1;
+    quint64 seen = 0;
+    for (int b = 0; b < Metrics::BUCKET_COUNT; ++b) {
+        seen += buckets[b];
+        if (seen >= target) return bucketUpperMs(b);
+    }
+    return bucketUpperMs(Metrics::BUCKET_COUNT - 1);
+}
+
+} // namespace
+
+Metrics::Metrics(QObject *parent)
+    : QObject(parent)
+{
+    m_refreshTimer.setInterval(REFRESH_INTERVAL_MS);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &Metrics::updated);
+}
+
+Metrics *Metrics::instance()
+{
+    static Metrics *metrics = new Metrics(QCoreApplication::instance());
+    return metrics;
+}
+
+void Metrics::count(CounterId id, quint64 delta)
+{
+    s_counters[id].fetch_add(delta, std::memory_order_relaxed);
+}
+
+void Metrics::record(HistogramId id, qint64 ns)
+{
+    Histogram &h = s_histograms[id];
+    const quint64 value = quint64(qMax<qint64>(0, ns));
+    h.buckets[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+    h.count.fetch_add(1, std::memory_order_relaxed);
+    h.sumNs.fetch_add(value, std::memory_order_relaxed);
+    quint64 max = h.maxNs.load(std::memory_order_relaxed);
+    while (value > max && !h.maxNs.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void Metrics::setLive(bool live)
+{
+    if (live == m_refreshTimer.isActive()) return;
+    if (live) {
+        m_refreshTimer.start();
+        emit updated();
+    } else {
+        m_refreshTimer.stop();
+    }
+    emit liveChanged();
+}
+
+QVariantMap Metrics::snapshot() const
+{
+    QVariantMap counters;
+    for (int c = 0; c < CounterCount; ++c) {
+        counters[COUNTER_NAMES[c]] = s_counters[c].load(std::memory_order_relaxed);
+    }
+
+    QVariantMap histograms;
+    for (int i = 0; i < HistogramCount; ++i) {
+        const Histogram &h = s_histograms[i];
+        quint64 buckets[BUCKET_COUNT];
+        quint64 total = 0;
+        QVariantList bucketList;
+        for (int b = 0; b < BUCKET_COUNT; ++b) {
+            buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+            total += buckets[b];
+            bucketList.append(buckets[b]);
+        }
+        QVariantMap row;
+        row["count"] = total;
+        row["meanMs"] = total ? double(h.sumNs.load(std::memory_order_relaxed)) / total / 1e6 : 0.0;
+        row["maxMs"] = double(h.maxNs.load(std::memory_order_relaxed)) / 1e6;
+        row["p50Ms"] = percentileMs(buckets, total, 0.50);
+        row["p95Ms"] = percentileMs(buckets, total, 0.95);
+        row["p99Ms"] = percentileMs(buckets, total, 0.99);
+        row["buckets"] = bucketList;
+        histograms[HISTOGRAM_NAMES[i]] = row;
+    }
+
+    // 命中率（没有访问时为 -1）
+    auto ratio = [](CounterId hits, CounterId misses) {
+        const quint64 h = s_counters[hits].load(std::memory_order_relaxed);
+        const quint64 m = s_counters[misses].load(std::memory_order_relaxed);
+        return h + m ? double(h) / double(h + m) : -1.0;
+    };
+    QVariantMap hitRates;
+    hitRates["background"] = ratio(BackgroundCacheHits, BackgroundCacheMisses);
+    hitRates["thumbnail"] = ratio(ThumbnailCacheHits, ThumbnailCacheMisses);
+    hitRates["lyricIndex"] = ratio(LyricIndexHits, LyricIndexMisses);
+
+    QVariantMap map;
+    map["counters"] = counters;
+    map["histograms"] = histograms;
+    map["hitRates"] = hitRates;
+    return map;
+}
+
+QString Metrics::toJson() const
+{
+    return QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(snapshot())).toJson(QJsonDocument::Indented));
+}
+
+bool Metrics::dumpJson(const QString &filePath) const
+{
+    const QString path = filePath.isEmpty()
+        ? QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/metrics/metrics-"
+              + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json"
+        : filePath;
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(toJson().toUtf8());
+    if (!file.commit()) return false;
+    qInfo() << "Metrics - 已导出:" << path;
+    return true;
+}
+
+void Metrics::reset()
+{
+    for (auto &counter : s_counters) counter.store(0, std::memory_order_relaxed);
+    for (Histogram &h : s_histograms) {
+        for (auto &bucket : h.buckets) bucket.store(0, std::memory_order_relaxed);
+        h.count.store(0, std::memory_order_relaxed);
+        h.sumNs.store(0, std::memory_order_relaxed);
+        h.maxNs.store(0, std::memory_order_relaxed);
+    }
+    emit updated();
+}
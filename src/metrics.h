@@ -0,0 +1,90 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <atomic>
+
+// 常驻的运行时指标：计数器与固定分桶直方图，全部为原子操作，可在任意线程记录（几纳秒）。
+// Metrics::instance() 以属性形式提供快照给调试浮层，也可导出为 JSON。
+// 与 Trace 不同，指标始终开启，只保存聚合值
+class Metrics : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariantMap snapshot READ snapshot NOTIFY updated)
+    // 浮层显示时才定时刷新快照
+    Q_PROPERTY(bool live READ live WRITE setLive NOTIFY liveChanged)
+
+public:
+    enum CounterId {
+        FilesScanned,
+        MetadataTimeouts,
+        ProbeFailuresSkipped,  // 之前读取失败且文件未变，跳过读取
+        ProbeHelperCrashes,
+        SettingsWrites,
+        BackgroundCacheHits,
+        BackgroundCacheMisses,
+        ThumbnailCacheHits,
+        ThumbnailCacheMisses,
+        LyricIndexHits,
+        LyricIndexMisses,
+        JobsCompleted,
+        JobsCancelled,
+        JobsStolen,            // 工作线程从其它线程的队列窃取的任务
+        PrefetchHits,          // 切歌时直接使用预取的下一首
+        PrefetchMisses,
+        CounterCount
+    };
+
+    enum HistogramId {
+        ProbeLatency,        // 单个文件的元数据读取
+        SearchLatency,       // 歌词全文搜索
+        TrackSwitchLatency,  // playIndex → PlayingState
+        SpectrumFrame,       // 一次频谱更新
+        QmlFrame,            // 渲染线程上同步到交换缓冲的耗时
+        HistogramCount
+    };
+
+    // 分桶按 2 的幂划分（微秒）：桶 i 覆盖 [2^(i-1), 2^i) µs，最后一桶收纳更长的耗时
+    static const int BUCKET_COUNT = 24;
+
+    static Metrics *instance();
+
+    static void count(CounterId id, quint64 delta = 1);
+    static void record(HistogramId id, qint64 ns);
+
+    // 作用域计时：析构时记录到直方图
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(HistogramId id) : m_id(id) { m_timer.start(); }
+        ~ScopedTimer() { record(m_id, m_timer.nsecsElapsed()); }
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        HistogramId m_id;
+        QElapsedTimer m_timer;
+    };
+
+    QVariantMap snapshot() const;
+    bool live() const { return m_refreshTimer.isActive(); }
+    void setLive(bool live);
+
+    Q_INVOKABLE QString toJson() const;
+    Q_INVOKABLE bool dumpJson(const QString &filePath = QString()) const;
+    Q_INVOKABLE void reset();
+
+signals:
+    void updated();
+    void liveChanged();
+
+private:
+    explicit Metrics(QObject *parent = nullptr);
+
+    QTimer m_refreshTimer;
+};
+
+#endif // METRICS_H
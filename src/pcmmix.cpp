@@ -0,0 +1,80 @@
+#include "pcmmix.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PCMMIX_SSE2 1
+#endif
+
+static const double HALF_PI = 1.57079632679489661923;
+static const qsizetype CHUNK_FRAMES = 256;   // 每次预先计算的增益个数
+
+// 计算一段帧的淡出/淡入增益
+static void computeGains(float *gOut, float *gIn, qsizetype frames, qsizetype pos, qsizetype total)
+{
+    const double scale = HALF_PI / double(total);
+    for (qsizetype i = 0; i < frames; ++i) {
+        const double a = (double(pos + i) + 0.5) * scale;
+        gOut[i] = float(std::cos(a));
+        gIn[i] = float(std::sin(a));
+    }
+}
+
+// 立体声：每个 __m128 装两帧，增益按 {g0, g0, g1, g1} 展开
+static void mixStereo(float *out, const float *in, const float *gOut, const float *gIn, qsizetype frames)
+{
+    qsizetype f = 0;
+#ifdef PCMMIX_SSE2
+    for (; f + 2 <= frames; f += 2) {
+        const __m128 go = _mm_setr_ps(gOut[f], gOut[f], gOut[f + 1], gOut[f + 1]);
+        const __m128 gi = _mm_setr_ps(gIn[f], gIn[f], gIn[f + 1], gIn[f + 1]);
+        const __m128 a = _mm_loadu_ps(out + f * 2);
+        const __m128 b = _mm_loadu_ps(in + f * 2);
+        _mm_storeu_ps(out + f * 2, _mm_add_ps(_mm_mul_ps(a, go), _mm_mul_ps(b, gi)));
+    }
+#endif
+    for (; f < frames; ++f) {
+        out[f * 2] = out[f * 2] * gOut[f] + in[f * 2] * gIn[f];
+        out[f * 2 + 1] = out[f * 2 + 1] * gOut[f] + in[f * 2 + 1] * gIn[f];
+    }
+}
+
+static void mixGeneric(float *out, const float *in, int channels,
+                       const float *gOut, const float *gIn, qsizetype frames)
+{
+    for (qsizetype f = 0; f < frames; ++f) {
+        for (int c = 0; c < channels; ++c) {
+            const qsizetype i = f * channels + c;
+            out[i] = out[i] * gOut[f] + (in ? in[i] * gIn[f] : 0.0f);
+        }
+    }
+}
+
+void crossfadeEqualPower(float *out, const float *in, int channels,
+                         qsizetype frames, qsizetype pos, qsizetype total)
+{
+    if (frames <= 0 || total <= 0) return;
+    float gOut[CHUNK_FRAMES];
+    float gIn[CHUNK_FRAMES];
+    for (qsizetype done = 0; done < frames; done += CHUNK_FRAMES) {
+        const qsizetype n = std::min(CHUNK_FRAMES, frames - done);
+        computeGains(gOut, gIn, n, pos + done, total);
+        float *o = out + done * channels;
+        const float *s = in + done * channels;
+        if (channels == 2) mixStereo(o, s, gOut, gIn, n);
+        else mixGeneric(o, s, channels, gOut, gIn, n);
+    }
+}
+
+void fadeOutEqualPower(float *out, int channels, qsizetype frames, qsizetype pos, qsizetype total)
+{
+    if (frames <= 0 || total <= 0) return;
+    float gOut[CHUNK_FRAMES];
+    float gIn[CHUNK_FRAMES];
+    for (qsizetype done = 0; done < frames; done += CHUNK_FRAMES) {
+        const qsizetype n = std::min(CHUNK_FRAMES, frames - done);
+        computeGains(gOut, gIn, n, pos + done, total);
+        mixGeneric(out + done * channels, nullptr, channels, gOut, gIn, n);
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef PCMMIX_H
+#define PCMMIX_H
+
+#include <QtGlobal>
+
+// PCM 混音内核（交错 float 采样），SSE2 可用时按 4 个采样一组处理，否则退回标量循环
+
+// 等功率交叉淡化：out = out * cos(t·π/2) + in * sin(t·π/2)，t = (pos + i + 0.5) / total
+// out 为淡出曲目，in 为淡入曲目；pos 为本段在整个淡化区间内的起始帧
+void crossfadeEqualPower(float *out, const float *in, int channels,
+                         qsizetype frames, qsizetype pos, qsizetype total);
+
+// 对 out 单独施加等功率淡出曲线（淡入曲目提前结束时补完剩余的淡化）
+void fadeOutEqualPower(float *out, int channels, qsizetype frames, qsizetype pos, qsizetype total);
+
+#endif // PCMMIX_H
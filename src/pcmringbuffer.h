@@ -0,0 +1,133 @@
+#ifndef PCMRINGBUFFER_H
+#define PCMRINGBUFFER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+// 单生产者/单消费者无锁 PCM 环形缓冲区（交错 float 采样）
+// - 生产者：解码线程调用 write()
+// - 消费者：音频输出回调调用 read()
+// - 分析抽头：任意线程调用 peekRecent() 直接读取刚被消费的那段采样，不复制、不加锁。
+//   写入端始终为读指针之后的 tapGuard 帧预留空间，保证这段数据在抽头读取期间不会被覆盖。
+class PcmRingBuffer
+{
+public:
+    PcmRingBuffer(int channels, qsizetype capacityFrames, qsizetype tapGuardFrames)
+        : m_channels(channels)
+        , m_guard(tapGuardFrames)
+    {
+        // 容量取 2 的幂，索引用掩码回绕
+        qsizetype cap = 1;
+        while (cap < capacityFrames + tapGuardFrames) cap <<= 1;
+        m_capacity = cap;
+        m_mask = cap - 1;
+        m_data.assign(size_t(cap * channels), 0.0f);
+    }
+
+    int channels() const { return m_channels; }
+    qsizetype capacityFrames() const { return m_capacity - m_guard; }
+    qsizetype tapGuardFrames() const { return m_guard; }
+
+    qsizetype availableToRead() const
+    {
+        return qsizetype(m_write.load(std::memory_order_acquire) - m_read.load(std::memory_order_acquire));
+    }
+
+    qsizetype availableToWrite() const
+    {
+        return capacityFrames() - availableToRead();
+    }
+
+    // 自上次 reset() 以来写入/读出的总帧数（绝对序号）
+    quint64 totalWritten() const { return m_write.load(std::memory_order_acquire); }
+    quint64 totalRead() const { return m_read.load(std::memory_order_acquire); }
+
+    // 生产者：写入最多 frames 帧，返回实际写入帧数
+    qsizetype write(const float *src, qsizetype frames)
+    {
+        const quint64 w = m_write.load(std::memory_order_relaxed);
+        const quint64 r = m_read.load(std::memory_order_acquire);
+        const qsizetype space = capacityFrames() - qsizetype(w - r);
+        const qsizetype n = std::min(frames, space);
+        if (n <= 0) return 0;
+
+        const qsizetype start = qsizetype(w & m_mask);
+        const qsizetype first = std::min(n, m_capacity - start);
+        std::memcpy(&m_data[size_t(start * m_channels)], src, size_t(first * m_channels) * sizeof(float));
+        if (n > first) {
+            std::memcpy(&m_data[0], src + first * m_channels, size_t((n - first) * m_channels) * sizeof(float));
+        }
+        m_write.store(w + quint64(n), std::memory_order_release);
+        return n;
+    }
+
+    // 消费者：读取最多 frames 帧，返回实际读取帧数
+    qsizetype read(float *dst, qsizetype frames)
+    {
+        const quint64 r = m_read.load(std::memory_order_relaxed);
+        const quint64 w = m_write.load(std::memory_order_acquire);
+        const qsizetype n = std::min(frames, qsizetype(w - r));
+        if (n <= 0) return 0;
+
+        const qsizetype start = qsizetype(r & m_mask);
+        const qsizetype first = std::min(n, m_capacity - start);
+        std::memcpy(dst, &m_data[size_t(start * m_channels)], size_t(first * m_channels) * sizeof(float));
+        if (n > first) {
+            std::memcpy(dst + first * m_channels, &m_data[0], size_t((n - first) * m_channels) * sizeof(float));
+        }
+        m_read.store(r + quint64(n), std::memory_order_release);
+        return n;
+    }
+
+    // 消费者：丢弃最多 frames 帧
+    qsizetype skip(qsizetype frames)
+    {
+        const quint64 r = m_read.load(std::memory_order_relaxed);
+        const quint64 w = m_write.load(std::memory_order_acquire);
+        const qsizetype n = std::min(frames, qsizetype(w - r));
+        if (n > 0) m_read.store(r + quint64(n), std::memory_order_release);
+        return std::max<qsizetype>(n, 0);
+    }
+
+    // 分析抽头：以最多两段连续内存回调最近被消费的 frames 帧（frames 不应超过 tapGuard 的一半，
+    // 为抽头读取期间消费者继续前进留出余量）。fn(const float *samples, qsizetype frames)
+    template<typename Fn>
+    qsizetype peekRecent(qsizetype frames, Fn &&fn) const
+    {
+        frames = std::min(frames, m_guard / 2);
+        const quint64 r = m_read.load(std::memory_order_acquire);
+        if (r < quint64(frames)) frames = qsizetype(r);
+        if (frames <= 0) return 0;
+
+        const quint64 from = r - quint64(frames);
+        const qsizetype start = qsizetype(from & m_mask);
+        const qsizetype first = std::min(frames, m_capacity - start);
+        fn(&m_data[size_t(start * m_channels)], first);
+        if (frames > first) fn(&m_data[0], frames - first);
+        return frames;
+    }
+
+    // 仅在生产者和消费者都静止时调用（例如输出已停止的跳转过程中）
+    void reset()
+    {
+        m_read.store(0, std::memory_order_relaxed);
+        m_write.store(0, std::memory_order_relaxed);
+        std::fill(m_data.begin(), m_data.end(), 0.0f);
+    }
+
+private:
+    const int m_channels;
+    const qsizetype m_guard;
+    qsizetype m_capacity = 0;
+    quint64 m_mask = 0;
+    std::vector<float> m_data;
+
+    // 读写计数单调递增（64 位不会回绕），各自独占一条缓存行避免伪共享
+    alignas(64) std::atomic<quint64> m_write { 0 };
+    alignas(64) std::atomic<quint64> m_read { 0 };
+};
+
+#endif // PCMRINGBUFFER_H
@@ -1,22 +1,39 @@
 #include "playerbackend.h"
+#include "trace.h"
+#include "metrics.h"
+#include "backgroundthumbnails.h"
+#include "sessionsnapshot.h"
+#include "startuptimeline.h"
+#include "playlistfile.h"
 #include <QUrl>
 #include <QFile>
 #include <QDebug>
 #include <QRandomGenerator>
 #include <QCursor>
-#include <QSettings>
 #include <QDir>
-#include <QRegularExpression>
+#include <QFileInfo>
 #include <QStringList>
 #include <QKeyEvent>
 #include <QApplication>
+#include <QScreen>
 #include <cmath>
+#include <algorithm>
+
+static const int MAX_CROSSFADE_MS = 12000;
+static const int PREFETCH_DELAY_MS = 1500;          // 切歌稳定后再预取下一首，不与当前曲目的加载争抢
+static const qint64 READAHEAD_BYTES = 4 * 1024 * 1024;
+static const int READAHEAD_CHUNK = 256 * 1024;
+static const int LOUDNESS_SAVE_DELAY_MS = 10000;     // 最后一次分析完成后多久写回响度缓存
+static const int LOUDNESS_SAVE_BATCH = 50;           // 连续分析时每完成这么多首写回一次
 
 PlayerBackend::PlayerBackend(PlaylistModel *playlist, QObject *parent)
     : QObject(parent)
     , m_playlist(playlist)
     , m_playMode(0) // Default to Sequential mode
 {
+    m_settings = new SettingsStore("MusicPlayer", "Settings", this);
+    connect(m_settings, &SettingsStore::writeCountChanged, this, &PlayerBackend::settingsWriteCountChanged);
+
     m_player = new QMediaPlayer(this);
     m_audioOutput = new QAudioOutput(this);
     m_player->setAudioOutput(m_audioOutput);
@@ -24,8 +41,25 @@ PlayerBackend::PlayerBackend(PlaylistModel *playlist, QObject *parent)
     // 设置音量为最大值
     m_audioOutput->setVolume(1.0);
 
-    // setup audio buffer read - 使用 QMediaPlayer 的状态变化来启动音频设备
-    connect(m_player, &QMediaPlayer::playbackStateChanged, this, [this](QMediaPlayer::PlaybackState state){
+    for (int b = 0; b < Equalizer::BAND_COUNT; ++b) {
+        m_eqGains.append(0.0);
+        m_eqFrequencies.append(Equalizer::defaultFrequency(b));
+        m_eqQ.append(1.0);
+    }
+
+    // 播放引擎选择："pcm" 使用自有解码→环形缓冲→输出管线，其它值使用 QMediaPlayer
+    if (m_settings->value("audioEngine", "qt").toString() == "pcm") {
+        m_engine = new AudioEngine(this);
+        m_analyzer.setSampleRate(m_engine->sampleRate());
+        m_analysisWindow.resize(m_analyzer.fftSize());
+
+        m_engineStatsTimer = new QTimer(this);
+        m_engineStatsTimer->setInterval(250);
+        connect(m_engineStatsTimer, &QTimer::timeout, this, &PlayerBackend::engineStatsChanged);
+        m_engineStatsTimer->start();
+    }
+
+    auto startSpectrumTimer = [this](QMediaPlayer::PlaybackState state){
         if (state == QMediaPlayer::PlayingState) {
             // 启动音频设备读取
             if (!m_fftTimer) {
@@ -39,7 +73,7 @@ PlayerBackend::PlayerBackend(PlaylistModel *playlist, QObject *parent)
                 m_fftTimer->stop();
             }
         }
-    });
+    };
 
     // 安装事件过滤器来处理ESC键
     if (QApplication::instance()) {
@@ -51,40 +85,173 @@ PlayerBackend::PlayerBackend(PlaylistModel *playlist, QObject *parent)
     m_audioLevelTimer->setInterval(25); // Update every 25ms for more responsive visualization
     connect(m_audioLevelTimer, &QTimer::timeout, this, &PlayerBackend::updateAudioLevel);
 
-    connect(m_player, &QMediaPlayer::positionChanged, this, &PlayerBackend::onPositionChanged);
-    connect(m_player, &QMediaPlayer::durationChanged, this, &PlayerBackend::onDurationChanged);
-    connect(m_player, &QMediaPlayer::playbackStateChanged, this, &PlayerBackend::onPlaybackStateChanged);
-    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &PlayerBackend::onMediaStatusChanged);
+    if (m_engine) {
+        // setup audio buffer read - 使用播放状态变化来启动频谱分析
+        connect(m_engine, &AudioEngine::playbackStateChanged, this, startSpectrumTimer);
+        connect(m_engine, &AudioEngine::positionChanged, this, &PlayerBackend::onPositionChanged);
+        connect(m_engine, &AudioEngine::durationChanged, this, &PlayerBackend::onDurationChanged);
+        connect(m_engine, &AudioEngine::playbackStateChanged, this, &PlayerBackend::onPlaybackStateChanged);
+        connect(m_engine, &AudioEngine::mediaStatusChanged, this, &PlayerBackend::onMediaStatusChanged);
+        connect(m_engine, &AudioEngine::trackAdvanced, this, &PlayerBackend::onTrackAdvanced);
+    } else {
+        // setup audio buffer read - 使用 QMediaPlayer 的状态变化来启动音频设备
+        connect(m_player, &QMediaPlayer::playbackStateChanged, this, startSpectrumTimer);
+        connect(m_player, &QMediaPlayer::positionChanged, this, &PlayerBackend::onPositionChanged);
+        connect(m_player, &QMediaPlayer::durationChanged, this, &PlayerBackend::onDurationChanged);
+        connect(m_player, &QMediaPlayer::playbackStateChanged, this, &PlayerBackend::onPlaybackStateChanged);
+        connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &PlayerBackend::onMediaStatusChanged);
+    }
     
+    // 背景图片在后台预缩放、预模糊；壁纸或列表变化时分别请求当前图片与预取其余图片
+    m_bgPipeline = new BackgroundPipeline(this);
+    connect(m_bgPipeline, &BackgroundPipeline::ready, this,
+            [this](const QString &path, const QString &display, const QString &blurred) {
+        if (path != m_backgroundImage) return;
+        m_backgroundDisplayImage = display;
+        m_backgroundBlurImage = blurred;
+        emit backgroundVariantsChanged();
+    });
+    connect(this, &PlayerBackend::backgroundImageChanged, this, &PlayerBackend::updateBackgroundVariants);
+    connect(this, &PlayerBackend::backgroundImageListChanged, this, [this]() {
+        m_bgPipeline->prefetch(m_backgroundImageList);
+    });
+    if (QScreen *screen = QGuiApplication::primaryScreen()) {
+        connect(screen, &QScreen::geometryChanged, this, &PlayerBackend::updateBackgroundTargetSize);
+    }
+    updateBackgroundTargetSize();
+
+    // 预测下一首并提前准备封面、歌词、响度与文件页
+    m_prefetchTimer = new QTimer(this);
+    m_prefetchTimer->setSingleShot(true);
+    m_prefetchTimer->setInterval(PREFETCH_DELAY_MS);
+    connect(m_prefetchTimer, &QTimer::timeout, this, &PlayerBackend::prefetchNextTrack);
+
+    // 歌单重新加载后索引失效，下一首在下次切歌时重新确定
+    if (m_playlist) {
+        connect(m_playlist, &QAbstractItemModel::modelReset, this, [this]() {
+            m_preparedNextIndex = -1;
+            m_prefetched = PrefetchedTrack();
+            m_queue.reset(m_playlist->rowCount());
+            emit upNextChanged();
+        });
+        // 只有追加在末尾时索引不变；曲库变化插在中间的行由 onLibraryScanned 先行换算
+        connect(m_playlist, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &, int first) {
+            if (first == m_queue.trackCount()) m_queue.setTrackCount(m_playlist->rowCount());
+        });
+    }
+
+    // 后台分析任务：背景管理窗口的缩略图、响度；上次退出时未完成的任务继续执行
+    m_jobs = new JobScheduler(this);
+    m_jobs->registerKind("thumbnail", [](const QString &imagePath, JobScheduler::Context &) {
+        return !BackgroundThumbnails::ensure(imagePath).isEmpty();
+    });
+    // 预读下一首文件的开头（容器头、内嵌封面与最初几秒音频）进系统页缓存，切歌时打开与解码不必等磁盘
+    m_jobs->registerKind("readahead", [](const QString &path, JobScheduler::Context &context) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) return false;
+        QByteArray buffer(READAHEAD_CHUNK, Qt::Uninitialized);
+        qint64 total = 0;
+        while (total < READAHEAD_BYTES && !context.isCancelled()) {
+            const qint64 n = file.read(buffer.data(), buffer.size());
+            if (n <= 0) break;
+            total += n;
+        }
+        return true;
+    });
+    // 响度分析：结果写入库缓存，播放时换算为增益。恢复会话前读取设置，恢复的曲目即按设置施加增益
+    m_loudness = std::make_shared<LoudnessCache>();
+    m_loudness->load(LoudnessCache::defaultCachePath());
+    m_jobs->registerKind("loudness", [loudness = m_loudness](const QString &path, JobScheduler::Context &context) {
+        return loudness->analyze(path, [&context]() { return context.isCancelled(); });
+    });
+    m_loudnessMode = qBound(0, m_settings->value("loudnessMode", 1).toInt(), 2);
+    m_loudnessPreventClipping = m_settings->value("loudnessPreventClipping", true).toBool();
+    m_loudnessTargetLufs = qBound(-30.0, m_settings->value("loudnessTargetLufs", -18.0).toDouble(), -5.0);
+    // 分析结果陆续写回磁盘，异常退出时不必重新分析
+    m_loudnessSaveTimer = new QTimer(this);
+    m_loudnessSaveTimer->setSingleShot(true);
+    m_loudnessSaveTimer->setInterval(LOUDNESS_SAVE_DELAY_MS);
+    connect(m_loudnessSaveTimer, &QTimer::timeout, this, &PlayerBackend::saveLoudnessCache);
+    connect(m_jobs, &JobScheduler::jobFinished, this, [this](const QString &kind, const QString &, bool ok) {
+        if (kind != "loudness" || !ok) return;
+        if (++m_loudnessUnsaved >= LOUDNESS_SAVE_BATCH) saveLoudnessCache();
+        else m_loudnessSaveTimer->start();
+    });
+    m_jobs->restore(JobScheduler::defaultStatePath());
+    connect(this, &PlayerBackend::isPlayingChanged, m_jobs, &JobScheduler::setPlaybackActive);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() {
+        m_jobs->shutdown(JobScheduler::defaultStatePath());
+    });
+
+    m_columns.load(LibraryColumns::defaultPath());
+    m_playlists = new PlaylistLibrary(this);
+    connect(m_playlists, &PlaylistLibrary::namesChanged, this, &PlayerBackend::playlistsChanged);
+    connect(m_playlists, &PlaylistLibrary::loadingChanged, this, &PlayerBackend::playlistLoadingChanged);
+    connect(m_playlists, &PlaylistLibrary::saved, this, &PlayerBackend::playlistSaved);
+    connect(m_playlists, &PlaylistLibrary::tracksLoaded, this, &PlayerBackend::onPlaylistTracksLoaded);
+    connect(m_playlists, &PlaylistLibrary::loadFinished, this, &PlayerBackend::onPlaylistLoadFinished);
+
+    // 曲库数据归曲库服务的线程所有；每次扫描完成后收到新快照与变化区间
+    m_library = new LibraryService(this);
+    m_librarySnapshot = m_library->snapshot();
+    connect(m_library, &LibraryService::scanned, this, &PlayerBackend::onLibraryScanned);
+    // 补全响度分析：判断文件是否变化要读取每个文件的信息，在任务线程上进行，只提交缺少或已过期的曲目
+    m_jobs->registerKind("loudness-backfill", [library = m_library, loudness = m_loudness, jobs = m_jobs]
+                                              (const QString &, JobScheduler::Context &context) {
+        const LibrarySnapshotPtr snapshot = library->snapshot();
+        for (const TrackItem &track : snapshot->tracks) {
+            if (context.isCancelled()) return false;
+            const QString path = track.url.toLocalFile();
+            if (!loudness->lookup(path, nullptr)) jobs->submit("loudness", path, JobScheduler::Idle);
+        }
+        return true;
+    });
+
+    // 恢复上次会话：第一帧即显示上次的歌曲并可直接继续播放；退出时保存
+    restoreSession();
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &PlayerBackend::saveSession);
+
     // 延迟加载设置和歌单，让界面先显示
     QTimer::singleShot(100, this, &PlayerBackend::delayedInit);
 }
 
+QMediaPlayer::PlaybackState PlayerBackend::playbackState() const
+{
+    return m_engine ? m_engine->playbackState() : m_player->playbackState();
+}
+
+QMediaPlayer::MediaStatus PlayerBackend::mediaStatus() const
+{
+    return m_engine ? m_engine->mediaStatus() : m_player->mediaStatus();
+}
+
 bool PlayerBackend::isPlaying() const
 {
-    return m_player->playbackState() == QMediaPlayer::PlayingState;
+    return playbackState() == QMediaPlayer::PlayingState;
 }
 
 qint64 PlayerBackend::position() const
 {
-    return m_player->position();
+    return m_engine ? m_engine->position() : m_player->position();
 }
 
 qint64 PlayerBackend::duration() const
 {
-    return m_player->duration();
+    return m_engine ? m_engine->duration() : m_player->duration();
 }
 
 void PlayerBackend::play()
 {
-    m_player->play();
+    if (m_engine) m_engine->play();
+    else m_player->play();
     m_audioLevelTimer->start();
     emit isPlayingChanged(true);
 }
 
 void PlayerBackend::pause()
 {
-    m_player->pause();
+    if (m_engine) m_engine->pause();
+    else m_player->pause();
     m_audioLevelTimer->stop();
     m_audioLevel = 0.0;
     emit audioLevelChanged();
@@ -93,7 +260,7 @@ void PlayerBackend::pause()
 
 void PlayerBackend::togglePlay()
 {
-    if (m_player->playbackState() == QMediaPlayer::PlayingState) pause();
+    if (playbackState() == QMediaPlayer::PlayingState) pause();
     else play();
 }
 
@@ -102,23 +269,101 @@ void PlayerBackend::next()
     if (!m_playlist) return;
     int count = m_playlist->rowCount();
     if (count == 0) return;
-    
-    int idx;
-    switch (m_playMode) {
-    case 1: // Loop One
-        idx = m_index; // Stay on current track
-        break;
-    case 2: // Loop All
-        idx = (m_index + 1) % count;
-        break;
-    case 3: // Random
-        idx = QRandomGenerator::global()->bounded(count);
-        break;
-    default:
-        idx = (m_index + 1) % count; // Default to Loop All behavior
-        break;
-    }
-    playIndex(idx);
+
+    // 由播放队列决定，与预读给引擎的曲目（peekNext）一致
+    const int idx = m_queue.advance(m_index);
+    emit upNextChanged();
+    startTrack(idx);
+}
+
+int PlayerBackend::resolveNextIndex() const
+{
+    int count = m_playlist ? m_playlist->rowCount() : 0;
+    if (count == 0) return -1;
+    return m_queue.peekNext(m_index);
+}
+
+void PlayerBackend::prepareNextTrack()
+{
+    // 下一首可能已变化（切歌、播放模式或队列改动）：稍后重新预取
+    m_prefetchTimer->start();
+
+    // 仅 PCM 管线支持无缝衔接：提前把下一首交给引擎预读
+    if (!m_engine || !m_playlist || m_index < 0) return;
+    m_preparedNextIndex = resolveNextIndex();
+    QVariantMap info = m_playlist->get(m_preparedNextIndex);
+    const QUrl url(info.value("url").toString());
+    m_engine->setNextSource(url, trackGain(url.toLocalFile(), JobScheduler::NextTrack));
+}
+
+void PlayerBackend::onTrackAdvanced()
+{
+    // 引擎已无缝切换到预读的曲目：队列前进一步，按实际播放的文件找回索引并刷新界面
+    const int queued = m_queue.advance(m_index);
+    emit upNextChanged();
+    int idx = m_playlist ? m_playlist->indexOfPath(m_engine->source().toLocalFile()) : -1;
+    if (idx < 0) idx = queued;
+    m_preparedNextIndex = -1;
+    setTrackSwitchGap(m_engine->lastTrackSwitchGapMs());
+    recordPlay(m_engine->source().toLocalFile());
+
+    const PrefetchedTrack track = takeTrack(idx);
+    if (!track.info.isEmpty()) applyTrackInfo(track);
+    prepareNextTrack();
+}
+
+PlayerBackend::PrefetchedTrack PlayerBackend::loadTrack(int idx) const
+{
+    PrefetchedTrack track;
+    if (!m_playlist) return track;
+    track.info = m_playlist->get(idx);
+    if (track.info.isEmpty()) return track;
+    track.index = idx;
+    track.url = QUrl(track.info.value("url").toString());
+    track.lyrics = parseLyrics(track.info.value("lyrics").toString());
+    return track;
+}
+
+PlayerBackend::PrefetchedTrack PlayerBackend::takeTrack(int idx)
+{
+    if (m_playlist && idx >= 0 && idx == m_prefetched.index && idx < m_playlist->rowCount()
+        && m_playlist->tracks()[idx].url == m_prefetched.url) {
+        Metrics::count(Metrics::PrefetchHits);
+        PrefetchedTrack track = std::move(m_prefetched);
+        m_prefetched = PrefetchedTrack();
+        return track;
+    }
+    Metrics::count(Metrics::PrefetchMisses);
+    return loadTrack(idx);
+}
+
+void PlayerBackend::prefetchNextTrack()
+{
+    TRACE_SCOPE("PlayerBackend::prefetchNextTrack");
+    if (!m_playlist || m_index < 0) return;
+    // 与实际切歌使用同一个预测：播放模式（单曲循环、随机置换）与待播队列都由 PlayQueue 决定
+    const int next = resolveNextIndex();
+    const TrackList &tracks = m_playlist->tracks();
+    if (next < 0 || next >= tracks.size()) return;
+    if (next == m_prefetched.index && tracks[next].url == m_prefetched.url) return;
+
+    m_prefetched = loadTrack(next);
+    const QString path = m_prefetched.url.toLocalFile();
+    m_jobs->submit("readahead", path, JobScheduler::NextTrack);
+    trackGain(path, JobScheduler::NextTrack);   // 尚未分析响度时提前分析
+
+    const QString cover = m_prefetched.info.value("cover").toString();
+    if (m_nextCover != cover) {
+        m_nextCover = cover;
+        emit nextCoverChanged();
+    }
+}
+
+void PlayerBackend::setTrackSwitchGap(double ms)
+{
+    m_trackSwitchGapMs = qMax(0.0, ms);
+    m_measuringSwitch = false;
+    emit trackSwitchGapChanged();
 }
 
 void PlayerBackend::previous()
@@ -126,36 +371,67 @@ void PlayerBackend::previous()
     if (!m_playlist) return;
     int count = m_playlist->rowCount();
     if (count == 0) return;
-    int idx = (m_index - 1 + count) % count;
-    playIndex(idx);
+    // 回到真正播放过的上一首（随机模式下也是如此）
+    startTrack(m_queue.retreat(m_index));
 }
 
 void PlayerBackend::setPosition(qint64 ms)
 {
-    m_player->setPosition(ms);
+    if (m_engine) m_engine->setPosition(ms);
+    else m_player->setPosition(ms);
 }
 
 void PlayerBackend::playIndex(int idx)
 {
+    if (!m_playlist || idx < 0 || idx >= m_playlist->rowCount()) return;
+    m_queue.jumpTo(idx);
+    startTrack(idx);
+}
+
+void PlayerBackend::startTrack(int idx)
+{
+    TRACE_SCOPE("PlayerBackend::startTrack");
     if (!m_playlist) return;
-    QVariantMap info = m_playlist->get(idx);
-    if (info.isEmpty()) return;
+    const PrefetchedTrack track = takeTrack(idx);
+    if (track.info.isEmpty()) return;
 
-    m_index = idx;
-    emit currentIndexChanged(m_index);
+    m_pendingSeek = -1;
+    m_preparedNextIndex = -1;
+    m_trackSwitchClock.start();
+    const QUrl url = track.url;
+    // 切歌后原来的“当前/下一首”分析任务降为空闲补全
+    m_jobs->demote(JobScheduler::CurrentTrack, JobScheduler::Idle);
+    m_jobs->demote(JobScheduler::NextTrack, JobScheduler::Idle);
+    m_trackGain = trackGain(url.toLocalFile(), JobScheduler::CurrentTrack);
+    if (m_engine) {
+        m_engine->setSource(url, m_trackGain);
+    } else {
+        applyVolume();
+        m_player->setSource(url);
+    }
+    recordPlay(url.toLocalFile());
 
-    QString urlStr = info.value("url").toString();
-    QUrl url(urlStr);
-    m_player->setSource(url);
+    applyTrackInfo(track);
+    prepareNextTrack();
 
+    // try to play immediately
+    if (m_engine) m_engine->play();
+    else m_player->play();
+}
+
+void PlayerBackend::applyTrackInfo(const PrefetchedTrack &track)
+{
+    m_index = track.index;
+    emit currentIndexChanged(m_index);
+
+    const QVariantMap &info = track.info;
     m_title = info.value("title").toString();
     m_artist = info.value("artist").toString();
     m_album = info.value("album").toString();
     m_lyrics = info.value("lyrics").toString();
     m_cover = info.value("cover").toString();
 
-    // 解析歌词
-    m_parsedLyrics = parseLyrics(m_lyrics);
+    m_parsedLyrics = track.lyrics;
     m_currentLyrics.clear();
     m_nextLyrics.clear();
     m_lastLyricPosition = -1;
@@ -167,15 +443,61 @@ void PlayerBackend::playIndex(int idx)
     emit currentLyricsChanged();
     emit nextLyricsChanged();
     emit coverChanged();
+}
 
-    // try to play immediately
-    m_player->play();
+void PlayerBackend::playLyricHit(int idx, qint64 ms)
+{
+    // 播放歌词搜索结果：切歌后等媒体加载完成再跳转到命中行
+    if (idx != m_index) {
+        playIndex(idx);
+    } else if (!isPlaying()) {
+        play();
+    }
+    if (ms < 0) return;
+
+    if (idx == m_index && (mediaStatus() == QMediaPlayer::LoadedMedia ||
+                           mediaStatus() == QMediaPlayer::BufferedMedia)) {
+        setPosition(ms);
+    } else {
+        m_pendingSeek = ms;
+    }
+}
+
+QVariantList PlayerBackend::searchLyrics(const QString &query, int limit) const
+{
+    QVariantList results;
+    if (!m_playlist) return results;
+    Metrics::ScopedTimer searchTimer(Metrics::SearchLatency);
+
+    // 歌词索引随曲库快照发布，搜索读取最新的一份，不等待正在进行的扫描
+    const QVector<LyricHit> hits = m_library->snapshot()->lyrics->search(query, limit);
+    for (const LyricHit &hit : hits) {
+        int idx = m_playlist->indexOfPath(hit.path);
+        if (idx < 0) continue;
+        QVariantMap info = m_playlist->get(idx);
+        QVariantMap row;
+        row["index"] = idx;
+        row["title"] = info.value("title");
+        row["artist"] = info.value("artist");
+        row["line"] = hit.line;
+        row["time"] = hit.timeMs;
+        results.append(row);
+    }
+    return results;
 }
 
 void PlayerBackend::importFolder(const QString &folderPath)
 {
     if (!m_playlist) return;
-    m_playlist->loadFolder(folderPath);
+    // 选择音乐文件夹后回到曲库
+    if (!m_currentPlaylist.isEmpty() || !m_currentSmartPlaylist.isEmpty()) {
+        m_playlists->cancelLoad();
+        m_currentPlaylist.clear();
+        leaveSmartView();
+        emit currentPlaylistChanged();
+        saveSettings();
+    }
+    loadLibrary(folderPath);
     
     // 保存音乐文件夹路径
     setMusicFolder(folderPath);
@@ -184,6 +506,11 @@ void PlayerBackend::importFolder(const QString &folderPath)
 // signals handlers
 void PlayerBackend::onPositionChanged(qint64 pos)
 {
+    // 下一首开始出声：扣除已播放的部分即为切歌间隙
+    if (m_measuringSwitch && pos > 0 && playbackState() == QMediaPlayer::PlayingState) {
+        setTrackSwitchGap(double(m_switchClock.elapsed() - pos));
+    }
+
     emit positionChanged(pos);
     updateLyrics(pos);
 }
@@ -196,6 +523,11 @@ void PlayerBackend::onDurationChanged(qint64 dur)
 void PlayerBackend::onPlaybackStateChanged(QMediaPlayer::PlaybackState st)
 {
     if (st == QMediaPlayer::PlayingState) {
+        // 切歌延迟：从 playIndex 到真正进入播放状态
+        if (m_trackSwitchClock.isValid()) {
+            Metrics::record(Metrics::TrackSwitchLatency, m_trackSwitchClock.nsecsElapsed());
+            m_trackSwitchClock.invalidate();
+        }
         m_audioLevelTimer->start();
     } else {
         m_audioLevelTimer->stop();
@@ -209,13 +541,26 @@ void PlayerBackend::onMediaStatusChanged(QMediaPlayer::MediaStatus st)
 {
     Q_UNUSED(st)
     // could read metadata here (QMediaMetaData) and update title/artist/cover if available
+
+    if (st == QMediaPlayer::LoadedMedia) markStartup("playable");
+
+    // 歌词搜索跳转（或恢复会话的播放位置）：媒体可寻址后再设置位置
+    if (m_pendingSeek >= 0 && (st == QMediaPlayer::LoadedMedia || st == QMediaPlayer::BufferedMedia)) {
+        setPosition(m_pendingSeek);
+        m_pendingSeek = -1;
+    }
     
     // Handle end of media for different play modes
     if (st == QMediaPlayer::EndOfMedia) {
-        if (m_playMode == 1) { // Loop One
-            // Restart the current track
-            m_player->setPosition(0);
-            m_player->play();
+        // 非无缝路径：测量从播完到下一首出声的间隙
+        m_switchClock.start();
+        m_measuringSwitch = true;
+
+        if (m_playMode == 1 && m_queue.upNext().isEmpty()) { // Loop One
+            // Restart the current track（待播队列中有曲目时先播放队列）
+            setPosition(0);
+            if (m_engine) m_engine->play();
+            else m_player->play();
         } else if (m_playMode == 2) { // Loop All
             // Play next track (will wrap around to first if at end)
             next();
@@ -232,6 +577,9 @@ void PlayerBackend::onMediaStatusChanged(QMediaPlayer::MediaStatus st)
 // Simulated audio level update (since QAudioProbe is not available in Qt 6)
 void PlayerBackend::updateAudioLevel()
 {
+    // PCM 管线下电平由 updateSpectrum 从真实采样计算
+    if (m_engine) return;
+
     // Generate a more realistic simulated audio level for visualization purposes
     // In a real implementation, you might use platform-specific audio APIs
     static double phase = 0.0;
@@ -325,7 +673,9 @@ void PlayerBackend::setMusicFolder(const QString &folderPath)
 
 void PlayerBackend::saveSettings()
 {
-    QSettings settings("MusicPlayer", "Settings");
+    TRACE_SCOPE("PlayerBackend::saveSettings");
+    // 只记录变化的键，稍后由 SettingsStore 在后台线程合并写入
+    SettingsStore &settings = *m_settings;
     
     // 保存背景图片路径
     if (!m_backgroundImage.isEmpty()) {
@@ -351,8 +701,44 @@ void PlayerBackend::saveSettings()
         settings.remove("musicFolder");
     }
     
-    // 保存播放模式
+    // 保存当前显示的歌单
+    if (!m_currentPlaylist.isEmpty()) {
+        settings.setValue("currentPlaylist", m_currentPlaylist);
+    } else {
+        settings.remove("currentPlaylist");
+    }
+
+    // 保存智能歌单
+    if (!m_smartPlaylists.isEmpty()) {
+        settings.setValue("smartPlaylists", m_smartPlaylists);
+    } else {
+        settings.remove("smartPlaylists");
+    }
+    if (!m_currentSmartPlaylist.isEmpty()) {
+        settings.setValue("currentSmartPlaylist", m_currentSmartPlaylist);
+    } else {
+        settings.remove("currentSmartPlaylist");
+    }
+
+    // 保存播放模式与交叉淡化时长
     settings.setValue("playMode", m_playMode);
+    settings.setValue("crossfadeMs", m_crossfadeMs);
+    settings.setValue("loudnessMode", m_loudnessMode);
+    settings.setValue("loudnessPreventClipping", m_loudnessPreventClipping);
+
+    // 保存均衡器设置
+    QVariantList eqGains, eqFrequencies, eqQ;
+    for (int b = 0; b < Equalizer::BAND_COUNT; ++b) {
+        eqGains.append(m_eqGains[b]);
+        eqFrequencies.append(m_eqFrequencies[b]);
+        eqQ.append(m_eqQ[b]);
+    }
+    settings.setValue("eqEnabled", m_eqEnabled);
+    settings.setValue("eqPreamp", m_eqPreamp);
+    settings.setValue("eqPreset", m_eqPreset);
+    settings.setValue("eqGains", eqGains);
+    settings.setValue("eqFrequencies", eqFrequencies);
+    settings.setValue("eqQ", eqQ);
     
     // 保存音量和静音设置
     settings.setValue("volume", m_volume);
@@ -361,7 +747,8 @@ void PlayerBackend::saveSettings()
 
 void PlayerBackend::loadSettings()
 {
-    QSettings settings("MusicPlayer", "Settings");
+    TRACE_SCOPE("PlayerBackend::loadSettings");
+    SettingsStore &settings = *m_settings;
     
     // 加载背景图片路径
     QString savedBackgroundImage = settings.value("backgroundImage").toString();
@@ -372,6 +759,9 @@ void PlayerBackend::loadSettings()
     
     // 加载背景图片列表
     m_backgroundImageList = settings.value("backgroundImageList", QStringList()).toStringList();
+    for (const QString &imagePath : std::as_const(m_backgroundImageList)) {
+        m_jobs->submit("thumbnail", imagePath, JobScheduler::Idle);
+    }
     emit backgroundImageListChanged();
     
     // 加载当前背景图片索引
@@ -383,16 +773,31 @@ void PlayerBackend::loadSettings()
     if (!savedMusicFolder.isEmpty() && QDir(savedMusicFolder).exists()) {
         m_musicFolder = savedMusicFolder;
         emit musicFolderChanged();
-        
-        // 自动加载音乐文件夹中的歌曲
-        if (m_playlist) {
-            m_playlist->loadFolder(m_musicFolder);
-        }
+        // 歌曲由 delayedInit 统一加载（每次启动只扫描一次）
     } else {
         // 如果没有设置音乐文件夹或文件夹不存在，发出信号提示用户选择
         emit musicFolderNeeded();
     }
     
+    // 加载当前显示的歌单（歌单文件已删除时回到曲库）
+    const QString savedPlaylist = settings.value("currentPlaylist").toString();
+    if (!savedPlaylist.isEmpty() && m_playlists->contains(savedPlaylist)) {
+        m_currentPlaylist = savedPlaylist;
+        emit currentPlaylistChanged();
+    }
+
+    // 加载智能歌单；当前智能歌单在曲库扫描完成后求值
+    m_smartPlaylists = settings.value("smartPlaylists").toMap();
+    emit smartPlaylistsChanged();
+    const QString savedSmart = settings.value("currentSmartPlaylist").toString();
+    if (m_currentPlaylist.isEmpty() && m_smartPlaylists.contains(savedSmart)) {
+        m_smartQuery = SmartQuery::compile(m_smartPlaylists.value(savedSmart).toString());
+        if (m_smartQuery.isValid()) {
+            m_currentSmartPlaylist = savedSmart;
+            emit currentPlaylistChanged();
+        }
+    }
+
     // 加载播放模式
     int savedPlayMode = settings.value("playMode", 1).toInt(); // Default to 1 (Loop One)
     if (savedPlayMode >= 1 && savedPlayMode <= 3) {
@@ -403,6 +808,26 @@ void PlayerBackend::loadSettings()
         m_playMode = 1;
         emit playModeChanged();
     }
+    applyQueueMode();
+
+    m_crossfadeMs = qBound(0, settings.value("crossfadeMs", 0).toInt(), MAX_CROSSFADE_MS);
+    if (m_engine) m_engine->setCrossfadeMs(m_crossfadeMs);
+    emit crossfadeMsChanged();
+
+    // 加载均衡器设置
+    m_eqEnabled = settings.value("eqEnabled", false).toBool();
+    m_eqPreamp = settings.value("eqPreamp", 0.0).toDouble();
+    m_eqPreset = settings.value("eqPreset", "Flat").toString();
+    const QVariantList eqGains = settings.value("eqGains").toList();
+    const QVariantList eqFrequencies = settings.value("eqFrequencies").toList();
+    const QVariantList eqQ = settings.value("eqQ").toList();
+    for (int b = 0; b < Equalizer::BAND_COUNT; ++b) {
+        if (b < eqGains.size()) m_eqGains[b] = eqGains[b].toDouble();
+        if (b < eqFrequencies.size()) m_eqFrequencies[b] = eqFrequencies[b].toDouble();
+        if (b < eqQ.size()) m_eqQ[b] = eqQ[b].toDouble();
+    }
+    applyEqualizer();
+    emit equalizerChanged();
     
     // 加载音量和静音设置
     double savedVolume = settings.value("volume", 1.0).toDouble();
@@ -411,52 +836,32 @@ void PlayerBackend::loadSettings()
     m_volume = qMax(0.0, qMin(1.0, savedVolume));
     m_isMuted = savedMuted;
     
-    if (m_audioOutput) {
-        m_audioOutput->setVolume(m_isMuted ? 0.0 : m_volume);
-    }
+    applyVolume();
     
     emit volumeChanged();
     emit isMutedChanged();
+
+    // 后台任务的 CPU 预算（百分比）：空闲、播放中、使用电池时
+    m_jobs->setBudget(settings.value("jobBudget", 50).toInt(),
+                      settings.value("jobBudgetPlaying", 20).toInt(),
+                      settings.value("jobBudgetBattery", 10).toInt());
 }
 
 void PlayerBackend::updateLyrics(qint64 position)
 {
+    TRACE_SCOPE("PlayerBackend::updateLyrics");
     if (m_parsedLyrics.isEmpty()) {
         return;
     }
 
+    // 时间轴已排序：二分查找最后一句不晚于当前位置的歌词
+    const auto it = std::upper_bound(m_parsedLyrics.cbegin(), m_parsedLyrics.cend(), position,
+                                     [](qint64 pos, const LyricLine &line) { return pos < line.timeMs; });
     QString newCurrentLyrics;
     QString newNextLyrics;
-
-    for (int i = 0; i < m_parsedLyrics.size(); ++i) {
-        QString line = m_parsedLyrics[i];
-        
-        // 解析时间戳和歌词 [mm:ss.xxx]歌词内容
-        QRegularExpression re(R"(^\[(\d{2}):(\d{2})\.(\d{2,3})\](.*)$)");
-        QRegularExpressionMatch match = re.match(line);
-        
-        if (match.hasMatch()) {
-            int minutes = match.captured(1).toInt();
-            int seconds = match.captured(2).toInt();
-            int milliseconds = match.captured(3).toInt();
-            QString lyric = match.captured(4).trimmed();
-            
-            qint64 lyricTime = (minutes * 60 + seconds) * 1000 + milliseconds;
-            
-            if (lyricTime <= position) {
-                newCurrentLyrics = lyric;
-                // 查找下一句歌词
-                if (i + 1 < m_parsedLyrics.size()) {
-                    QString nextLine = m_parsedLyrics[i + 1];
-                    QRegularExpressionMatch nextMatch = re.match(nextLine);
-                    if (nextMatch.hasMatch()) {
-                        newNextLyrics = nextMatch.captured(4).trimmed();
-                    }
-                }
-            } else {
-                break;
-            }
-        }
+    if (it != m_parsedLyrics.cbegin()) {
+        newCurrentLyrics = (it - 1)->text;
+        if (it != m_parsedLyrics.cend()) newNextLyrics = it->text;
     }
 
     // 只有当歌词发生变化时才更新
@@ -468,28 +873,13 @@ void PlayerBackend::updateLyrics(qint64 position)
     }
 }
 
-QStringList PlayerBackend::parseLyrics(const QString &lyricsText)
+QVector<LyricLine> PlayerBackend::parseLyrics(const QString &lyricsText)
 {
-    QStringList parsedLines;
-    
-    if (lyricsText.isEmpty()) {
-        return parsedLines;
-    }
-
-    QStringList lines = lyricsText.split('\n', Qt::SkipEmptyParts);
-    
-    for (const QString &line : lines) {
-        QString trimmedLine = line.trimmed();
-        if (!trimmedLine.isEmpty()) {
-            // 检查是否是时间戳格式 [mm:ss.xxx] 或 [mm:ss.xx]
-            QRegularExpression re(R"(^\[\d{2}:\d{2}\.\d{2,3}\])");
-            if (re.match(trimmedLine).hasMatch()) {
-                parsedLines.append(trimmedLine);
-            }
-        }
-    }
-    
-    return parsedLines;
+    QVector<LyricLine> lines = LyricIndex::parseLines(lyricsText, true);
+    // 无时间戳的行排在最前，去掉
+    const auto timed = std::find_if(lines.cbegin(), lines.cend(), [](const LyricLine &line) { return line.timeMs >= 0; });
+    lines.erase(lines.cbegin(), timed);
+    return lines;
 }
 
 void PlayerBackend::delayedInit()
@@ -497,22 +887,473 @@ void PlayerBackend::delayedInit()
     // 异步加载设置和歌单，不阻塞界面显示
     loadSettings();
     if (!m_musicFolder.isEmpty()) {
-        // 使用 QTimer 延迟加载歌单，让界面完全显示后再开始加载
+        // 使用 QTimer 延迟加载歌单，让界面完全显示后再开始加载；扫描完成后再处理启动参数
         QTimer::singleShot(50, this, [this]() {
-            m_playlist->loadFolder(m_musicFolder);
+            loadLibrary(m_musicFolder);
+            if (!m_libraryLoading) finishInit();
         });
+    } else {
+        finishInit();
+    }
+}
+
+void PlayerBackend::finishInit()
+{
+    m_initialized = true;
+    const QStringList pending = m_pendingArguments;
+    m_pendingArguments.clear();
+    if (!pending.isEmpty()) handleArguments(pending);
+}
+
+void PlayerBackend::handleArguments(const QStringList &arguments)
+{
+    // 只有播放控制命令时不打扰当前窗口状态，其余情况（包括不带参数再次启动）唤出窗口
+    const bool controlOnly = !arguments.isEmpty()
+        && std::all_of(arguments.begin(), arguments.end(), [](const QString &arg) { return arg.startsWith("--"); });
+    if (!controlOnly) emit activationRequested();
+    if (arguments.isEmpty()) return;
+    if (!m_initialized) {
+        // 启动扫描尚未完成：先记下，避免刚加入的歌曲被扫描重建的歌单覆盖
+        m_pendingArguments += arguments;
+        return;
     }
+
+    int firstAdded = -1;
+    QStringList toProbe;   // 不在列表中的文件：在曲库线程上读取，完成后追加
+    for (const QString &arg : arguments) {
+        if (arg == "--play") play();
+        else if (arg == "--pause") pause();
+        else if (arg == "--toggle") togglePlay();
+        else if (arg == "--next") next();
+        else if (arg == "--previous") previous();
+        else if (QFileInfo(arg).isDir()) {
+            // 当前曲库目录已加载，无需重新扫描
+            if (QDir(arg) != QDir(m_musicFolder)) importFolder(arg);
+        } else if (QFileInfo(arg).isFile() && PlaylistReader::isPlaylistFile(arg)) {
+            importPlaylist(arg);
+        } else if (QFileInfo(arg).isFile() && m_playlist) {
+            // 已在列表中时直接播放，否则读取后追加到末尾
+            const int idx = m_playlist->indexOfPath(QFileInfo(arg).absoluteFilePath());
+            if (idx < 0) toProbe.append(arg);
+            else if (firstAdded < 0 && toProbe.isEmpty()) firstAdded = idx;
+        } else {
+            qWarning() << "PlayerBackend - 忽略无法识别的参数:" << arg;
+        }
+    }
+    if (firstAdded >= 0) playIndex(firstAdded);
+    if (toProbe.isEmpty()) return;
+
+    // 读取元数据可能要等辅助进程超时，不在 GUI 线程上等待；第一个文件参数不在列表中时，读取完成后播放
+    const bool playFirst = firstAdded < 0;
+    m_library->probeFiles(toProbe, this, [this, playFirst](const QVector<TrackItem> &tracks) {
+        if (tracks.isEmpty() || !m_playlist) return;
+        QVector<TrackItem> added;
+        for (const TrackItem &track : tracks) {
+            // 等待期间可能已由扫描或另一次转发加入
+            if (m_playlist->indexOfPath(track.url.toLocalFile()) < 0) added.append(track);
+        }
+        m_playlist->appendTracks(added);
+        if (!playFirst) return;
+        const int idx = m_playlist->indexOfPath(tracks.constFirst().url.toLocalFile());
+        if (idx >= 0) playIndex(idx);
+    });
+}
+
+void PlayerBackend::loadLibrary(const QString &folderPath)
+{
+    TRACE_SCOPE("PlayerBackend::loadLibrary");
+    if (!m_playlist || folderPath.isEmpty() || !QDir(folderPath).exists()) return;
+    if (m_libraryLoading) {
+        // 同一目录直接沿用正在进行的扫描，不同目录等本次结束后再扫描
+        if (folderPath != m_libraryLoadingFolder) m_libraryQueuedFolder = folderPath;
+        return;
+    }
+    m_libraryLoading = true;
+    m_libraryLoadingFolder = folderPath;
+    m_library->scan(folderPath);
+}
+
+void PlayerBackend::onLibraryScanned(const LibrarySnapshotPtr &snapshot, const LibraryChangeSet &changes)
+{
+    TRACE_SCOPE("PlayerBackend::onLibraryScanned");
+    // 扫描会改变行号，先记下当前歌曲的路径，之后按路径找回
+    QString currentPath;
+    if (m_index >= 0) currentPath = QUrl(m_playlist->get(m_index).value("url").toString()).toLocalFile();
+
+    m_librarySnapshot = snapshot;
+    m_playlists->setLibrary(snapshot);
+    LibraryColumns::Delta delta;
+    if (!changes.isEmpty()) {
+        delta = m_columns.update(snapshot->tracks, QDateTime::currentMSecsSinceEpoch());
+        m_albumTracksDirty = true;
+        // 已移出曲库的文件不再保留响度结果
+        QSet<QString> paths;
+        paths.reserve(snapshot->tracks.size());
+        for (const TrackItem &track : snapshot->tracks) paths.insert(track.url.toLocalFile());
+        m_loudness->retain(paths);
+        // 预取的下一首可能只是标签、封面或歌词变了（行号与地址不变），丢弃后按新快照重新预取
+        m_prefetched = PrefetchedTrack();
+    }
+    queueLoudnessAnalysis();
+
+    // 正在显示命名歌单时只更新曲库索引，列表保持不变；智能歌单只重新计算变化的行
+    const bool libraryView = m_currentPlaylist.isEmpty() && m_currentSmartPlaylist.isEmpty();
+    if (libraryView && !changes.reset && m_playlist->libraryGeneration() == changes.fromGeneration) {
+        // 列表正显示上一份快照：播放队列先按变化区间换算行号，列表再逐段更新，滚动位置与队列都保留
+        if (!changes.isEmpty()) {
+            m_queue.remap([&changes](int row) { return changes.mapRow(row); }, snapshot->tracks.size());
+            m_playlist->applyChanges(snapshot->tracks, changes);
+            emit upNextChanged();
+        }
+    } else if (libraryView) {
+        // 整表替换会清空播放队列；曲目顺序不变（如从会话快照恢复的列表）时索引仍然有效，恢复原来的队列
+        const TrackList previousTracks = m_playlist->tracks();
+        const QByteArray queueState = m_queue.saveState();
+        m_playlist->setTracks(snapshot->tracks, snapshot->generation);
+        const bool sameOrder = snapshot->tracks.size() == previousTracks.size()
+            && std::equal(snapshot->tracks.begin(), snapshot->tracks.end(), previousTracks.begin(),
+                          [](const TrackItem &a, const TrackItem &b) { return a.url == b.url; });
+        if (sameOrder && m_queue.restoreState(queueState)) emit upNextChanged();
+    }
+
+    m_libraryLoading = false;
+    m_libraryLoadingFolder.clear();
+    ++m_libraryScanCount;
+    markStartup("libraryLoaded");
+    if (m_playlist->rowCount() > 0) markStartup("playable");
+
+    if (libraryView) {
+        remapCurrentIndex(currentPath);
+    } else if (!m_currentSmartPlaylist.isEmpty()) {
+        if (!changes.isEmpty()) {
+            m_smartQuery.update(m_columns, delta, QDateTime::currentMSecsSinceEpoch(), &m_smartMatches);
+            showSmartResult();
+        }
+    } else if (m_playlist->rowCount() == 0 && !m_playlists->isLoading()) {
+        // 没有会话快照可恢复：从歌单文件加载
+        openPlaylist(m_currentPlaylist);
+    }
+
+    if (!m_libraryQueuedFolder.isEmpty()) {
+        const QString next = m_libraryQueuedFolder;
+        m_libraryQueuedFolder.clear();
+        QTimer::singleShot(0, this, [this, next]() { loadLibrary(next); });
+    } else if (!m_initialized) {
+        finishInit();
+    }
+}
+
+void PlayerBackend::remapCurrentIndex(const QString &currentPath)
+{
+    if (currentPath.isEmpty()) return;
+    const int idx = m_playlist->indexOfPath(currentPath);
+    if (idx != m_index) {
+        m_index = idx;
+        emit currentIndexChanged(m_index);
+    }
+    prepareNextTrack();
+}
+
+void PlayerBackend::beginPlaylistView(const QString &name)
+{
+    // 当前歌曲继续播放；列表分批加载，加载到它所在的批次时再找回索引
+    m_viewCurrentPath = m_index >= 0 ? QUrl(m_playlist->get(m_index).value("url").toString()).toLocalFile() : QString();
+    if (m_currentPlaylist != name || !m_currentSmartPlaylist.isEmpty()) {
+        m_currentPlaylist = name;
+        leaveSmartView();
+        emit currentPlaylistChanged();
+        saveSettings();
+    }
+    m_playlist->clear();
+    if (m_index != -1) {
+        m_index = -1;
+        emit currentIndexChanged(m_index);
+    }
+}
+
+void PlayerBackend::openPlaylist(const QString &name)
+{
+    if (!m_playlist || !m_playlists->contains(name)) return;
+    beginPlaylistView(name);
+    m_playlists->load(m_playlists->filePath(name));
+}
+
+void PlayerBackend::importPlaylist(const QString &filePath)
+{
+    if (!m_playlist || !PlaylistReader::isPlaylistFile(filePath)) return;
+    const QString name = m_playlists->uniqueName(QFileInfo(filePath).completeBaseName());
+    beginPlaylistView(name);
+    m_playlists->load(filePath, name);
+}
+
+void PlayerBackend::showLibrary()
+{
+    if (!m_playlist || (m_currentPlaylist.isEmpty() && m_currentSmartPlaylist.isEmpty())) return;
+    m_playlists->cancelLoad();
+    QString currentPath = m_viewCurrentPath;
+    if (m_index >= 0) currentPath = QUrl(m_playlist->get(m_index).value("url").toString()).toLocalFile();
+    m_viewCurrentPath.clear();
+    m_currentPlaylist.clear();
+    leaveSmartView();
+    emit currentPlaylistChanged();
+    saveSettings();
+    m_playlist->setTracks(m_librarySnapshot->tracks, m_librarySnapshot->generation);
+    remapCurrentIndex(currentPath);
+}
+
+void PlayerBackend::exportPlaylist(const QString &filePath)
+{
+    if (!m_playlist || filePath.isEmpty()) return;
+    m_playlists->save(filePath, m_playlist->tracks(), true);
+}
+
+void PlayerBackend::savePlaylist(const QString &name)
+{
+    if (!m_playlist || name.trimmed().isEmpty()) return;
+    m_playlists->save(m_playlists->filePath(name), m_playlist->tracks(), false);
+}
+
+void PlayerBackend::deletePlaylist(const QString &name)
+{
+    if (name == m_currentPlaylist) showLibrary();
+    m_playlists->remove(name);
+}
+
+void PlayerBackend::onPlaylistTracksLoaded(const QVector<TrackItem> &tracks)
+{
+    m_playlist->appendTracks(tracks);
+    if (m_index < 0 && !m_viewCurrentPath.isEmpty()) {
+        const int idx = m_playlist->indexOfPath(m_viewCurrentPath);
+        if (idx >= 0) {
+            m_viewCurrentPath.clear();
+            m_index = idx;
+            m_queue.jumpTo(idx);
+            emit currentIndexChanged(m_index);
+        }
+    }
+}
+
+void PlayerBackend::onPlaylistLoadFinished(bool ok, int count)
+{
+    if (!ok && count == 0) {
+        qWarning() << "PlayerBackend - 歌单加载失败:" << m_currentPlaylist;
+        showLibrary();
+        return;
+    }
+    m_viewCurrentPath.clear();
+    prepareNextTrack();
+}
+
+QString PlayerBackend::saveSmartPlaylist(const QString &name, const QString &query)
+{
+    const QString trimmed = name.trimmed();
+    if (trimmed.isEmpty()) return QStringLiteral("名称为空");
+    QString error;
+    if (!SmartQuery::compile(query, &error).isValid()) return error;
+    m_smartPlaylists.insert(trimmed, query);
+    emit smartPlaylistsChanged();
+    saveSettings();
+    // 修改了正在显示的智能歌单：按新条件重新筛选
+    if (trimmed == m_currentSmartPlaylist) openSmartPlaylist(trimmed);
+    return QString();
+}
+
+QString PlayerBackend::smartPlaylistQuery(const QString &name) const
+{
+    return m_smartPlaylists.value(name).toString();
+}
+
+void PlayerBackend::openSmartPlaylist(const QString &name)
+{
+    if (!m_playlist || !m_smartPlaylists.contains(name)) return;
+    const SmartQuery query = SmartQuery::compile(m_smartPlaylists.value(name).toString());
+    if (!query.isValid()) return;
+
+    m_playlists->cancelLoad();
+    m_viewCurrentPath.clear();
+    m_currentPlaylist.clear();
+    m_currentSmartPlaylist = name;
+    m_smartQuery = query;
+    emit currentPlaylistChanged();
+    saveSettings();
+
+    m_smartQuery.evaluate(m_columns, QDateTime::currentMSecsSinceEpoch(), &m_smartMatches);
+    showSmartResult();
+}
+
+void PlayerBackend::deleteSmartPlaylist(const QString &name)
+{
+    if (!m_smartPlaylists.contains(name)) return;
+    if (name == m_currentSmartPlaylist) showLibrary();
+    m_smartPlaylists.remove(name);
+    emit smartPlaylistsChanged();
+    saveSettings();
+}
+
+void PlayerBackend::leaveSmartView()
+{
+    m_currentSmartPlaylist.clear();
+    m_smartQuery = SmartQuery();
+    m_smartMatches.clear();
+}
+
+void PlayerBackend::showSmartResult()
+{
+    QString currentPath;
+    if (m_index >= 0) currentPath = QUrl(m_playlist->get(m_index).value("url").toString()).toLocalFile();
+
+    const TrackList &library = m_columns.tracks();
+    QVector<TrackItem> tracks;
+    for (size_t r = 0; r < m_smartMatches.size(); ++r) {
+        if (m_smartMatches[r]) tracks.append(library[int(r)]);
+    }
+    m_playlist->setTracks(tracks);
+    remapCurrentIndex(currentPath);
+}
+
+void PlayerBackend::recordPlay(const QString &path)
+{
+    if (path.isEmpty()) return;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int row = m_columns.recordPlay(path, now);
+    // 只更新这一行的结果；列表在下次打开或曲库更新时刷新，正在播放的歌曲不会突然从列表中消失
+    if (row >= 0 && !m_currentSmartPlaylist.isEmpty()) {
+        m_smartQuery.updateRows(m_columns, { row }, now, &m_smartMatches);
+    }
+}
+
+void PlayerBackend::restoreSession()
+{
+    TRACE_SCOPE("PlayerBackend::restoreSession");
+    if (!m_playlist) return;
+    SessionSnapshot snapshot;
+    if (!snapshot.load(SessionSnapshot::defaultPath()) || !snapshot.isValid()) return;
+
+    const TrackItem &track = snapshot.tracks[snapshot.index];
+    if (!QFile::exists(track.url.toLocalFile())) return;
+
+    m_playlist->setTracks(snapshot.tracks);
+    // 恢复随机顺序、历史与待播；快照中没有队列状态时从当前曲目开始记录历史
+    if (!m_queue.restoreState(snapshot.queue)) m_queue.jumpTo(snapshot.index);
+    emit upNextChanged();
+    if (m_musicFolder.isEmpty()) m_musicFolder = snapshot.musicFolder;
+
+    // 只加载不播放，媒体就绪后跳回上次的位置
+    m_trackGain = trackGain(track.url.toLocalFile(), JobScheduler::CurrentTrack);
+    if (m_engine) {
+        m_engine->setSource(track.url, m_trackGain);
+    } else {
+        applyVolume();
+        m_player->setSource(track.url);
+    }
+    applyTrackInfo(loadTrack(snapshot.index));
+    if (snapshot.positionMs > 0) m_pendingSeek = snapshot.positionMs;
+    prepareNextTrack();
+    markStartup("sessionRestored");
+}
+
+void PlayerBackend::saveSession()
+{
+    TRACE_SCOPE("PlayerBackend::saveSession");
+    if (!m_playlist) return;
+    SessionSnapshot snapshot;
+    snapshot.musicFolder = m_musicFolder;
+    snapshot.tracks = m_playlist->tracks().toVector();
+    snapshot.index = m_index;
+    snapshot.queue = m_queue.saveState();
+    snapshot.positionMs = m_index >= 0 ? position() : 0;
+    if (!snapshot.save(SessionSnapshot::defaultPath())) {
+        qWarning() << "PlayerBackend - 保存会话快照失败";
+    }
+    if (m_columns.isDirty() && !m_columns.save(LibraryColumns::defaultPath())) {
+        qWarning() << "PlayerBackend - 保存播放统计失败";
+    }
+    saveLoudnessCache();
+}
+
+void PlayerBackend::saveLoudnessCache()
+{
+    m_loudnessSaveTimer->stop();
+    m_loudnessUnsaved = 0;
+    if (m_loudness->isDirty() && !m_loudness->save(LoudnessCache::defaultCachePath())) {
+        qWarning() << "PlayerBackend - 保存响度分析结果失败";
+    }
+}
+
+void PlayerBackend::markStartup(const QString &label)
+{
+    if (StartupTimeline::mark(label)) emit startupTimelineChanged();
+}
+
+void PlayerBackend::traceComponent(const QString &name, double compileMs, double createMs)
+{
+    StartupTimeline::recordComponent(name, qint64(compileMs), qint64(createMs));
+    emit startupTimelineChanged();
+}
+
+QVariantList PlayerBackend::startupTimeline() const
+{
+    return StartupTimeline::events();
+}
+
+int PlayerBackend::timeToFirstFrameMs() const
+{
+    return int(StartupTimeline::elapsed("firstFrame"));
+}
+
+int PlayerBackend::timeToPlayableMs() const
+{
+    return int(StartupTimeline::elapsed("playable"));
 }
 
 void PlayerBackend::setPlayMode(int mode)
 {
     if (m_playMode != mode && mode >= 1 && mode <= 3) {
         m_playMode = mode;
+        applyQueueMode();
         emit playModeChanged();
         saveSettings();
+        prepareNextTrack();
+    }
+}
+
+void PlayerBackend::applyQueueMode()
+{
+    switch (m_playMode) {
+    case 1: m_queue.setMode(PlayQueue::RepeatOne); break;
+    case 3: m_queue.setMode(PlayQueue::Shuffle); break;
+    default: m_queue.setMode(PlayQueue::Sequential); break;
     }
 }
 
+QVariantList PlayerBackend::upNext() const
+{
+    QVariantList list;
+    for (int idx : m_queue.upNext()) list.append(idx);
+    return list;
+}
+
+void PlayerBackend::playNext(int idx)
+{
+    m_queue.playNext(idx);
+    emit upNextChanged();
+    prepareNextTrack();
+}
+
+void PlayerBackend::addToQueue(int idx)
+{
+    m_queue.enqueue(idx);
+    emit upNextChanged();
+    prepareNextTrack();
+}
+
+void PlayerBackend::removeFromQueue(int position)
+{
+    m_queue.removeUpNext(position);
+    emit upNextChanged();
+    prepareNextTrack();
+}
+
 void PlayerBackend::togglePlayMode()
 {
     int nextMode;
@@ -527,6 +1368,23 @@ void PlayerBackend::togglePlayMode()
 
 void PlayerBackend::updateSpectrum()
 {
+    TRACE_SCOPE("PlayerBackend::updateSpectrum");
+    Metrics::ScopedTimer frameTimer(Metrics::SpectrumFrame);
+    // PCM 管线：直接从环形缓冲区的分析抽头读取刚输出的采样做 FFT
+    if (m_engine) {
+        const int frames = m_engine->readAnalysisWindow(m_analysisWindow.data(), m_analyzer.fftSize());
+        if (!isPlaying() || frames < m_analyzer.fftSize()) {
+            m_spectrum.fill(0.0, m_analyzer.bandCount());
+            m_analyzer.reset();
+            m_audioLevel = 0.0;
+        } else {
+            m_analyzer.process(m_analysisWindow.constData(), m_spectrum, m_audioLevel);
+        }
+        emit audioLevelChanged();
+        emit spectrumChanged();
+        return;
+    }
+
     // 由于 Qt 6 中无法直接获取 PCM 数据，我们基于音频级别生成模拟频谱
     // 这将创建一个更真实的频谱效果，与音频级别同步
     
@@ -594,21 +1452,104 @@ void PlayerBackend::setVolume(double volume)
 {
     if (m_volume != volume) {
         m_volume = qMax(0.0, qMin(1.0, volume));
-        if (m_audioOutput) {
-            m_audioOutput->setVolume(m_isMuted ? 0.0 : m_volume);
-        }
+        applyVolume();
         emit volumeChanged();
         saveSettings();
     }
 }
 
+void PlayerBackend::setCrossfadeMs(int ms)
+{
+    ms = qBound(0, ms, MAX_CROSSFADE_MS);
+    if (m_crossfadeMs == ms) return;
+    m_crossfadeMs = ms;
+    if (m_engine) m_engine->setCrossfadeMs(ms);
+    emit crossfadeMsChanged();
+    saveSettings();
+}
+
+QVariantList PlayerBackend::eqBandGains() const
+{
+    QVariantList list;
+    for (double gain : m_eqGains) list.append(gain);
+    return list;
+}
+
+QVariantList PlayerBackend::eqBandFrequencies() const
+{
+    QVariantList list;
+    for (double freq : m_eqFrequencies) list.append(freq);
+    return list;
+}
+
+void PlayerBackend::setEqEnabled(bool enabled)
+{
+    if (m_eqEnabled == enabled) return;
+    m_eqEnabled = enabled;
+    applyEqualizer();
+    emit equalizerChanged();
+    saveSettings();
+}
+
+void PlayerBackend::setEqPreamp(double gainDb)
+{
+    gainDb = qBound(-24.0, gainDb, 24.0);
+    if (m_eqPreamp == gainDb) return;
+    m_eqPreamp = gainDb;
+    applyEqualizer();
+    emit equalizerChanged();
+    saveSettings();
+}
+
+void PlayerBackend::setEqBandGain(int band, double gainDb)
+{
+    if (band < 0 || band >= Equalizer::BAND_COUNT) return;
+    setEqBand(band, m_eqFrequencies[band], gainDb, m_eqQ[band]);
+}
+
+void PlayerBackend::setEqBand(int band, double frequencyHz, double gainDb, double q)
+{
+    if (band < 0 || band >= Equalizer::BAND_COUNT) return;
+    m_eqGains[band] = qBound(-24.0, gainDb, 24.0);
+    m_eqFrequencies[band] = qBound(20.0, frequencyHz, 20000.0);
+    m_eqQ[band] = qBound(0.1, q, 10.0);
+    m_eqPreset.clear();
+    applyEqualizer();
+    emit equalizerChanged();
+    saveSettings();
+}
+
+void PlayerBackend::applyEqPreset(const QString &name)
+{
+    const QVector<double> gains = Equalizer::presetGains(name);
+    if (gains.isEmpty()) return;
+    for (int b = 0; b < Equalizer::BAND_COUNT; ++b) {
+        m_eqGains[b] = gains[b];
+        m_eqFrequencies[b] = Equalizer::defaultFrequency(b);
+        m_eqQ[b] = 1.0;
+    }
+    m_eqPreset = name;
+    applyEqualizer();
+    emit equalizerChanged();
+    saveSettings();
+}
+
+void PlayerBackend::applyEqualizer()
+{
+    if (!m_engine) return;
+    Equalizer &eq = m_engine->equalizer();
+    for (int b = 0; b < Equalizer::BAND_COUNT; ++b) {
+        eq.setBand(b, m_eqFrequencies[b], m_eqGains[b], m_eqQ[b]);
+    }
+    eq.setPreamp(m_eqPreamp);
+    eq.setEnabled(m_eqEnabled);
+}
+
 void PlayerBackend::setMuted(bool muted)
 {
     if (m_isMuted != muted) {
         m_isMuted = muted;
-        if (m_audioOutput) {
-            m_audioOutput->setVolume(m_isMuted ? 0.0 : m_volume);
-        }
+        applyVolume();
         emit isMutedChanged();
         saveSettings();
     }
@@ -619,6 +1560,106 @@ void PlayerBackend::toggleMute()
     setMuted(!m_isMuted);
 }
 
+void PlayerBackend::applyVolume()
+{
+    const double effective = m_isMuted ? 0.0 : m_volume;
+    if (m_engine) {
+        m_engine->setVolume(float(effective));
+    } else if (m_audioOutput) {
+        // QMediaPlayer 不能对采样施加增益：响度均衡只能通过降低音量实现
+        m_audioOutput->setVolume(effective * qMin(1.0f, m_trackGain));
+    }
+}
+
+float PlayerBackend::trackGain(const QString &path, JobScheduler::Priority priority)
+{
+    if (m_loudnessMode == 0 || path.isEmpty()) return 1.0f;
+    LoudnessInfo info;
+    if (!m_loudness->lookup(path, &info)) {
+        // 尚未分析或文件已变化：本次按原音量播放，同时提前分析
+        m_jobs->submit("loudness", path, priority);
+        return 1.0f;
+    }
+
+    if (m_loudnessMode == 2) {
+        // 专辑内全部曲目都有结果时才使用专辑增益，否则暂时按曲目。
+        // 其它曲目不逐个读取文件信息（每次切歌都在 GUI 线程上），它们被播放时自己的查询会发现文件变化
+        const QStringList members = albumTracks(path);
+        QVector<LoudnessInfo> infos;
+        for (const QString &member : members) {
+            LoudnessInfo memberInfo;
+            if (member == path) infos.append(info);
+            else if (m_loudness->contains(member, &memberInfo)) infos.append(memberInfo);
+            else m_jobs->submit("loudness", member, priority);
+        }
+        if (members.size() > 1 && infos.size() == members.size()) info = LoudnessInfo::combine(infos);
+    }
+    return info.gain(m_loudnessTargetLufs, m_loudnessPreventClipping);
+}
+
+QStringList PlayerBackend::albumTracks(const QString &path)
+{
+    if (m_albumTracksDirty) {
+        m_albumTracksDirty = false;
+        m_albumKeyByPath.clear();
+        m_albumTracks.clear();
+        for (const TrackItem &track : m_librarySnapshot->tracks) {
+            if (track.album.isEmpty()) continue;
+            // 不同目录下的同名专辑（如各种“精选集”）分开计算
+            const QString trackPath = track.url.toLocalFile();
+            const QString key = trackPath.left(trackPath.lastIndexOf('/')) + QChar('\n') + track.album.toLower();
+            m_albumKeyByPath.insert(trackPath, key);
+            m_albumTracks[key].append(trackPath);
+        }
+    }
+    return m_albumTracks.value(m_albumKeyByPath.value(path));
+}
+
+void PlayerBackend::queueLoudnessAnalysis()
+{
+    if (m_loudnessMode == 0) return;
+    // 以快照版本为键：曲库再次变化时提交新的一轮，同一版本只检查一次
+    m_jobs->submit("loudness-backfill", QString::number(m_librarySnapshot->generation), JobScheduler::Idle);
+}
+
+void PlayerBackend::setLoudnessMode(int mode)
+{
+    mode = qBound(0, mode, 2);
+    if (m_loudnessMode == mode) return;
+    m_loudnessMode = mode;
+    queueLoudnessAnalysis();
+    applyLoudnessSettings();
+    emit loudnessChanged();
+    saveSettings();
+}
+
+void PlayerBackend::setLoudnessPreventClipping(bool enabled)
+{
+    if (m_loudnessPreventClipping == enabled) return;
+    m_loudnessPreventClipping = enabled;
+    applyLoudnessSettings();
+    emit loudnessChanged();
+    saveSettings();
+}
+
+void PlayerBackend::applyLoudnessSettings()
+{
+    if (m_engine) {
+        // 下一首已按旧设置交给引擎预读：重新交一次，设置才能从下一首起生效
+        prepareNextTrack();
+    } else if (m_player) {
+        // QMediaPlayer 只能通过音量衰减，改变音量不会产生爆音，当前曲目立即生效
+        m_trackGain = trackGain(m_player->source().toLocalFile(), JobScheduler::CurrentTrack);
+        applyVolume();
+    }
+}
+
+void PlayerBackend::setAudioEngine(const QString &engine)
+{
+    if (engine != "qt" && engine != "pcm") return;
+    m_settings->setValue("audioEngine", engine);
+}
+
 bool PlayerBackend::eventFilter(QObject *obj, QEvent *event)
 {
     if (event->type() == QEvent::KeyPress) {
@@ -645,6 +1686,23 @@ bool PlayerBackend::eventFilter(QObject *obj, QEvent *event)
             next();
             return true; // 事件已处理
         }
+        else if (keyEvent->key() == Qt::Key_T && (keyEvent->modifiers() & Qt::ControlModifier)
+                 && (keyEvent->modifiers() & Qt::ShiftModifier)) {
+            // Ctrl+Shift+T：未在追踪时开始记录，正在追踪时导出到默认位置
+            if (!Trace::enabled()) {
+                qInfo() << "Ctrl+Shift+T detected, tracing enabled";
+                Trace::setEnabled(true);
+            } else {
+                Trace::dumpJson(Trace::defaultDumpPath());
+            }
+            return true; // 事件已处理
+        }
+        else if (keyEvent->key() == Qt::Key_M && (keyEvent->modifiers() & Qt::ControlModifier)
+                 && (keyEvent->modifiers() & Qt::ShiftModifier)) {
+            // Ctrl+Shift+M：显示/隐藏运行时指标浮层
+            emit toggleMetricsOverlay();
+            return true; // 事件已处理
+        }
         else if (keyEvent->key() == Qt::Key_F && (keyEvent->modifiers() & Qt::ControlModifier)) {
             qDebug() << "Ctrl+F detected, toggling search mode";
             emit toggleSearchMode();
@@ -655,10 +1713,47 @@ bool PlayerBackend::eventFilter(QObject *obj, QEvent *event)
 }
 
 // 背景图片管理方法
+void PlayerBackend::updateBackgroundTargetSize()
+{
+    QScreen *screen = QGuiApplication::primaryScreen();
+    if (!screen) return;
+    const QSize size = screen->size() * screen->devicePixelRatio();
+    if (size == m_bgPipeline->targetSize()) return;
+    m_bgPipeline->setTargetSize(size);
+    updateBackgroundVariants();
+    m_bgPipeline->prefetch(m_backgroundImageList);
+}
+
+void PlayerBackend::updateBackgroundVariants()
+{
+    BackgroundPipeline::Variants variants;
+    if (m_backgroundImage.isEmpty()) {
+        m_backgroundDisplayImage.clear();
+        m_backgroundBlurImage.clear();
+    } else if (m_bgPipeline->lookup(m_backgroundImage, &variants)) {
+        m_backgroundDisplayImage = variants.display;
+        m_backgroundBlurImage = variants.blurred;
+    } else {
+        // 处理完成前先显示原图，模糊层暂时留空
+        m_backgroundDisplayImage = m_backgroundImage;
+        m_backgroundBlurImage.clear();
+        m_bgPipeline->request(m_backgroundImage);
+    }
+    emit backgroundVariantsChanged();
+}
+
+QString PlayerBackend::backgroundThumbnailUrl(const QString &imagePath) const
+{
+    // 管理窗口中可见的项：缩略图尚未生成时提前到空闲补全之前
+    m_jobs->submit("thumbnail", imagePath, JobScheduler::Visible);
+    return BackgroundThumbnails::url(imagePath);
+}
+
 void PlayerBackend::addBackgroundImage(const QString &imagePath)
 {
     if (QFile::exists(imagePath) && !m_backgroundImageList.contains(imagePath)) {
         m_backgroundImageList.append(imagePath);
+        m_jobs->submit("thumbnail", imagePath, JobScheduler::Visible);
         emit backgroundImageListChanged();
         
         // 如果是第一张图片，设置为当前背景
@@ -674,12 +1769,12 @@ void PlayerBackend::addBackgroundImage(const QString &imagePath)
 
 void PlayerBackend::addBackgroundImages(const QStringList &imagePaths)
 {
-    bool hasNewImages = false;
+    QStringList added;
     
     for (const QString &imagePath : imagePaths) {
         if (QFile::exists(imagePath) && !m_backgroundImageList.contains(imagePath)) {
             m_backgroundImageList.append(imagePath);
-            hasNewImages = true;
+            added.append(imagePath);
             
             // 如果是第一张图片，设置为当前背景
             if (m_backgroundImageList.size() == 1) {
@@ -690,7 +1785,11 @@ void PlayerBackend::addBackgroundImages(const QStringList &imagePaths)
         }
     }
     
-    if (hasNewImages) {
+    if (!added.isEmpty()) {
+        // 新加入的图片多半马上会在管理窗口中显示
+        for (const QString &imagePath : std::as_const(added)) {
+            m_jobs->submit("thumbnail", imagePath, JobScheduler::Visible);
+        }
         emit backgroundImageListChanged();
         saveSettings();
     }
@@ -713,7 +1812,8 @@ void PlayerBackend::removeBackgroundImageByIndex(int index)
         return;
     }
     
-    // 移除指定索引的图片
+    // 移除指定索引的图片及其缩略图缓存
+    BackgroundThumbnails::remove(m_backgroundImageList[index]);
     m_backgroundImageList.removeAt(index);
     
     // 如果移除的是当前背景图片
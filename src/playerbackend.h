@@ -6,12 +6,25 @@
 #include <QAudioOutput>
 #include <QTimer>
 #include <QVariant>
-#include <QSettings>
 #include <QTimer>
 #include <QDateTime>
 #include <QRandomGenerator>
 #include <QVector>
+#include <QElapsedTimer>
 #include "playlistmodel.h"
+#include "libraryservice.h"
+#include "lyricindex.h"
+#include "audioengine.h"
+#include "spectrumanalyzer.h"
+#include "backgroundpipeline.h"
+#include "settingsstore.h"
+#include "playqueue.h"
+#include "playlistlibrary.h"
+#include "librarycolumns.h"
+#include "smartquery.h"
+#include "jobscheduler.h"
+#include "loudnesscache.h"
+#include <vector>
 
 class PlayerBackend : public QObject
 {
@@ -27,10 +40,14 @@ class PlayerBackend : public QObject
     Q_PROPERTY(QString currentLyrics READ currentLyrics NOTIFY currentLyricsChanged)
     Q_PROPERTY(QString nextLyrics READ nextLyrics NOTIFY nextLyricsChanged)
     Q_PROPERTY(QString cover READ cover NOTIFY coverChanged)
+    // 预测的下一首的封面：界面据此提前解码进图片缓存
+    Q_PROPERTY(QString nextCover READ nextCover NOTIFY nextCoverChanged)
     Q_PROPERTY(double audioLevel READ audioLevel NOTIFY audioLevelChanged)
     Q_PROPERTY(int globalMouseX READ globalMouseX NOTIFY globalMouseXChanged)
     Q_PROPERTY(int globalMouseY READ globalMouseY NOTIFY globalMouseYChanged)
     Q_PROPERTY(QString backgroundImage READ backgroundImage NOTIFY backgroundImageChanged)
+    Q_PROPERTY(QString backgroundDisplayImage READ backgroundDisplayImage NOTIFY backgroundVariantsChanged)
+    Q_PROPERTY(QString backgroundBlurImage READ backgroundBlurImage NOTIFY backgroundVariantsChanged)
     Q_PROPERTY(QStringList backgroundImageList READ backgroundImageList NOTIFY backgroundImageListChanged)
     Q_PROPERTY(int currentBackgroundIndex READ currentBackgroundIndex NOTIFY currentBackgroundIndexChanged)
     Q_PROPERTY(QString musicFolder READ musicFolder NOTIFY musicFolderChanged)
@@ -38,6 +55,37 @@ class PlayerBackend : public QObject
     Q_PROPERTY(QVariantList spectrum READ spectrum NOTIFY spectrumChanged)
     Q_PROPERTY(double volume READ volume WRITE setVolume NOTIFY volumeChanged)
     Q_PROPERTY(bool isMuted READ isMuted WRITE setMuted NOTIFY isMutedChanged)
+    Q_PROPERTY(QString audioEngine READ audioEngine CONSTANT)
+    Q_PROPERTY(qint64 engineUnderruns READ engineUnderruns NOTIFY engineStatsChanged)
+    Q_PROPERTY(double engineBufferFill READ engineBufferFill NOTIFY engineStatsChanged)
+    Q_PROPERTY(qint64 engineDecodeAheadMs READ engineDecodeAheadMs NOTIFY engineStatsChanged)
+    Q_PROPERTY(bool eqAvailable READ eqAvailable CONSTANT)
+    Q_PROPERTY(bool eqEnabled READ eqEnabled WRITE setEqEnabled NOTIFY equalizerChanged)
+    Q_PROPERTY(double eqPreamp READ eqPreamp WRITE setEqPreamp NOTIFY equalizerChanged)
+    Q_PROPERTY(QVariantList eqBandGains READ eqBandGains NOTIFY equalizerChanged)
+    Q_PROPERTY(QVariantList eqBandFrequencies READ eqBandFrequencies NOTIFY equalizerChanged)
+    Q_PROPERTY(QString eqPreset READ eqPreset NOTIFY equalizerChanged)
+    Q_PROPERTY(QStringList eqPresetNames READ eqPresetNames CONSTANT)
+    Q_PROPERTY(int crossfadeMs READ crossfadeMs WRITE setCrossfadeMs NOTIFY crossfadeMsChanged)
+    Q_PROPERTY(double lastTrackSwitchGapMs READ lastTrackSwitchGapMs NOTIFY trackSwitchGapChanged)
+    Q_PROPERTY(int settingsWriteCount READ settingsWriteCount NOTIFY settingsWriteCountChanged)
+    // 启动时间线（毫秒，未到达时为 -1）与本次运行的曲库扫描次数
+    Q_PROPERTY(QVariantList startupTimeline READ startupTimeline NOTIFY startupTimelineChanged)
+    Q_PROPERTY(int timeToFirstFrameMs READ timeToFirstFrameMs NOTIFY startupTimelineChanged)
+    Q_PROPERTY(int timeToPlayableMs READ timeToPlayableMs NOTIFY startupTimelineChanged)
+    Q_PROPERTY(int libraryScanCount READ libraryScanCount NOTIFY startupTimelineChanged)
+    // 待播队列（“下一首播放”/“加入队列”插入的曲目索引，按播放顺序）
+    Q_PROPERTY(QVariantList upNext READ upNext NOTIFY upNextChanged)
+    // 命名歌单；currentPlaylist 为空时列表显示整个曲库
+    Q_PROPERTY(QStringList playlists READ playlists NOTIFY playlistsChanged)
+    Q_PROPERTY(QString currentPlaylist READ currentPlaylist NOTIFY currentPlaylistChanged)
+    Q_PROPERTY(bool playlistLoading READ playlistLoading NOTIFY playlistLoadingChanged)
+    // 智能歌单（按条件从曲库筛选，见 SmartQuery）
+    Q_PROPERTY(QStringList smartPlaylists READ smartPlaylists NOTIFY smartPlaylistsChanged)
+    Q_PROPERTY(QString currentSmartPlaylist READ currentSmartPlaylist NOTIFY currentPlaylistChanged)
+    // 响度均衡：0 关闭，1 按曲目，2 按专辑；增益在下一首开始时生效
+    Q_PROPERTY(int loudnessMode READ loudnessMode WRITE setLoudnessMode NOTIFY loudnessChanged)
+    Q_PROPERTY(bool loudnessPreventClipping READ loudnessPreventClipping WRITE setLoudnessPreventClipping NOTIFY loudnessChanged)
 
 public:
     explicit PlayerBackend(PlaylistModel *playlist, QObject *parent = nullptr);
@@ -53,10 +101,13 @@ public:
     QString currentLyrics() const { return m_currentLyrics; }
     QString nextLyrics() const { return m_nextLyrics; }
     QString cover() const { return m_cover; }
+    QString nextCover() const { return m_nextCover; }
     double audioLevel() const { return m_audioLevel; }
     int globalMouseX() const { return m_globalMouseX; }
     int globalMouseY() const { return m_globalMouseY; }
     QString backgroundImage() const { return m_backgroundImage; }
+    QString backgroundDisplayImage() const { return m_backgroundDisplayImage; } // 预缩放缓存，未就绪时为原图
+    QString backgroundBlurImage() const { return m_backgroundBlurImage; }       // 预模糊缓存，未就绪时为空
     QStringList backgroundImageList() const { return m_backgroundImageList; }
     int currentBackgroundIndex() const { return m_currentBackgroundIndex; }
     QString musicFolder() const { return m_musicFolder; }
@@ -64,6 +115,54 @@ public:
     QVariantList spectrum() const;
     double volume() const;
     bool isMuted() const;
+    QString audioEngine() const { return m_engine ? "pcm" : "qt"; }
+    qint64 engineUnderruns() const { return m_engine ? qint64(m_engine->underruns()) : 0; }
+    double engineBufferFill() const { return m_engine ? m_engine->bufferFill() : 0.0; }
+    qint64 engineDecodeAheadMs() const { return m_engine ? m_engine->decodeAheadMs() : 0; }
+    int crossfadeMs() const { return m_crossfadeMs; }
+    bool eqAvailable() const { return m_engine != nullptr; }
+    bool eqEnabled() const { return m_eqEnabled; }
+    double eqPreamp() const { return m_eqPreamp; }
+    QVariantList eqBandGains() const;
+    QVariantList eqBandFrequencies() const;
+    QString eqPreset() const { return m_eqPreset; } // 手动调节后为空
+    QStringList eqPresetNames() const { return Equalizer::presetNames(); }
+    double lastTrackSwitchGapMs() const { return m_trackSwitchGapMs; } // 最近一次自动切歌的间隙，-1 表示尚未测得
+    int settingsWriteCount() const { return m_settings->writeCount(); } // 设置实际落盘的次数
+    QVariantList startupTimeline() const;
+    int timeToFirstFrameMs() const;
+    int timeToPlayableMs() const;
+    int libraryScanCount() const { return m_libraryScanCount; }
+    QVariantList upNext() const;
+    QStringList playlists() const { return m_playlists->names(); }
+    QString currentPlaylist() const { return m_currentPlaylist; }
+    bool playlistLoading() const { return m_playlists->isLoading(); }
+    QStringList smartPlaylists() const { return m_smartPlaylists.keys(); }
+    QString currentSmartPlaylist() const { return m_currentSmartPlaylist; }
+    int loudnessMode() const { return m_loudnessMode; }
+    bool loudnessPreventClipping() const { return m_loudnessPreventClipping; }
+
+    // 全库歌词搜索：返回 [{index, title, artist, line, time}]，time 为毫秒（无时间戳为 -1）
+    Q_INVOKABLE QVariantList searchLyrics(const QString &query, int limit = 50) const;
+    // 背景管理窗口的缩略图地址（image://bgthumb/）
+    Q_INVOKABLE QString backgroundThumbnailUrl(const QString &imagePath) const;
+    // 播放队列：插到待播最前 / 排到待播最后 / 从待播中移除
+    Q_INVOKABLE void playNext(int idx);
+    Q_INVOKABLE void addToQueue(int idx);
+    Q_INVOKABLE void removeFromQueue(int position);
+    // 命名歌单：打开 / 回到曲库 / 导入 M3U、M3U8、PLS（另存为同名歌单并打开）/
+    // 导出当前列表（按扩展名写 M3U8 或 PLS）/ 把当前列表保存为歌单 / 删除
+    Q_INVOKABLE void openPlaylist(const QString &name);
+    Q_INVOKABLE void showLibrary();
+    Q_INVOKABLE void importPlaylist(const QString &filePath);
+    Q_INVOKABLE void exportPlaylist(const QString &filePath);
+    Q_INVOKABLE void savePlaylist(const QString &name);
+    Q_INVOKABLE void deletePlaylist(const QString &name);
+    // 智能歌单：保存（返回条件的错误信息，成功为空）/ 打开 / 删除 / 读取条件
+    Q_INVOKABLE QString saveSmartPlaylist(const QString &name, const QString &query);
+    Q_INVOKABLE void openSmartPlaylist(const QString &name);
+    Q_INVOKABLE void deleteSmartPlaylist(const QString &name);
+    Q_INVOKABLE QString smartPlaylistQuery(const QString &name) const;
 
 public slots:
     void play();
@@ -73,6 +172,7 @@ public slots:
     void previous();
     void setPosition(qint64 ms);
     void playIndex(int idx);
+    void playLyricHit(int idx, qint64 ms);
     void importFolder(const QString &folderPath);
     void updateGlobalMousePosition();
     void setBackgroundImage(const QString &imagePath);
@@ -86,11 +186,26 @@ public slots:
     void saveSettings();
     void loadSettings();
     void delayedInit();
+    void saveSession();
+    // 命令行或其它实例转来的参数：文件加入歌单（第一个立即播放），文件夹导入，--play 等为播放控制
+    void handleArguments(const QStringList &arguments);
+    void markStartup(const QString &label);
+    void traceComponent(const QString &name, double compileMs, double createMs); // 由 TracedLoader 调用
     void setPlayMode(int mode);
     void togglePlayMode();
     void setVolume(double volume);
     void setMuted(bool muted);
     void toggleMute();
+    void setCrossfadeMs(int ms); // 0 关闭；仅 PCM 播放引擎支持
+    void setLoudnessMode(int mode);
+    void setLoudnessPreventClipping(bool enabled);
+    // 均衡器（仅 PCM 播放引擎支持，设置始终保存）
+    void setEqEnabled(bool enabled);
+    void setEqPreamp(double gainDb);
+    void setEqBandGain(int band, double gainDb);
+    void setEqBand(int band, double frequencyHz, double gainDb, double q);
+    void applyEqPreset(const QString &name);
+    void setAudioEngine(const QString &engine); // "qt" 或 "pcm"，下次启动生效
 
 signals:
     void currentIndexChanged(int);
@@ -104,20 +219,37 @@ signals:
     void currentLyricsChanged();
     void nextLyricsChanged();
     void coverChanged();
+    void nextCoverChanged();
     void audioLevelChanged();
     void globalMouseXChanged();
     void globalMouseYChanged();
     void backgroundImageChanged();
     void backgroundImageListChanged();
+    void backgroundVariantsChanged();
     void currentBackgroundIndexChanged();
     void musicFolderChanged();
     void musicFolderNeeded();
     void playModeChanged();
+    void upNextChanged();
+    void playlistsChanged();
+    void currentPlaylistChanged();
+    void playlistLoadingChanged();
+    void playlistSaved(const QString &filePath, bool ok);
+    void smartPlaylistsChanged();
+    void crossfadeMsChanged();
+    void loudnessChanged();
+    void equalizerChanged();
     void spectrumChanged();
     void volumeChanged();
     void isMutedChanged();
+    void engineStatsChanged();
+    void trackSwitchGapChanged();
+    void settingsWriteCountChanged();
+    void startupTimelineChanged();
+    void activationRequested(); // 其它实例请求显示窗口
     void escapeKeyPressed();
     void toggleSearchMode(); // 用于控制搜索模式切换的信号
+    void toggleMetricsOverlay();
 
 protected:
     bool eventFilter(QObject *obj, QEvent *event) override;
@@ -127,16 +259,61 @@ private slots:
     void onDurationChanged(qint64 dur);
     void onPlaybackStateChanged(QMediaPlayer::PlaybackState st);
     void onMediaStatusChanged(QMediaPlayer::MediaStatus st);
+    void onTrackAdvanced();
     void updateAudioLevel();
     void updateSpectrum();
     void updateLyrics(qint64 position);
-    QStringList parseLyrics(const QString &lyricsText);
 
 private:
+    friend class BackendBenchmark;  // bench/backend_benchmark.cpp
+
+    QMediaPlayer::PlaybackState playbackState() const;
+    QMediaPlayer::MediaStatus mediaStatus() const;
+    void applyVolume();
+    // 切歌时需要的曲目信息：模型中的一行与解析好的歌词时间轴
+    struct PrefetchedTrack {
+        int index = -1;
+        QUrl url;
+        QVariantMap info;
+        QVector<LyricLine> lyrics;
+    };
+
+    static QVector<LyricLine> parseLyrics(const QString &lyricsText); // 只保留带时间戳的行，按时间排序
+    PrefetchedTrack loadTrack(int idx) const;
+    PrefetchedTrack takeTrack(int idx);   // 命中预取结果时直接使用，否则现场读取
+    void prefetchNextTrack();
+    void applyTrackInfo(const PrefetchedTrack &track);
+    int resolveNextIndex() const;
+    void prepareNextTrack();
+    void startTrack(int idx);
+    void applyQueueMode();
+    void setTrackSwitchGap(double ms);
+    void applyEqualizer();
+    void updateBackgroundVariants();
+    void updateBackgroundTargetSize();
+    void restoreSession();
+    void loadLibrary(const QString &folderPath);
+    void onLibraryScanned(const LibrarySnapshotPtr &snapshot, const LibraryChangeSet &changes);
+    void finishInit();
+    void remapCurrentIndex(const QString &currentPath);
+    void beginPlaylistView(const QString &name);
+    void onPlaylistTracksLoaded(const QVector<TrackItem> &tracks);
+    void onPlaylistLoadFinished(bool ok, int count);
+    void leaveSmartView();
+    void showSmartResult();
+    void recordPlay(const QString &path);
+    float trackGain(const QString &path, JobScheduler::Priority priority);
+    void applyLoudnessSettings();
+    QStringList albumTracks(const QString &path);
+    void queueLoudnessAnalysis();
+    void saveLoudnessCache();
+
     PlaylistModel *m_playlist;
     QMediaPlayer *m_player;
     QAudioOutput *m_audioOutput;
+    AudioEngine *m_engine = nullptr; // 非空时使用自有 PCM 管线代替 QMediaPlayer
     QTimer *m_audioLevelTimer;
+    QTimer *m_engineStatsTimer = nullptr;
 
     int m_index = -1;
     QString m_title;
@@ -147,19 +324,75 @@ private:
     QString m_nextLyrics;
     QString m_cover;
     double m_audioLevel = 0.0;
-    QStringList m_parsedLyrics;
+    QVector<LyricLine> m_parsedLyrics;
     qint64 m_lastLyricPosition = -1;
+    qint64 m_pendingSeek = -1; // 媒体加载完成后再跳转的位置（毫秒）
+
+    // 曲库加载（单飞）：扫描在曲库服务的线程上进行，扫描期间的重复请求只排队一次
+    LibraryService *m_library = nullptr;
+    LibrarySnapshotPtr m_librarySnapshot;   // 最近一次扫描的结果，只在 GUI 线程上替换，读取不需要同步
+    bool m_libraryLoading = false;
+    QString m_libraryLoadingFolder;
+    QString m_libraryQueuedFolder;
+    int m_libraryScanCount = 0;
+    QStringList m_pendingArguments; // 曲库加载完成前收到的参数，加载后再处理
+    bool m_initialized = false;
+    int m_preparedNextIndex = -1; // 已交给播放引擎预读的下一首（随机模式下保证预读与实际播放一致）
+    PrefetchedTrack m_prefetched; // 按播放模式与队列预测的下一首，切歌前准备好
+    QTimer *m_prefetchTimer = nullptr;
+    QString m_nextCover;
+    PlayQueue m_queue;            // 下一首/上一首的顺序（随机置换、历史、待播）
+    PlaylistLibrary *m_playlists = nullptr;
+    QString m_currentPlaylist;    // 正在显示的命名歌单，空为曲库
+    QString m_viewCurrentPath;    // 切换歌单时正在播放的文件，分批加载到它时找回索引
+    LibraryColumns m_columns;     // 曲库列式存储与播放统计，智能歌单在其上求值
+    QVariantMap m_smartPlaylists; // 名称 → 条件
+    QString m_currentSmartPlaylist;
+    SmartQuery m_smartQuery;      // 当前智能歌单的已编译条件与逐行结果
+    JobScheduler *m_jobs = nullptr; // 后台分析任务（缩略图等），按优先级与 CPU 预算执行
+    std::vector<quint8> m_smartMatches;
+    double m_trackSwitchGapMs = -1.0;
+    QElapsedTimer m_switchClock;  // QMediaPlayer 路径：从 EndOfMedia 到下一首出声的耗时
+    QElapsedTimer m_trackSwitchClock;  // 指标：从 playIndex 到 PlayingState
+    bool m_measuringSwitch = false;
     int m_globalMouseX = 0;
     int m_globalMouseY = 0;
+    SettingsStore *m_settings = nullptr;  // 设置的合并写入层，saveSettings 只提交有变化的键
     QString m_backgroundImage;
     QStringList m_backgroundImageList;
+    QString m_backgroundDisplayImage;
+    QString m_backgroundBlurImage;
+    BackgroundPipeline *m_bgPipeline = nullptr;
     int m_currentBackgroundIndex = -1;
     QString m_musicFolder;
     int m_playMode; // 0: Sequential, 1: Loop One, 2: Loop All, 3: Random
+    int m_crossfadeMs = 0; // 切歌交叉淡化时长，0 为无缝衔接
+
+    // 响度均衡
+    std::shared_ptr<LoudnessCache> m_loudness;   // 与后台分析任务共享
+    QTimer *m_loudnessSaveTimer = nullptr;
+    int m_loudnessUnsaved = 0;                    // 上次写回后完成的分析数
+    int m_loudnessMode = 1;
+    bool m_loudnessPreventClipping = true;
+    double m_loudnessTargetLufs = -18.0;
+    float m_trackGain = 1.0f;                     // QMediaPlayer 引擎下折算进音量（只能衰减）
+    QHash<QString, QString> m_albumKeyByPath;     // 曲库中的专辑分组（目录 + 专辑名），按需重建
+    QHash<QString, QStringList> m_albumTracks;
+    bool m_albumTracksDirty = true;
+
+    // 均衡器设置
+    bool m_eqEnabled = false;
+    double m_eqPreamp = 0.0;
+    QVector<double> m_eqGains;
+    QVector<double> m_eqFrequencies;
+    QVector<double> m_eqQ;
+    QString m_eqPreset = "Flat";
     
     // 频谱相关成员
     QVector<double> m_spectrum;   // 例如 30 个频段
     QTimer *m_fftTimer = nullptr;
+    SpectrumAnalyzer m_analyzer;  // 仅 PCM 管线可用时做真实频谱分析
+    QVector<float> m_analysisWindow;
     
     // 音量相关成员
     double m_volume = 1.0;
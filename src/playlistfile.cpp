@@ -0,0 +1,191 @@
+#include "playlistfile.h"
+#include "playlistmodel.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QUrl>
+
+static const QString UNKNOWN_ARTIST = QStringLiteral("Unknown Artist");
+
+// “艺术家 - 标题”，没有分隔符时整段作为标题
+static void splitDisplay(const QString &display, PlaylistEntry *entry)
+{
+    const int separator = display.indexOf(" - ");
+    if (separator > 0) {
+        entry->artist = display.left(separator).trimmed();
+        entry->title = display.mid(separator + 3).trimmed();
+    } else {
+        entry->title = display;
+    }
+}
+
+static bool hasSuffix(const QString &filePath, const char *suffix)
+{
+    return filePath.endsWith(QLatin1String(suffix), Qt::CaseInsensitive);
+}
+
+PlaylistReader::PlaylistReader(const QString &filePath)
+    : m_file(filePath)
+    , m_decoder(QStringDecoder::Utf8)
+{
+    m_baseDir = QFileInfo(filePath).absolutePath();
+    m_pls = hasSuffix(filePath, ".pls");
+    m_utf8Only = hasSuffix(filePath, ".m3u8");
+}
+
+bool PlaylistReader::isPlaylistFile(const QString &filePath)
+{
+    return hasSuffix(filePath, ".m3u") || hasSuffix(filePath, ".m3u8") || hasSuffix(filePath, ".pls");
+}
+
+bool PlaylistReader::open()
+{
+    return m_file.open(QIODevice::ReadOnly);
+}
+
+QString PlaylistReader::decodeLine(const QByteArray &raw)
+{
+    // 旧式 .m3u 常见本地编码（GBK 等）：UTF-8 解码失败的行按本地编码重新解码
+    m_decoder.resetState();
+    QString line = m_decoder(raw);
+    if (m_decoder.hasError() && !m_utf8Only) line = QString::fromLocal8Bit(raw);
+    if (m_firstLine) {
+        m_firstLine = false;
+        if (line.startsWith(QChar(0xFEFF))) line.remove(0, 1);
+    }
+    return line.trimmed();
+}
+
+QString PlaylistReader::resolvePath(const QString &ref) const
+{
+    if (ref.startsWith("file:", Qt::CaseInsensitive)) return QUrl(ref).toLocalFile();
+    if (ref.contains("://")) return QString();   // 网络流不支持
+
+    QString path = QDir::fromNativeSeparators(ref);
+    if (!QDir::isAbsolutePath(path)) path = m_baseDir + '/' + path;
+    return QDir::cleanPath(path);
+}
+
+bool PlaylistReader::readBatch(int maxCount, QVector<PlaylistEntry> *out)
+{
+    const int target = out->size() + maxCount;
+    while (out->size() < target) {
+        if (m_file.atEnd()) {
+            if (m_pls) flushPls(out);
+            return false;
+        }
+        const QByteArray raw = m_file.readLine();
+        if (raw.isEmpty() && m_file.error() != QFileDevice::NoError) return false;
+        const QString line = decodeLine(raw);
+        if (line.isEmpty()) continue;
+        if (m_pls) readPlsLine(line, out);
+        else readM3uLine(line, out);
+    }
+    return true;
+}
+
+void PlaylistReader::readM3uLine(const QString &line, QVector<PlaylistEntry> *out)
+{
+    if (line.startsWith('#')) {
+        // #EXTINF:秒数,艺术家 - 标题（秒数为 -1 表示未知）
+        if (!line.startsWith("#EXTINF:", Qt::CaseInsensitive)) return;
+        m_pending = PlaylistEntry();
+        m_hasPending = true;
+        const int comma = line.indexOf(',');
+        const QString seconds = line.mid(8, comma < 0 ? -1 : comma - 8).section(' ', 0, 0);
+        m_pending.durationMs = qMax(0, seconds.toInt() * 1000);
+        if (comma < 0) return;
+        splitDisplay(line.mid(comma + 1).trimmed(), &m_pending);
+        return;
+    }
+
+    PlaylistEntry entry = m_hasPending ? m_pending : PlaylistEntry();
+    m_hasPending = false;
+    entry.path = resolvePath(line);
+    if (!entry.path.isEmpty()) out->append(entry);
+}
+
+void PlaylistReader::readPlsLine(const QString &line, QVector<PlaylistEntry> *out)
+{
+    // FileN= / TitleN= / LengthN=，同一编号的键通常相邻；编号变化时输出上一条
+    static const QRegularExpression KEY_RE(QStringLiteral("^(File|Title|Length)(\\d+)=(.*)$"),
+                                           QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch match = KEY_RE.match(line);
+    if (!match.hasMatch()) return;
+
+    const int number = match.capturedView(2).toInt();
+    if (number != m_plsNumber) {
+        flushPls(out);
+        m_plsNumber = number;
+        m_pending = PlaylistEntry();
+        m_hasPending = true;
+    }
+    const QString key = match.captured(1).toLower();
+    const QString value = match.captured(3).trimmed();
+    if (key == "file") m_pending.path = resolvePath(value);
+    else if (key == "title") splitDisplay(value, &m_pending);
+    else m_pending.durationMs = qMax(0, value.toInt() * 1000);
+}
+
+void PlaylistReader::flushPls(QVector<PlaylistEntry> *out)
+{
+    if (m_hasPending && !m_pending.path.isEmpty()) out->append(m_pending);
+    m_hasPending = false;
+}
+
+PlaylistWriter::PlaylistWriter(const QString &filePath, bool relative)
+    : m_file(filePath)
+{
+    m_pls = hasSuffix(filePath, ".pls");
+    m_relative = relative;
+    if (relative) m_baseDir = QDir(QFileInfo(filePath).absolutePath());
+}
+
+bool PlaylistWriter::open()
+{
+    if (!m_file.open(QIODevice::WriteOnly)) return false;
+    m_file.write(m_pls ? "[playlist]\n" : "#EXTM3U\n");
+    return true;
+}
+
+void PlaylistWriter::write(const TrackItem &track)
+{
+    writeEntry(track.url.toLocalFile(), track.title, track.artist, track.duration);
+}
+
+void PlaylistWriter::write(const PlaylistEntry &entry)
+{
+    writeEntry(entry.path, entry.title, entry.artist, entry.durationMs);
+}
+
+void PlaylistWriter::writeEntry(const QString &path, const QString &title, const QString &artist, int durationMs)
+{
+    QString ref = path;
+    if (m_relative) {
+        const QString relative = m_baseDir.relativeFilePath(path);
+        if (!relative.startsWith("../")) ref = relative;
+    }
+    const int seconds = durationMs > 0 ? (durationMs + 500) / 1000 : -1;
+    const QString display = (artist.isEmpty() || artist == UNKNOWN_ARTIST) ? title : artist + " - " + title;
+    ++m_count;
+
+    m_buffer.clear();
+    if (m_pls) {
+        const QByteArray n = QByteArray::number(m_count);
+        m_buffer += "File" + n + '=' + ref.toUtf8() + '\n';
+        if (!title.isEmpty()) m_buffer += "Title" + n + '=' + display.toUtf8() + '\n';
+        m_buffer += "Length" + n + '=' + QByteArray::number(seconds) + '\n';
+    } else {
+        m_buffer += "#EXTINF:" + QByteArray::number(seconds) + ',' + display.toUtf8() + '\n';
+        m_buffer += ref.toUtf8() + '\n';
+    }
+    m_file.write(m_buffer);
+}
+
+bool PlaylistWriter::commit()
+{
+    if (m_pls) {
+        m_file.write("NumberOfEntries=" + QByteArray::number(m_count) + "\nVersion=2\n");
+    }
+    return m_file.commit();
+}
@@ -0,0 +1,79 @@
+#ifndef PLAYLISTFILE_H
+#define PLAYLISTFILE_H
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QString>
+#include <QStringDecoder>
+#include <QVector>
+
+struct TrackItem;
+
+// 歌单文件中的一条记录（路径已解析为绝对路径，不检查文件是否存在）
+struct PlaylistEntry {
+    QString path;
+    QString title;      // #EXTINF / TitleN 中的标题，可能为空
+    QString artist;
+    int durationMs = 0; // 未知时为 0
+};
+
+// 流式读取 M3U / M3U8 / PLS：按行读取、逐批返回，十万条的歌单也不需要一次读入内存。
+// 相对路径按歌单所在目录解析，只做字符串运算；网络地址会被跳过
+class PlaylistReader
+{
+public:
+    explicit PlaylistReader(const QString &filePath);
+
+    bool open();
+    // 追加最多 maxCount 条记录到 out，返回 false 表示已读完（或出错）
+    bool readBatch(int maxCount, QVector<PlaylistEntry> *out);
+    QString errorString() const { return m_file.errorString(); }
+
+    static bool isPlaylistFile(const QString &filePath);
+
+private:
+    QString decodeLine(const QByteArray &raw);
+    QString resolvePath(const QString &ref) const;
+    void readM3uLine(const QString &line, QVector<PlaylistEntry> *out);
+    void readPlsLine(const QString &line, QVector<PlaylistEntry> *out);
+    void flushPls(QVector<PlaylistEntry> *out);
+
+    QFile m_file;
+    QString m_baseDir;
+    bool m_pls = false;
+    bool m_utf8Only = false;     // .m3u8 固定为 UTF-8；.m3u / .pls 逐行回退到本地编码
+    bool m_firstLine = true;
+    QStringDecoder m_decoder;
+    PlaylistEntry m_pending;     // M3U：#EXTINF 之后等待路径行；PLS：当前编号的记录
+    bool m_hasPending = false;
+    int m_plsNumber = -1;
+};
+
+// 流式写出 M3U8 / PLS（按文件扩展名），经由 QSaveFile 逐条写入，写完一次性替换目标文件。
+// relative 为 true 时，位于歌单目录之下的曲目写成相对路径，便于与音乐文件一起拷贝
+class PlaylistWriter
+{
+public:
+    PlaylistWriter(const QString &filePath, bool relative);
+
+    bool open();
+    void write(const TrackItem &track);
+    void write(const PlaylistEntry &entry);
+    bool commit();
+    void cancel() { m_file.cancelWriting(); }
+    int count() const { return m_count; }
+    QString errorString() const { return m_file.errorString(); }
+
+private:
+    void writeEntry(const QString &path, const QString &title, const QString &artist, int durationMs);
+
+    QSaveFile m_file;
+    QDir m_baseDir;
+    bool m_relative = false;
+    bool m_pls = false;
+    int m_count = 0;
+    QByteArray m_buffer; // 复用的单条记录缓冲
+};
+
+#endif // PLAYLISTFILE_H
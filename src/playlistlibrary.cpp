@@ -0,0 +1,238 @@
+#include "playlistlibrary.h"
+#include "playlistfile.h"
+#include "trace.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QDebug>
+#include <memory>
+
+static const int LOAD_BATCH = 2000;   // 每批追加到模型的曲目数
+static const QString PLAYLIST_SUFFIX = QStringLiteral(".m3u8");
+
+// 曲库之外的文件只用歌单中的信息与文件名补全，不读取标签，也不检查文件是否存在
+static TrackItem trackFromEntry(const PlaylistEntry &entry)
+{
+    const QFileInfo fi(entry.path);
+    TrackItem track;
+    track.url = QUrl::fromLocalFile(entry.path);
+    track.name = fi.completeBaseName();
+    track.duration = entry.durationMs;
+    track.cover = "qrc:/assets/default_cover.svg";
+    if (!entry.title.isEmpty()) {
+        track.title = entry.title;
+        track.artist = entry.artist.isEmpty() ? "Unknown Artist" : entry.artist;
+    } else {
+        const QPair<QString, QString> parsed = PlaylistModel::parseFileName(fi.fileName());
+        track.title = parsed.first.isEmpty() ? track.name : parsed.first;
+        track.artist = parsed.second.isEmpty() ? "Unknown Artist" : parsed.second;
+    }
+    return track;
+}
+
+class PlaylistLibraryWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PlaylistLibraryWorker(PlaylistLibrary *owner) : m_owner(owner) {}
+
+    void load(quint64 generation, const QString &sourcePath, const QString &copyPath,
+              const LibrarySnapshotPtr &library);
+    void save(const QString &filePath, const TrackList &tracks, bool relative);
+
+private:
+    void finish(quint64 generation, bool ok, int count);
+
+    PlaylistLibrary *m_owner;
+};
+
+void PlaylistLibraryWorker::finish(quint64 generation, bool ok, int count)
+{
+    QMetaObject::invokeMethod(m_owner, [o = m_owner, generation, ok, count]() {
+        o->onLoadFinished(generation, ok, count);
+    }, Qt::QueuedConnection);
+}
+
+void PlaylistLibraryWorker::load(quint64 generation, const QString &sourcePath, const QString &copyPath,
+                                 const LibrarySnapshotPtr &library)
+{
+    TRACE_SCOPE("PlaylistLibraryWorker::load");
+    PlaylistReader reader(sourcePath);
+    if (!reader.open()) {
+        qWarning() << "PlaylistLibrary - 无法读取歌单:" << sourcePath << reader.errorString();
+        finish(generation, false, 0);
+        return;
+    }
+
+    std::unique_ptr<PlaylistWriter> copy;
+    if (!copyPath.isEmpty()) {
+        QDir().mkpath(PlaylistLibrary::storageDir());
+        copy = std::make_unique<PlaylistWriter>(copyPath, false);
+        if (!copy->open()) {
+            qWarning() << "PlaylistLibrary - 无法保存歌单:" << copyPath << copy->errorString();
+            copy.reset();
+        }
+    }
+
+    QVector<PlaylistEntry> entries;
+    entries.reserve(LOAD_BATCH);
+    int total = 0;
+    bool more = true;
+    while (more) {
+        if (m_owner->m_generation.load() != generation) {
+            if (copy) copy->cancel();
+            return;
+        }
+        entries.clear();
+        more = reader.readBatch(LOAD_BATCH, &entries);
+
+        QVector<TrackItem> batch;
+        batch.reserve(entries.size());
+        for (const PlaylistEntry &entry : entries) {
+            const int row = library ? library->indexOfPath(entry.path) : -1;
+            batch.append(row >= 0 ? library->tracks.at(row) : trackFromEntry(entry));
+            if (copy) copy->write(batch.constLast());
+        }
+        total += batch.size();
+        if (!batch.isEmpty()) {
+            QMetaObject::invokeMethod(m_owner, [o = m_owner, generation, batch]() {
+                o->onBatch(generation, batch);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    bool ok = true;
+    if (copy && !copy->commit()) {
+        qWarning() << "PlaylistLibrary - 保存歌单失败:" << copyPath << copy->errorString();
+        ok = false;
+    }
+    finish(generation, ok, total);
+}
+
+void PlaylistLibraryWorker::save(const QString &filePath, const TrackList &tracks, bool relative)
+{
+    TRACE_SCOPE("PlaylistLibraryWorker::save");
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    PlaylistWriter writer(filePath, relative);
+    bool ok = writer.open();
+    if (ok) {
+        for (const TrackItem &track : tracks) writer.write(track);
+        ok = writer.commit();
+    }
+    if (!ok) qWarning() << "PlaylistLibrary - 写出歌单失败:" << filePath << writer.errorString();
+    QMetaObject::invokeMethod(m_owner, [o = m_owner, filePath, ok]() { o->onSaved(filePath, ok); },
+                              Qt::QueuedConnection);
+}
+
+PlaylistLibrary::PlaylistLibrary(QObject *parent)
+    : QObject(parent)
+{
+    m_worker = new PlaylistLibraryWorker(this);
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread.setObjectName("PlaylistLibrary");
+    m_thread.start(QThread::LowPriority);
+    refreshNames();
+}
+
+PlaylistLibrary::~PlaylistLibrary()
+{
+    ++m_generation;
+    m_thread.quit();
+    m_thread.wait();
+}
+
+QString PlaylistLibrary::storageDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/playlists";
+}
+
+QString PlaylistLibrary::filePath(const QString &name) const
+{
+    static const QRegularExpression INVALID_RE(QStringLiteral("[\\\\/:*?\"<>|]"));
+    QString fileName = name.trimmed();
+    fileName.replace(INVALID_RE, "_");
+    return storageDir() + "/" + fileName + PLAYLIST_SUFFIX;
+}
+
+QString PlaylistLibrary::uniqueName(const QString &base) const
+{
+    const QString name = QFileInfo(filePath(base)).completeBaseName();
+    if (!contains(name)) return name;
+    for (int n = 2;; ++n) {
+        const QString candidate = QString("%1 (%2)").arg(name).arg(n);
+        if (!contains(candidate)) return candidate;
+    }
+}
+
+void PlaylistLibrary::refreshNames()
+{
+    QStringList names;
+    const QFileInfoList files = QDir(storageDir()).entryInfoList({ "*" + PLAYLIST_SUFFIX }, QDir::Files, QDir::Name);
+    for (const QFileInfo &fi : files) names.append(fi.completeBaseName());
+    if (names == m_names) return;
+    m_names = names;
+    emit namesChanged();
+}
+
+void PlaylistLibrary::load(const QString &sourcePath, const QString &copyToName)
+{
+    const quint64 generation = ++m_generation;
+    const QString copyPath = copyToName.isEmpty() ? QString() : filePath(copyToName);
+    const LibrarySnapshotPtr library = m_library;
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, generation, sourcePath, copyPath, library]() {
+        w->load(generation, sourcePath, copyPath, library);
+    }, Qt::QueuedConnection);
+    if (!m_loading) {
+        m_loading = true;
+        emit loadingChanged();
+    }
+}
+
+void PlaylistLibrary::cancelLoad()
+{
+    ++m_generation;
+    if (m_loading) {
+        m_loading = false;
+        emit loadingChanged();
+    }
+}
+
+void PlaylistLibrary::save(const QString &filePath, const TrackList &tracks, bool relative)
+{
+    QMetaObject::invokeMethod(m_worker, [w = m_worker, filePath, tracks, relative]() {
+        w->save(filePath, tracks, relative);
+    }, Qt::QueuedConnection);
+}
+
+bool PlaylistLibrary::remove(const QString &name)
+{
+    if (!contains(name) || !QFile::remove(filePath(name))) return false;
+    refreshNames();
+    return true;
+}
+
+void PlaylistLibrary::onBatch(quint64 generation, const QVector<TrackItem> &tracks)
+{
+    if (generation != m_generation.load()) return;
+    emit tracksLoaded(tracks);
+}
+
+void PlaylistLibrary::onLoadFinished(quint64 generation, bool ok, int count)
+{
+    if (generation != m_generation.load()) return;
+    m_loading = false;
+    emit loadingChanged();
+    refreshNames();
+    emit loadFinished(ok, count);
+}
+
+void PlaylistLibrary::onSaved(const QString &filePath, bool ok)
+{
+    refreshNames();
+    emit saved(filePath, ok);
+}
+
+#include "playlistlibrary.moc"
@@ -0,0 +1,63 @@
+#ifndef PLAYLISTLIBRARY_H
+#define PLAYLISTLIBRARY_H
+
+#include <QObject>
+#include <QThread>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "playlistmodel.h"
+
+class PlaylistLibraryWorker;
+
+// 命名歌单：以 M3U8 保存在 AppLocalDataLocation/playlists/ 下。读取与写出都在后台线程流式进行；
+// 读到的路径按曲库索引取元数据（不访问磁盘），每 LOAD_BATCH 条交回 GUI 线程追加到模型
+class PlaylistLibrary : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PlaylistLibrary(QObject *parent = nullptr);
+    ~PlaylistLibrary() override;
+
+    QStringList names() const { return m_names; }
+    bool contains(const QString &name) const { return m_names.contains(name); }
+    QString filePath(const QString &name) const;
+    QString uniqueName(const QString &base) const;
+    bool isLoading() const { return m_loading; }
+
+    // 曲库快照：歌单中的路径在曲库中找到时直接沿用扫描得到的元数据（工作线程直接读取快照，不复制）
+    void setLibrary(const LibrarySnapshotPtr &library) { m_library = library; }
+
+    // 读取歌单文件；copyToName 非空时同时另存为该名称的歌单（导入）。新的请求会取消未完成的读取
+    void load(const QString &sourcePath, const QString &copyToName = QString());
+    void cancelLoad();
+    // 写出曲目列表（tracks 不可变，不复制）
+    void save(const QString &filePath, const TrackList &tracks, bool relative);
+    bool remove(const QString &name);
+
+    static QString storageDir();
+
+signals:
+    void tracksLoaded(const QVector<TrackItem> &tracks);
+    void loadFinished(bool ok, int count);
+    void saved(const QString &filePath, bool ok);
+    void namesChanged();
+    void loadingChanged();
+
+private:
+    friend class PlaylistLibraryWorker;
+
+    void refreshNames();
+    void onBatch(quint64 generation, const QVector<TrackItem> &tracks);
+    void onLoadFinished(quint64 generation, bool ok, int count);
+    void onSaved(const QString &filePath, bool ok);
+
+    QThread m_thread;
+    PlaylistLibraryWorker *m_worker = nullptr;
+    LibrarySnapshotPtr m_library;
+    QStringList m_names;
+    std::atomic<quint64> m_generation { 0 };   // 取消读取：工作线程每批检查一次
+    bool m_loading = false;
+};
+
+#endif // PLAYLISTLIBRARY_H
@@ -1,21 +1,10 @@
 #include "playlistmodel.h"
-#include <QDir>
 #include <QFileInfo>
-#include <QRegularExpression>
-#include <QDebug>
-#include <QMediaPlayer>
-#include <QAudioOutput>
-#include <QEventLoop>
-#include <QTimer>
-#include <QMediaMetaData>
-#include <QImage>
-#include <QDateTime>
-
-static const QStringList AUDIO_EXTS = { ".mp3", ".m4a", ".wav", ".flac", ".ogg" };
 
 PlaylistModel::PlaylistModel(QObject *parent)
     : QAbstractListModel(parent)
-{}
+{
+}
 
 int PlaylistModel::rowCount(const QModelIndex &parent) const
 {
@@ -29,7 +18,7 @@ QVariant PlaylistModel::data(const QModelIndex &index, int role) const
     int row = index.row();
     if (row < 0 || row >= m_items.size()) return {};
 
-    const TrackItem &it = m_items[row];
+    const TrackItem &it = m_items.at(row);
     switch (role) {
     case IndexRole: return row;
     case NameRole: return it.name;
@@ -61,12 +50,10 @@ QHash<int, QByteArray> PlaylistModel::roleNames() const
 
 void PlaylistModel::clear()
 {
-    beginResetModel();
-    m_items.clear();
-    endResetModel();
+    setTracks(TrackList());
 }
 
-QPair<QString, QString> PlaylistModel::parseFileName(const QString &fileName) const
+QPair<QString, QString> PlaylistModel::parseFileName(const QString &fileName)
 {
     // Try "01 - Title - Artist", "Title - Artist", else filename -> title
     QString base = QFileInfo(fileName).completeBaseName();
@@ -80,187 +67,70 @@ QPair<QString, QString> PlaylistModel::parseFileName(const QString &fileName) co
     }
 }
 
-void PlaylistModel::addFile(const QString &filePath)
+void PlaylistModel::setTracks(const QVector<TrackItem> &tracks)
 {
-    QFileInfo fi(filePath);
-    QString ext = fi.suffix().toLower();
-    if (!AUDIO_EXTS.contains("." + ext)) return;
-
-    TrackItem it;
-    it.url = QUrl::fromLocalFile(fi.absoluteFilePath());
-    it.duration = 0;
-    it.cover = "qrc:/assets/default_cover.svg";
-
-    // 使用文件名作为后备
-    QString baseName = fi.completeBaseName();
-    it.name = baseName;
-    
-    // 初始化为文件名解析结果
-    QPair<QString, QString> parsed = parseFileName(fi.fileName());
-    it.title = parsed.first.isEmpty() ? baseName : parsed.first;
-    it.artist = parsed.second.isEmpty() ? "Unknown Artist" : parsed.second;
-    
-    // 防止title和artist相同
-    if (it.artist == it.title) {
-        it.artist = "Unknown Artist";
-    }
-    
-    // 尝试从元数据提取信息
-    bool metadataLoaded = false;
-    
-    // 创建临时播放器来提取元数据
-    QMediaPlayer tempPlayer;
-    QAudioOutput tempAudioOutput;
-    tempPlayer.setAudioOutput(&tempAudioOutput);
-    
-    // 同步等待元数据（使用事件循环）
-    QEventLoop loop;
-    QTimer timer;
-    timer.setSingleShot(true);
-    timer.setInterval(5000); // 增加超时时间到5秒
-    
-    QObject::connect(&tempPlayer, &QMediaPlayer::mediaStatusChanged, [&](QMediaPlayer::MediaStatus status) {
-        if (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::BufferedMedia) {
-            metadataLoaded = true;
-            
-            // 提取元数据
-            auto metaData = tempPlayer.metaData();
-            
-            // 提取标题
-            if (metaData.value(QMediaMetaData::Title).isValid()) {
-                QString extractedTitle = metaData.value(QMediaMetaData::Title).toString();
-                if (!extractedTitle.isEmpty()) {
-                    it.title = extractedTitle;
-                }
-            }
-            
-            // 提取艺术家
-            QString extractedArtist;
-            if (metaData.value(QMediaMetaData::Author).isValid()) {
-                extractedArtist = metaData.value(QMediaMetaData::Author).toString();
-            } else if (metaData.value(QMediaMetaData::AlbumArtist).isValid()) {
-                extractedArtist = metaData.value(QMediaMetaData::AlbumArtist).toString();
-            } else if (metaData.value(QMediaMetaData::ContributingArtist).isValid()) {
-                extractedArtist = metaData.value(QMediaMetaData::ContributingArtist).toString();
-            }
-            
-            if (!extractedArtist.isEmpty()) {
-                it.artist = extractedArtist;
-            }
-            
-            // 提取唱片集
-            if (metaData.value(QMediaMetaData::AlbumTitle).isValid()) {
-                it.album = metaData.value(QMediaMetaData::AlbumTitle).toString();
-            }
-            
-            // 提取时长
-            if (metaData.value(QMediaMetaData::Duration).isValid()) {
-                it.duration = metaData.value(QMediaMetaData::Duration).toInt();
-            }
-            
-            // 提取歌词 - 尝试多种可能的键名
-            QString lyricsText;
-            
-            // 尝试遍历所有元数据查找歌词相关内容
-            auto keys = metaData.keys();
-            for (auto metaKey : keys) {
-                QVariant value = metaData.value(metaKey);
-                if (value.isValid() && value.canConvert<QString>()) {
-                    QString valueStr = value.toString();
-                    // 检查是否包含歌词内容（通常歌词文本较长且包含换行符）
-                    if (valueStr.length() > 50 && 
-                        (valueStr.contains('\n') || valueStr.contains('\r') || 
-                         valueStr.contains("lyric", Qt::CaseInsensitive) ||
-                         valueStr.contains("text", Qt::CaseInsensitive))) {
-                        lyricsText = valueStr;
-                        break;
-                    }
-                }
-            }
-            
-            if (!lyricsText.isEmpty()) {
-                it.lyrics = lyricsText;
-            }
-            
-            // 提取封面 - 尝试多种可能的键名
-            QImage coverImage;
-            
-            // 尝试 CoverArtImage
-            if (metaData.value(QMediaMetaData::CoverArtImage).isValid()) {
-                QVariant coverVariant = metaData.value(QMediaMetaData::CoverArtImage);
-                coverImage = coverVariant.value<QImage>();
-            }
-            // 尝试 ThumbnailImage
-            else if (metaData.value(QMediaMetaData::ThumbnailImage).isValid()) {
-                QVariant coverVariant = metaData.value(QMediaMetaData::ThumbnailImage);
-                coverImage = coverVariant.value<QImage>();
-            }
-            
-            if (!coverImage.isNull()) {
-                // 保存封面到临时文件
-                QString tempPath = QDir::tempPath() + "/music_cover_" + QString::number(QDateTime::currentMSecsSinceEpoch()) + ".jpg";
-                if (coverImage.save(tempPath, "JPG", 90)) {
-                    it.cover = "file:///" + tempPath;
-                    qDebug() << "PlaylistModel::addFile - 封面已保存到:" << it.cover;
-                } else {
-                    qDebug() << "PlaylistModel::addFile - 封面保存失败";
-                }
-            } else {
-                qDebug() << "PlaylistModel::addFile - 未找到封面图片，使用默认封面:" << it.cover;
-            }
-            
-            // 最终检查：防止title和artist相同
-            if (it.artist == it.title) {
-                it.artist = "Unknown Artist";
-            }
-            
-            loop.quit();
-        } else if (status == QMediaPlayer::InvalidMedia) {
-            loop.quit();
-        }
-    });
-    
-    QObject::connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
-    
-    timer.start();
-    tempPlayer.setSource(it.url);
-    
-    // 不调用play()，只设置源就足够触发元数据加载
-    loop.exec();
-    
-    if (!metadataLoaded) {
-        // 静默处理超时情况
-    }
-
-    beginInsertRows({}, m_items.size(), m_items.size());
-    m_items.append(it);
-    endInsertRows();
+    setTracks(TrackList(tracks));
 }
 
-void PlaylistModel::loadFolder(const QString &folderPath)
+void PlaylistModel::setTracks(const TrackList &tracks, quint64 libraryGeneration)
 {
-    QDir dir(folderPath);
-    if (!dir.exists()) return;
-
     beginResetModel();
-    m_items.clear();
+    m_items = tracks;
+    m_libraryGeneration = libraryGeneration;
+    m_pathIndexDirty = true;
+    endResetModel();
+}
 
-    QFileInfoList entries = QDir(folderPath).entryInfoList(QDir::Files | QDir::NoDotAndDotDot, QDir::Name);
-    for (const QFileInfo &fi : entries) {
-        addFile(fi.absoluteFilePath());
+void PlaylistModel::applyChanges(const TrackList &tracks, const LibraryChangeSet &changes)
+{
+    if (changes.reset || changes.fromGeneration != m_libraryGeneration) {
+        setTracks(tracks, changes.toGeneration);
+        return;
     }
 
-    // Also walk subfolders if desired: (commented out)
-    // QDirIterator it(folderPath, QDirIterator::Subdirectories);
+    // 每一步之后 m_items 都是与已发出的通知一致的中间状态（与上一步共享未受影响的块，每步只复制两个边界块）
+    for (const LibraryChangeSet::Range &range : changes.removed) {
+        beginRemoveRows({}, range.first, range.first + range.count - 1);
+        m_items = m_items.spliced(range.first, range.count, tracks, 0, 0);
+        m_pathIndexDirty = true;
+        endRemoveRows();
+    }
+    for (const LibraryChangeSet::Range &range : changes.inserted) {
+        beginInsertRows({}, range.first, range.first + range.count - 1);
+        m_items = m_items.spliced(range.first, 0, tracks, range.first, range.count);
+        m_pathIndexDirty = true;
+        endInsertRows();
+    }
+    // 最后换成新快照本身，不再保留拼接出的副本
+    m_items = tracks;
+    m_libraryGeneration = changes.toGeneration;
+    m_pathIndexDirty = true;
+    for (int row : changes.changed) {
+        emit dataChanged(index(row), index(row));
+    }
+}
 
-    endResetModel();
+void PlaylistModel::appendTracks(const QVector<TrackItem> &tracks)
+{
+    if (tracks.isEmpty()) return;
+    const int first = m_items.size();
+    beginInsertRows({}, first, first + tracks.size() - 1);
+    m_items = m_items.appended(tracks);
+    m_libraryGeneration = 0;
+    if (!m_pathIndexDirty) {
+        for (int i = first; i < m_items.size(); ++i) {
+            const QString path = m_items[i].url.toLocalFile();
+            if (!m_pathIndex.contains(path)) m_pathIndex.insert(path, i);
+        }
+    }
+    endInsertRows();
 }
 
 QVariantMap PlaylistModel::get(int idx) const
 {
     QVariantMap map;
     if (idx < 0 || idx >= m_items.size()) return map;
-    const TrackItem &t = m_items[idx];
+    const TrackItem &t = m_items.at(idx);
     map["name"] = t.name;
     map["title"] = t.title;
     map["artist"] = t.artist;
@@ -270,4 +140,16 @@ QVariantMap PlaylistModel::get(int idx) const
     map["duration"] = t.duration;
     map["cover"] = t.cover;
     return map;
-}
\ No newline at end of file
+}
+
+int PlaylistModel::indexOfPath(const QString &filePath) const
+{
+    // 大歌单下逐项比较太慢：整表替换后第一次查询时建立路径索引，追加时增量维护
+    if (m_pathIndexDirty) {
+        m_pathIndex.clear();
+        m_pathIndex.reserve(m_items.size());
+        for (int i = m_items.size() - 1; i >= 0; --i) m_pathIndex.insert(m_items[i].url.toLocalFile(), i);
+        m_pathIndexDirty = false;
+    }
+    return m_pathIndex.value(filePath, -1);
+}
@@ -3,18 +3,7 @@
 
 #include <QAbstractListModel>
 #include <QVector>
-#include <QUrl>
-
-struct TrackItem {
-    QString name;    // 文件名（作为后备显示）
-    QString title;   // 从元数据提取的标题
-    QString artist;  // 从元数据提取的艺术家
-    QString album;   // 从元数据提取的唱片集
-    QString lyrics;  // 从元数据提取的歌词
-    QUrl url;
-    int duration; // ms
-    QString cover; // qrc or file path
-};
+#include "librarysnapshot.h"
 
 class PlaylistModel : public QAbstractListModel
 {
@@ -40,14 +29,30 @@ public:
     QHash<int, QByteArray> roleNames() const override;
 
     Q_INVOKABLE void clear();
-    Q_INVOKABLE void loadFolder(const QString &folderPath);
     Q_INVOKABLE QVariantMap get(int idx) const;
 
+    int indexOfPath(const QString &filePath) const;
+    // 整表替换；libraryGeneration 非 0 表示内容就是该版本的曲库快照，之后可按变化区间增量更新
+    void setTracks(const QVector<TrackItem> &tracks);
+    void setTracks(const TrackList &tracks, quint64 libraryGeneration = 0);
+    // 曲库快照的变化：按区间发出删除、插入与数据变化通知，列表的滚动位置与选中项保持不变
+    void applyChanges(const TrackList &tracks, const LibraryChangeSet &changes);
+    // 歌单分批加载：每批只发出一次插入通知
+    void appendTracks(const QVector<TrackItem> &tracks);
+    const TrackList &tracks() const { return m_items; }
+    quint64 libraryGeneration() const { return m_libraryGeneration; }
+
+    // 按“标题 - 艺术家”等格式解析文件名（导入的歌单缺少标签时也用它补全）
+    static QPair<QString, QString> parseFileName(const QString &fileName);
+
 private:
-    QVector<TrackItem> m_items;
+    friend class BackendBenchmark;  // bench/backend_benchmark.cpp
 
-    void addFile(const QString &filePath);
-    QPair<QString, QString> parseFileName(const QString &fileName) const;
+    // 不可变列表：替换时只交换块指针，与曲库快照共享同一份数据
+    TrackList m_items;
+    quint64 m_libraryGeneration = 0;
+    mutable QHash<QString, int> m_pathIndex;   // 路径 → 第一次出现的行，按需重建
+    mutable bool m_pathIndexDirty = true;
 };
 
 #endif // PLAYLISTMODEL_H
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "playqueue.h"
+#include <QDataStream>
+#include <QIODevice>
+#include <algorithm>
+#include <utility>
+
+static const quint32 PLAY_QUEUE_VERSION = 1;
+
+PlayQueue::PlayQueue()
+    : m_random(QRandomGenerator::global()->generate())
+{
+}
+
+void PlayQueue::setMode(Mode mode)
+{
+    if (m_mode == mode) return;
+    m_mode = mode;
+    // 切换到随机时重新开始一轮
+    if (mode == Shuffle) newShuffleCycle();
+}
+
+void PlayQueue::setTrackCount(int count)
+{
+    if (count < m_count) {
+        reset(count);
+        return;
+    }
+    // 新增的位置 [m_count, count) 未被交换过，默认值即为新曲目本身，自动进入本轮随机
+    m_count = count;
+}
+
+void PlayQueue::reset(int count)
+{
+    m_count = qMax(0, count);
+    m_upNext.clear();
+    m_history.clear();
+    m_historyStart = 0;
+    m_historySize = 0;
+    m_historyPos = -1;
+    newShuffleCycle();
+}
+
+void PlayQueue::remap(const std::function<int(int)> &newIndex, int count)
+{
+    m_count = qMax(0, count);
+    std::deque<int> upNext;
+    for (int index : m_upNext) {
+        const int mapped = newIndex(index);
+        if (mapped >= 0 && mapped < m_count) upNext.push_back(mapped);
+    }
+    m_upNext.swap(upNext);
+
+    QVector<int> history;
+    int position = -1;
+    for (int p = 0; p < m_historySize; ++p) {
+        const int mapped = newIndex(historyAt(p));
+        if (mapped >= 0 && mapped < m_count && (history.isEmpty() || history.constLast() != mapped)) {
+            history.append(mapped);
+        }
+        if (p <= m_historyPos) position = history.size() - 1;
+    }
+    m_historyStart = 0;
+    m_historySize = history.size();
+    m_historyPos = position;
+    if (!history.isEmpty()) {
+        m_history.resize(HISTORY_CAPACITY);
+        std::copy(history.begin(), history.end(), m_history.begin());
+    }
+
+    // 随机置换以位置为键，行号变化后无法逐项换算
+    newShuffleCycle();
+}
+
+int PlayQueue::historyAt(int position) const
+{
+    return m_history[(m_historyStart + position) % HISTORY_CAPACITY];
+}
+
+void PlayQueue::pushHistory(int index)
+{
+    if (index < 0) return;
+    if (m_historyPos >= 0 && historyAt(m_historyPos) == index) return;
+    if (m_history.isEmpty()) m_history.resize(HISTORY_CAPACITY);
+
+    // 从历史中间重新选择：丢弃“前进”部分
+    m_historySize = m_historyPos + 1;
+    if (m_historySize == HISTORY_CAPACITY) {
+        m_historyStart = (m_historyStart + 1) % HISTORY_CAPACITY;
+        --m_historySize;
+    }
+    m_history[(m_historyStart + m_historySize) % HISTORY_CAPACITY] = index;
+    ++m_historySize;
+    m_historyPos = m_historySize - 1;
+}
+
+void PlayQueue::jumpTo(int index)
+{
+    if (index < 0 || index >= m_count) return;
+    pushHistory(index);
+}
+
+void PlayQueue::newShuffleCycle() const
+{
+    m_swaps.clear();
+    m_shuffleCursor = 0;
+    m_cursorDrawn = false;
+}
+
+int PlayQueue::shuffleValueAt(int position) const
+{
+    return m_swaps.value(position, position);
+}
+
+int PlayQueue::shufflePeek(int current) const
+{
+    for (;;) {
+        if (m_shuffleCursor >= m_count) newShuffleCycle();
+        if (!m_cursorDrawn) {
+            // Fisher–Yates 的一步：从尚未播放的位置中随机取一个换到游标处
+            const int pick = m_shuffleCursor + int(m_random.bounded(quint32(m_count - m_shuffleCursor)));
+            const int a = shuffleValueAt(m_shuffleCursor);
+            const int b = shuffleValueAt(pick);
+            m_swaps.insert(m_shuffleCursor, b);
+            if (pick != m_shuffleCursor) m_swaps.insert(pick, a);
+            m_cursorDrawn = true;
+        }
+        const int value = shuffleValueAt(m_shuffleCursor);
+        // 正在播放的曲目（刚开始新一轮或之前被手动选中）不立即重复
+        if (value == current && m_count > 1) {
+            shuffleConsume();
+            continue;
+        }
+        return value;
+    }
+}
+
+void PlayQueue::shuffleConsume() const
+{
+    // 游标之前的位置不会再被访问，不必保留
+    m_swaps.remove(m_shuffleCursor);
+    ++m_shuffleCursor;
+    m_cursorDrawn = false;
+}
+
+int PlayQueue::peekNext(int current) const
+{
+    if (m_count <= 0) return -1;
+    if (m_historyPos + 1 < m_historySize) return historyAt(m_historyPos + 1);
+    if (!m_upNext.empty()) return m_upNext.front();
+
+    switch (m_mode) {
+    case RepeatOne:
+        return current >= 0 && current < m_count ? current : 0;
+    case Shuffle:
+        return shufflePeek(current);
+    case Sequential:
+        break;
+    }
+    return current >= 0 ? (current + 1) % m_count : 0;
+}
+
+int PlayQueue::advance(int current)
+{
+    const int next = peekNext(current);
+    if (next < 0) return -1;
+
+    if (m_historyPos + 1 < m_historySize) {
+        ++m_historyPos;
+        return next;
+    }
+    if (!m_upNext.empty()) {
+        m_upNext.pop_front();
+    } else if (m_mode == Shuffle) {
+        shuffleConsume();
+    }
+    pushHistory(next);
+    return next;
+}
+
+int PlayQueue::retreat(int current)
+{
+    if (m_count <= 0) return -1;
+    if (m_historyPos > 0) {
+        --m_historyPos;
+        return historyAt(m_historyPos);
+    }
+    return current > 0 ? current - 1 : m_count - 1;
+}
+
+void PlayQueue::playNext(int index)
+{
+    if (index >= 0 && index < m_count) m_upNext.push_front(index);
+}
+
+void PlayQueue::enqueue(int index)
+{
+    if (index >= 0 && index < m_count) m_upNext.push_back(index);
+}
+
+void PlayQueue::removeUpNext(int position)
+{
+    if (position >= 0 && position < int(m_upNext.size())) m_upNext.erase(m_upNext.begin() + position);
+}
+
+QByteArray PlayQueue::saveState() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << PLAY_QUEUE_VERSION << qint32(m_mode) << qint32(m_count)
+        << qint32(m_shuffleCursor) << m_cursorDrawn << qint32(m_swaps.size());
+    for (auto it = m_swaps.constBegin(); it != m_swaps.constEnd(); ++it) {
+        out << qint32(it.key()) << qint32(it.value());
+    }
+    out << qint32(m_upNext.size());
+    for (int index : m_upNext) out << qint32(index);
+    out << qint32(m_historySize) << qint32(m_historyPos);
+    for (int i = 0; i < m_historySize; ++i) out << qint32(historyAt(i));
+    return data;
+}
+
+bool PlayQueue::restoreState(const QByteArray &state)
+{
+    if (state.isEmpty()) return false;
+    QDataStream in(state);
+    in.setVersion(QDataStream::Qt_6_2);
+
+    quint32 version = 0;
+    qint32 mode = 0, count = 0, cursor = 0, swapCount = 0;
+    bool drawn = false;
+    in >> version >> mode >> count >> cursor >> drawn >> swapCount;
+    if (version != PLAY_QUEUE_VERSION || count != m_count || cursor < 0 || cursor > count) return false;
+
+    auto valid = [count](qint32 index) { return index >= 0 && index < count; };
+    QHash<int, int> swaps;
+    for (qint32 i = 0; i < swapCount && in.status() == QDataStream::Ok; ++i) {
+        qint32 position = 0, value = 0;
+        in >> position >> value;
+        if (!valid(position) || !valid(value)) return false;
+        swaps.insert(position, value);
+    }
+
+    qint32 upNextCount = 0;
+    in >> upNextCount;
+    std::deque<int> upNext;
+    for (qint32 i = 0; i < upNextCount && in.status() == QDataStream::Ok; ++i) {
+        qint32 index = 0;
+        in >> index;
+        if (!valid(index)) return false;
+        upNext.push_back(index);
+    }
+
+    qint32 historySize = 0, historyPos = -1;
+    in >> historySize >> historyPos;
+    if (historySize < 0 || historySize > HISTORY_CAPACITY || historyPos >= historySize) return false;
+    QVector<int> history(HISTORY_CAPACITY);
+    for (qint32 i = 0; i < historySize && in.status() == QDataStream::Ok; ++i) {
+        qint32 index = 0;
+        in >> index;
+        if (!valid(index)) return false;
+        history[i] = index;
+    }
+    if (in.status() != QDataStream::Ok) return false;
+
+    m_mode = Mode(qBound(0, int(mode), int(Shuffle)));
+    m_swaps = std::move(swaps);
+    m_shuffleCursor = cursor;
+    m_cursorDrawn = drawn;
+    m_upNext = std::move(upNext);
+    m_history = std::move(history);
+    m_historyStart = 0;
+    m_historySize = historySize;
+    m_historyPos = historySize > 0 ? qMax(0, int(historyPos)) : -1;
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef PLAYQUEUE_H
+#define PLAYQUEUE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QVector>
+#include <deque>
+#include <functional>
+
+// 播放队列：与 PlaylistModel 的排列顺序分开，决定“下一首 / 上一首”。
+// - 随机播放使用按需展开的 Fisher–Yates 置换：只记录被交换过的位置，每一步 O(1)，
+//   一轮内不重复，内存与已播放的曲目数成正比而不是与曲库大小成正比
+// - 历史记录是定长环形缓冲区：上一首回到真正播放过的上一首，之后的下一首沿历史前进
+// - 用户插入的“下一首播放”/“加入队列”优先于播放模式
+// - saveState()/restoreState() 为紧凑的二进制形式，保存在会话快照中
+class PlayQueue
+{
+public:
+    enum Mode {
+        Sequential,   // 列表循环
+        RepeatOne,    // 单曲循环
+        Shuffle       // 随机
+    };
+
+    static const int HISTORY_CAPACITY = 1000;
+
+    PlayQueue();
+
+    Mode mode() const { return m_mode; }
+    void setMode(Mode mode);
+
+    int trackCount() const { return m_count; }
+    // 歌单追加曲目：保留当前的随机顺序与历史（新曲目参与本轮随机）
+    void setTrackCount(int count);
+    // 歌单重建：索引失效，清空历史、待播与随机进度
+    void reset(int count);
+    // 歌单增量更新：历史与待播按 newIndex 换算成新行号（返回 -1 的曲目已移除，直接去掉），随机进度重新开始
+    void remap(const std::function<int(int)> &newIndex, int count);
+
+    // 用户直接选择播放某首：记入历史
+    void jumpTo(int index);
+    // 下一首：沿历史前进 > 待播队列 > 播放模式。peekNext 返回 advance 将要返回的曲目
+    int peekNext(int current) const;
+    int advance(int current);
+    // 上一首：沿历史后退；没有更早的历史时按列表顺序
+    int retreat(int current);
+
+    // “下一首播放”插到待播队列最前，“加入队列”排在最后
+    void playNext(int index);
+    void enqueue(int index);
+    void removeUpNext(int position);
+    QVector<int> upNext() const { return QVector<int>(m_upNext.begin(), m_upNext.end()); }
+
+    int historySize() const { return m_historySize; }
+
+    QByteArray saveState() const;
+    // 曲目数与当前歌单不一致时返回 false 并保持原状态
+    bool restoreState(const QByteArray &state);
+
+private:
+    int historyAt(int position) const;
+    void pushHistory(int index);
+    void newShuffleCycle() const;
+    int shuffleValueAt(int position) const;
+    int shufflePeek(int current) const;
+    void shuffleConsume() const;
+
+    Mode m_mode = Sequential;
+    int m_count = 0;
+
+    // 随机置换：位置 p 上的曲目为 m_swaps.value(p, p)，[0, m_shuffleCursor) 已播放。
+    // peekNext 需要确定下一首，所以展开过程放在 const 函数中（mutable）
+    mutable QHash<int, int> m_swaps;
+    mutable int m_shuffleCursor = 0;
+    mutable bool m_cursorDrawn = false;   // 游标位置已完成本步交换
+    mutable QRandomGenerator m_random;
+
+    std::deque<int> m_upNext;
+
+    // 历史环：从 m_historyStart 起的 m_historySize 项，m_historyPos 为当前曲目
+    QVector<int> m_history;
+    int m_historyStart = 0;
+    int m_historySize = 0;
+    int m_historyPos = -1;
+};
+
+#endif // PLAYQUEUE_H
@@ -0,0 +1,97 @@
+#include "probefailurecache.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+static const quint32 PROBE_CACHE_MAGIC = 0x50524246; // "PRBF"
+static const quint32 PROBE_CACHE_VERSION = 1;
+
+bool ProbeFailureCache::contains(const QString &path, qint64 size, qint64 mtime) const
+{
+    auto it = m_entries.constFind(path);
+    return it != m_entries.constEnd() && it->size == size && it->mtime == mtime;
+}
+
+void ProbeFailureCache::record(const QString &path, qint64 size, qint64 mtime, int status)
+{
+    Entry &entry = m_entries[path];
+    if (entry.size == size && entry.mtime == mtime && entry.status == status) return;
+    entry = { size, mtime, qint32(status) };
+    m_dirty = true;
+}
+
+void ProbeFailureCache::remove(const QString &path)
+{
+    if (m_entries.remove(path)) m_dirty = true;
+}
+
+void ProbeFailureCache::retain(const QSet<QString> &keep)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (keep.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        }
+    }
+}
+
+QString ProbeFailureCache::defaultCachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/library/probe-failures.idx";
+}
+
+bool ProbeFailureCache::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_2);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != PROBE_CACHE_MAGIC || version != PROBE_CACHE_VERSION) {
+        qWarning() << "ProbeFailureCache - 缓存格式不匹配，忽略:" << filePath;
+        return false;
+    }
+
+    QHash<QString, Entry> entries;
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Entry entry;
+        in >> path >> entry.size >> entry.mtime >> entry.status;
+        entries.insert(path, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "ProbeFailureCache - 缓存已损坏，忽略:" << filePath;
+        return false;
+    }
+    m_entries = entries;
+    m_dirty = false;
+    return true;
+}
+
+bool ProbeFailureCache::save(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << PROBE_CACHE_MAGIC << PROBE_CACHE_VERSION << qint32(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        out << it.key() << it->size << it->mtime << it->status;
+    }
+
+    if (!file.commit()) return false;
+    m_dirty = false;
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef PROBEFAILURECACHE_H
+#define PROBEFAILURECACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+
+// 元数据读取失败的记录（无法识别、超时、辅助进程崩溃）：以“路径 + 大小 + 修改时间”为键，
+// 文件未变化时扫描直接跳过读取，歌曲信息取自文件名；文件被修改或替换后重新读取。
+// 与歌词索引一起保存在库缓存目录
+class ProbeFailureCache
+{
+public:
+    bool contains(const QString &path, qint64 size, qint64 mtime) const;
+    void record(const QString &path, qint64 size, qint64 mtime, int status);
+    void remove(const QString &path);
+    // 移除不在 keep 集合中的记录（重新扫描文件夹后清理）
+    void retain(const QSet<QString> &keep);
+
+    int count() const { return m_entries.size(); }
+
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+    bool isDirty() const { return m_dirty; }
+
+    static QString defaultCachePath();
+
+private:
+    struct Entry {
+        qint64 size = 0;
+        qint64 mtime = 0;
+        qint32 status = 0;   // ProbeResult::Status，仅用于诊断
+    };
+
+    QHash<QString, Entry> m_entries;
+    mutable bool m_dirty = false;
+};
+
+#endif // PROBEFAILURECACHE_H
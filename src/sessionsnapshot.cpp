@@ -0,0 +1,80 @@
+#include "sessionsnapshot.h"
+#include "trace.h"
+#include <QByteArray>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+static const quint32 SESSION_MAGIC = 0x4D505353; // "MPSS"
+static const quint32 SESSION_VERSION = 2;   // 2：增加播放队列状态
+
+QString SessionSnapshot::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/session.snapshot";
+}
+
+bool SessionSnapshot::load(const QString &filePath)
+{
+    TRACE_SCOPE("SessionSnapshot::load");
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly) || file.size() <= 0) return false;
+
+    // 映射文件后直接在内存上反序列化，避免启动时的额外读拷贝
+    uchar *mapped = file.map(0, file.size());
+    QByteArray data;
+    if (mapped) data = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), qsizetype(file.size()));
+    else data = file.readAll();
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_2);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != SESSION_MAGIC || version < 1 || version > SESSION_VERSION) {
+        qWarning() << "SessionSnapshot::load - 快照格式不匹配，忽略:" << filePath;
+        return false;
+    }
+
+    qint32 trackCount = 0;
+    in >> musicFolder >> index >> positionMs >> trackCount;
+    tracks.clear();
+    tracks.reserve(qMax(0, trackCount));
+    for (qint32 i = 0; i < trackCount && in.status() == QDataStream::Ok; ++i) {
+        TrackItem t;
+        qint32 duration = 0;
+        in >> t.name >> t.title >> t.artist >> t.album >> t.lyrics >> t.url >> duration >> t.cover;
+        t.duration = duration;
+        tracks.append(t);
+    }
+    queue.clear();
+    if (version >= 2) in >> queue;
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "SessionSnapshot::load - 快照已损坏，忽略:" << filePath;
+        tracks.clear();
+        index = -1;
+        return false;
+    }
+    return true;
+}
+
+bool SessionSnapshot::save(const QString &filePath) const
+{
+    TRACE_SCOPE("SessionSnapshot::save");
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << SESSION_MAGIC << SESSION_VERSION;
+    out << musicFolder << qint32(index) << positionMs << qint32(tracks.size());
+    for (const TrackItem &t : tracks) {
+        out << t.name << t.title << t.artist << t.album << t.lyrics << t.url << qint32(t.duration) << t.cover;
+    }
+    out << queue;
+    return file.commit();
+}
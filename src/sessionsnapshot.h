@@ -0,0 +1,27 @@
+#ifndef SESSIONSNAPSHOT_H
+#define SESSIONSNAPSHOT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "playlistmodel.h"
+
+// 会话快照：退出时保存歌单顺序、当前曲目与播放位置，下次启动时在构造阶段直接映射读取，
+// 第一帧就能显示上次的歌曲（封面、歌词）并可立即继续播放，不必等待曲库重新扫描
+struct SessionSnapshot
+{
+    QString musicFolder;
+    QVector<TrackItem> tracks;
+    int index = -1;
+    qint64 positionMs = 0;
+    QByteArray queue;   // PlayQueue::saveState()
+
+    bool isValid() const { return index >= 0 && index < tracks.size(); }
+
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+
+    static QString defaultPath();
+};
+
+#endif // SESSIONSNAPSHOT_H
@@ -0,0 +1,137 @@
+#include "settingsstore.h"
+#include "trace.h"
+#include "metrics.h"
+#include <QCoreApplication>
+#include <QSettings>
+#include <QDebug>
+
+// 写线程上的工作对象：每批改动打开一次 QSettings，写完立即 sync
+class SettingsWriter : public QObject
+{
+    Q_OBJECT
+public:
+    SettingsWriter(const QString &organization, const QString &application)
+        : m_organization(organization), m_application(application) {}
+
+    void write(const QVariantMap &changes)
+    {
+        TRACE_SCOPE("SettingsWriter::write");
+        QSettings settings(m_organization, m_application);
+        for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+            if (it.value().isValid()) settings.setValue(it.key(), it.value());
+            else settings.remove(it.key());
+        }
+        settings.sync();
+        Metrics::count(Metrics::SettingsWrites);
+        if (settings.status() != QSettings::NoError) {
+            qWarning() << "SettingsStore - 写入设置失败:" << settings.status();
+        }
+        emit written();
+    }
+
+signals:
+    void written();
+
+private:
+    QString m_organization;
+    QString m_application;
+};
+
+SettingsStore::SettingsStore(const QString &organization, const QString &application, QObject *parent)
+    : QObject(parent)
+    , m_organization(organization)
+    , m_application(application)
+{
+    m_writer = new SettingsWriter(organization, application);
+    m_writer->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_writer, &QObject::deleteLater);
+    connect(m_writer, &SettingsWriter::written, this, &SettingsStore::onWritten);
+    m_thread.setObjectName("SettingsStore");
+    m_thread.start(QThread::LowPriority);
+
+    m_delayTimer.setSingleShot(true);
+    m_delayTimer.setInterval(WRITE_DELAY_MS);
+    connect(&m_delayTimer, &QTimer::timeout, this, &SettingsStore::flush);
+
+    // 事件循环结束前写完，不依赖析构顺序
+    if (QCoreApplication *app = QCoreApplication::instance()) {
+        connect(app, &QCoreApplication::aboutToQuit, this, &SettingsStore::flushAndWait);
+    }
+}
+
+SettingsStore::~SettingsStore()
+{
+    flushAndWait();
+    m_thread.quit();
+    m_thread.wait();
+}
+
+QVariant SettingsStore::value(const QString &key, const QVariant &defaultValue) const
+{
+    auto it = m_pending.constFind(key);
+    if (it != m_pending.constEnd()) return it.value().isValid() ? it.value() : defaultValue;
+    it = m_written.constFind(key);
+    if (it != m_written.constEnd()) return it.value().isValid() ? it.value() : defaultValue;
+
+    // 从磁盘读到的值记为“已写入”，之后保存相同的值不会产生写入
+    QSettings settings(m_organization, m_application);
+    if (!settings.contains(key)) return defaultValue;
+    const QVariant stored = settings.value(key);
+    m_written.insert(key, stored);
+    return stored;
+}
+
+void SettingsStore::setValue(const QString &key, const QVariant &value)
+{
+    markDirty(key, value);
+}
+
+void SettingsStore::remove(const QString &key)
+{
+    markDirty(key, QVariant());
+}
+
+void SettingsStore::markDirty(const QString &key, const QVariant &value)
+{
+    // 与已提交的值相同且没有更新的待写值时无需再写
+    auto pending = m_pending.constFind(key);
+    if (pending != m_pending.constEnd()) {
+        if (pending.value() == value) return;
+    } else {
+        auto written = m_written.constFind(key);
+        if (written != m_written.constEnd() && written.value() == value) return;
+    }
+
+    m_pending.insert(key, value);
+    emit pendingCountChanged();
+    m_delayTimer.start();
+}
+
+void SettingsStore::flush()
+{
+    m_delayTimer.stop();
+    if (m_pending.isEmpty()) return;
+
+    const QVariantMap changes = m_pending;
+    for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) m_written.insert(it.key(), it.value());
+    m_pending.clear();
+    emit pendingCountChanged();
+
+    QMetaObject::invokeMethod(m_writer, [w = m_writer, changes]() { w->write(changes); }, Qt::QueuedConnection);
+}
+
+void SettingsStore::flushAndWait()
+{
+    flush();
+    if (!m_thread.isRunning()) return;
+    // 排在已提交的写入之后，返回时所有改动都已落盘
+    QMetaObject::invokeMethod(m_writer, []() {}, Qt::BlockingQueuedConnection);
+}
+
+void SettingsStore::onWritten()
+{
+    ++m_writeCount;
+    emit writeCountChanged();
+}
+
+#include "settingsstore.moc"
@@ -0,0 +1,57 @@
+#ifndef SETTINGSSTORE_H
+#define SETTINGSSTORE_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QVariantMap>
+
+class SettingsWriter;
+
+// 延迟合并写入的设置存储：setValue/remove 只记录与上次写入不同的键，
+// 短暂停顿后把这批改动交给后台线程写入 QSettings 并 sync（QSettings 对文件格式的写入本身是
+// 先写临时文件再替换，保证原子性）。拖动音量条等连续操作只产生一次磁盘写入，界面线程不等待存储。
+// 退出时析构函数同步写完剩余改动
+class SettingsStore : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int writeCount READ writeCount NOTIFY writeCountChanged)
+    Q_PROPERTY(int pendingCount READ pendingCount NOTIFY pendingCountChanged)
+
+public:
+    explicit SettingsStore(const QString &organization, const QString &application, QObject *parent = nullptr);
+    ~SettingsStore() override;
+
+    // 读取：优先返回尚未落盘的值
+    QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
+    void setValue(const QString &key, const QVariant &value);
+    void remove(const QString &key);
+
+    // 立即提交当前改动（异步写入）；flushAndWait 会等待写入完成
+    void flush();
+    void flushAndWait();
+
+    int writeCount() const { return m_writeCount; }
+    int pendingCount() const { return int(m_pending.size()); }
+
+    static const int WRITE_DELAY_MS = 400;
+
+signals:
+    void writeCountChanged();
+    void pendingCountChanged();
+
+private:
+    void markDirty(const QString &key, const QVariant &value);
+    void onWritten();
+
+    QString m_organization;
+    QString m_application;
+    QVariantMap m_pending;          // 待写入的键；无效 QVariant 表示删除
+    mutable QVariantMap m_written;  // 已提交给写线程（或从磁盘读到）的值，用于跳过未变化的键
+    QTimer m_delayTimer;
+    QThread m_thread;
+    SettingsWriter *m_writer = nullptr;
+    int m_writeCount = 0;
+};
+
+#endif // SETTINGSSTORE_H
@@ -0,0 +1,122 @@
+#include "singleinstance.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QFileInfo>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QLockFile>
+#include <QThread>
+#include <QDebug>
+
+static const int PROBE_TIMEOUT_MS = 200;       // 判断套接字文件是否仍有主实例在监听
+static const int RETRY_INTERVAL_MS = 50;       // 等待主实例开始监听时的重试间隔
+
+SingleInstance::SingleInstance(QObject *parent)
+    : QObject(parent)
+{
+}
+
+SingleInstance::~SingleInstance() = default;
+
+QString SingleInstance::serverName()
+{
+    // 按用户区分，避免多用户登录时互相转发
+    QString user = qEnvironmentVariable("USERNAME");
+    if (user.isEmpty()) user = qEnvironmentVariable("USER");
+    const QByteArray hash = QCryptographicHash::hash(user.toUtf8(), QCryptographicHash::Sha1).toHex().left(12);
+    return QStringLiteral("MusicPlayer-") + QString::fromLatin1(hash);
+}
+
+QStringList SingleInstance::normalizeArguments(const QStringList &arguments)
+{
+    QStringList result;
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString &arg = arguments.at(i);
+        if (arg.startsWith("--")) {
+            result.append(arg);
+        } else {
+            const QFileInfo info(arg);
+            result.append(info.exists() ? info.absoluteFilePath() : arg);
+        }
+    }
+    return result;
+}
+
+bool SingleInstance::forwardToRunning(const QStringList &arguments, int timeoutMs)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName());
+    if (!socket.waitForConnected(timeoutMs)) return false;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_2);
+    out << arguments;
+    socket.write(payload);
+    if (!socket.waitForBytesWritten(timeoutMs)) {
+        qWarning() << "SingleInstance - 转发参数失败:" << socket.errorString();
+        return false;
+    }
+    socket.disconnectFromServer();
+    return true;
+}
+
+bool SingleInstance::forwardWhenReady(const QStringList &arguments, int timeoutMs)
+{
+    // 另一个进程已持有锁但可能尚未开始监听：在期限内反复尝试
+    const QDeadlineTimer deadline(timeoutMs);
+    do {
+        if (forwardToRunning(arguments, PROBE_TIMEOUT_MS)) return true;
+        QThread::msleep(RETRY_INTERVAL_MS);
+    } while (!deadline.hasExpired());
+    return false;
+}
+
+bool SingleInstance::listen()
+{
+    // 同时启动的两个进程以锁文件决出主实例；持有者崩溃后锁按进程号判定失效，可被接管
+    m_lock = std::make_unique<QLockFile>(QDir::tempPath() + "/" + serverName() + ".lock");
+    m_lock->setStaleLockTime(0);
+    if (!m_lock->tryLock(0)) {
+        qDebug() << "SingleInstance - 另一个实例正在运行或启动";
+        m_lock.reset();
+        return false;
+    }
+
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server->listen(serverName())) {
+        // 上次异常退出可能留下失效的套接字文件：确认没有进程在监听后才清理重试
+        QLocalSocket probe;
+        probe.connectToServer(serverName());
+        if (probe.waitForConnected(PROBE_TIMEOUT_MS)) {
+            qWarning() << "SingleInstance - 套接字仍有实例在监听，放弃接管";
+            return false;
+        }
+        QLocalServer::removeServer(serverName());
+        if (!m_server->listen(serverName())) {
+            qWarning() << "SingleInstance - 无法监听:" << m_server->errorString();
+            return false;
+        }
+    }
+    connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+    return true;
+}
+
+void SingleInstance::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            QDataStream in(socket);
+            in.setVersion(QDataStream::Qt_6_2);
+            in.startTransaction();
+            QStringList arguments;
+            in >> arguments;
+            if (!in.commitTransaction()) return; // 数据尚未收全
+            emit argumentsReceived(arguments);
+        });
+    }
+}
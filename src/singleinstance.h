@@ -0,0 +1,42 @@
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QObject>
+#include <QStringList>
+#include <memory>
+
+class QLocalServer;
+class QLockFile;
+
+// 单实例：第一个进程监听本地套接字，之后启动的进程把命令行参数（文件、文件夹、
+// --play/--pause/--toggle/--next/--previous）转交给它后立即退出，
+// 不再重复创建 QML 引擎和扫描曲库
+class SingleInstance : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SingleInstance(QObject *parent = nullptr);
+    ~SingleInstance() override;
+
+    // 已有实例在运行时转发参数并返回 true
+    static bool forwardToRunning(const QStringList &arguments, int timeoutMs = 500);
+    // 同上，但在 timeoutMs 内等待刚启动的主实例开始监听
+    static bool forwardWhenReady(const QStringList &arguments, int timeoutMs);
+    // 成为主实例，开始接收其它进程的参数；另一个进程已是（或正成为）主实例时返回 false
+    bool listen();
+
+    // 把相对路径转成绝对路径（接收方的工作目录可能不同），并去掉程序名
+    static QStringList normalizeArguments(const QStringList &arguments);
+
+signals:
+    void argumentsReceived(const QStringList &arguments);
+
+private:
+    static QString serverName();
+    void onNewConnection();
+
+    QLocalServer *m_server = nullptr;
+    std::unique_ptr<QLockFile> m_lock;   // 主实例在整个生命周期内持有
+};
+
+#endif // SINGLEINSTANCE_H
@@ -0,0 +1,326 @@
+#include "smartquery.h"
+#include "trace.h"
+#include <QRegularExpression>
+#include <QStringList>
+#include <algorithm>
+
+static const qint64 MS_PER_SECOND = 1000;
+static const qint64 MS_PER_HOUR = 3600 * MS_PER_SECOND;
+static const qint64 MS_PER_DAY = 24 * MS_PER_HOUR;
+
+// 拆分为单词、带引号的字符串与比较运算符
+static QStringList tokenize(const QString &text, QString *error)
+{
+    QStringList tokens;
+    int i = 0;
+    const int n = text.size();
+    while (i < n) {
+        const QChar c = text.at(i);
+        if (c.isSpace()) {
+            ++i;
+        } else if (c == '"') {
+            const int end = text.indexOf('"', i + 1);
+            if (end < 0) {
+                if (error) *error = QStringLiteral("引号不成对");
+                return {};
+            }
+            tokens.append(text.mid(i, end - i + 1));
+            i = end + 1;
+        } else if (c == '<' || c == '>' || c == '=' || (c == '!' && i + 1 < n && text.at(i + 1) == '=')) {
+            const bool twoChars = i + 1 < n && text.at(i + 1) == '=' && c != '=';
+            tokens.append(text.mid(i, twoChars ? 2 : 1));
+            i += twoChars ? 2 : 1;
+        } else {
+            int end = i;
+            while (end < n && !text.at(end).isSpace() && text.at(end) != '"'
+                   && text.at(end) != '<' && text.at(end) != '>' && text.at(end) != '='
+                   && !(text.at(end) == '!' && end + 1 < n && text.at(end + 1) == '=')) {
+                ++end;
+            }
+            tokens.append(text.mid(i, end - i));
+            i = end;
+        }
+    }
+    return tokens;
+}
+
+static QString unquote(const QString &token)
+{
+    return token.startsWith('"') ? token.mid(1, token.size() - 2) : token;
+}
+
+// 时长：300 / 300s / 5m / 5min / 1h / 4:30，返回毫秒，无法解析时为 -1
+static qint64 parseDuration(const QString &value)
+{
+    static const QRegularExpression CLOCK_RE(QStringLiteral("^(\\d+):(\\d{1,2})$"));
+    static const QRegularExpression UNIT_RE(QStringLiteral("^(\\d+(?:\\.\\d+)?)(s|m|min|h)?$"));
+    const QRegularExpressionMatch clock = CLOCK_RE.match(value);
+    if (clock.hasMatch()) {
+        return (clock.captured(1).toLongLong() * 60 + clock.captured(2).toLongLong()) * MS_PER_SECOND;
+    }
+    const QRegularExpressionMatch unit = UNIT_RE.match(value.toLower());
+    if (!unit.hasMatch()) return -1;
+    const double amount = unit.captured(1).toDouble();
+    const QString suffix = unit.captured(2);
+    const qint64 scale = suffix == "h" ? MS_PER_HOUR : (suffix.startsWith('m') ? 60 * MS_PER_SECOND : MS_PER_SECOND);
+    return qint64(amount * scale);
+}
+
+// 距今时长：30 / 30d / 2w / 12h，返回毫秒，无法解析时为 -1
+static qint64 parseAge(const QString &value)
+{
+    static const QRegularExpression AGE_RE(QStringLiteral("^(\\d+(?:\\.\\d+)?)(h|d|w)?$"));
+    const QRegularExpressionMatch match = AGE_RE.match(value.toLower());
+    if (!match.hasMatch()) return -1;
+    const double amount = match.captured(1).toDouble();
+    const QString suffix = match.captured(2);
+    const qint64 scale = suffix == "h" ? MS_PER_HOUR : (suffix == "w" ? 7 * MS_PER_DAY : MS_PER_DAY);
+    return qint64(amount * scale);
+}
+
+SmartQuery SmartQuery::compile(const QString &text, QString *error)
+{
+    static const QHash<QString, Field> FIELDS = {
+        { "title", Title }, { "artist", Artist }, { "album", Album }, { "duration", Duration },
+        { "added", Added }, { "played", Played }, { "plays", Plays },
+    };
+    static const QHash<QString, Op> OPS = {
+        { "contains", Contains }, { "!contains", NotContains }, { "=", Equal }, { "!=", NotEqual },
+        { "<", Less }, { "<=", LessEqual }, { ">", Greater }, { ">=", GreaterEqual },
+    };
+
+    SmartQuery query;
+    QString message;
+    const QStringList tokens = tokenize(text, &message);
+    if (tokens.isEmpty() && message.isEmpty()) message = QStringLiteral("条件为空");
+
+    QVector<Predicate> group;
+    int i = 0;
+    while (message.isEmpty() && i < tokens.size()) {
+        if (i + 2 >= tokens.size()) {
+            message = QStringLiteral("条件不完整: %1").arg(tokens.mid(i).join(' '));
+            break;
+        }
+        const QString fieldName = tokens.at(i).toLower();
+        const QString opName = tokens.at(i + 1).toLower();
+        const QString value = unquote(tokens.at(i + 2));
+        if (!FIELDS.contains(fieldName)) {
+            message = QStringLiteral("未知字段: %1").arg(tokens.at(i));
+            break;
+        }
+        if (!OPS.contains(opName)) {
+            message = QStringLiteral("未知运算符: %1").arg(tokens.at(i + 1));
+            break;
+        }
+
+        Predicate p;
+        p.field = FIELDS.value(fieldName);
+        p.op = OPS.value(opName);
+        const bool textOp = p.op == Contains || p.op == NotContains;
+        if (isTextField(p.field)) {
+            if (p.op != Contains && p.op != NotContains && p.op != Equal && p.op != NotEqual) {
+                message = QStringLiteral("%1 不支持 %2").arg(fieldName, opName);
+                break;
+            }
+            p.text = value.toLower();
+        } else if (textOp) {
+            message = QStringLiteral("%1 不支持 %2").arg(fieldName, opName);
+            break;
+        } else if (p.field == Added || p.field == Played) {
+            if (p.op == Equal || p.op == NotEqual) {
+                message = QStringLiteral("%1 只支持 < <= > >=").arg(fieldName);
+                break;
+            }
+            p.number = parseAge(value);
+            query.m_timeDependent = true;
+        } else if (p.field == Duration) {
+            p.number = parseDuration(value);
+        } else {
+            bool ok = false;
+            p.number = value.toLongLong(&ok);
+            if (!ok) p.number = -1;
+        }
+        if (!isTextField(p.field) && p.number < 0) {
+            message = QStringLiteral("无法识别的值: %1").arg(value);
+            break;
+        }
+        group.append(p);
+        i += 3;
+
+        if (i < tokens.size()) {
+            const QString joiner = tokens.at(i).toLower();
+            if (joiner == "or") {
+                query.m_groups.append(group);
+                group.clear();
+            } else if (joiner != "and") {
+                message = QStringLiteral("应为 and / or: %1").arg(tokens.at(i));
+                break;
+            }
+            if (++i >= tokens.size()) message = QStringLiteral("%1 之后缺少条件").arg(joiner);
+        }
+    }
+
+    if (!message.isEmpty()) {
+        if (error) *error = message;
+        return SmartQuery();
+    }
+    query.m_groups.append(group);
+    if (error) error->clear();
+    return query;
+}
+
+const QVector<QString> &SmartQuery::textColumn(const LibraryColumns &columns, Field field)
+{
+    switch (field) {
+    case Artist: return columns.artists();
+    case Album: return columns.albums();
+    default: return columns.titles();
+    }
+}
+
+const QVector<qint64> &SmartQuery::numberColumn(const LibraryColumns &columns, Field field)
+{
+    switch (field) {
+    case Added: return columns.addedAt();
+    case Played: return columns.lastPlayedAt();
+    case Plays: return columns.playCounts();
+    default: return columns.durations();
+    }
+}
+
+void SmartQuery::numericOperand(const Predicate &p, qint64 nowMs, Op *op, qint64 *value)
+{
+    // “距今 < X”等价于“时间戳 > 现在 - X”：换算成对时间戳列的比较，运算方向相反
+    if (p.field != Added && p.field != Played) {
+        *op = p.op;
+        *value = p.number;
+        return;
+    }
+    *value = nowMs - p.number;
+    switch (p.op) {
+    case Less: *op = Greater; break;
+    case LessEqual: *op = GreaterEqual; break;
+    case Greater: *op = Less; break;
+    default: *op = LessEqual; break;
+    }
+}
+
+// 数值列：运算符分派在循环之外，循环体只有一次比较与按位与，编译器可以向量化
+template <typename Compare>
+static void scanColumn(const qint64 *column, int count, quint8 *mask, Compare compare)
+{
+    for (int i = 0; i < count; ++i) mask[i] &= quint8(compare(column[i]));
+}
+
+void SmartQuery::scan(const Predicate &p, const LibraryColumns &columns, qint64 nowMs, quint8 *mask)
+{
+    const int count = columns.rowCount();
+    if (isTextField(p.field)) {
+        // 文本列：已排除的行不再比较
+        const QString *column = textColumn(columns, p.field).constData();
+        const QString &needle = p.text;
+        for (int i = 0; i < count; ++i) {
+            if (!mask[i]) continue;
+            switch (p.op) {
+            case Contains: mask[i] = column[i].contains(needle); break;
+            case NotContains: mask[i] = !column[i].contains(needle); break;
+            case Equal: mask[i] = column[i] == needle; break;
+            default: mask[i] = column[i] != needle; break;
+            }
+        }
+        return;
+    }
+
+    Op op;
+    qint64 v;
+    numericOperand(p, nowMs, &op, &v);
+    const qint64 *column = numberColumn(columns, p.field).constData();
+    switch (op) {
+    case Equal: scanColumn(column, count, mask, [v](qint64 x) { return x == v; }); break;
+    case NotEqual: scanColumn(column, count, mask, [v](qint64 x) { return x != v; }); break;
+    case Less: scanColumn(column, count, mask, [v](qint64 x) { return x < v; }); break;
+    case LessEqual: scanColumn(column, count, mask, [v](qint64 x) { return x <= v; }); break;
+    case Greater: scanColumn(column, count, mask, [v](qint64 x) { return x > v; }); break;
+    default: scanColumn(column, count, mask, [v](qint64 x) { return x >= v; }); break;
+    }
+}
+
+void SmartQuery::evaluate(const LibraryColumns &columns, qint64 nowMs, std::vector<quint8> *matches) const
+{
+    TRACE_SCOPE("SmartQuery::evaluate");
+    const int count = columns.rowCount();
+    matches->assign(size_t(count), 0);
+    std::vector<quint8> groupMask(size_t(count));
+    for (const QVector<Predicate> &group : m_groups) {
+        std::fill(groupMask.begin(), groupMask.end(), quint8(1));
+        for (const Predicate &p : group) scan(p, columns, nowMs, groupMask.data());
+        for (int i = 0; i < count; ++i) (*matches)[size_t(i)] |= groupMask[size_t(i)];
+    }
+}
+
+bool SmartQuery::matchesRow(const LibraryColumns &columns, int row, qint64 nowMs) const
+{
+    for (const QVector<Predicate> &group : m_groups) {
+        bool all = true;
+        for (const Predicate &p : group) {
+            quint8 mask = 1;
+            if (isTextField(p.field)) {
+                const QString &value = textColumn(columns, p.field).at(row);
+                switch (p.op) {
+                case Contains: mask = value.contains(p.text); break;
+                case NotContains: mask = !value.contains(p.text); break;
+                case Equal: mask = value == p.text; break;
+                default: mask = value != p.text; break;
+                }
+            } else {
+                Op op;
+                qint64 v;
+                numericOperand(p, nowMs, &op, &v);
+                const qint64 x = numberColumn(columns, p.field).at(row);
+                switch (op) {
+                case Equal: mask = x == v; break;
+                case NotEqual: mask = x != v; break;
+                case Less: mask = x < v; break;
+                case LessEqual: mask = x <= v; break;
+                case Greater: mask = x > v; break;
+                default: mask = x >= v; break;
+                }
+            }
+            if (!mask) {
+                all = false;
+                break;
+            }
+        }
+        if (all) return true;
+    }
+    return false;
+}
+
+void SmartQuery::update(const LibraryColumns &columns, const LibraryColumns::Delta &delta, qint64 nowMs,
+                        std::vector<quint8> *matches) const
+{
+    TRACE_SCOPE("SmartQuery::update");
+    // 结果随时间变化，或变化的行太多时，整列重新扫描更快
+    if (m_timeDependent || matches->empty() || delta.changedRows.size() * 4 > columns.rowCount()) {
+        evaluate(columns, nowMs, matches);
+        return;
+    }
+    std::vector<quint8> previous;
+    previous.swap(*matches);
+    matches->assign(size_t(columns.rowCount()), 0);
+    for (int r = 0; r < columns.rowCount(); ++r) {
+        const int old = delta.oldRow.at(r);
+        if (old >= 0 && size_t(old) < previous.size()) (*matches)[size_t(r)] = previous[size_t(old)];
+        else (*matches)[size_t(r)] = matchesRow(columns, r, nowMs);
+    }
+}
+
+void SmartQuery::updateRows(const LibraryColumns &columns, const QVector<int> &rows, qint64 nowMs,
+                            std::vector<quint8> *matches) const
+{
+    if (m_timeDependent || matches->size() != size_t(columns.rowCount())) {
+        evaluate(columns, nowMs, matches);
+        return;
+    }
+    for (int r : rows) (*matches)[size_t(r)] = matchesRow(columns, r, nowMs);
+}
@@ -0,0 +1,56 @@
+#ifndef SMARTQUERY_H
+#define SMARTQUERY_H
+
+#include <QString>
+#include <QVector>
+#include <vector>
+#include "librarycolumns.h"
+
+// 智能歌单的条件：编译一次，按列扫描求值。语法（不区分大小写）：
+//   条件 [and 条件 ...] [or 条件 [and ...]]，and 优先于 or
+//   条件 = 字段 运算符 值；值含空格时加双引号
+//   title / artist / album：contains、!contains、=、!=（比较不区分大小写）
+//   duration：=、!=、<、<=、>、>=，值如 300、300s、5m、1h、4:30（不带单位为秒）
+//   added / played：距今多久（<、<=、>、>=），值如 30d、2w、12h（不带单位为天）；从未播放视为无限久
+//   plays：播放次数
+// 例：artist contains "周杰伦" and duration > 5m；added < 30d；plays = 0
+class SmartQuery
+{
+public:
+    static SmartQuery compile(const QString &text, QString *error = nullptr);
+
+    bool isValid() const { return !m_groups.isEmpty(); }
+    // 含 added / played 条件时结果随时间变化，不能沿用上次的结果
+    bool isTimeDependent() const { return m_timeDependent; }
+
+    // 对全部行求值：每个条件对整列做一次扫描，只保留仍然匹配的行
+    void evaluate(const LibraryColumns &columns, qint64 nowMs, std::vector<quint8> *matches) const;
+    // 曲库更新后：未变化的行沿用上次的结果，只重新计算新行与元数据变化的行
+    void update(const LibraryColumns &columns, const LibraryColumns::Delta &delta, qint64 nowMs,
+                std::vector<quint8> *matches) const;
+    // 只重新计算指定的行（例如播放次数变化）
+    void updateRows(const LibraryColumns &columns, const QVector<int> &rows, qint64 nowMs,
+                    std::vector<quint8> *matches) const;
+
+private:
+    enum Field { Title, Artist, Album, Duration, Added, Played, Plays };
+    enum Op { Contains, NotContains, Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+    struct Predicate {
+        Field field = Title;
+        Op op = Equal;
+        QString text;       // 文本字段：已转小写
+        qint64 number = 0;  // duration 为毫秒，added / played 为距今毫秒数
+    };
+
+    static bool isTextField(Field field) { return field <= Album; }
+    static const QVector<QString> &textColumn(const LibraryColumns &columns, Field field);
+    static const QVector<qint64> &numberColumn(const LibraryColumns &columns, Field field);
+    static void numericOperand(const Predicate &p, qint64 nowMs, Op *op, qint64 *value);
+    static void scan(const Predicate &p, const LibraryColumns &columns, qint64 nowMs, quint8 *mask);
+    bool matchesRow(const LibraryColumns &columns, int row, qint64 nowMs) const;
+
+    QVector<QVector<Predicate>> m_groups;   // 组内为 and，组间为 or
+    bool m_timeDependent = false;
+};
+
+#endif // SMARTQUERY_H
@@ -0,0 +1,124 @@
+#include "spectrumanalyzer.h"
+#include <cmath>
+#include <algorithm>
+
+static const double MIN_FREQ = 40.0;
+static const double MAX_FREQ = 16000.0;
+static const double FLOOR_DB = -70.0;
+static const double PI = 3.14159265358979323846;
+
+SpectrumAnalyzer::SpectrumAnalyzer(int fftSize, int bandCount)
+    : m_fftSize(fftSize)
+    , m_bandCount(bandCount)
+{
+    // fftSize 必须为 2 的幂
+    m_window.resize(fftSize);
+    for (int i = 0; i < fftSize; ++i) {
+        m_window[i] = float(0.5 - 0.5 * std::cos(2.0 * PI * i / (fftSize - 1)));
+    }
+
+    m_buf.resize(fftSize);
+    m_twiddles.resize(fftSize / 2);
+    for (int k = 0; k < fftSize / 2; ++k) {
+        const double a = -2.0 * PI * k / fftSize;
+        m_twiddles[k] = { float(std::cos(a)), float(std::sin(a)) };
+    }
+
+    int bits = 0;
+    while ((1 << bits) < fftSize) ++bits;
+    m_bitReverse.resize(fftSize);
+    for (int i = 0; i < fftSize; ++i) {
+        int r = 0;
+        for (int b = 0; b < bits; ++b) {
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        }
+        m_bitReverse[i] = r;
+    }
+
+    m_smoothed.fill(0.0, bandCount);
+    rebuildBands();
+}
+
+void SpectrumAnalyzer::setSampleRate(int sampleRate)
+{
+    if (sampleRate > 0 && sampleRate != m_sampleRate) {
+        m_sampleRate = sampleRate;
+        rebuildBands();
+    }
+}
+
+void SpectrumAnalyzer::reset()
+{
+    m_smoothed.fill(0.0, m_bandCount);
+    m_smoothedLevel = 0.0;
+}
+
+void SpectrumAnalyzer::rebuildBands()
+{
+    // 对数分布的频段边界，保证每个频段至少一个 bin
+    m_bandEdges.resize(m_bandCount + 1);
+    const double binHz = double(m_sampleRate) / m_fftSize;
+    const double maxFreq = std::min(MAX_FREQ, m_sampleRate / 2.0);
+    int prev = 0;
+    for (int b = 0; b <= m_bandCount; ++b) {
+        const double f = MIN_FREQ * std::pow(maxFreq / MIN_FREQ, double(b) / m_bandCount);
+        int bin = int(std::lround(f / binHz));
+        if (b > 0) bin = std::max(bin, prev + 1);
+        bin = std::min(bin, m_fftSize / 2);
+        m_bandEdges[b] = bin;
+        prev = bin;
+    }
+}
+
+void SpectrumAnalyzer::fft()
+{
+    const int n = m_fftSize;
+    for (int i = 0; i < n; ++i) {
+        const int j = m_bitReverse[i];
+        if (j > i) std::swap(m_buf[i], m_buf[j]);
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        const int half = len >> 1;
+        const int step = n / len;
+        for (int i = 0; i < n; i += len) {
+            for (int k = 0; k < half; ++k) {
+                const std::complex<float> t = m_twiddles[k * step] * m_buf[i + k + half];
+                m_buf[i + k + half] = m_buf[i + k] - t;
+                m_buf[i + k] += t;
+            }
+        }
+    }
+}
+
+void SpectrumAnalyzer::process(const float *mono, QVector<double> &bands, double &level)
+{
+    double sumSquares = 0.0;
+    for (int i = 0; i < m_fftSize; ++i) {
+        sumSquares += double(mono[i]) * mono[i];
+        m_buf[i] = { mono[i] * m_window[i], 0.0f };
+    }
+    fft();
+
+    // Hann 窗满幅正弦的峰值约为 N/4
+    const double norm = 4.0 / m_fftSize;
+    if (bands.size() != m_bandCount) bands.resize(m_bandCount);
+    for (int b = 0; b < m_bandCount; ++b) {
+        double peak = 0.0;
+        for (int k = m_bandEdges[b]; k < std::max(m_bandEdges[b + 1], m_bandEdges[b] + 1) && k < m_fftSize / 2; ++k) {
+            peak = std::max(peak, double(std::abs(m_buf[k])));
+        }
+        const double db = 20.0 * std::log10(peak * norm + 1e-9);
+        double value = std::clamp((db - FLOOR_DB) / -FLOOR_DB, 0.0, 1.0);
+
+        // 快起慢落，避免频谱条抖动
+        double &s = m_smoothed[b];
+        s = value > s ? value : s * 0.85 + value * 0.15;
+        bands[b] = s;
+    }
+
+    const double rms = std::sqrt(sumSquares / m_fftSize);
+    const double rmsDb = 20.0 * std::log10(rms + 1e-9);
+    const double rawLevel = std::clamp((rmsDb + 50.0) / 50.0, 0.0, 1.0);
+    m_smoothedLevel = rawLevel > m_smoothedLevel ? rawLevel : m_smoothedLevel * 0.8 + rawLevel * 0.2;
+    level = m_smoothedLevel;
+}
@@ -0,0 +1,39 @@
+#ifndef SPECTRUMANALYZER_H
+#define SPECTRUMANALYZER_H
+
+#include <QVector>
+#include <vector>
+#include <complex>
+
+// 基于真实 PCM 的频谱分析：Hann 窗 + 基 2 FFT，按对数频率划分频段并做起落平滑
+// 输出与模拟频谱相同的 0..1 取值范围，Visualizer 无需改动
+class SpectrumAnalyzer
+{
+public:
+    explicit SpectrumAnalyzer(int fftSize = 2048, int bandCount = 60);
+
+    int fftSize() const { return m_fftSize; }
+    int bandCount() const { return m_bandCount; }
+    void setSampleRate(int sampleRate);
+
+    // mono 长度必须为 fftSize()；输出 bands（0..1）与 RMS 电平（0..1）
+    void process(const float *mono, QVector<double> &bands, double &level);
+    void reset();
+
+private:
+    void fft();
+    void rebuildBands();
+
+    int m_fftSize;
+    int m_bandCount;
+    int m_sampleRate = 48000;
+    std::vector<float> m_window;
+    std::vector<std::complex<float>> m_buf;
+    std::vector<std::complex<float>> m_twiddles;
+    std::vector<int> m_bitReverse;
+    std::vector<int> m_bandEdges; // bandCount + 1 个 FFT bin 边界
+    QVector<double> m_smoothed;
+    double m_smoothedLevel = 0.0;
+};
+
+#endif // SPECTRUMANALYZER_H
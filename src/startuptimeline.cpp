@@ -0,0 +1,67 @@
+#include "startuptimeline.h"
+#include <QElapsedTimer>
+#include <QVariantMap>
+#include <QVector>
+#include <QDebug>
+
+namespace {
+struct Event {
+    QString label;
+    qint64 ms = 0;
+    qint64 compileMs = -1;   // 仅 QML 组件记录
+    qint64 createMs = -1;
+};
+QElapsedTimer s_clock;
+QVector<Event> s_events;
+}
+
+namespace StartupTimeline {
+
+void start()
+{
+    s_clock.start();
+    s_events.clear();
+}
+
+bool mark(const QString &label)
+{
+    if (!s_clock.isValid() || elapsed(label) >= 0) return false;
+    const qint64 ms = s_clock.elapsed();
+    s_events.append({ label, ms });
+    qInfo() << "Startup -" << label << ms << "ms";
+    return true;
+}
+
+void recordComponent(const QString &name, qint64 compileMs, qint64 createMs)
+{
+    if (!s_clock.isValid()) return;
+    const QString label = "qml:" + name;
+    s_events.append({ label, s_clock.elapsed(), compileMs, createMs });
+    qInfo() << "Startup -" << label << "compile" << compileMs << "ms, create" << createMs << "ms";
+}
+
+qint64 elapsed(const QString &label)
+{
+    for (const Event &event : s_events) {
+        if (event.label == label) return event.ms;
+    }
+    return -1;
+}
+
+QVariantList events()
+{
+    QVariantList list;
+    for (const Event &event : s_events) {
+        QVariantMap row;
+        row["label"] = event.label;
+        row["ms"] = event.ms;
+        if (event.compileMs >= 0) {
+            row["compileMs"] = event.compileMs;
+            row["createMs"] = event.createMs;
+        }
+        list.append(row);
+    }
+    return list;
+}
+
+} // namespace StartupTimeline
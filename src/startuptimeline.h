@@ -0,0 +1,23 @@
+#ifndef STARTUPTIMELINE_H
+#define STARTUPTIMELINE_H
+
+#include <QString>
+#include <QVariantList>
+
+// 启动时间线：main() 开头调用 start()，之后各阶段调用 mark() 记录距启动的毫秒数。
+// 每个标签只记录第一次，用于观察首帧时间（firstFrame）与可播放时间（playable）
+namespace StartupTimeline {
+
+void start();
+// 首次记录返回 true
+bool mark(const QString &label);
+// 记录 QML 组件的编译与创建耗时（标签为 "qml:<name>"，可重复记录）
+void recordComponent(const QString &name, qint64 compileMs, qint64 createMs);
+// 未记录时返回 -1
+qint64 elapsed(const QString &label);
+// [{label, ms}]，按记录顺序；组件记录另有 compileMs、createMs
+QVariantList events();
+
+} // namespace StartupTimeline
+
+#endif // STARTUPTIMELINE_H
@@ -0,0 +1,150 @@
+#include "trace.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QDebug>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+static const int EVENTS_PER_THREAD = 1 << 16;   // 每线程保留最近 65536 个事件，写满后覆盖最旧的
+
+namespace {
+
+struct Event {
+    const char *name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+// 每个线程一个环形缓冲区：只有所属线程写入，count（累计写入数）以 release 发布，导出时以 acquire 读取
+struct ThreadBuffer {
+    int tid = 0;
+    QString threadName;
+    std::unique_ptr<Event[]> events{ new Event[EVENTS_PER_THREAD] };
+    std::atomic<qint64> count{ 0 };
+};
+
+QMutex s_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;   // 线程退出后缓冲区保留到进程结束
+thread_local ThreadBuffer *t_buffer = nullptr;
+
+const auto s_origin = std::chrono::steady_clock::now();
+
+ThreadBuffer *currentBuffer()
+{
+    if (t_buffer) return t_buffer;
+    // 每个线程只在第一次记录时加锁注册一次
+    auto buffer = std::make_unique<ThreadBuffer>();
+    QThread *thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        buffer->threadName = QStringLiteral("Main");
+    } else if (thread) {
+        buffer->threadName = thread->objectName();
+    }
+    QMutexLocker locker(&s_registryMutex);
+    buffer->tid = int(s_buffers.size()) + 1;
+    if (buffer->threadName.isEmpty()) buffer->threadName = QString("Thread %1").arg(buffer->tid);
+    t_buffer = buffer.get();
+    s_buffers.push_back(std::move(buffer));
+    return t_buffer;
+}
+
+QString jsonEscape(const QString &text)
+{
+    QString out;
+    out.reserve(text.size());
+    for (QChar c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (c.unicode() < 0x20) out += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+        else out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+namespace Trace {
+
+std::atomic<bool> g_enabled{ false };
+
+void setEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_origin).count();
+}
+
+void recordComplete(const char *name, qint64 startNs, qint64 endNs)
+{
+    ThreadBuffer *buffer = currentBuffer();
+    const qint64 index = buffer->count.load(std::memory_order_relaxed);
+    buffer->events[index % EVENTS_PER_THREAD] = { name, startNs, endNs - startNs };
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+QString defaultDumpPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/traces/trace-"
+         + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json";
+}
+
+bool dumpJson(const QString &filePath)
+{
+    QByteArray json;
+    json.reserve(1 << 20);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto append = [&](const QByteArray &event) {
+        if (!first) json += ",\n";
+        first = false;
+        json += event;
+    };
+
+    qint64 dropped = 0;
+    {
+        QMutexLocker locker(&s_registryMutex);
+        std::vector<Event> events;
+        for (const auto &buffer : s_buffers) {
+            append(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"%2\"}}")
+                   .arg(buffer->tid).arg(jsonEscape(buffer->threadName)).toUtf8());
+            // 先复制再检查：复制期间所属线程可能继续写入，被覆盖的最旧部分不导出
+            const qint64 end = buffer->count.load(std::memory_order_acquire);
+            qint64 begin = qMax<qint64>(0, end - EVENTS_PER_THREAD);
+            events.clear();
+            for (qint64 i = begin; i < end; ++i) events.push_back(buffer->events[i % EVENTS_PER_THREAD]);
+            const qint64 overwritten = buffer->count.load(std::memory_order_acquire) - EVENTS_PER_THREAD;
+            const qint64 skip = qMax<qint64>(0, overwritten - begin);
+            begin += skip;
+            dropped += begin;
+            for (qint64 i = skip; i < qint64(events.size()); ++i) {
+                const Event &e = events[size_t(i)];
+                // trace-event 的时间单位是微秒，保留小数以免短事件变成 0
+                append(QString("{\"name\":\"%1\",\"cat\":\"app\",\"ph\":\"X\",\"pid\":1,\"tid\":%2,\"ts\":%3,\"dur\":%4}")
+                       .arg(jsonEscape(QString::fromUtf8(e.name))).arg(buffer->tid)
+                       .arg(e.startNs / 1000.0, 0, 'f', 3).arg(e.durationNs / 1000.0, 0, 'f', 3).toUtf8());
+            }
+        }
+    }
+    // 被覆盖（未导出）的最旧事件数记录在 otherData 中
+    json += QString("],\"otherData\":{\"droppedEvents\":\"%1\"}}\n").arg(dropped).toUtf8();
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(json);
+    if (!file.commit()) return false;
+    qInfo() << "Trace - 已导出:" << filePath << (dropped > 0 ? QString("（缓冲区已满，最早的 %1 个事件已被覆盖）").arg(dropped) : QString());
+    return true;
+}
+
+} // namespace Trace
@@ -0,0 +1,48 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <atomic>
+
+// 轻量级作用域追踪：TRACE_SCOPE("名称") 在作用域结束时记录一个完整事件，
+// 写入当前线程自己的环形缓冲区（无锁，单写者，写满后覆盖最旧的事件），可导出为 Chrome / Perfetto 的 trace-event JSON。
+// 未启用时只有一次 relaxed 原子读取
+namespace Trace {
+
+extern std::atomic<bool> g_enabled;
+
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool enabled);
+
+// 写出每个线程最近记录的事件（chrome://tracing 或 ui.perfetto.dev 可直接打开），可反复导出
+bool dumpJson(const QString &filePath);
+QString defaultDumpPath();
+
+qint64 nowNs();
+// name 必须是静态字符串（通常为字面量），缓冲区只保存指针
+void recordComplete(const char *name, qint64 startNs, qint64 endNs);
+
+class Scope
+{
+public:
+    explicit Scope(const char *name)
+        : m_name(enabled() ? name : nullptr), m_start(m_name ? nowNs() : 0) {}
+    ~Scope()
+    {
+        if (m_name) recordComplete(m_name, m_start, nowNs());
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_name;
+    qint64 m_start;
+};
+
+} // namespace Trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+#endif // TRACE_H
@@ -0,0 +1,18 @@
+#ifndef TRACKITEM_H
+#define TRACKITEM_H
+
+#include <QString>
+#include <QUrl>
+
+struct TrackItem {
+    QString name;    // 文件名（作为后备显示）
+    QString title;   // 从元数据提取的标题
+    QString artist;  // 从元数据提取的艺术家
+    QString album;   // 从元数据提取的唱片集
+    QString lyrics;  // 从元数据提取的歌词
+    QUrl url;
+    int duration; // ms
+    QString cover; // qrc or file path
+};
+
+#endif // TRACKITEM_H